@@ -138,6 +138,7 @@ int vtkCompleteArrays::RequestData(
     // Receive and collected information from the remote processes.
     vtkPVDataInformation* dataInfo = vtkPVDataInformation::New();
     vtkPVDataInformation* tmpInfo = vtkPVDataInformation::New();
+    dataInfo->SkipCompositeDataInformationOn();
 
     int length = 0;
     this->Controller->Receive(&length, 1, infoProc, 389002);
@@ -180,6 +181,8 @@ int vtkCompleteArrays::RequestData(
     vtkClientServerStream css;
     vtkPVDataInformation* dataInfo = vtkPVDataInformation::New();
     dataInfo->SetSortArrays(0);
+    // only the arrays are needed, leave the per-block information behind.
+    dataInfo->SkipCompositeDataInformationOn();
     dataInfo->CopyFromObject(output);
     dataInfo->CopyToStream(&css);
     size_t length;
@@ -21,13 +21,18 @@
 #include "vtkInformation.h"
 #include "vtkInformationKey.h"
 #include "vtkInformationIterator.h"
+#include "vtkInformationVector.h"
 #include "vtkNew.h"
 #include "vtkStringArray.h"
 #include "vtkStdString.h"
 #include "vtkPVPostFilter.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkVariant.h"
 #include "vtkVariantArray.h"
 
+#include <algorithm>
+#include <cmath>
 #include <map>
 #include <set>
 #include <vector>
@@ -46,6 +51,181 @@ namespace
   typedef std::vector<vtkPVArrayInformationInformationKey> vtkInternalInformationKeysBase;
 }
 
+namespace
+{
+  // Arrays smaller than this are handled by vtkDataArray::GetRange(), the
+  // threading overhead isn't worth it.
+  const vtkIdType vtkParallelRangeMinimumValues = 262144;
+
+  // Computes the magnitude range (when there is more than one component)
+  // followed by the range of each component in a single pass over the
+  // tuples. The inner loops are written as plain min/max reductions so that
+  // the compiler can vectorize them.
+  template <class T>
+  class vtkArrayRangeFunctor
+  {
+    const T* Data;
+    int NumberOfComponents;
+    int NumberOfRanges;
+    vtkSMPThreadLocal<std::vector<double> > LocalRanges;
+
+  public:
+    std::vector<double> Ranges;
+
+    vtkArrayRangeFunctor(const T* data, int numComps) :
+      Data(data), NumberOfComponents(numComps),
+      NumberOfRanges(numComps > 1? numComps + 1 : numComps)
+      {
+      }
+
+    void Initialize()
+      {
+      std::vector<double>& ranges = this->LocalRanges.Local();
+      ranges.resize(2 * this->NumberOfRanges);
+      for (int cc = 0; cc < this->NumberOfRanges; cc++)
+        {
+        ranges[2*cc] = VTK_DOUBLE_MAX;
+        ranges[2*cc+1] = -VTK_DOUBLE_MAX;
+        }
+      }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      std::vector<double>& ranges = this->LocalRanges.Local();
+      const int numComps = this->NumberOfComponents;
+      // component ranges follow the magnitude range, if any.
+      double* compRanges = &ranges[2 * (this->NumberOfRanges - numComps)];
+      const T* tuple = this->Data + begin * numComps;
+      if (numComps == 1)
+        {
+        double minV = compRanges[0], maxV = compRanges[1];
+        for (vtkIdType cc = begin; cc < end; ++cc, ++tuple)
+          {
+          double v = static_cast<double>(*tuple);
+          // NaNs fail both comparisons and are skipped.
+          minV = v < minV? v : minV;
+          maxV = v > maxV? v : maxV;
+          }
+        compRanges[0] = minV;
+        compRanges[1] = maxV;
+        return;
+        }
+
+      double minMag2 = ranges[0], maxMag2 = ranges[1];
+      for (vtkIdType cc = begin; cc < end; ++cc, tuple += numComps)
+        {
+        double mag2 = 0.0;
+        for (int comp = 0; comp < numComps; ++comp)
+          {
+          double v = static_cast<double>(tuple[comp]);
+          mag2 += v * v;
+          compRanges[2*comp] = v < compRanges[2*comp]? v : compRanges[2*comp];
+          compRanges[2*comp+1] =
+            v > compRanges[2*comp+1]? v : compRanges[2*comp+1];
+          }
+        minMag2 = mag2 < minMag2? mag2 : minMag2;
+        maxMag2 = mag2 > maxMag2? mag2 : maxMag2;
+        }
+      ranges[0] = minMag2;
+      ranges[1] = maxMag2;
+      }
+
+    void Reduce()
+      {
+      this->Ranges.resize(2 * this->NumberOfRanges);
+      for (int cc = 0; cc < this->NumberOfRanges; cc++)
+        {
+        this->Ranges[2*cc] = VTK_DOUBLE_MAX;
+        this->Ranges[2*cc+1] = -VTK_DOUBLE_MAX;
+        }
+      vtkSMPThreadLocal<std::vector<double> >::iterator iter;
+      for (iter = this->LocalRanges.begin();
+        iter != this->LocalRanges.end(); ++iter)
+        {
+        for (int cc = 0; cc < this->NumberOfRanges; cc++)
+          {
+          this->Ranges[2*cc] = std::min(this->Ranges[2*cc], (*iter)[2*cc]);
+          this->Ranges[2*cc+1] =
+            std::max(this->Ranges[2*cc+1], (*iter)[2*cc+1]);
+          }
+        }
+      if (this->NumberOfComponents > 1 && this->Ranges[0] <= this->Ranges[1])
+        {
+        // the magnitude was tracked squared. When every tuple has a NaN, the
+        // range is left empty, as for components.
+        this->Ranges[0] = sqrt(this->Ranges[0]);
+        this->Ranges[1] = sqrt(this->Ranges[1]);
+        }
+      }
+  };
+
+  template <class T>
+  void vtkComputeArrayRanges(const T* data, vtkIdType numTuples,
+    int numComps, double* ranges)
+    {
+    vtkArrayRangeFunctor<T> functor(data, numComps);
+    vtkSMPTools::For(0, numTuples, functor);
+    std::copy(functor.Ranges.begin(), functor.Ranges.end(), ranges);
+    }
+
+  // Stores ranges computed by vtkComputeArrayRanges() in the range cache of
+  // the array, the one vtkDataArray::GetRange() uses. Entries older than the
+  // array are stale.
+  void vtkCacheArrayRanges(vtkDataArray* array, const double* ranges)
+    {
+    int numComps = array->GetNumberOfComponents();
+    vtkInformation* info = array->GetInformation();
+    if (numComps > 1)
+      {
+      info->Set(vtkDataArray::L2_NORM_RANGE(), ranges, 2);
+      ranges += 2;
+      }
+    vtkNew<vtkInformationVector> infoVec;
+    infoVec->SetNumberOfInformationObjects(numComps);
+    for (int cc = 0; cc < numComps; cc++)
+      {
+      infoVec->GetInformationObject(cc)->Set(
+        vtkDataArray::COMPONENT_RANGE(), ranges + 2 * cc, 2);
+      }
+    info->Set(vtkDataArray::PER_COMPONENT(), infoVec.GetPointer());
+    }
+
+  // Returns true if the range cache of the array has all the ranges, up to
+  // date, in which case vtkDataArray::GetRange() doesn't scan the array. As
+  // in vtkDataArray::ComputeRange(), a range is up to date when it was
+  // stored after the array was last modified.
+  bool vtkHasCachedArrayRanges(vtkDataArray* array)
+    {
+    if (!array->HasInformation())
+      {
+      return false;
+      }
+    vtkInformation* info = array->GetInformation();
+    vtkInformationVector* infoVec = info->Get(vtkDataArray::PER_COMPONENT());
+    int numComps = array->GetNumberOfComponents();
+    if (!infoVec || infoVec->GetNumberOfInformationObjects() < numComps)
+      {
+      return false;
+      }
+    unsigned long arrayMTime = array->GetMTime();
+    if (numComps > 1 && (!info->Has(vtkDataArray::L2_NORM_RANGE()) ||
+        arrayMTime > info->GetMTime()))
+      {
+      return false;
+      }
+    for (int cc = 0; cc < numComps; cc++)
+      {
+      vtkInformation* compInfo = infoVec->GetInformationObject(cc);
+      if (!compInfo->Has(vtkDataArray::COMPONENT_RANGE()) ||
+        arrayMTime > compInfo->GetMTime())
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+}
+
 class vtkPVArrayInformation::vtkInternalComponentNames:
     public vtkInternalComponentNameBase
 {
@@ -555,24 +735,7 @@ void vtkPVArrayInformation::CopyFromObject(vtkObject* obj)
 
   if (vtkDataArray* const data_array = vtkDataArray::SafeDownCast(obj))
     {
-    double range[2];
-    double *ptr;
-    int idx;
-
-    ptr = this->Ranges;
-    if (this->NumberOfComponents > 1)
-      {
-      // First store range of vector magnitude.
-      data_array->GetRange(range, -1);
-      *ptr++ = range[0];
-      *ptr++ = range[1];
-      }
-    for (idx = 0; idx < this->NumberOfComponents; ++idx)
-      {
-      data_array->GetRange(range, idx);
-      *ptr++ = range[0];
-      *ptr++ = range[1];
-      }
+    this->CopyRangesFromArray(data_array);
     }
 
   if(this->InformationKeys)
@@ -597,6 +760,60 @@ void vtkPVArrayInformation::CopyFromObject(vtkObject* obj)
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkPVArrayInformation::CopyRangesFromArray(vtkDataArray* data_array)
+{
+  int numRanges = this->NumberOfComponents > 1?
+    this->NumberOfComponents + 1 : this->NumberOfComponents;
+  if (numRanges == 0)
+    {
+    return;
+    }
+
+  // Ranges cached by the array are used as they are, by GetRange() below.
+  vtkIdType numValues =
+    data_array->GetNumberOfTuples() * this->NumberOfComponents;
+  bool computed = false;
+  if (numValues >= vtkParallelRangeMinimumValues &&
+    data_array->HasStandardMemoryLayout() &&
+    !vtkHasCachedArrayRanges(data_array))
+    {
+    computed = true;
+    void* voidPtr = data_array->GetVoidPointer(0);
+    switch (data_array->GetDataType())
+      {
+      vtkTemplateMacro(vtkComputeArrayRanges(static_cast<VTK_TT*>(voidPtr),
+          data_array->GetNumberOfTuples(), this->NumberOfComponents,
+          this->Ranges));
+    default:
+      computed = false;
+      }
+    if (computed)
+      {
+      vtkCacheArrayRanges(data_array, this->Ranges);
+      }
+    }
+
+  if (!computed)
+    {
+    double range[2];
+    double *ptr = this->Ranges;
+    if (this->NumberOfComponents > 1)
+      {
+      // First store range of vector magnitude.
+      data_array->GetRange(range, -1);
+      *ptr++ = range[0];
+      *ptr++ = range[1];
+      }
+    for (int idx = 0; idx < this->NumberOfComponents; ++idx)
+      {
+      data_array->GetRange(range, idx);
+      *ptr++ = range[0];
+      *ptr++ = range[1];
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkPVArrayInformation::AddInformation(vtkPVInformation* info)
 {
@@ -28,6 +28,7 @@
 #include "vtkPVInformation.h"
 class vtkAbstractArray;
 class vtkClientServerStream;
+class vtkDataArray;
 class vtkStdString;
 class vtkStringArray;
 
@@ -138,6 +139,12 @@ protected:
   vtkPVArrayInformation();
   ~vtkPVArrayInformation();
 
+  // Description:
+  // Fills Ranges from the array. Large arrays are scanned once, in parallel,
+  // for all component and magnitude ranges, which are then stored in the
+  // range cache of the array, the one vtkDataArray::GetRange() uses.
+  void CopyRangesFromArray(vtkDataArray*);
+
   int IsPartial;
   int DataType;
   int NumberOfComponents;
@@ -212,7 +212,7 @@ void vtkPVCompositeDataInformation::CopyFromObject(vtkObject* object)
     if (curDO)
       {
       childInfo = vtkSmartPointer<vtkPVDataInformation>::New();
-      childInfo->CopyFromObject(curDO);
+      childInfo->CopyFromBlock(curDO);
       }
     this->Internal->ChildrenInformation.resize(index+1);
     this->Internal->ChildrenInformation[index].Info = childInfo;
@@ -264,7 +264,7 @@ void vtkPVCompositeDataInformation::CopyFromAMR(vtkUniformGridAMR* amr)
       vtkUniformGrid* dataset = amr->GetDataSet(level, idx);
       if (dataset)
         {
-        tempDSInfo->CopyFromObject(dataset);
+        tempDSInfo->CopyFromBlock(dataset);
         levelInfo->AddInformation(tempDSInfo.GetPointer(), 1);
         }
       }
@@ -31,6 +31,7 @@
 #include "vtkGraph.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
+#include "vtkInformationObjectBaseKey.h"
 #include "vtkPVInstantiator.h"
 #include "vtkMath.h"
 #include "vtkMultiProcessController.h"
@@ -48,15 +49,19 @@
 #include "vtkUniformGrid.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkMultiProcessStream.h"
+#include "vtkUnsignedCharArray.h"
 
 #include <vector>
 #include <map>
 #include <string>
+#include <string.h>
 
 vtkStandardNewMacro(vtkPVDataInformation);
 
 std::map<std::string, std::string> helpers;
 
+vtkInformationKeyMacro(vtkPVDataInformation, BLOCK_INFORMATION, ObjectBase);
+
 //----------------------------------------------------------------------------
 vtkPVDataInformation::vtkPVDataInformation()
 {
@@ -92,6 +97,7 @@ vtkPVDataInformation::vtkPVDataInformation()
 
   this->PortNumber = -1;
   this->SortArrays = true;
+  this->SkipCompositeDataInformation = false;
 }
 
 //----------------------------------------------------------------------------
@@ -122,14 +128,16 @@ vtkPVDataInformation::~vtkPVDataInformation()
 //----------------------------------------------------------------------------
 void vtkPVDataInformation::CopyParametersToStream(vtkMultiProcessStream& str)
 {
-  str << 828792 << this->PortNumber;
+  str << 828792 << this->PortNumber
+      << (this->SkipCompositeDataInformation? 1 : 0);
 }
 
 //----------------------------------------------------------------------------
 void vtkPVDataInformation::CopyParametersFromStream(vtkMultiProcessStream& str)
 {
-  int magic_number;
-  str >> magic_number >> this->PortNumber;
+  int magic_number, skipComposite;
+  str >> magic_number >> this->PortNumber >> skipComposite;
+  this->SkipCompositeDataInformation = (skipComposite != 0);
   if (magic_number != 828792)
     {
     vtkErrorMacro("Magic number mismatch.");
@@ -143,6 +151,8 @@ void vtkPVDataInformation::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent);
 
   os << indent << "PortNumber: " << this->PortNumber << endl;
+  os << indent << "SkipCompositeDataInformation: "
+     << this->SkipCompositeDataInformation << endl;
   os << indent << "DataSetType: " << this->DataSetType << endl;
   os << indent << "CompositeDataSetType: " << this->CompositeDataSetType << endl;
   os << indent << "NumberOfPoints: " << this->NumberOfPoints << endl;
@@ -318,7 +328,7 @@ void vtkPVDataInformation::AddFromMultiPieceDataSet(vtkCompositeDataSet* data)
     if (dobj)
       {
       vtkPVDataInformation* dinf = vtkPVDataInformation::New();
-      dinf->CopyFromObject(dobj);
+      dinf->CopyFromBlock(dobj);
       dinf->SetDataClassName(dobj->GetClassName());
       dinf->DataSetType = dobj->GetDataObjectType();
       this->AddInformation(dinf, /*addingParts=*/ 1);
@@ -328,6 +338,49 @@ void vtkPVDataInformation::AddFromMultiPieceDataSet(vtkCompositeDataSet* data)
   iter->Delete();
 }
 
+//----------------------------------------------------------------------------
+void vtkPVDataInformation::CopyFromBlock(vtkDataObject* block)
+{
+  if (block->IsA("vtkCompositeDataSet"))
+    {
+    // Nested composite datasets are cheap to walk; their leaves are cached
+    // individually.
+    this->CopyFromObject(block);
+    return;
+    }
+
+  // The serialized information is kept in the block's own information, so
+  // it goes away with the block. It is up to date as long as neither the
+  // block nor its information were modified after it was stored.
+  vtkInformation* blockInfo = block->GetInformation();
+  vtkUnsignedCharArray* cached = vtkUnsignedCharArray::SafeDownCast(
+    blockInfo->Get(vtkPVDataInformation::BLOCK_INFORMATION()));
+  if (cached && block->GetMTime() <= cached->GetMTime() &&
+    blockInfo->GetMTime() <= cached->GetMTime())
+    {
+    vtkClientServerStream stream;
+    stream.SetData(cached->GetPointer(0),
+      static_cast<size_t>(cached->GetNumberOfTuples()));
+    this->CopyFromStream(&stream);
+    return;
+    }
+
+  this->CopyFromObject(block);
+
+  vtkClientServerStream stream;
+  this->CopyToStream(&stream);
+  const unsigned char* data;
+  size_t length;
+  stream.GetData(&data, &length);
+  vtkUnsignedCharArray* serialized = vtkUnsignedCharArray::New();
+  serialized->SetNumberOfTuples(static_cast<vtkIdType>(length));
+  memcpy(serialized->GetPointer(0), data, length);
+  blockInfo->Set(vtkPVDataInformation::BLOCK_INFORMATION(), serialized);
+  // storing it modified the block's information, stamp it afterwards.
+  serialized->Modified();
+  serialized->Delete();
+}
+
 //----------------------------------------------------------------------------
 void vtkPVDataInformation::CopyFromCompositeDataSetInitialize(
   vtkCompositeDataSet* data)
@@ -754,8 +807,11 @@ void vtkPVDataInformation::AddInformation(
     this->SetCompositeDataClassName(info->GetCompositeDataClassName());
     this->SetCompositeDataSetName(info->GetCompositeDataSetName());
     this->CompositeDataSetType = info->CompositeDataSetType;
-    this->CompositeDataInformation->AddInformation(
-      info->CompositeDataInformation);
+    if (!this->SkipCompositeDataInformation)
+      {
+      this->CompositeDataInformation->AddInformation(
+        info->CompositeDataInformation);
+      }
     }
 
   if (info->NumberOfDataSets == 0)
@@ -1160,7 +1216,11 @@ void vtkPVDataInformation::CopyToStream(vtkClientServerStream* css)
 
   dcss.Reset();
 
-  this->CompositeDataInformation->CopyToStream(&dcss);
+  // An empty stream is read back as no composite data information.
+  if (!this->SkipCompositeDataInformation)
+    {
+    this->CompositeDataInformation->CopyToStream(&dcss);
+    }
   dcss.GetData(&data, &length);
   *css << vtkClientServerStream::InsertArray(data, static_cast<int>(length));
 
@@ -37,6 +37,7 @@ class vtkDataSet;
 class vtkGenericDataSet;
 class vtkGraph;
 class vtkInformation;
+class vtkInformationObjectBaseKey;
 class vtkPVArrayInformation;
 class vtkPVCompositeDataInformation;
 class vtkPVDataSetAttributesInformation;
@@ -69,10 +70,28 @@ public:
   vtkSetMacro(PortNumber, int);
   vtkGetMacro(PortNumber, int);
 
+  // Description:
+  // When set, only the summary of the data (types, counts, bounds, memory,
+  // arrays, time) is gathered: the per-block vtkPVCompositeDataInformation is
+  // neither serialized nor merged across processes, which makes gathering
+  // information for composite datasets with many blocks much cheaper.
+  // Like PortNumber, this can be set on the client-side before gathering the
+  // information. Off by default.
+  vtkSetMacro(SkipCompositeDataInformation, bool);
+  vtkGetMacro(SkipCompositeDataInformation, bool);
+  vtkBooleanMacro(SkipCompositeDataInformation, bool);
+
   // Description:
   // Transfer information about a single object into this object.
   virtual void CopyFromObject(vtkObject*);
 
+  // Description:
+  // Key under which the information of the blocks of composite datasets is
+  // kept, serialized, in each block's own vtkInformation. It is reused by
+  // later calls to CopyFromObject() as long as neither the block nor its
+  // information is modified.
+  static vtkInformationObjectBaseKey* BLOCK_INFORMATION();
+
   // Description:
   // Merge another information object. Calls AddInformation(info, 0).
   virtual void AddInformation(vtkPVInformation* info);
@@ -228,6 +247,13 @@ protected:
   void CopyFromSelection(vtkSelection* selection);
   void CopyCommonMetaData(vtkDataObject*, vtkInformation*);
 
+  // Description:
+  // Same as CopyFromObject() but, for a non-composite \c block, reuses the
+  // information computed by an earlier call if the block has not been
+  // modified since. This is used for the blocks of composite datasets so that
+  // re-gathering the information only recomputes the blocks that changed.
+  void CopyFromBlock(vtkDataObject* block);
+
   static vtkPVDataInformationHelper *FindHelper(const char *classname);
 
   // Data information collected from remote processes.
@@ -276,6 +302,7 @@ private:
 
   int PortNumber;
   bool SortArrays;
+  bool SkipCompositeDataInformation;
 };
 
 #endif
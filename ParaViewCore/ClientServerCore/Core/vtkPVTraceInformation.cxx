@@ -0,0 +1,363 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVTraceInformation.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVTraceInformation.h"
+
+#include "vtkClientServerStream.h"
+#include "vtkMultiProcessStream.h"
+#include "vtkObjectFactory.h"
+#include "vtkProcessModule.h"
+#include "vtkPVTraceRecorder.h"
+
+#include <vtksys/ios/fstream>
+#include <vtksys/ios/sstream>
+
+#include <map>
+#include <stdio.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+class vtkPVTraceInformation::vtkInternals
+{
+public:
+  class vtkRecord : public vtkPVTraceRecorder::Event
+    {
+  public:
+    int Rank;
+    int ProcessType;
+    };
+
+  std::vector<vtkRecord> Records;
+  std::string ChromeTrace;
+
+  static void WriteString(ostream& os, const std::string& str)
+    {
+    os << '"';
+    for (size_t cc=0; cc < str.size(); cc++)
+      {
+      unsigned char ch = static_cast<unsigned char>(str[cc]);
+      switch (ch)
+        {
+      case '"':
+        os << "\\\"";
+        break;
+      case '\\':
+        os << "\\\\";
+        break;
+      case '\n':
+        os << "\\n";
+        break;
+      case '\t':
+        os << "\\t";
+        break;
+      default:
+        if (ch < 0x20)
+          {
+          char buffer[8];
+          sprintf(buffer, "\\u%04x", static_cast<int>(ch));
+          os << buffer;
+          }
+        else
+          {
+          os << str[cc];
+          }
+        }
+      }
+    os << '"';
+    }
+
+  static const char* GetProcessTypeName(int type)
+    {
+    switch (type)
+      {
+    case vtkProcessModule::PROCESS_CLIENT:
+      return "client";
+    case vtkProcessModule::PROCESS_SERVER:
+      return "server";
+    case vtkProcessModule::PROCESS_DATA_SERVER:
+      return "data server";
+    case vtkProcessModule::PROCESS_RENDER_SERVER:
+      return "render server";
+    case vtkProcessModule::PROCESS_BATCH:
+    case vtkProcessModule::PROCESS_SYMMETRIC_BATCH:
+      return "batch";
+    default:
+      return "process";
+      }
+    }
+
+  void WriteChromeTrace(ostream& os)
+    {
+    double start = 0.0;
+    for (size_t cc=0; cc < this->Records.size(); cc++)
+      {
+      if (cc == 0 || this->Records[cc].Time < start)
+        {
+        start = this->Records[cc].Time;
+        }
+      }
+
+    // every (process type, rank) pair gets its own pid on the timeline.
+    typedef std::map<std::pair<int, int>, int> PidsType;
+    PidsType pids;
+    for (size_t cc=0; cc < this->Records.size(); cc++)
+      {
+      std::pair<int, int> key(this->Records[cc].ProcessType,
+        this->Records[cc].Rank);
+      if (pids.find(key) == pids.end())
+        {
+        int pid = static_cast<int>(pids.size());
+        pids[key] = pid;
+        }
+      }
+
+    os << "{\"traceEvents\":[";
+    bool first = true;
+    for (PidsType::iterator iter = pids.begin(); iter != pids.end(); ++iter)
+      {
+      vtksys_ios::ostringstream name;
+      name << GetProcessTypeName(iter->first.first) << " "
+           << iter->first.second;
+      os << (first? "\n" : ",\n")
+         << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":"
+         << iter->second << ",\"args\":{\"name\":";
+      WriteString(os, name.str());
+      os << "}}";
+      os << ",\n{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":"
+         << iter->second << ",\"args\":{\"sort_index\":" << iter->second
+         << "}}";
+      first = false;
+      }
+
+    for (size_t cc=0; cc < this->Records.size(); cc++)
+      {
+      const vtkRecord& record = this->Records[cc];
+      std::pair<int, int> key(record.ProcessType, record.Rank);
+      os << (first? "\n" : ",\n") << "{\"name\":";
+      WriteString(os, record.Name);
+      os << ",\"cat\":\"paraview\",\"ph\":\"X\",\"ts\":"
+         << static_cast<vtkTypeInt64>((record.Time - start) * 1.0e6)
+         << ",\"dur\":" << static_cast<vtkTypeInt64>(record.Duration * 1.0e6)
+         << ",\"pid\":" << pids[key]
+         << ",\"tid\":" << record.Thread
+         << ",\"args\":{\"rank\":" << record.Rank;
+      if (!record.Object.empty())
+        {
+        os << ",\"object\":";
+        WriteString(os, record.Object);
+        }
+      os << ",\"bytes\":" << record.Bytes << "}}";
+      first = false;
+      }
+    os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+};
+
+vtkStandardNewMacro(vtkPVTraceInformation);
+//----------------------------------------------------------------------------
+vtkPVTraceInformation::vtkPVTraceInformation()
+{
+  this->ClearRecorder = false;
+  this->Internals = new vtkInternals();
+}
+
+//----------------------------------------------------------------------------
+vtkPVTraceInformation::~vtkPVTraceInformation()
+{
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTraceInformation::CopyParametersToStream(vtkMultiProcessStream& str)
+{
+  str << 828794 << (this->ClearRecorder? 1 : 0);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTraceInformation::CopyParametersFromStream(vtkMultiProcessStream& str)
+{
+  int magic_number, clear;
+  str >> magic_number >> clear;
+  if (magic_number != 828794)
+    {
+    vtkErrorMacro("Magic number mismatch.");
+    }
+  this->ClearRecorder = (clear != 0);
+}
+
+//----------------------------------------------------------------------------
+// This ignores the object, and gets the events from the recorder.
+void vtkPVTraceInformation::CopyFromObject(vtkObject*)
+{
+  std::vector<vtkPVTraceRecorder::Event> events;
+  vtkPVTraceRecorder::GetEvents(events);
+  if (this->ClearRecorder)
+    {
+    vtkPVTraceRecorder::ClearEvents();
+    }
+
+  vtkProcessModule* pm = vtkProcessModule::GetProcessModule();
+  int rank = pm? pm->GetPartitionId() : 0;
+  int type = static_cast<int>(vtkProcessModule::GetProcessType());
+  double offset = vtkPVTraceRecorder::GetClockOffset();
+
+  this->Internals->Records.reserve(
+    this->Internals->Records.size() + events.size());
+  for (size_t cc=0; cc < events.size(); cc++)
+    {
+    vtkInternals::vtkRecord record;
+    static_cast<vtkPVTraceRecorder::Event&>(record) = events[cc];
+    record.Time += offset;
+    record.Rank = rank;
+    record.ProcessType = type;
+    this->Internals->Records.push_back(record);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTraceInformation::AddInformation(vtkPVInformation* info)
+{
+  vtkPVTraceInformation* other = vtkPVTraceInformation::SafeDownCast(info);
+  if (other && other != this)
+    {
+    this->Internals->Records.insert(this->Internals->Records.end(),
+      other->Internals->Records.begin(), other->Internals->Records.end());
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTraceInformation::CopyToStream(vtkClientServerStream* css)
+{
+  css->Reset();
+  *css << vtkClientServerStream::Reply
+       << static_cast<int>(this->Internals->Records.size());
+  for (size_t cc=0; cc < this->Internals->Records.size(); cc++)
+    {
+    const vtkInternals::vtkRecord& record = this->Internals->Records[cc];
+    *css << record.Rank
+         << record.ProcessType
+         << record.Thread
+         << record.Time
+         << record.Duration
+         << record.Bytes
+         << record.Name.c_str()
+         << record.Object.c_str();
+    }
+  *css << vtkClientServerStream::End;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTraceInformation::CopyFromStream(const vtkClientServerStream* css)
+{
+  this->Internals->Records.clear();
+
+  int numEvents;
+  if (!css->GetArgument(0, 0, &numEvents))
+    {
+    vtkErrorMacro("Error parsing number of events from message.");
+    return;
+    }
+
+  this->Internals->Records.resize(numEvents);
+  int arg = 1;
+  for (int cc=0; cc < numEvents; cc++)
+    {
+    vtkInternals::vtkRecord& record = this->Internals->Records[cc];
+    const char* name = NULL;
+    const char* object = NULL;
+    if (!css->GetArgument(0, arg++, &record.Rank) ||
+      !css->GetArgument(0, arg++, &record.ProcessType) ||
+      !css->GetArgument(0, arg++, &record.Thread) ||
+      !css->GetArgument(0, arg++, &record.Time) ||
+      !css->GetArgument(0, arg++, &record.Duration) ||
+      !css->GetArgument(0, arg++, &record.Bytes) ||
+      !css->GetArgument(0, arg++, &name) ||
+      !css->GetArgument(0, arg++, &object))
+      {
+      vtkErrorMacro("Error parsing event " << cc << " from message.");
+      this->Internals->Records.resize(cc);
+      return;
+      }
+    record.Name = name? name : "";
+    record.Object = object? object : "";
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkPVTraceInformation::GetNumberOfEvents()
+{
+  return static_cast<int>(this->Internals->Records.size());
+}
+
+#define vtkPVTraceInformationGetEventMacro(type, method, expr, defaultValue) \
+  type vtkPVTraceInformation::method(int idx)                                 \
+    {                                                                         \
+    if (idx < 0 || idx >= this->GetNumberOfEvents())                          \
+      {                                                                       \
+      return defaultValue;                                                    \
+      }                                                                       \
+    const vtkInternals::vtkRecord& record = this->Internals->Records[idx];    \
+    return expr;                                                              \
+    }
+
+//----------------------------------------------------------------------------
+vtkPVTraceInformationGetEventMacro(const char*, GetEventName,
+  record.Name.c_str(), NULL)
+vtkPVTraceInformationGetEventMacro(const char*, GetEventObject,
+  record.Object.c_str(), NULL)
+vtkPVTraceInformationGetEventMacro(double, GetEventTime, record.Time, 0.0)
+vtkPVTraceInformationGetEventMacro(double, GetEventDuration,
+  record.Duration, 0.0)
+vtkPVTraceInformationGetEventMacro(int, GetEventThread, record.Thread, -1)
+vtkPVTraceInformationGetEventMacro(int, GetEventRank, record.Rank, -1)
+vtkPVTraceInformationGetEventMacro(int, GetEventProcessType,
+  record.ProcessType, -1)
+vtkPVTraceInformationGetEventMacro(vtkTypeInt64, GetEventBytes, record.Bytes, 0)
+
+//----------------------------------------------------------------------------
+const char* vtkPVTraceInformation::GetChromeTrace()
+{
+  vtksys_ios::ostringstream str;
+  this->Internals->WriteChromeTrace(str);
+  this->Internals->ChromeTrace = str.str();
+  return this->Internals->ChromeTrace.c_str();
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVTraceInformation::WriteChromeTrace(const char* filename)
+{
+  if (!filename || !filename[0])
+    {
+    vtkErrorMacro("No filename specified.");
+    return false;
+    }
+
+  vtksys_ios::ofstream file(filename);
+  if (!file)
+    {
+    vtkErrorMacro("Failed to open file for writing: " << filename);
+    return false;
+    }
+  this->Internals->WriteChromeTrace(file);
+  return !file.fail();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTraceInformation::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "ClearRecorder: " << this->ClearRecorder << endl;
+  os << indent << "NumberOfEvents: " << this->GetNumberOfEvents() << endl;
+}
@@ -0,0 +1,113 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVTraceInformation.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVTraceInformation - gathers vtkPVTraceRecorder events from all
+// processes.
+// .SECTION Description
+// vtkPVTraceInformation collects the events recorded by vtkPVTraceRecorder on
+// each process, tagged with the process type and rank, so that they can be
+// merged on the client. Unlike vtkPVTimerInformation, the events are kept
+// structured and can be exported as a Chrome trace (JSON) timeline, which can
+// be loaded in chrome://tracing or Perfetto to compare ranks and stages side
+// by side. Event times are corrected with vtkPVTraceRecorder::GetClockOffset()
+// so that all ranks of a server share the clock of its root. Client and
+// server clocks are not synchronized.
+//
+// Events from the local process can be added with CopyFromObject(NULL);
+// several gathered objects (e.g. client and servers) can be merged with
+// AddInformation().
+// .SECTION See Also
+// vtkPVTraceRecorder vtkPVTimerInformation
+
+#ifndef __vtkPVTraceInformation_h
+#define __vtkPVTraceInformation_h
+
+#include "vtkPVClientServerCoreCoreModule.h" //needed for exports
+#include "vtkPVInformation.h"
+
+class VTKPVCLIENTSERVERCORECORE_EXPORT vtkPVTraceInformation : public vtkPVInformation
+{
+public:
+  static vtkPVTraceInformation* New();
+  vtkTypeMacro(vtkPVTraceInformation, vtkPVInformation);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // When set, the recorder on each process is cleared once its events have
+  // been gathered, so that the next gather only returns new events. This must
+  // be set before calling GatherInformation(). Off by default.
+  vtkSetMacro(ClearRecorder, bool);
+  vtkGetMacro(ClearRecorder, bool);
+  vtkBooleanMacro(ClearRecorder, bool);
+
+  // Description:
+  // Access to the gathered events. Each event is a complete span; its time is
+  // the start time, in seconds.
+  int GetNumberOfEvents();
+  const char* GetEventName(int idx);
+  const char* GetEventObject(int idx);
+  double GetEventTime(int idx);
+  double GetEventDuration(int idx);
+  int GetEventThread(int idx);
+  int GetEventRank(int idx);
+  int GetEventProcessType(int idx);
+  vtkTypeInt64 GetEventBytes(int idx);
+
+  // Description:
+  // Returns the events as a Chrome trace JSON document. Each process type and
+  // rank is shown as a separate process on the timeline.
+  const char* GetChromeTrace();
+
+  // Description:
+  // Write the Chrome trace JSON document to a file. Returns false on error.
+  bool WriteChromeTrace(const char* filename);
+
+  // Description:
+  // Transfer information about a single object into this object. This
+  // ignores the object and copies the events recorded on this process.
+  virtual void CopyFromObject(vtkObject*);
+
+  // Description:
+  // Merge another information object.
+  virtual void AddInformation(vtkPVInformation*);
+
+  //BTX
+  // Description:
+  // Manage a serialized version of the information.
+  virtual void CopyToStream(vtkClientServerStream*);
+  virtual void CopyFromStream(const vtkClientServerStream*);
+
+  // Description:
+  // Serialize/Deserialize the parameters that control how/what information is
+  // gathered. This are different from the ivars that constitute the gathered
+  // information itself.
+  virtual void CopyParametersToStream(vtkMultiProcessStream&);
+  virtual void CopyParametersFromStream(vtkMultiProcessStream&);
+  //ETX
+
+protected:
+  vtkPVTraceInformation();
+  ~vtkPVTraceInformation();
+
+  bool ClearRecorder;
+
+private:
+  vtkPVTraceInformation(const vtkPVTraceInformation&); // Not implemented
+  void operator=(const vtkPVTraceInformation&); // Not implemented
+
+  class vtkInternals;
+  vtkInternals* Internals;
+};
+
+#endif
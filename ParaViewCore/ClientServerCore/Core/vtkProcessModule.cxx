@@ -28,6 +28,7 @@
 #include "vtkPVConfig.h"
 #include "vtkPVConfig.h"
 #include "vtkPVOptions.h"
+#include "vtkPVTraceRecorder.h"
 #include "vtkSessionIterator.h"
 #include "vtkStdString.h"
 #include "vtkTCPNetworkAccessManager.h"
@@ -186,6 +187,9 @@ bool vtkProcessModule::Initialize(ProcessTypes type, int &argc, char** &argv)
   vtkMultiProcessController::SetGlobalController(
     vtkProcessModule::GlobalController);
 
+  // so that trace events from all ranks line up on a single timeline.
+  vtkPVTraceRecorder::SynchronizeClocks(vtkProcessModule::GlobalController);
+
   // Hack to support -display parameter.  vtkPVOptions requires parameters to be
   // specified as -option=value, but it is generally expected that X window
   // programs allow you to set the display as -display host:port (i.e. without
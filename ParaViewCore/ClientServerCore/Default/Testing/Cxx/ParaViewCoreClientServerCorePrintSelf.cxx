@@ -69,6 +69,7 @@
 #include "vtkPVSynchronizedRenderer.h"
 #include "vtkPVTemporalDataInformation.h"
 #include "vtkPVTimerInformation.h"
+#include "vtkPVTraceInformation.h"
 #include "vtkPVView.h"
 #include "vtkPVXYChartView.h"
 #include "vtkProcessModule.h"
@@ -79,6 +80,7 @@
 #include "vtkSessionIterator.h"
 #include "vtkSpreadSheetRepresentation.h"
 #include "vtkSpreadSheetView.h"
+#include "vtkStreamingGeometryRepresentation.h"
 #include "vtkTCPNetworkAccessManager.h"
 #include "vtkTextSourceRepresentation.h"
 #include "vtkUnstructuredGridVolumeRepresentation.h"
@@ -173,6 +175,7 @@ int ParaViewCoreClientServerCorePrintSelf(int, char*[])
   //PRINT_SELF(vtkPVSynchronizedRenderer);
   PRINT_SELF(vtkPVTemporalDataInformation);
   PRINT_SELF(vtkPVTimerInformation);
+  PRINT_SELF(vtkPVTraceInformation);
   //PRINT_SELF(vtkPVView);
   //PRINT_SELF(vtkPVXYChartView);
   PRINT_SELF(vtkProcessModule);
@@ -183,6 +186,7 @@ int ParaViewCoreClientServerCorePrintSelf(int, char*[])
   PRINT_SELF(vtkSessionIterator);
   PRINT_SELF(vtkSpreadSheetRepresentation);
   //PRINT_SELF(vtkSpreadSheetView);
+  PRINT_SELF(vtkStreamingGeometryRepresentation);
   PRINT_SELF(vtkTCPNetworkAccessManager);
   PRINT_SELF(vtkTextSourceRepresentation);
   PRINT_SELF(vtkUnstructuredGridVolumeRepresentation);
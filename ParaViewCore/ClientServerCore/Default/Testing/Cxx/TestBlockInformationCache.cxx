@@ -0,0 +1,149 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestBlockInformationCache.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkInformation.h"
+#include "vtkInformationObjectBaseKey.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPVCompositeDataInformation.h"
+#include "vtkPVDataInformation.h"
+#include "vtkSmartPointer.h"
+
+#include <iostream>
+
+namespace
+{
+  vtkSmartPointer<vtkPolyData> NewBlock(int numberOfPoints, double x)
+    {
+    vtkNew<vtkPoints> points;
+    for (int cc=0; cc < numberOfPoints; cc++)
+      {
+      points->InsertNextPoint(x, cc, 0);
+      }
+    vtkSmartPointer<vtkPolyData> block = vtkSmartPointer<vtkPolyData>::New();
+    block->SetPoints(points.GetPointer());
+    return block;
+    }
+
+  vtkPVDataInformation* GetBlockInformation(vtkPVDataInformation* info,
+    unsigned int index)
+    {
+    return info->GetCompositeDataInformation()->GetDataInformation(index);
+    }
+
+  bool Check(vtkMultiBlockDataSet* data, unsigned int index,
+    vtkTypeInt64 numberOfPoints, double xmax, const char* step)
+    {
+    vtkNew<vtkPVDataInformation> info;
+    info->CopyFromObject(data);
+    vtkPVDataInformation* blockInfo =
+      GetBlockInformation(info.GetPointer(), index);
+    if (!blockInfo || blockInfo->GetNumberOfPoints() != numberOfPoints ||
+      blockInfo->GetBounds()[1] != xmax)
+      {
+      std::cerr << "ERROR: " << step << ": block " << index << " has "
+                << (blockInfo? blockInfo->GetNumberOfPoints() : -1)
+                << " points up to x = "
+                << (blockInfo? blockInfo->GetBounds()[1] : 0)
+                << ", expected " << numberOfPoints << " up to x = " << xmax
+                << "." << std::endl;
+      return false;
+      }
+    return true;
+    }
+}
+
+// Checks that the information of composite blocks, kept in each block's
+// information, is reused while the blocks are unchanged, and recomputed when
+// a block or its information is modified or when a block is replaced.
+int TestBlockInformationCache(int, char* [])
+{
+  vtkNew<vtkMultiBlockDataSet> data;
+  data->SetNumberOfBlocks(2);
+  data->SetBlock(0, NewBlock(10, 1));
+  data->SetBlock(1, NewBlock(20, 2));
+  if (!Check(data.GetPointer(), 0, 10, 1, "first gather") ||
+    !Check(data.GetPointer(), 1, 20, 2, "first gather"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // the information of an unmodified block is reused...
+  vtkPolyData* block = vtkPolyData::SafeDownCast(data->GetBlock(0));
+  vtkSmartPointer<vtkObjectBase> cached =
+    block->GetInformation()->Get(vtkPVDataInformation::BLOCK_INFORMATION());
+  if (!cached || !Check(data.GetPointer(), 0, 10, 1, "unmodified block") ||
+    block->GetInformation()->Get(vtkPVDataInformation::BLOCK_INFORMATION()) !=
+    cached)
+    {
+    std::cerr << "ERROR: The information of an unmodified block was not "
+              << "reused." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // ... until the block is modified.
+  block->GetPoints()->SetPoint(0, 5, 0, 0);
+  block->GetPoints()->Modified();
+  if (!Check(data.GetPointer(), 0, 10, 5, "modified block"))
+    {
+    return EXIT_FAILURE;
+    }
+  if (block->GetInformation()->Get(vtkPVDataInformation::BLOCK_INFORMATION()) ==
+    cached)
+    {
+    std::cerr << "ERROR: The information of a modified block was reused."
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // changes to the block's information are picked up too.
+  block->GetInformation()->Set(vtkDataObject::DATA_TIME_STEP(), 3.5);
+  vtkNew<vtkPVDataInformation> info;
+  info->CopyFromObject(data.GetPointer());
+  vtkPVDataInformation* blockInfo = GetBlockInformation(info.GetPointer(), 0);
+  if (!blockInfo || !blockInfo->GetHasTime() || blockInfo->GetTime() != 3.5)
+    {
+    std::cerr << "ERROR: The time set on the block was not picked up."
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // a new block, even one that may reuse the memory of the block it
+  // replaces, gets its own information.
+  for (int cc=0; cc < 10; cc++)
+    {
+    data->SetBlock(1, NULL);
+    data->SetBlock(1, NewBlock(30 + cc, 2));
+    if (!Check(data.GetPointer(), 1, 30 + cc, 2, "replaced block"))
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  // a shallow copy does not share the information of the original.
+  vtkSmartPointer<vtkPolyData> copy = vtkSmartPointer<vtkPolyData>::New();
+  copy->ShallowCopy(data->GetBlock(1));
+  vtkNew<vtkPoints> points;
+  points->InsertNextPoint(7, 0, 0);
+  copy->SetPoints(points.GetPointer());
+  data->SetBlock(0, copy);
+  if (!Check(data.GetPointer(), 0, 1, 7, "shallow copy") ||
+    !Check(data.GetPointer(), 1, 39, 2, "shallow copied block"))
+    {
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
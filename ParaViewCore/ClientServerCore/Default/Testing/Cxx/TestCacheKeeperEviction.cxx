@@ -0,0 +1,181 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestCacheKeeperEviction.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCacheSizeKeeper.h"
+#include "vtkFloatArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkPVCacheKeeper.h"
+#include "vtkSmartPointer.h"
+#include "vtkTrivialProducer.h"
+
+#include <iostream>
+#include <set>
+
+namespace
+{
+  vtkSmartPointer<vtkPolyData> NewData(vtkIdType numberOfValues)
+    {
+    vtkNew<vtkFloatArray> values;
+    values->SetName("Values");
+    values->SetNumberOfTuples(numberOfValues);
+    values->FillComponent(0, 1);
+    vtkSmartPointer<vtkPolyData> data = vtkSmartPointer<vtkPolyData>::New();
+    data->GetFieldData()->AddArray(values.GetPointer());
+    return data;
+    }
+
+  // Caches \c time, then releases cached data until the cache fits in its
+  // limit, as vtkPVView::Update() does.
+  void Cache(vtkPVCacheKeeper* cacher, double time)
+    {
+    cacher->SetCacheTime(time);
+    cacher->Update();
+    vtkCacheSizeKeeper* keeper = vtkCacheSizeKeeper::GetInstance();
+    while (keeper->GetEvictionPolicy() != vtkCacheSizeKeeper::NO_EVICTION &&
+      keeper->GetCacheSize() > keeper->GetCacheLimit() &&
+      vtkPVCacheKeeper::HasCachedData(keeper))
+      {
+      vtkPVCacheKeeper::ReleaseCachedData(keeper);
+      }
+    }
+
+  // Checks that, out of all the times cached so far, exactly \c expected are
+  // still cached.
+  bool CheckCached(vtkPVCacheKeeper* cacher, const std::set<double>& times,
+    const double* expected, int numberOfExpected, const char* step)
+    {
+    std::set<double> expectedTimes(expected, expected + numberOfExpected);
+    std::set<double>::const_iterator iter;
+    for (iter = times.begin(); iter != times.end(); ++iter)
+      {
+      if (cacher->IsCached(*iter) != (expectedTimes.count(*iter) > 0))
+        {
+        std::cerr << "ERROR: " << step << ": time " << *iter << " is "
+                  << (cacher->IsCached(*iter)? "" : "not ") << "cached."
+                  << std::endl;
+        return false;
+        }
+      }
+    return true;
+    }
+}
+
+// Checks which time steps vtkPVCacheKeeper releases once the cache is full,
+// for each eviction policy.
+int TestCacheKeeperEviction(int, char* [])
+{
+  vtkCacheSizeKeeper* keeper = vtkCacheSizeKeeper::GetInstance();
+  vtkSmartPointer<vtkPolyData> small = NewData(10000);
+  vtkSmartPointer<vtkPolyData> large = NewData(20000);
+  const unsigned long smallSize = small->GetActualMemorySize();
+  if (large->GetActualMemorySize() <= smallSize ||
+    large->GetActualMemorySize() > 2 * smallSize)
+    {
+    std::cerr << "ERROR: Unexpected data sizes." << std::endl;
+    return EXIT_FAILURE;
+    }
+  // room for 3 small time steps.
+  keeper->SetCacheLimit(3 * smallSize);
+
+  vtkNew<vtkTrivialProducer> producer;
+  producer->SetOutput(small);
+  vtkNew<vtkPVCacheKeeper> cacher;
+  cacher->SetInputConnection(producer->GetOutputPort());
+  std::set<double> times;
+
+  // with the default policy, forward playback keeps the last time steps...
+  if (keeper->GetEvictionPolicy() !=
+    vtkCacheSizeKeeper::FARTHEST_FROM_CACHE_TIME)
+    {
+    std::cerr << "ERROR: Unexpected default eviction policy." << std::endl;
+    return EXIT_FAILURE;
+    }
+  for (int cc=0; cc < 6; cc++)
+    {
+    Cache(cacher.GetPointer(), cc);
+    times.insert(cc);
+    }
+  const double forward[] = { 3, 4, 5 };
+  if (!CheckCached(cacher.GetPointer(), times, forward, 3, "forward") ||
+    keeper->GetCacheSize() != 3 * smallSize)
+    {
+    return EXIT_FAILURE;
+    }
+
+  // ... and time steps behind the cache time count twice as far as those
+  // ahead of it: 3 is released rather than 5.
+  Cache(cacher.GetPointer(), 3.8);
+  times.insert(3.8);
+  const double behind[] = { 3.8, 4, 5 };
+  if (!CheckCached(cacher.GetPointer(), times, behind, 3, "behind"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // data larger than the room freed by a single entry releases as many
+  // entries as needed, 3.8 and then 4.
+  producer->SetOutput(large);
+  Cache(cacher.GetPointer(), 4.5);
+  times.insert(4.5);
+  const double larger[] = { 4.5, 5 };
+  if (!CheckCached(cacher.GetPointer(), times, larger, 2, "larger") ||
+    keeper->GetCacheSize() != smallSize + large->GetActualMemorySize())
+    {
+    return EXIT_FAILURE;
+    }
+  producer->SetOutput(small);
+
+  // the least recently used entry is released, whatever its time: 1 was
+  // cached after 0 but not used since.
+  cacher->RemoveAllCaches();
+  times.clear();
+  if (keeper->GetCacheSize() != 0)
+    {
+    std::cerr << "ERROR: " << keeper->GetCacheSize()
+              << " KB still cached after removing all caches." << std::endl;
+    return EXIT_FAILURE;
+    }
+  keeper->SetEvictionPolicy(vtkCacheSizeKeeper::LEAST_RECENTLY_USED);
+  for (int cc=0; cc < 3; cc++)
+    {
+    Cache(cacher.GetPointer(), cc);
+    times.insert(cc);
+    }
+  Cache(cacher.GetPointer(), 0);
+  Cache(cacher.GetPointer(), 3);
+  times.insert(3);
+  const double recent[] = { 0, 2, 3 };
+  if (!CheckCached(cacher.GetPointer(), times, recent, 3, "least recently used"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // without eviction, a full cache does not cache anything new.
+  keeper->SetEvictionPolicy(vtkCacheSizeKeeper::NO_EVICTION);
+  keeper->SetCacheFull(1);
+  Cache(cacher.GetPointer(), 4);
+  times.insert(4);
+  keeper->SetCacheFull(0);
+  if (!CheckCached(cacher.GetPointer(), times, recent, 3, "no eviction") ||
+    keeper->GetCacheSize() != 3 * smallSize)
+    {
+    return EXIT_FAILURE;
+    }
+
+  cacher->RemoveAllCaches();
+  keeper->SetEvictionPolicy(vtkCacheSizeKeeper::FARTHEST_FROM_CACHE_TIME);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,194 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestImageDelta.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkNew.h"
+#include "vtkPVClientServerSynchronizedRenderers.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <iostream>
+#include <string.h>
+
+namespace
+{
+  // sizes that are not multiples of the tile size, to cover partial tiles.
+  const int WIDTH = 203;
+  const int HEIGHT = 117;
+  const int TILE_SIZE = 32;
+
+  void FillImage(vtkUnsignedCharArray* image, int numComps, int x0, int y0,
+    int size)
+    {
+    image->SetNumberOfComponents(numComps);
+    image->SetNumberOfTuples(WIDTH * HEIGHT);
+    unsigned char* ptr = image->GetPointer(0);
+    for (int y=0; y < HEIGHT; y++)
+      {
+      for (int x=0; x < WIDTH; x++, ptr += numComps)
+        {
+        // a gradient with a square at (x0, y0).
+        bool inSquare = (x >= x0 && x < x0 + size && y >= y0 && y < y0 + size);
+        for (int comp=0; comp < numComps; comp++)
+          {
+          ptr[comp] = inSquare? static_cast<unsigned char>(255 - comp) :
+            static_cast<unsigned char>((x + y * comp) & 0xff);
+          }
+        }
+      }
+    }
+
+  int CountDirtyTiles(vtkUnsignedCharArray* dirtyTiles)
+    {
+    int count = 0;
+    for (vtkIdType cc=0; cc < dirtyTiles->GetNumberOfTuples(); cc++)
+      {
+      for (int bit=0; bit < 8; bit++)
+        {
+        count += (dirtyTiles->GetValue(cc) >> bit) & 1;
+        }
+      }
+    return count;
+    }
+
+  // Encodes current as a delta against previous, decodes it and compares
+  // the result with current. Returns the number of dirty tiles, -1 on error.
+  int RoundTrip(vtkUnsignedCharArray* previous, vtkUnsignedCharArray* current)
+    {
+    vtkNew<vtkUnsignedCharArray> dirtyTiles;
+    vtkNew<vtkUnsignedCharArray> tileData;
+    if (!vtkPVClientServerSynchronizedRenderers::EncodeImageDelta(current,
+        previous, WIDTH, HEIGHT, TILE_SIZE, dirtyTiles.GetPointer(),
+        tileData.GetPointer()))
+      {
+      std::cerr << "ERROR: Failed to encode the delta." << std::endl;
+      return -1;
+      }
+    vtkNew<vtkUnsignedCharArray> result;
+    result->SetNumberOfComponents(current->GetNumberOfComponents());
+    if (!vtkPVClientServerSynchronizedRenderers::DecodeImageDelta(previous,
+        WIDTH, HEIGHT, TILE_SIZE, dirtyTiles.GetPointer(),
+        tileData.GetPointer(), result.GetPointer()))
+      {
+      std::cerr << "ERROR: Failed to decode the delta." << std::endl;
+      return -1;
+      }
+    if (result->GetNumberOfTuples() != current->GetNumberOfTuples() ||
+      memcmp(result->GetPointer(0), current->GetPointer(0),
+        current->GetNumberOfTuples() * current->GetNumberOfComponents()) != 0)
+      {
+      std::cerr << "ERROR: The decoded image does not match." << std::endl;
+      return -1;
+      }
+    return CountDirtyTiles(dirtyTiles.GetPointer());
+    }
+
+  bool TestComponents(int numComps)
+    {
+    vtkNew<vtkUnsignedCharArray> previous;
+    vtkNew<vtkUnsignedCharArray> current;
+    FillImage(previous.GetPointer(), numComps, 10, 10, 20);
+
+    // an unchanged image has no dirty tile.
+    FillImage(current.GetPointer(), numComps, 10, 10, 20);
+    if (RoundTrip(previous.GetPointer(), current.GetPointer()) != 0)
+      {
+      return false;
+      }
+
+    // the square moves within the first tile, and into the partial tiles
+    // of the last row and column.
+    FillImage(current.GetPointer(), numComps, 11, 10, 20);
+    if (RoundTrip(previous.GetPointer(), current.GetPointer()) != 1)
+      {
+      return false;
+      }
+    FillImage(current.GetPointer(), numComps, WIDTH - 8, HEIGHT - 8, 20);
+    if (RoundTrip(previous.GetPointer(), current.GetPointer()) != 2)
+      {
+      return false;
+      }
+    return true;
+    }
+}
+
+// Checks that images encoded as tile deltas against a previous image decode
+// back to the same image, and that deltas are refused when they cannot
+// apply.
+int TestImageDelta(int, char* [])
+{
+  if (!TestComponents(3) || !TestComponents(4))
+    {
+    return EXIT_FAILURE;
+    }
+
+  vtkNew<vtkUnsignedCharArray> previous;
+  vtkNew<vtkUnsignedCharArray> current;
+  vtkNew<vtkUnsignedCharArray> dirtyTiles;
+  vtkNew<vtkUnsignedCharArray> tileData;
+  vtkNew<vtkUnsignedCharArray> result;
+
+  // a full image is needed when every tile changed...
+  FillImage(previous.GetPointer(), 4, 0, 0, 0);
+  FillImage(current.GetPointer(), 4, 0, 0, WIDTH);
+  if (vtkPVClientServerSynchronizedRenderers::EncodeImageDelta(
+      current.GetPointer(), previous.GetPointer(), WIDTH, HEIGHT, TILE_SIZE,
+      dirtyTiles.GetPointer(), tileData.GetPointer()))
+    {
+    std::cerr << "ERROR: Encoded a delta where every tile changed."
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // ... or when the previous image does not match.
+  FillImage(previous.GetPointer(), 3, 0, 0, 0);
+  if (vtkPVClientServerSynchronizedRenderers::EncodeImageDelta(
+      current.GetPointer(), previous.GetPointer(), WIDTH, HEIGHT, TILE_SIZE,
+      dirtyTiles.GetPointer(), tileData.GetPointer()))
+    {
+    std::cerr << "ERROR: Encoded a delta against a mismatched image."
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // a delta does not decode against a mismatched image, nor with missing
+  // tile data.
+  FillImage(previous.GetPointer(), 4, 0, 0, 0);
+  FillImage(current.GetPointer(), 4, 40, 40, 10);
+  if (!vtkPVClientServerSynchronizedRenderers::EncodeImageDelta(
+      current.GetPointer(), previous.GetPointer(), WIDTH, HEIGHT, TILE_SIZE,
+      dirtyTiles.GetPointer(), tileData.GetPointer()))
+    {
+    std::cerr << "ERROR: Failed to encode the delta." << std::endl;
+    return EXIT_FAILURE;
+    }
+  vtkNew<vtkUnsignedCharArray> mismatched;
+  FillImage(mismatched.GetPointer(), 3, 0, 0, 0);
+  result->SetNumberOfComponents(4);
+  if (vtkPVClientServerSynchronizedRenderers::DecodeImageDelta(
+      mismatched.GetPointer(), WIDTH, HEIGHT, TILE_SIZE,
+      dirtyTiles.GetPointer(), tileData.GetPointer(), result.GetPointer()))
+    {
+    std::cerr << "ERROR: Decoded a delta against a mismatched image."
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+  tileData->SetNumberOfTuples(tileData->GetNumberOfTuples() - 1);
+  if (vtkPVClientServerSynchronizedRenderers::DecodeImageDelta(
+      previous.GetPointer(), WIDTH, HEIGHT, TILE_SIZE,
+      dirtyTiles.GetPointer(), tileData.GetPointer(), result.GetPointer()))
+    {
+    std::cerr << "ERROR: Decoded a delta with missing tiles." << std::endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
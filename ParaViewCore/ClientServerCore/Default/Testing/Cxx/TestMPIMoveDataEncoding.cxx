@@ -0,0 +1,600 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestMPIMoveDataEncoding.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCharArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkIntArray.h"
+#include "vtkMPIMoveData.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkMultiPieceDataSet.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkStringArray.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnsignedShortArray.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <iostream>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+  // Exposes the marshaling used by vtkMPIMoveData to move data between
+  // processes.
+  class vtkTestMPIMoveData : public vtkMPIMoveData
+  {
+  public:
+    static vtkTestMPIMoveData* New();
+    vtkTypeMacro(vtkTestMPIMoveData, vtkMPIMoveData);
+
+    // Returns the buffer \c data is marshaled to.
+    std::vector<char> Marshal(vtkDataObject* data,
+      std::vector<vtkDataArray*>* detachedArrays=NULL)
+      {
+      this->ClearBuffer();
+      this->MarshalDataToBuffer(data, detachedArrays);
+      std::vector<char> buffer(this->Buffers,
+        this->Buffers + this->BufferTotalLength);
+      this->ClearBuffer();
+      return buffer;
+      }
+
+    // Reconstructs \c output from \c buffers, as gathered from several
+    // processes.
+    void Reconstruct(const std::vector<std::vector<char> >& buffers,
+      vtkDataObject* output)
+      {
+      this->ClearBuffer();
+      this->NumberOfBuffers = static_cast<int>(buffers.size());
+      this->BufferLengths = new vtkIdType[buffers.size()];
+      this->BufferOffsets = new vtkIdType[buffers.size()];
+      this->BufferTotalLength = 0;
+      for (size_t cc=0; cc < buffers.size(); cc++)
+        {
+        this->BufferOffsets[cc] = this->BufferTotalLength;
+        this->BufferLengths[cc] = static_cast<vtkIdType>(buffers[cc].size());
+        this->BufferTotalLength += this->BufferLengths[cc];
+        }
+      this->Buffers = new char[this->BufferTotalLength];
+      for (size_t cc=0; cc < buffers.size(); cc++)
+        {
+        memcpy(this->Buffers + this->BufferOffsets[cc], &buffers[cc][0],
+          buffers[cc].size());
+        }
+      this->ReconstructDataFromBuffer(output);
+      this->ClearBuffer();
+      }
+
+  protected:
+    vtkTestMPIMoveData() {}
+    ~vtkTestMPIMoveData() {}
+
+  private:
+    vtkTestMPIMoveData(const vtkTestMPIMoveData&);
+    void operator=(const vtkTestMPIMoveData&);
+  };
+  vtkStandardNewMacro(vtkTestMPIMoveData);
+
+  //---------------------------------------------------------------------------
+  vtkSmartPointer<vtkPoints> NewGridPoints(int nx, int ny, int nz)
+    {
+    vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+    for (int k=0; k < nz; k++)
+      {
+      for (int j=0; j < ny; j++)
+        {
+        for (int i=0; i < nx; i++)
+          {
+          points->InsertNextPoint(i, j + 0.25 * i, k - 0.5 * j);
+          }
+        }
+      }
+    return points;
+    }
+
+  // 3x3 points with every kind of polydata cell.
+  vtkSmartPointer<vtkPolyData> NewPolyData(double offset)
+    {
+    vtkSmartPointer<vtkPolyData> pd = vtkSmartPointer<vtkPolyData>::New();
+    pd->SetPoints(NewGridPoints(3, 3, 1));
+
+    vtkIdType vert0[1] = { 0 }, vert1[1] = { 8 };
+    vtkNew<vtkCellArray> verts;
+    verts->InsertNextCell(1, vert0);
+    verts->InsertNextCell(1, vert1);
+    pd->SetVerts(verts.GetPointer());
+    vtkIdType line[3] = { 0, 1, 2 };
+    vtkNew<vtkCellArray> lines;
+    lines->InsertNextCell(3, line);
+    pd->SetLines(lines.GetPointer());
+    vtkIdType quad[4] = { 0, 1, 4, 3 }, triangle[3] = { 4, 5, 8 };
+    vtkNew<vtkCellArray> polys;
+    polys->InsertNextCell(4, quad);
+    polys->InsertNextCell(3, triangle);
+    pd->SetPolys(polys.GetPointer());
+    vtkIdType strip[4] = { 3, 4, 6, 7 };
+    vtkNew<vtkCellArray> strips;
+    strips->InsertNextCell(4, strip);
+    pd->SetStrips(strips.GetPointer());
+
+    vtkNew<vtkFloatArray> normals;
+    normals->SetName("Normals");
+    normals->SetNumberOfComponents(3);
+    vtkNew<vtkIdTypeArray> ids;
+    ids->SetName("Ids");
+    for (vtkIdType cc=0; cc < pd->GetNumberOfPoints(); cc++)
+      {
+      normals->InsertNextTuple3(0, 0.6, 0.8 + offset);
+      ids->InsertNextValue(1000000 * cc + 7);
+      }
+    pd->GetPointData()->SetNormals(normals.GetPointer());
+    pd->GetPointData()->AddArray(ids.GetPointer());
+
+    vtkNew<vtkDoubleArray> density;
+    density->SetName("Density");
+    for (vtkIdType cc=0; cc < pd->GetNumberOfCells(); cc++)
+      {
+      density->InsertNextValue(offset + 1.0 / (cc + 3));
+      }
+    pd->GetCellData()->SetScalars(density.GetPointer());
+
+    vtkNew<vtkIntArray> step;
+    step->SetName("Step");
+    step->InsertNextValue(42);
+    pd->GetFieldData()->AddArray(step.GetPointer());
+    return pd;
+    }
+
+  // 3x2x2 points with two hexahedra and a tetrahedron.
+  vtkSmartPointer<vtkUnstructuredGrid> NewUnstructuredGrid()
+    {
+    vtkSmartPointer<vtkUnstructuredGrid> ug =
+      vtkSmartPointer<vtkUnstructuredGrid>::New();
+    ug->SetPoints(NewGridPoints(3, 2, 2));
+    ug->Allocate(3);
+    vtkIdType hex0[8] = { 0, 1, 4, 3, 6, 7, 10, 9 };
+    vtkIdType hex1[8] = { 1, 2, 5, 4, 7, 8, 11, 10 };
+    vtkIdType tetra[4] = { 0, 1, 3, 6 };
+    ug->InsertNextCell(VTK_HEXAHEDRON, 8, hex0);
+    ug->InsertNextCell(VTK_HEXAHEDRON, 8, hex1);
+    ug->InsertNextCell(VTK_TETRA, 4, tetra);
+
+    vtkNew<vtkUnsignedShortArray> temperature;
+    temperature->SetName("Temperature");
+    for (vtkIdType cc=0; cc < ug->GetNumberOfPoints(); cc++)
+      {
+      temperature->InsertNextValue(static_cast<unsigned short>(300 + cc));
+      }
+    ug->GetPointData()->SetScalars(temperature.GetPointer());
+    vtkNew<vtkCharArray> material;
+    material->SetName("Material");
+    material->InsertNextValue('a');
+    material->InsertNextValue('b');
+    material->InsertNextValue('c');
+    ug->GetCellData()->AddArray(material.GetPointer());
+    return ug;
+    }
+
+  // An image with an extent that does not start at 0.
+  vtkSmartPointer<vtkImageData> NewImageData()
+    {
+    vtkSmartPointer<vtkImageData> id = vtkSmartPointer<vtkImageData>::New();
+    id->SetExtent(2, 5, -1, 2, 0, 1);
+    id->SetOrigin(1, 2, 3);
+    id->SetSpacing(0.5, 1, 2);
+
+    vtkNew<vtkFloatArray> elevation;
+    elevation->SetName("Elevation");
+    for (vtkIdType cc=0; cc < id->GetNumberOfPoints(); cc++)
+      {
+      elevation->InsertNextValue(0.1f * cc);
+      }
+    id->GetPointData()->SetScalars(elevation.GetPointer());
+    vtkNew<vtkUnsignedCharArray> colors;
+    colors->SetName("Colors");
+    colors->SetNumberOfComponents(3);
+    for (vtkIdType cc=0; cc < id->GetNumberOfCells(); cc++)
+      {
+      colors->InsertNextTuple3(cc, 255 - cc, 128);
+      }
+    id->GetCellData()->AddArray(colors.GetPointer());
+    return id;
+    }
+
+  // Named blocks, empty blocks and a nested multipiece.
+  vtkSmartPointer<vtkMultiBlockDataSet> NewMultiBlock()
+    {
+    vtkNew<vtkMultiPieceDataSet> pieces;
+    pieces->SetNumberOfPieces(3);
+    pieces->SetPiece(0, NewUnstructuredGrid());
+    pieces->SetPiece(2, NewImageData());
+    pieces->GetMetaData(2u)->Set(vtkCompositeDataSet::NAME(), "Image");
+
+    vtkSmartPointer<vtkMultiBlockDataSet> mb =
+      vtkSmartPointer<vtkMultiBlockDataSet>::New();
+    mb->SetNumberOfBlocks(4);
+    mb->SetBlock(0, NewPolyData(0));
+    mb->GetMetaData(0u)->Set(vtkCompositeDataSet::NAME(), "Surface");
+    mb->SetBlock(2, pieces.GetPointer());
+    mb->SetBlock(3, NewImageData());
+
+    vtkNew<vtkDoubleArray> info;
+    info->SetName("Info");
+    info->InsertNextValue(3.25);
+    info->InsertNextValue(-1);
+    mb->GetFieldData()->AddArray(info.GetPointer());
+    return mb;
+    }
+
+  //---------------------------------------------------------------------------
+  bool CompareArrays(vtkAbstractArray* actual, vtkAbstractArray* expected)
+    {
+    if (!actual || actual->GetDataType() != expected->GetDataType() ||
+      actual->GetNumberOfComponents() != expected->GetNumberOfComponents() ||
+      actual->GetNumberOfTuples() != expected->GetNumberOfTuples())
+      {
+      std::cerr << "ERROR: Array \""
+                << (expected->GetName()? expected->GetName() : "")
+                << "\" is missing or differs in type or size." << std::endl;
+      return false;
+      }
+    vtkDataArray* actualData = vtkDataArray::SafeDownCast(actual);
+    vtkDataArray* expectedData = vtkDataArray::SafeDownCast(expected);
+    vtkIdType numValues = expected->GetNumberOfTuples() *
+      expected->GetNumberOfComponents();
+    if (actualData && expectedData && numValues > 0 &&
+      memcmp(actualData->GetVoidPointer(0), expectedData->GetVoidPointer(0),
+        numValues * expectedData->GetDataTypeSize()) != 0)
+      {
+      std::cerr << "ERROR: The values of array \"" << expected->GetName()
+                << "\" differ." << std::endl;
+      return false;
+      }
+    vtkStringArray* actualStrings = vtkStringArray::SafeDownCast(actual);
+    vtkStringArray* expectedStrings = vtkStringArray::SafeDownCast(expected);
+    for (vtkIdType cc=0; expectedStrings && cc < numValues; cc++)
+      {
+      if (actualStrings->GetValue(cc) != expectedStrings->GetValue(cc))
+        {
+        std::cerr << "ERROR: The values of array \"" << expected->GetName()
+                  << "\" differ." << std::endl;
+        return false;
+        }
+      }
+    return true;
+    }
+
+  bool CompareFieldData(vtkFieldData* actual, vtkFieldData* expected)
+    {
+    if (actual->GetNumberOfArrays() != expected->GetNumberOfArrays())
+      {
+      std::cerr << "ERROR: " << actual->GetNumberOfArrays()
+                << " arrays instead of " << expected->GetNumberOfArrays()
+                << "." << std::endl;
+      return false;
+      }
+    for (int cc=0; cc < expected->GetNumberOfArrays(); cc++)
+      {
+      vtkAbstractArray* array = expected->GetAbstractArray(cc);
+      if (!CompareArrays(actual->GetAbstractArray(array->GetName()), array))
+        {
+        return false;
+        }
+      }
+    vtkDataSetAttributes* actualAttributes =
+      vtkDataSetAttributes::SafeDownCast(actual);
+    vtkDataSetAttributes* expectedAttributes =
+      vtkDataSetAttributes::SafeDownCast(expected);
+    for (int cc=0; expectedAttributes &&
+      cc < vtkDataSetAttributes::NUM_ATTRIBUTES; cc++)
+      {
+      vtkAbstractArray* actualAttribute =
+        actualAttributes->GetAbstractAttribute(cc);
+      vtkAbstractArray* expectedAttribute =
+        expectedAttributes->GetAbstractAttribute(cc);
+      if ((actualAttribute == NULL) != (expectedAttribute == NULL) ||
+        (expectedAttribute &&
+         strcmp(actualAttribute->GetName(), expectedAttribute->GetName()) != 0))
+        {
+        std::cerr << "ERROR: Attribute "
+                  << vtkDataSetAttributes::GetAttributeTypeAsString(cc)
+                  << " differs." << std::endl;
+        return false;
+        }
+      }
+    return true;
+    }
+
+  bool CompareGeometry(vtkDataSet* actual, vtkDataSet* expected)
+    {
+    if (actual->GetNumberOfPoints() != expected->GetNumberOfPoints() ||
+      actual->GetNumberOfCells() != expected->GetNumberOfCells())
+      {
+      std::cerr << "ERROR: " << actual->GetNumberOfPoints() << " points and "
+                << actual->GetNumberOfCells() << " cells instead of "
+                << expected->GetNumberOfPoints() << " and "
+                << expected->GetNumberOfCells() << "." << std::endl;
+      return false;
+      }
+    vtkPointSet* actualPointSet = vtkPointSet::SafeDownCast(actual);
+    vtkPointSet* expectedPointSet = vtkPointSet::SafeDownCast(expected);
+    if (expectedPointSet && expectedPointSet->GetPoints() &&
+      (!actualPointSet || !CompareArrays(actualPointSet->GetPoints()->GetData(),
+        expectedPointSet->GetPoints()->GetData())))
+      {
+      std::cerr << "ERROR: The points differ." << std::endl;
+      return false;
+      }
+    vtkNew<vtkIdList> actualIds;
+    vtkNew<vtkIdList> expectedIds;
+    for (vtkIdType cc=0; cc < expected->GetNumberOfCells(); cc++)
+      {
+      actual->GetCellPoints(cc, actualIds.GetPointer());
+      expected->GetCellPoints(cc, expectedIds.GetPointer());
+      bool same = actual->GetCellType(cc) == expected->GetCellType(cc) &&
+        actualIds->GetNumberOfIds() == expectedIds->GetNumberOfIds();
+      for (vtkIdType id=0; same && id < expectedIds->GetNumberOfIds(); id++)
+        {
+        same = actualIds->GetId(id) == expectedIds->GetId(id);
+        }
+      if (!same)
+        {
+        std::cerr << "ERROR: Cell " << cc << " differs." << std::endl;
+        return false;
+        }
+      }
+    return true;
+    }
+
+  bool CompareDataObjects(vtkDataObject* actual, vtkDataObject* expected)
+    {
+    if ((actual == NULL) != (expected == NULL))
+      {
+      std::cerr << "ERROR: Empty and non-empty blocks mixed up." << std::endl;
+      return false;
+      }
+    if (expected == NULL)
+      {
+      return true;
+      }
+    if (actual->GetDataObjectType() != expected->GetDataObjectType())
+      {
+      std::cerr << "ERROR: Got a " << actual->GetClassName() << " instead of a "
+                << expected->GetClassName() << "." << std::endl;
+      return false;
+      }
+
+    vtkMultiBlockDataSet* actualBlocks =
+      vtkMultiBlockDataSet::SafeDownCast(actual);
+    vtkMultiBlockDataSet* expectedBlocks =
+      vtkMultiBlockDataSet::SafeDownCast(expected);
+    vtkMultiPieceDataSet* actualPieces =
+      vtkMultiPieceDataSet::SafeDownCast(actual);
+    vtkMultiPieceDataSet* expectedPieces =
+      vtkMultiPieceDataSet::SafeDownCast(expected);
+    if (expectedBlocks || expectedPieces)
+      {
+      unsigned int numBlocks = expectedBlocks?
+        expectedBlocks->GetNumberOfBlocks() :
+        expectedPieces->GetNumberOfPieces();
+      unsigned int actualNumBlocks = actualBlocks?
+        actualBlocks->GetNumberOfBlocks() : actualPieces->GetNumberOfPieces();
+      if (actualNumBlocks != numBlocks)
+        {
+        std::cerr << "ERROR: " << actualNumBlocks << " blocks instead of "
+                  << numBlocks << "." << std::endl;
+        return false;
+        }
+      for (unsigned int cc=0; cc < numBlocks; cc++)
+        {
+        bool hasName = expectedBlocks?
+          (expectedBlocks->HasMetaData(cc) != 0) :
+          (expectedPieces->HasMetaData(cc) != 0);
+        bool actualHasName = actualBlocks?
+          (actualBlocks->HasMetaData(cc) != 0) :
+          (actualPieces->HasMetaData(cc) != 0);
+        if (hasName != actualHasName || (hasName && strcmp(
+              (actualBlocks? actualBlocks->GetMetaData(cc) :
+               actualPieces->GetMetaData(cc))->Get(vtkCompositeDataSet::NAME()),
+              (expectedBlocks? expectedBlocks->GetMetaData(cc) :
+               expectedPieces->GetMetaData(cc))->Get(
+                 vtkCompositeDataSet::NAME())) != 0))
+          {
+          std::cerr << "ERROR: The name of block " << cc << " differs."
+                    << std::endl;
+          return false;
+          }
+        if (!CompareDataObjects(
+            actualBlocks? actualBlocks->GetBlock(cc) :
+            actualPieces->GetPieceAsDataObject(cc),
+            expectedBlocks? expectedBlocks->GetBlock(cc) :
+            expectedPieces->GetPieceAsDataObject(cc)))
+          {
+          return false;
+          }
+        }
+      return CompareFieldData(actual->GetFieldData(),
+        expected->GetFieldData());
+      }
+
+    vtkImageData* actualImage = vtkImageData::SafeDownCast(actual);
+    vtkImageData* expectedImage = vtkImageData::SafeDownCast(expected);
+    if (expectedImage)
+      {
+      int* actualExtent = actualImage->GetExtent();
+      int* expectedExtent = expectedImage->GetExtent();
+      for (int cc=0; cc < 6; cc++)
+        {
+        if (actualExtent[cc] != expectedExtent[cc] ||
+          (cc < 3 && (actualImage->GetOrigin()[cc] !=
+              expectedImage->GetOrigin()[cc] ||
+            actualImage->GetSpacing()[cc] != expectedImage->GetSpacing()[cc])))
+          {
+          std::cerr << "ERROR: The extent, origin or spacing of the image "
+                    << "differs." << std::endl;
+          return false;
+          }
+        }
+      }
+
+    vtkDataSet* actualDataSet = vtkDataSet::SafeDownCast(actual);
+    vtkDataSet* expectedDataSet = vtkDataSet::SafeDownCast(expected);
+    return CompareGeometry(actualDataSet, expectedDataSet) &&
+      CompareFieldData(actualDataSet->GetPointData(),
+        expectedDataSet->GetPointData()) &&
+      CompareFieldData(actualDataSet->GetCellData(),
+        expectedDataSet->GetCellData()) &&
+      CompareFieldData(actualDataSet->GetFieldData(),
+        expectedDataSet->GetFieldData());
+    }
+
+  //---------------------------------------------------------------------------
+  bool HasMarker(const std::vector<char>& buffer, const char* marker)
+    {
+    return buffer.size() >= 4 && strncmp(&buffer[0], marker, 4) == 0;
+    }
+
+  // Marshals \c data, checks the buffer starts with \c marker, reconstructs
+  // the data from it and compares the result with \c data.
+  bool RoundTrip(vtkTestMPIMoveData* mover, vtkDataObject* data,
+    const char* marker)
+    {
+    std::vector<std::vector<char> > buffers(1, mover->Marshal(data));
+    if (!HasMarker(buffers[0], marker))
+      {
+      std::cerr << "ERROR: A " << data->GetClassName()
+                << " was not marshaled as \"" << marker << "\"." << std::endl;
+      return false;
+      }
+    vtkSmartPointer<vtkDataObject> output;
+    output.TakeReference(data->NewInstance());
+    mover->Reconstruct(buffers, output);
+    if (!CompareDataObjects(output, data))
+      {
+      std::cerr << "ERROR: A " << data->GetClassName()
+                << " marshaled as \"" << marker
+                << "\" did not round trip." << std::endl;
+      return false;
+      }
+    return true;
+    }
+}
+
+// Checks that data marshaled by vtkMPIMoveData is reconstructed as it was
+// sent, with the raw array encoding, with zlib compression and with the
+// legacy writer used for the data the raw encoding does not support, and
+// that the raw encoding moves the array memory as is.
+int TestMPIMoveDataEncoding(int, char* [])
+{
+  vtkNew<vtkTestMPIMoveData> mover;
+  vtkSmartPointer<vtkDataObject> data[] = {
+    NewPolyData(0), NewUnstructuredGrid(), NewImageData(), NewMultiBlock() };
+  const int numData = sizeof(data) / sizeof(data[0]);
+  for (int cc=0; cc < numData; cc++)
+    {
+    if (!RoundTrip(mover.GetPointer(), data[cc], "vtkr"))
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  // buffers gathered from several processes are appended.
+  vtkSmartPointer<vtkPolyData> first = NewPolyData(0);
+  vtkSmartPointer<vtkPolyData> second = NewPolyData(1);
+  std::vector<std::vector<char> > buffers;
+  buffers.push_back(mover->Marshal(first));
+  buffers.push_back(mover->Marshal(second));
+  vtkNew<vtkPolyData> appended;
+  mover->Reconstruct(buffers, appended.GetPointer());
+  if (appended->GetNumberOfPoints() != 2 * first->GetNumberOfPoints() ||
+    appended->GetNumberOfCells() != 2 * first->GetNumberOfCells() ||
+    !appended->GetPointData()->GetNormals() ||
+    appended->GetPointData()->GetNormals()->GetComponent(
+      first->GetNumberOfPoints(), 2) !=
+    second->GetPointData()->GetNormals()->GetComponent(0, 2))
+    {
+    std::cerr << "ERROR: Gathered buffers were not appended." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // detached arrays are not copied to the buffer: the buffer holds the
+  // descriptor only, and the arrays are the ones of the data.
+  std::vector<vtkDataArray*> detached;
+  std::vector<char> descriptor = mover->Marshal(first, &detached);
+  std::vector<char> whole = mover->Marshal(first);
+  vtkIdType arrayBytes = 0;
+  bool hasPoints = false;
+  for (size_t cc=0; cc < detached.size(); cc++)
+    {
+    vtkIdType numBytes = detached[cc]->GetNumberOfTuples() *
+      detached[cc]->GetNumberOfComponents() * detached[cc]->GetDataTypeSize();
+    arrayBytes += (numBytes + 7) & ~static_cast<vtkIdType>(7);
+    hasPoints = hasPoints || detached[cc] == first->GetPoints()->GetData();
+    }
+  if (!HasMarker(descriptor, "vtkr") || (descriptor[4] & 0x1) == 0 ||
+    !hasPoints ||
+    static_cast<vtkIdType>(descriptor.size()) + arrayBytes !=
+    static_cast<vtkIdType>(whole.size()))
+    {
+    std::cerr << "ERROR: The arrays were not detached from the buffer."
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // raw buffers go through zlib compression as a whole.
+  vtkMPIMoveData::SetUseZLibCompression(true);
+  bool compressed = true;
+  for (int cc=0; cc < numData && compressed; cc++)
+    {
+    compressed = RoundTrip(mover.GetPointer(), data[cc], "zlib");
+    }
+  vtkMPIMoveData::SetUseZLibCompression(false);
+  if (!compressed)
+    {
+    return EXIT_FAILURE;
+    }
+
+  // string arrays are left to the legacy writer.
+  vtkSmartPointer<vtkPolyData> labeled = NewPolyData(0);
+  vtkNew<vtkStringArray> labels;
+  labels->SetName("Labels");
+  labels->InsertNextValue("first");
+  labels->InsertNextValue("second");
+  labeled->GetFieldData()->AddArray(labels.GetPointer());
+  buffers.assign(1, mover->Marshal(labeled));
+  vtkNew<vtkPolyData> legacy;
+  mover->Reconstruct(buffers, legacy.GetPointer());
+  if (HasMarker(buffers[0], "vtkr") ||
+    !CompareGeometry(legacy.GetPointer(), labeled) ||
+    !CompareArrays(legacy->GetFieldData()->GetAbstractArray("Labels"),
+      labels.GetPointer()))
+    {
+    std::cerr << "ERROR: Data with string arrays did not round trip."
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,115 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVArrayInformation.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkDoubleArray.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkNew.h"
+#include "vtkPVArrayInformation.h"
+
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+  // large enough for the ranges to be computed in parallel and cached in the
+  // array.
+  const vtkIdType NUMBER_OF_TUPLES = 300000;
+
+  bool CheckRange(vtkPVArrayInformation* info, int comp, double min,
+    double max)
+    {
+    double range[2];
+    info->GetComponentRange(comp, range);
+    if (range[0] != min || range[1] != max)
+      {
+      std::cerr << "ERROR: Range of component " << comp << " is ["
+                << range[0] << ", " << range[1] << "], expected [" << min
+                << ", " << max << "]." << std::endl;
+      return false;
+      }
+    return true;
+    }
+}
+
+// Checks that the ranges cached in an array are used while they are up to
+// date, and recomputed once the array is modified.
+int TestPVArrayInformation(int, char* [])
+{
+  vtkNew<vtkDoubleArray> array;
+  array->SetName("Values");
+  array->SetNumberOfComponents(2);
+  array->SetNumberOfTuples(NUMBER_OF_TUPLES);
+  for (vtkIdType cc = 0; cc < NUMBER_OF_TUPLES; cc++)
+    {
+    array->SetComponent(cc, 0, cc % 100);
+    array->SetComponent(cc, 1, -(cc % 50));
+    }
+  array->Modified();
+
+  vtkNew<vtkPVArrayInformation> info;
+  info->CopyFromObject(array.GetPointer());
+  if (!CheckRange(info.GetPointer(), 0, 0, 99) ||
+    !CheckRange(info.GetPointer(), 1, -49, 0) ||
+    !CheckRange(info.GetPointer(), -1, 0, std::sqrt(99.0 * 99.0 + 49.0 * 49.0)))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // an up to date cache is used as is.
+  vtkInformationVector* infoVec =
+    array->GetInformation()->Get(vtkDataArray::PER_COMPONENT());
+  if (!infoVec || infoVec->GetNumberOfInformationObjects() != 2)
+    {
+    std::cerr << "ERROR: The ranges were not cached in the array."
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+  double cached[2] = { -1, 1 };
+  infoVec->GetInformationObject(0)->Set(
+    vtkDataArray::COMPONENT_RANGE(), cached, 2);
+  info->CopyFromObject(array.GetPointer());
+  if (!CheckRange(info.GetPointer(), 0, -1, 1))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // once the array is modified, the ranges are computed again, whether
+  // they grow or shrink.
+  array->SetComponent(10, 0, 1000);
+  array->Modified();
+  info->CopyFromObject(array.GetPointer());
+  if (!CheckRange(info.GetPointer(), 0, 0, 1000) ||
+    !CheckRange(info.GetPointer(), -1, 0,
+      std::sqrt(1000.0 * 1000.0 + 10.0 * 10.0)))
+    {
+    return EXIT_FAILURE;
+    }
+
+  double* values = array->GetPointer(0);
+  for (vtkIdType cc = 0; cc < NUMBER_OF_TUPLES; cc++)
+    {
+    values[2 * cc] = 5;
+    values[2 * cc + 1] = 0;
+    }
+  array->Modified();
+  info->CopyFromObject(array.GetPointer());
+  if (!CheckRange(info.GetPointer(), 0, 5, 5) ||
+    !CheckRange(info.GetPointer(), 1, 0, 0) ||
+    !CheckRange(info.GetPointer(), -1, 5, 5))
+    {
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
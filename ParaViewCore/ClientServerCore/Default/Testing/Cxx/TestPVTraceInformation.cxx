@@ -0,0 +1,135 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVTraceInformation.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkClientServerStream.h"
+#include "vtkDummyController.h"
+#include "vtkNew.h"
+#include "vtkPVTraceInformation.h"
+#include "vtkPVTraceRecorder.h"
+
+#include <iostream>
+#include <string>
+
+namespace
+{
+  int CountOccurrences(const std::string& str, const std::string& pattern)
+    {
+    int count = 0;
+    for (size_t pos = str.find(pattern); pos != std::string::npos;
+      pos = str.find(pattern, pos + pattern.size()))
+      {
+      count++;
+      }
+    return count;
+    }
+}
+
+#define TEST_ASSERT(cond)                                                     \
+  if (!(cond))                                                                \
+    {                                                                         \
+    std::cerr << "ERROR: Failed at line " << __LINE__ << ": " #cond           \
+              << std::endl;                                                   \
+    return EXIT_FAILURE;                                                      \
+    }
+
+// Records nested spans in a buffer too small to keep all of them, and checks
+// that only complete spans are gathered and written to the Chrome trace.
+int TestPVTraceInformation(int, char*[])
+{
+  vtkNew<vtkDummyController> controller;
+  vtkPVTraceRecorder::SynchronizeClocks(controller.GetPointer());
+  TEST_ASSERT(vtkPVTraceRecorder::GetClockOffset() == 0.0);
+
+  // nothing is recorded while disabled.
+  vtkPVTraceRecorder::BeginSpan("Disabled");
+  vtkPVTraceRecorder::EndSpan("Disabled");
+  TEST_ASSERT(vtkPVTraceRecorder::GetNumberOfEvents() == 0);
+
+  vtkPVTraceRecorder::SetEnabled(true);
+  vtkPVTraceRecorder::SetMaxNumberOfEvents(3);
+
+  // an end without a begin is dropped.
+  vtkPVTraceRecorder::EndSpan("Orphan");
+  TEST_ASSERT(vtkPVTraceRecorder::GetNumberOfEvents() == 0);
+
+  vtkNew<vtkDummyController> obj;
+  vtkPVTraceRecorder::BeginSpan("Outer", obj.GetPointer());
+  for (int cc=0; cc < 5; cc++)
+    {
+    vtkPVTraceSpan span("Inner");
+    span.SetBytes(cc);
+    }
+  // a span still open when the events are gathered is not reported.
+  vtkPVTraceRecorder::BeginSpan("Open");
+  vtkPVTraceRecorder::EndSpan("Outer", obj.GetPointer(), 1024);
+  TEST_ASSERT(vtkPVTraceRecorder::GetNumberOfEvents() == 3);
+
+  vtkNew<vtkPVTraceInformation> info;
+  info->SetClearRecorder(true);
+  info->CopyFromObject(NULL);
+  TEST_ASSERT(vtkPVTraceRecorder::GetNumberOfEvents() == 0);
+
+  // the oldest inner spans were evicted as a whole.
+  TEST_ASSERT(info->GetNumberOfEvents() == 3);
+  TEST_ASSERT(std::string(info->GetEventName(0)) == "Inner");
+  TEST_ASSERT(info->GetEventBytes(0) == 3);
+  TEST_ASSERT(std::string(info->GetEventName(1)) == "Inner");
+  TEST_ASSERT(info->GetEventBytes(1) == 4);
+  TEST_ASSERT(std::string(info->GetEventName(2)) == "Outer");
+  TEST_ASSERT(info->GetEventBytes(2) == 1024);
+  TEST_ASSERT(std::string(info->GetEventObject(2)).find("vtkDummyController")
+    == 0);
+
+  // the outer span encloses the inner ones.
+  double outerStart = info->GetEventTime(2);
+  double outerEnd = outerStart + info->GetEventDuration(2);
+  for (int cc=0; cc < 2; cc++)
+    {
+    TEST_ASSERT(info->GetEventDuration(cc) >= 0.0);
+    TEST_ASSERT(info->GetEventTime(cc) >= outerStart);
+    TEST_ASSERT(info->GetEventTime(cc) + info->GetEventDuration(cc) <=
+      outerEnd);
+    }
+
+  // the open span is reported once it ends.
+  vtkPVTraceRecorder::EndSpan("Open");
+  TEST_ASSERT(vtkPVTraceRecorder::GetNumberOfEvents() == 1);
+  vtkPVTraceRecorder::SetEnabled(false);
+  vtkPVTraceRecorder::ClearEvents();
+
+  // round trip through the stream used to gather from the servers.
+  vtkClientServerStream stream;
+  info->CopyToStream(&stream);
+  vtkNew<vtkPVTraceInformation> copy;
+  copy->CopyFromStream(&stream);
+  TEST_ASSERT(copy->GetNumberOfEvents() == 3);
+  for (int cc=0; cc < 3; cc++)
+    {
+    TEST_ASSERT(std::string(copy->GetEventName(cc)) == info->GetEventName(cc));
+    TEST_ASSERT(copy->GetEventTime(cc) == info->GetEventTime(cc));
+    TEST_ASSERT(copy->GetEventDuration(cc) == info->GetEventDuration(cc));
+    TEST_ASSERT(copy->GetEventBytes(cc) == info->GetEventBytes(cc));
+    }
+
+  std::string trace = copy->GetChromeTrace();
+  TEST_ASSERT(CountOccurrences(trace, "\"ph\":\"X\"") == 3);
+  TEST_ASSERT(CountOccurrences(trace, "\"ph\":\"B\"") == 0);
+  TEST_ASSERT(CountOccurrences(trace, "\"ph\":\"E\"") == 0);
+  TEST_ASSERT(CountOccurrences(trace, "\"dur\":") == 3);
+  TEST_ASSERT(CountOccurrences(trace, "\"name\":\"Inner\"") == 2);
+  TEST_ASSERT(CountOccurrences(trace, "\"name\":\"Outer\"") == 1);
+  TEST_ASSERT(CountOccurrences(trace, "\"bytes\":1024") == 1);
+  TEST_ASSERT(CountOccurrences(trace, "\"name\":\"process_name\"") == 1);
+  return EXIT_SUCCESS;
+}
@@ -49,6 +49,7 @@ vtkCacheSizeKeeper::vtkCacheSizeKeeper()
   this->CacheSize = 0;
   this->CacheFull = 0;
   this->CacheLimit = 100*1024; // 100 MBs.
+  this->EvictionPolicy = FARTHEST_FROM_CACHE_TIME;
 }
 
 //-----------------------------------------------------------------------------
@@ -63,4 +64,5 @@ void vtkCacheSizeKeeper::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "CacheSize: " << this->CacheSize << endl;
   os << indent << "CacheFull: " << this->CacheFull << endl;
   os << indent << "CacheLimit: " << this->CacheLimit << endl;
+  os << indent << "EvictionPolicy: " << this->EvictionPolicy << endl;
 }
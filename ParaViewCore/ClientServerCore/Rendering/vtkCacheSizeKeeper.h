@@ -17,6 +17,11 @@
 // .SECTION Description:
 // vtkCacheSizeKeeper keeps track of the amount of memory cached
 // by several vtkPVUpdateSuppressor objects.
+//
+// It also holds the EvictionPolicy used by the cachers (vtkPVCacheKeeper) once
+// the cache is full: rather than refusing to cache new data, cachers keep
+// caching and vtkPVView::Update releases their least useful entries until the
+// cache fits in its limit again.
 
 #ifndef __vtkCacheSizeKeeper_h
 #define __vtkCacheSizeKeeper_h
@@ -35,10 +40,12 @@ public:
   static vtkCacheSizeKeeper* GetInstance();
 
   // Description:
-  // Report increase in cache size (in kbytes).
+  // Report increase in cache size (in kbytes). With an eviction policy other
+  // than NO_EVICTION, cachers may add data when the cache is full, after
+  // having freed some of their own cached data.
   void AddCacheSize(unsigned long kbytes)
     {
-    if (this->CacheFull)
+    if (this->CacheFull && this->EvictionPolicy == NO_EVICTION)
       {
       vtkErrorMacro("Cache is full. Cannot add more cached data.");
       }
@@ -72,6 +79,27 @@ public:
   vtkGetMacro(CacheFull, int);
   vtkSetMacro(CacheFull, int);
 
+  enum
+    {
+    NO_EVICTION = 0,
+    LEAST_RECENTLY_USED = 1,
+    FARTHEST_FROM_CACHE_TIME = 2
+    };
+
+  // Description:
+  // Get/Set how cachers make room for new data once the cache is full.
+  // \li NO_EVICTION: new data is no longer cached.
+  // \li LEAST_RECENTLY_USED: the entry that was least recently used is
+  // released.
+  // \li FARTHEST_FROM_CACHE_TIME: the entry farthest from the time being
+  // cached is released, time steps behind the current time counting as twice
+  // as far as those ahead of it since animations mostly play forward.
+  // Default is FARTHEST_FROM_CACHE_TIME. Entries are released in rounds that
+  // vtkPVView::Update synchronizes, and the order only depends on the cache
+  // times, so all processes keep the same set of time steps.
+  vtkSetClampMacro(EvictionPolicy, int, NO_EVICTION, FARTHEST_FROM_CACHE_TIME);
+  vtkGetMacro(EvictionPolicy, int);
+
 protected:
   static vtkCacheSizeKeeper* New();
   vtkCacheSizeKeeper();
@@ -80,6 +108,7 @@ protected:
   unsigned long CacheSize;
   unsigned long CacheLimit;
   int CacheFull;
+  int EvictionPolicy;
 private:
   vtkCacheSizeKeeper(const vtkCacheSizeKeeper&); // Not implemented.
   void operator=(const vtkCacheSizeKeeper&); // Not implemented.
@@ -21,9 +21,12 @@
 #endif
 #include "vtkAlgorithmOutput.h"
 #include "vtkBoundingBox.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
 #include "vtkCommand.h"
 #include "vtkCompositeDataDisplayAttributes.h"
 #include "vtkCompositeDataIterator.h"
+#include "vtkConditionVariable.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
@@ -31,8 +34,13 @@
 #include "vtkMultiBlockDataSetAlgorithm.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkMultiProcessController.h"
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
 #include "vtkProperty.h"
 #include "vtkPVCacheKeeper.h"
 #include "vtkPVGeometryFilter.h"
@@ -45,11 +53,14 @@
 #include "vtkSelectionConverter.h"
 #include "vtkSelection.h"
 #include "vtkSelectionNode.h"
+#include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTransform.h"
 #include "vtkUnstructuredGrid.h"
 
 #include <vtksys/SystemTools.hxx>
+#include <math.h>
+#include <vector>
 
 //*****************************************************************************
 // This is used to convert a vtkPolyData to a vtkMultiBlockDataSet. If input is
@@ -92,6 +103,345 @@ protected:
 };
 vtkStandardNewMacro(vtkGeometryRepresentationMultiBlockMaker);
 
+//*****************************************************************************
+// Builds the LOD levels of a snapshot of the geometry on a background thread.
+// The snapshot shares the points, connectivity and attribute arrays of the
+// geometry, which the pipeline never modifies in place: its next execution
+// produces new arrays. The background thread only reads them, and the
+// snapshot, which holds the references to the shared arrays, is created and
+// released on the main thread only. Each level is a new data object, handed
+// over to the main thread once complete.
+class vtkGeometryRepresentation::vtkLODBuilder
+{
+public:
+  // Levels are built for the LOD resolutions 0, 1/(NumberOfLevels-1), ..., 1.
+  enum { NumberOfLevels = 5 };
+
+  vtkLODBuilder() :
+    Threader(vtkMultiThreader::New()),
+    Mutex(vtkMutexLock::New()),
+    Condition(vtkConditionVariable::New()),
+    ThreadId(-1),
+    Pending(NULL),
+    FirstLevel(0),
+    SourceMTime(0),
+    Generation(0),
+    Active(false),
+    Building(false),
+    Stop(false),
+    UseInputPoints(1),
+    CopyCellData(1),
+    UseInternalTriangles(0)
+    {
+    this->Levels.resize(NumberOfLevels);
+    }
+
+  ~vtkLODBuilder()
+    {
+    if (this->ThreadId >= 0)
+      {
+      this->Mutex->Lock();
+      this->Stop = true;
+      this->Generation++;
+      this->Mutex->Unlock();
+      this->Condition->Broadcast();
+      this->Threader->TerminateThread(this->ThreadId);
+      }
+    if (this->Pending)
+      {
+      this->Pending->Delete();
+      }
+    this->ReleaseRetired();
+    this->Condition->Delete();
+    this->Mutex->Delete();
+    this->Threader->Delete();
+    }
+
+  // Description:
+  // Returns the level built for the given LOD resolution, or -1 if it is not
+  // one of the resolutions of the levels.
+  static int GetLevel(double resolution)
+    {
+    int level = static_cast<int>(
+      floor(resolution * (NumberOfLevels - 1) + 0.5));
+    if (level < 0 || level >= NumberOfLevels ||
+      fabs(resolution * (NumberOfLevels - 1) - level) > 1e-3)
+      {
+      return -1;
+      }
+    return level;
+    }
+
+  static int GetNumberOfDivisions(int level)
+    {
+    // Same mapping from LOD resolution to divisions as for on-demand LODs.
+    return static_cast<int>(150.0 * level / (NumberOfLevels - 1)) + 10;
+    }
+
+  // Description:
+  // Returns true if levels are available, or being built, for the geometry
+  // with the given modification time.
+  bool HasLevels(unsigned long mtime)
+    {
+    this->Mutex->Lock();
+    bool active = this->Active && this->SourceMTime == mtime;
+    this->Mutex->Unlock();
+    return active;
+    }
+
+  // Description:
+  // Discards the current levels and starts building new ones for \c data,
+  // \c firstLevel first and then the others from the coarsest one up.
+  void Start(vtkDataObject* data, int firstLevel,
+    vtkQuadricClustering* reference)
+    {
+    vtkDataObject* snapshot = NewSnapshot(data);
+
+    this->Mutex->Lock();
+    this->ReleaseRetired();
+    if (this->ThreadId < 0)
+      {
+      this->ThreadId = this->Threader->SpawnThread(
+        &vtkLODBuilder::ThreadMain, this);
+      }
+    if (this->Pending)
+      {
+      this->Pending->Delete();
+      }
+    this->Pending = snapshot;
+    this->FirstLevel = firstLevel;
+    this->SourceMTime = data->GetMTime();
+    this->Generation++;
+    this->Active = true;
+    this->Building = true;
+    for (int cc = 0; cc < NumberOfLevels; cc++)
+      {
+      this->Levels[cc] = NULL;
+      }
+    this->UseInputPoints = reference->GetUseInputPoints();
+    this->CopyCellData = reference->GetCopyCellData();
+    this->UseInternalTriangles = reference->GetUseInternalTriangles();
+    this->Mutex->Unlock();
+    this->Condition->Broadcast();
+    }
+
+  // Description:
+  // Discards the current levels, and the levels being built.
+  void Reset()
+    {
+    this->Mutex->Lock();
+    this->ReleaseRetired();
+    if (this->Pending)
+      {
+      this->Pending->Delete();
+      this->Pending = NULL;
+      }
+    this->Generation++;
+    this->Active = false;
+    this->Building = false;
+    for (int cc = 0; cc < NumberOfLevels; cc++)
+      {
+      this->Levels[cc] = NULL;
+      }
+    this->Mutex->Unlock();
+    }
+
+  // Description:
+  // Returns the given level, waiting for it to be built if needed. Returns
+  // NULL if it could not be built.
+  vtkSmartPointer<vtkDataObject> GetLevelOutput(int level)
+    {
+    this->Mutex->Lock();
+    while (this->Building && this->Levels[level].GetPointer() == NULL)
+      {
+      this->Condition->Wait(this->Mutex);
+      }
+    vtkSmartPointer<vtkDataObject> output = this->Levels[level];
+    this->ReleaseRetired();
+    this->Mutex->Unlock();
+    return output;
+    }
+
+private:
+  // Description:
+  // Returns a new cell array over the connectivity of \c cells. Traversing
+  // it does not touch the traversal state of \c cells.
+  static vtkCellArray* NewSharedCells(vtkCellArray* cells)
+    {
+    vtkCellArray* shared = vtkCellArray::New();
+    if (cells && cells->GetNumberOfCells() > 0)
+      {
+      shared->SetCells(cells->GetNumberOfCells(), cells->GetData());
+      }
+    return shared;
+    }
+
+  // Description:
+  // Returns a snapshot of \c data for the background thread, made of new
+  // data objects sharing the arrays of \c data.
+  static vtkDataObject* NewSnapshot(vtkDataObject* data)
+    {
+    vtkCompositeDataSet* cd = vtkCompositeDataSet::SafeDownCast(data);
+    if (cd)
+      {
+      vtkCompositeDataSet* snapshot = cd->NewInstance();
+      snapshot->CopyStructure(cd);
+      vtkCompositeDataIterator* iter = cd->NewIterator();
+      for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+        iter->GoToNextItem())
+        {
+        vtkDataObject* leaf = NewSnapshot(iter->GetCurrentDataObject());
+        snapshot->SetDataSet(iter, leaf);
+        leaf->Delete();
+        }
+      iter->Delete();
+      return snapshot;
+      }
+
+    vtkPolyData* pd = vtkPolyData::SafeDownCast(data);
+    if (!pd)
+      {
+      vtkDataObject* snapshot = data->NewInstance();
+      snapshot->DeepCopy(data);
+      return snapshot;
+      }
+
+    vtkPolyData* snapshot = vtkPolyData::New();
+    if (pd->GetPoints())
+      {
+      // Computed here, the bounds of the points are only read afterwards.
+      pd->GetPoints()->GetBounds();
+      snapshot->SetPoints(pd->GetPoints());
+      }
+    snapshot->GetPointData()->ShallowCopy(pd->GetPointData());
+    snapshot->GetCellData()->ShallowCopy(pd->GetCellData());
+    vtkCellArray* cells = NewSharedCells(pd->GetVerts());
+    snapshot->SetVerts(cells);
+    cells->Delete();
+    cells = NewSharedCells(pd->GetLines());
+    snapshot->SetLines(cells);
+    cells->Delete();
+    cells = NewSharedCells(pd->GetPolys());
+    snapshot->SetPolys(cells);
+    cells->Delete();
+    cells = NewSharedCells(pd->GetStrips());
+    snapshot->SetStrips(cells);
+    cells->Delete();
+    return snapshot;
+    }
+
+  // Description:
+  // Releases the snapshots the background thread is done with. Called on
+  // the main thread, with Mutex locked.
+  void ReleaseRetired()
+    {
+    for (size_t cc = 0; cc < this->Retired.size(); cc++)
+      {
+      this->Retired[cc]->Delete();
+      }
+    this->Retired.clear();
+    }
+
+  static VTK_THREAD_RETURN_TYPE ThreadMain(void* arg)
+    {
+    vtkMultiThreader::ThreadInfo* info =
+      static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    static_cast<vtkLODBuilder*>(info->UserData)->Run();
+    return VTK_THREAD_RETURN_VALUE;
+    }
+
+  void Run()
+    {
+    this->Mutex->Lock();
+    while (!this->Stop)
+      {
+      if (!this->Pending)
+        {
+        this->Condition->Wait(this->Mutex);
+        continue;
+        }
+
+      // The snapshot is used by this thread until it is retired.
+      vtkDataObject* snapshot = this->Pending;
+      this->Pending = NULL;
+      unsigned long generation = this->Generation;
+      int firstLevel = this->FirstLevel;
+      int useInputPoints = this->UseInputPoints;
+      int copyCellData = this->CopyCellData;
+      int useInternalTriangles = this->UseInternalTriangles;
+      this->Mutex->Unlock();
+
+      // The requested level first, then the others coarsest first.
+      std::vector<int> order(1, firstLevel);
+      for (int level = 0; level < NumberOfLevels; level++)
+        {
+        if (level != firstLevel)
+          {
+          order.push_back(level);
+          }
+        }
+
+      for (int cc = 0; cc < NumberOfLevels; cc++)
+        {
+        int level = order[cc];
+        vtkDataObject* output = snapshot->NewInstance();
+        vtkQuadricClustering* decimator = vtkQuadricClustering::New();
+        decimator->SetUseInputPoints(useInputPoints);
+        decimator->SetCopyCellData(copyCellData);
+        decimator->SetUseInternalTriangles(useInternalTriangles);
+        int divisions = GetNumberOfDivisions(level);
+        decimator->SetNumberOfDivisions(divisions, divisions, divisions);
+        decimator->SetInputData(snapshot);
+        decimator->Update();
+        // The decimator output is not shared, passing its arrays is enough.
+        output->ShallowCopy(decimator->GetOutputDataObject(0));
+        decimator->Delete();
+
+        this->Mutex->Lock();
+        bool cancelled = (generation != this->Generation);
+        if (!cancelled)
+          {
+          this->Levels[level].TakeReference(output);
+          if (cc == NumberOfLevels - 1)
+            {
+            this->Building = false;
+            }
+          }
+        this->Mutex->Unlock();
+        this->Condition->Broadcast();
+
+        if (cancelled)
+          {
+          output->Delete();
+          break;
+          }
+        }
+      this->Mutex->Lock();
+      this->Retired.push_back(snapshot);
+      }
+    this->Mutex->Unlock();
+    }
+
+  vtkMultiThreader* Threader;
+  vtkMutexLock* Mutex;
+  vtkConditionVariable* Condition;
+  int ThreadId;
+
+  // Protected by Mutex.
+  vtkDataObject* Pending;
+  std::vector<vtkDataObject*> Retired;
+  std::vector<vtkSmartPointer<vtkDataObject> > Levels;
+  int FirstLevel;
+  unsigned long SourceMTime;
+  unsigned long Generation;
+  bool Active;
+  bool Building;
+  bool Stop;
+  int UseInputPoints;
+  int CopyCellData;
+  int UseInternalTriangles;
+};
+
 //*****************************************************************************
 
 
@@ -139,6 +489,10 @@ vtkGeometryRepresentation::vtkGeometryRepresentation()
   this->Representation = SURFACE;
 
   this->SuppressLOD = false;
+  this->BuildLODInBackground = true;
+  this->LODBuiltInBackground = false;
+  this->UseBackgroundLOD = false;
+  this->LODBuilder = new vtkLODBuilder();
   this->DebugString = 0;
   this->SetDebugString(this->GetClassName());
 
@@ -151,6 +505,7 @@ vtkGeometryRepresentation::vtkGeometryRepresentation()
 vtkGeometryRepresentation::~vtkGeometryRepresentation()
 {
   this->SetDebugString(0);
+  delete this->LODBuilder;
   this->CacheKeeper->Delete();
   this->GeometryFilter->Delete();
   this->MultiBlockMaker->Delete();
@@ -257,8 +612,7 @@ int vtkGeometryRepresentation::ProcessViewRequest(
     // to provide a place-holder dataset of the right type. This is essential
     // since the vtkPVRenderView uses the type specified to decide on the
     // delivery mechanism, among other things.
-    vtkPVRenderView::SetPiece(inInfo, this,
-      this->CacheKeeper->GetOutputDataObject(0));
+    vtkPVRenderView::SetPiece(inInfo, this, this->GetGeometryToDeliver());
 
     // Since we are rendering polydata, it can be redistributed when ordered
     // compositing is needed. So let the view know that it can feel free to
@@ -283,6 +637,8 @@ int vtkGeometryRepresentation::ProcessViewRequest(
     this->Actor->GetMatrix(matrix.GetPointer());
     vtkPVRenderView::SetGeometryBounds(inInfo, this->DataBounds,
       matrix.GetPointer());
+
+    this->UpdateBackgroundLOD(inInfo);
     }
   else if (request_type == vtkPVView::REQUEST_UPDATE_LOD())
     {
@@ -298,6 +654,7 @@ int vtkGeometryRepresentation::ProcessViewRequest(
         this->Decimator->Modified();
 
         this->LODOutlineFilter->Update();
+        this->LODBuiltInBackground = false;
         // Pass along the LOD geometry to the view so that it can deliver it to
         // the rendering node as and when needed.
         vtkPVRenderView::SetPieceLOD(inInfo, this,
@@ -309,19 +666,41 @@ int vtkGeometryRepresentation::ProcessViewRequest(
         // new geometry.
         this->LODOutlineFilter->Modified();
 
-        if (inInfo->Has(vtkPVRenderView::LOD_RESOLUTION()))
+        // Use the level built in the background for this resolution, if any.
+        // The first LOD request for a geometry starts the build, with the
+        // requested level first; the other levels are then ready when the
+        // resolution changes.
+        vtkSmartPointer<vtkDataObject> lod;
+        int level = inInfo->Has(vtkPVRenderView::LOD_RESOLUTION())?
+          vtkLODBuilder::GetLevel(
+            inInfo->Get(vtkPVRenderView::LOD_RESOLUTION())) : -1;
+        vtkDataObject* geometry = this->GetGeometryToDeliver();
+        if (level >= 0 && this->UseBackgroundLOD && geometry)
           {
-          int division = static_cast<int>(150 *
-            inInfo->Get(vtkPVRenderView::LOD_RESOLUTION())) + 10;
-          this->Decimator->SetNumberOfDivisions(division, division, division);
+          if (!this->LODBuilder->HasLevels(geometry->GetMTime()))
+            {
+            this->LODBuilder->Start(geometry, level, this->Decimator);
+            }
+          lod = this->LODBuilder->GetLevelOutput(level);
           }
+        this->LODBuiltInBackground = (lod.GetPointer() != NULL);
 
-        this->Decimator->Update();
+        if (!lod)
+          {
+          if (inInfo->Has(vtkPVRenderView::LOD_RESOLUTION()))
+            {
+            int division = static_cast<int>(150 *
+              inInfo->Get(vtkPVRenderView::LOD_RESOLUTION())) + 10;
+            this->Decimator->SetNumberOfDivisions(division, division, division);
+            }
+
+          this->Decimator->Update();
+          lod = this->Decimator->GetOutputDataObject(0);
+          }
 
         // Pass along the LOD geometry to the view so that it can deliver it to
         // the rendering node as and when needed.
-        vtkPVRenderView::SetPieceLOD(inInfo, this,
-          this->Decimator->GetOutputDataObject(0));
+        vtkPVRenderView::SetPieceLOD(inInfo, this, lod);
         }
       }
     }
@@ -480,6 +859,12 @@ bool vtkGeometryRepresentation::IsCached(double cache_key)
   return this->CacheKeeper->IsCached(cache_key);
 }
 
+//----------------------------------------------------------------------------
+vtkDataObject* vtkGeometryRepresentation::GetGeometryToDeliver()
+{
+  return this->CacheKeeper->GetOutputDataObject(0);
+}
+
 //----------------------------------------------------------------------------
 vtkDataObject* vtkGeometryRepresentation::GetRenderedDataObject(int port)
 {
@@ -677,10 +1062,37 @@ void vtkGeometryRepresentation::SetVisibility(bool val)
   this->Superclass::SetVisibility(val);
 }
 
+//----------------------------------------------------------------------------
+void vtkGeometryRepresentation::UpdateBackgroundLOD(vtkInformation* inInfo)
+{
+  vtkPVRenderView* view = vtkPVRenderView::SafeDownCast(
+    inInfo->Get(vtkPVView::VIEW()));
+  vtkDataObject* geometry = this->GetGeometryToDeliver();
+
+  // Only bother when this geometry alone is large enough for the view to use
+  // LOD rendering.
+  this->UseBackgroundLOD = this->BuildLODInBackground && !this->SuppressLOD &&
+    view && !view->GetUseOutlineForLODRendering() && geometry &&
+    geometry->GetActualMemorySize() / 1024.0 >=
+    view->GetLODRenderingThreshold();
+
+  // Levels of a previous geometry are of no use any more. New levels are only
+  // built once interaction begins, on the first LOD request.
+  if (!this->UseBackgroundLOD ||
+    !this->LODBuilder->HasLevels(geometry->GetMTime()))
+    {
+    this->LODBuilder->Reset();
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkGeometryRepresentation::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "BuildLODInBackground: " << this->BuildLODInBackground
+     << endl;
+  os << indent << "LODBuiltInBackground: " << this->LODBuiltInBackground
+     << endl;
 }
 
 //****************************************************************************
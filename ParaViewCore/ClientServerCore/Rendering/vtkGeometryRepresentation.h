@@ -76,6 +76,23 @@ public:
   virtual void SetSuppressLOD(bool suppress)
     { this->SuppressLOD = suppress; }
 
+  // Description:
+  // When set to true (default) and the geometry is large enough for the view
+  // to use LOD rendering, the first LOD request for a geometry starts building
+  // the decimated geometries for the LOD resolutions 0, 0.25, 0.5, 0.75 and 1
+  // on a background thread, the requested one first. The other levels are
+  // then ready when the LOD resolution changes, instead of being computed
+  // while the user waits. Other resolutions are still decimated on demand.
+  vtkSetMacro(BuildLODInBackground, bool);
+  vtkGetMacro(BuildLODInBackground, bool);
+  vtkBooleanMacro(BuildLODInBackground, bool);
+
+  // Description:
+  // Returns true if the LOD geometry passed to the view by the last LOD
+  // request is a level built in the background, false if it was decimated
+  // on demand.
+  vtkGetMacro(LODBuiltInBackground, bool);
+
   // Description:
   // Set the lighting properties of the object. vtkGeometryRepresentation
   // overrides these based of the following conditions:
@@ -265,6 +282,12 @@ protected:
   // Overridden to check with the vtkPVCacheKeeper to see if the key is cached.
   virtual bool IsCached(double cache_key);
 
+  // Description:
+  // Returns the geometry handed to the view for delivery in REQUEST_UPDATE()
+  // and decimated for LOD rendering. This is the output of the CacheKeeper by
+  // default.
+  virtual vtkDataObject* GetGeometryToDeliver();
+
   vtkAlgorithm* GeometryFilter;
   vtkAlgorithm* MultiBlockMaker;
   vtkPVCacheKeeper* CacheKeeper;
@@ -281,6 +304,8 @@ protected:
   double Diffuse;
   int Representation;
   bool SuppressLOD;
+  bool BuildLODInBackground;
+  bool LODBuiltInBackground;
   bool RequestGhostCellsIfNeeded;
   double DataBounds[6];
 
@@ -289,6 +314,17 @@ private:
   void operator=(const vtkGeometryRepresentation&); // Not implemented
 
   friend class vtkSelectionRepresentation;
+
+  // Description:
+  // Decides whether LOD levels are built in the background for the current
+  // geometry, and discards the levels of a previous geometry. Called in the
+  // REQUEST_UPDATE pass.
+  void UpdateBackgroundLOD(vtkInformation* inInfo);
+
+  class vtkLODBuilder;
+  vtkLODBuilder* LODBuilder;
+  bool UseBackgroundLOD;
+
   char* DebugString;
   vtkSetStringMacro(DebugString);
 //ETX
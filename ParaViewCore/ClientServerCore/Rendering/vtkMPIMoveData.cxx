@@ -14,10 +14,13 @@
 =========================================================================*/
 #include "vtkMPIMoveData.h"
 
+#include "vtkByteSwap.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCharArray.h"
 #include "vtkCompositeDataSet.h"
 #include "vtkDataSetReader.h"
+#include "vtkIdTypeArray.h"
 #include "vtkDirectedGraph.h"
 #include "vtkGenericDataObjectReader.h"
 #include "vtkGenericDataObjectWriter.h"
@@ -28,13 +31,16 @@
 #include "vtkInformationVector.h"
 #include "vtkMPIMToNSocketConnection.h"
 #include "vtkMultiBlockDataSet.h"
+#include "vtkMultiPieceDataSet.h"
 #include "vtkMultiProcessController.h"
 #include "vtkMultiProcessControllerHelper.h"
+#include "vtkMultiProcessStream.h"
 #include "vtkNonOverlappingAMR.h"
 #include "vtkObjectFactory.h"
 #include "vtkOutlineFilter.h"
 #include "vtkOverlappingAMR.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkProcessModule.h"
 #include "vtkPVConfig.h"
@@ -46,6 +52,7 @@
 #include "vtkTimerLog.h"
 #include "vtkToolkits.h"
 #include "vtkUndirectedGraph.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 
 #include "vtk_zlib.h"
@@ -57,7 +64,7 @@
 #include "vtkAllToNRedistributeCompositePolyData.h"
 #endif
 
-#include <vector>
+#include <string.h>
 
 bool vtkMPIMoveData::UseZLibCompression = false;
 
@@ -68,6 +75,569 @@ namespace
     {
     return vtkMultiProcessControllerHelper::MergePieces(pieces, result);
     }
+
+  //---------------------------------------------------------------------------
+  // Raw array encoding.
+  //
+  // A raw buffer starts with a 16 byte header: the "vtkr" marker, a flags byte,
+  // 3 reserved bytes and the descriptor length as a little-endian 64 bit
+  // integer. The descriptor is a vtkMultiProcessStream describing the data
+  // object tree and every array (name, type, tuples, components, attribute).
+  // Unless the arrays are detached, the raw array memory follows the
+  // descriptor, each array padded to 8 bytes, in the order the descriptor
+  // lists them.
+  const int RAW_VERSION = 1;
+  const int RAW_HEADER_SIZE = 16;
+  const unsigned char RAW_FLAG_DETACHED_ARRAYS = 0x1;
+  const int RAW_NULL_BLOCK = -1;
+
+  inline vtkIdType vtkMPIMoveDataPad8(vtkIdType length)
+    {
+    return (length + 7) & ~static_cast<vtkIdType>(7);
+    }
+
+  inline bool vtkMPIMoveDataIsBigEndian()
+    {
+#ifdef VTK_WORDS_BIGENDIAN
+    return true;
+#else
+    return false;
+#endif
+    }
+
+  inline vtkIdType vtkMPIMoveDataArrayBytes(vtkDataArray* array)
+    {
+    return array->GetNumberOfTuples() * array->GetNumberOfComponents() *
+      array->GetDataTypeSize();
+    }
+
+  //---------------------------------------------------------------------------
+  bool vtkMPIMoveDataCanEncodeFieldData(vtkFieldData* fd)
+    {
+    for (int cc=0; fd && cc < fd->GetNumberOfArrays(); cc++)
+      {
+      // vtkStringArray, vtkVariantArray and bit arrays are left to the legacy
+      // writer.
+      vtkDataArray* array = fd->GetArray(cc);
+      if (array == NULL || array->GetDataType() == VTK_BIT)
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+
+  //---------------------------------------------------------------------------
+  bool vtkMPIMoveDataCanEncodeRaw(vtkDataObject* data)
+    {
+    if (data == NULL)
+      {
+      return false;
+      }
+    if (vtkMultiBlockDataSet* mb = vtkMultiBlockDataSet::SafeDownCast(data))
+      {
+      for (unsigned int cc=0; cc < mb->GetNumberOfBlocks(); cc++)
+        {
+        vtkDataObject* block = mb->GetBlock(cc);
+        if (block && !vtkMPIMoveDataCanEncodeRaw(block))
+          {
+          return false;
+          }
+        }
+      return vtkMPIMoveDataCanEncodeFieldData(data->GetFieldData());
+      }
+    if (vtkMultiPieceDataSet* mp = vtkMultiPieceDataSet::SafeDownCast(data))
+      {
+      for (unsigned int cc=0; cc < mp->GetNumberOfPieces(); cc++)
+        {
+        vtkDataObject* piece = mp->GetPieceAsDataObject(cc);
+        if (piece && !vtkMPIMoveDataCanEncodeRaw(piece))
+          {
+          return false;
+          }
+        }
+      return vtkMPIMoveDataCanEncodeFieldData(data->GetFieldData());
+      }
+
+    vtkDataSet* ds = vtkDataSet::SafeDownCast(data);
+    switch (data->GetDataObjectType())
+      {
+    case VTK_POLY_DATA:
+    case VTK_IMAGE_DATA:
+      break;
+
+    case VTK_UNSTRUCTURED_GRID:
+      // polyhedral cells need the face stream which we don't encode.
+      if (vtkUnstructuredGrid::SafeDownCast(data)->GetFaces() != NULL)
+        {
+        return false;
+        }
+      break;
+
+    default:
+      return false;
+      }
+    return vtkMPIMoveDataCanEncodeFieldData(ds->GetPointData()) &&
+      vtkMPIMoveDataCanEncodeFieldData(ds->GetCellData()) &&
+      vtkMPIMoveDataCanEncodeFieldData(ds->GetFieldData());
+    }
+
+  //---------------------------------------------------------------------------
+  class vtkMPIMoveDataRawEncoder
+    {
+  public:
+    vtkMultiProcessStream Descriptor;
+    std::vector<vtkDataArray*> Arrays;
+
+    vtkMPIMoveDataRawEncoder()
+      {
+      this->Descriptor << RAW_VERSION
+                       << static_cast<int>(vtkMPIMoveDataIsBigEndian())
+                       << static_cast<int>(sizeof(vtkIdType));
+      }
+
+    void EncodeArray(vtkDataArray* array, int attributeType)
+      {
+      this->Descriptor << std::string(array->GetName()? array->GetName() : "")
+                       << array->GetDataType()
+                       << static_cast<vtkTypeInt64>(array->GetNumberOfTuples())
+                       << array->GetNumberOfComponents()
+                       << attributeType;
+      this->Arrays.push_back(array);
+      }
+
+    void EncodeFieldData(vtkFieldData* fd)
+      {
+      vtkDataSetAttributes* dsa = vtkDataSetAttributes::SafeDownCast(fd);
+      int numArrays = fd? fd->GetNumberOfArrays() : 0;
+      this->Descriptor << numArrays;
+      for (int cc=0; cc < numArrays; cc++)
+        {
+        this->EncodeArray(fd->GetArray(cc),
+          dsa? dsa->IsArrayAnAttribute(cc) : -1);
+        }
+      }
+
+    void EncodeCells(vtkCellArray* cells)
+      {
+      vtkIdType numCells = cells? cells->GetNumberOfCells() : 0;
+      this->Descriptor << static_cast<vtkTypeInt64>(numCells);
+      if (numCells > 0)
+        {
+        this->EncodeArray(cells->GetData(), -1);
+        }
+      }
+
+    void EncodePoints(vtkPoints* points)
+      {
+      this->Descriptor << static_cast<int>(points != NULL);
+      if (points)
+        {
+        this->EncodeArray(points->GetData(), -1);
+        }
+      }
+
+    void EncodeDataObject(vtkDataObject* data)
+      {
+      if (data == NULL)
+        {
+        this->Descriptor << RAW_NULL_BLOCK;
+        return;
+        }
+
+      int dataType = data->GetDataObjectType();
+      this->Descriptor << dataType;
+      switch (dataType)
+        {
+      case VTK_MULTIBLOCK_DATA_SET:
+      case VTK_MULTIPIECE_DATA_SET:
+          {
+          vtkCompositeDataSet* cd = vtkCompositeDataSet::SafeDownCast(data);
+          vtkMultiBlockDataSet* mb = vtkMultiBlockDataSet::SafeDownCast(data);
+          vtkMultiPieceDataSet* mp = vtkMultiPieceDataSet::SafeDownCast(data);
+          unsigned int numBlocks = mb? mb->GetNumberOfBlocks() :
+            mp->GetNumberOfPieces();
+          this->Descriptor << numBlocks;
+          for (unsigned int cc=0; cc < numBlocks; cc++)
+            {
+            vtkInformation* metaData = NULL;
+            if (mb && mb->HasMetaData(cc))
+              {
+              metaData = mb->GetMetaData(cc);
+              }
+            else if (mp && mp->HasMetaData(cc))
+              {
+              metaData = mp->GetMetaData(cc);
+              }
+            bool hasName = metaData &&
+              metaData->Has(vtkCompositeDataSet::NAME()) &&
+              metaData->Get(vtkCompositeDataSet::NAME());
+            this->Descriptor << static_cast<int>(hasName);
+            if (hasName)
+              {
+              this->Descriptor << std::string(
+                metaData->Get(vtkCompositeDataSet::NAME()));
+              }
+            this->EncodeDataObject(
+              mb? mb->GetBlock(cc) : mp->GetPieceAsDataObject(cc));
+            }
+          this->EncodeFieldData(cd->GetFieldData());
+          }
+        return;
+
+      case VTK_POLY_DATA:
+          {
+          vtkPolyData* pd = vtkPolyData::SafeDownCast(data);
+          this->EncodePoints(pd->GetPoints());
+          this->EncodeCells(pd->GetNumberOfVerts()? pd->GetVerts() : NULL);
+          this->EncodeCells(pd->GetNumberOfLines()? pd->GetLines() : NULL);
+          this->EncodeCells(pd->GetNumberOfPolys()? pd->GetPolys() : NULL);
+          this->EncodeCells(pd->GetNumberOfStrips()? pd->GetStrips() : NULL);
+          }
+        break;
+
+      case VTK_UNSTRUCTURED_GRID:
+          {
+          vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(data);
+          this->EncodePoints(ug->GetPoints());
+          vtkCellArray* cells = ug->GetCells();
+          int hasCells = (cells != NULL && cells->GetNumberOfCells() > 0 &&
+            ug->GetCellTypesArray() && ug->GetCellLocationsArray())? 1 : 0;
+          this->Descriptor << hasCells;
+          if (hasCells)
+            {
+            this->EncodeArray(ug->GetCellTypesArray(), -1);
+            this->EncodeArray(ug->GetCellLocationsArray(), -1);
+            this->EncodeCells(cells);
+            }
+          }
+        break;
+
+      case VTK_IMAGE_DATA:
+          {
+          vtkImageData* id = vtkImageData::SafeDownCast(data);
+          int* extent = id->GetExtent();
+          double* origin = id->GetOrigin();
+          double* spacing = id->GetSpacing();
+          for (int cc=0; cc < 6; cc++)
+            {
+            this->Descriptor << extent[cc];
+            }
+          for (int cc=0; cc < 3; cc++)
+            {
+            this->Descriptor << origin[cc] << spacing[cc];
+            }
+          }
+        break;
+        }
+
+      vtkDataSet* ds = vtkDataSet::SafeDownCast(data);
+      this->EncodeFieldData(ds->GetPointData());
+      this->EncodeFieldData(ds->GetCellData());
+      this->EncodeFieldData(ds->GetFieldData());
+      }
+    };
+
+  //---------------------------------------------------------------------------
+  // Source for the raw array memory during decode. The memory either follows
+  // the descriptor in the marshaled buffer or arrives as separate messages.
+  class vtkMPIMoveDataRawSource
+    {
+  public:
+    const char* Buffer;
+    vtkIdType Length;
+    vtkIdType Position;
+    vtkCommunicator* Communicator;
+    int Tag;
+    // Sizes of the array messages announced by the sender, and the number of
+    // them received so far.
+    const std::vector<vtkIdType>* MessageSizes;
+    size_t NumberOfMessagesRead;
+
+    vtkMPIMoveDataRawSource() : Buffer(NULL), Length(0), Position(0),
+      Communicator(NULL), Tag(0), MessageSizes(NULL), NumberOfMessagesRead(0) {}
+
+    bool Read(void* dest, vtkIdType numBytes)
+      {
+      if (this->Communicator)
+        {
+        // never receive a message into an array of a different size, the
+        // messages that follow would be misread.
+        if (this->NumberOfMessagesRead >= this->MessageSizes->size() ||
+          (*this->MessageSizes)[this->NumberOfMessagesRead] != numBytes)
+          {
+          return false;
+          }
+        this->NumberOfMessagesRead++;
+        return this->Communicator->Receive(static_cast<char*>(dest), numBytes,
+          1, this->Tag) != 0;
+        }
+      if (this->Position + numBytes > this->Length)
+        {
+        return false;
+        }
+      memcpy(dest, this->Buffer + this->Position, numBytes);
+      this->Position += vtkMPIMoveDataPad8(numBytes);
+      return true;
+      }
+    };
+
+  //---------------------------------------------------------------------------
+  class vtkMPIMoveDataRawDecoder
+    {
+  public:
+    vtkMultiProcessStream Descriptor;
+    vtkMPIMoveDataRawSource* Source;
+    bool SwapBytes;
+    int SenderIdTypeSize;
+    bool Valid;
+
+    vtkMPIMoveDataRawDecoder(vtkMPIMoveDataRawSource* source)
+      : Source(source), SwapBytes(false), SenderIdTypeSize(sizeof(vtkIdType)),
+      Valid(true)
+      {
+      }
+
+    bool ReadHeader()
+      {
+      int version, bigEndian;
+      this->Descriptor >> version >> bigEndian >> this->SenderIdTypeSize;
+      this->SwapBytes =
+        (bigEndian != 0) != vtkMPIMoveDataIsBigEndian();
+      return version == RAW_VERSION;
+      }
+
+    vtkSmartPointer<vtkDataArray> DecodeArray(int& attributeType)
+      {
+      std::string name;
+      int dataType, numComponents;
+      vtkTypeInt64 numTuples;
+      this->Descriptor >> name >> dataType >> numTuples >> numComponents
+                       >> attributeType;
+
+      // vtkIdType may differ in size between the sender and this process, in
+      // which case we receive into an integer array matching the sender and
+      // convert afterwards.
+      int receiveType = dataType;
+      if (dataType == VTK_ID_TYPE &&
+        this->SenderIdTypeSize != static_cast<int>(sizeof(vtkIdType)))
+        {
+        receiveType = this->SenderIdTypeSize == 4?
+          VTK_TYPE_INT32 : VTK_TYPE_INT64;
+        }
+
+      vtkSmartPointer<vtkDataArray> array;
+      array.TakeReference(vtkDataArray::CreateDataArray(receiveType));
+      array->SetNumberOfComponents(numComponents);
+      array->SetNumberOfTuples(static_cast<vtkIdType>(numTuples));
+      vtkIdType numBytes = vtkMPIMoveDataArrayBytes(array);
+      if (numBytes > 0)
+        {
+        if (!this->Source->Read(array->GetVoidPointer(0), numBytes))
+          {
+          this->Valid = false;
+          }
+        else if (this->SwapBytes && array->GetDataTypeSize() > 1)
+          {
+          vtkByteSwap::SwapVoidRange(array->GetVoidPointer(0),
+            numBytes / array->GetDataTypeSize(), array->GetDataTypeSize());
+          }
+        }
+
+      if (receiveType != dataType)
+        {
+        vtkSmartPointer<vtkDataArray> converted;
+        converted.TakeReference(vtkDataArray::CreateDataArray(dataType));
+        converted->DeepCopy(array);
+        array = converted;
+        }
+      if (!name.empty())
+        {
+        array->SetName(name.c_str());
+        }
+      return array;
+      }
+
+    void DecodeFieldData(vtkFieldData* fd)
+      {
+      vtkDataSetAttributes* dsa = vtkDataSetAttributes::SafeDownCast(fd);
+      int numArrays;
+      this->Descriptor >> numArrays;
+      for (int cc=0; cc < numArrays; cc++)
+        {
+        int attributeType;
+        vtkSmartPointer<vtkDataArray> array = this->DecodeArray(attributeType);
+        if (dsa && attributeType >= 0)
+          {
+          dsa->SetAttribute(array, attributeType);
+          }
+        else
+          {
+          fd->AddArray(array);
+          }
+        }
+      }
+
+    vtkSmartPointer<vtkCellArray> DecodeCells()
+      {
+      vtkTypeInt64 numCells;
+      this->Descriptor >> numCells;
+      if (numCells == 0)
+        {
+        return NULL;
+        }
+      int attributeType;
+      vtkSmartPointer<vtkDataArray> data = this->DecodeArray(attributeType);
+      vtkSmartPointer<vtkCellArray> cells = vtkSmartPointer<vtkCellArray>::New();
+      cells->SetCells(static_cast<vtkIdType>(numCells),
+        vtkIdTypeArray::SafeDownCast(data));
+      return cells;
+      }
+
+    vtkSmartPointer<vtkPoints> DecodePoints()
+      {
+      int hasPoints;
+      this->Descriptor >> hasPoints;
+      if (!hasPoints)
+        {
+        return NULL;
+        }
+      int attributeType;
+      vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+      points->SetData(this->DecodeArray(attributeType));
+      return points;
+      }
+
+    vtkSmartPointer<vtkDataObject> DecodeDataObject()
+      {
+      int dataType;
+      this->Descriptor >> dataType;
+      if (dataType == RAW_NULL_BLOCK)
+        {
+        return NULL;
+        }
+
+      vtkSmartPointer<vtkDataObject> data;
+      switch (dataType)
+        {
+      case VTK_MULTIBLOCK_DATA_SET:
+      case VTK_MULTIPIECE_DATA_SET:
+          {
+          vtkSmartPointer<vtkMultiBlockDataSet> mb;
+          vtkSmartPointer<vtkMultiPieceDataSet> mp;
+          if (dataType == VTK_MULTIBLOCK_DATA_SET)
+            {
+            mb = vtkSmartPointer<vtkMultiBlockDataSet>::New();
+            data = mb;
+            }
+          else
+            {
+            mp = vtkSmartPointer<vtkMultiPieceDataSet>::New();
+            data = mp;
+            }
+          unsigned int numBlocks;
+          this->Descriptor >> numBlocks;
+          if (mb) { mb->SetNumberOfBlocks(numBlocks); }
+          else { mp->SetNumberOfPieces(numBlocks); }
+          for (unsigned int cc=0; cc < numBlocks && this->Valid; cc++)
+            {
+            int hasName;
+            std::string name;
+            this->Descriptor >> hasName;
+            if (hasName)
+              {
+              this->Descriptor >> name;
+              }
+            vtkSmartPointer<vtkDataObject> block = this->DecodeDataObject();
+            if (mb)
+              {
+              mb->SetBlock(cc, block);
+              if (hasName)
+                {
+                mb->GetMetaData(cc)->Set(vtkCompositeDataSet::NAME(),
+                  name.c_str());
+                }
+              }
+            else
+              {
+              mp->SetPiece(cc, block);
+              if (hasName)
+                {
+                mp->GetMetaData(cc)->Set(vtkCompositeDataSet::NAME(),
+                  name.c_str());
+                }
+              }
+            }
+          this->DecodeFieldData(data->GetFieldData());
+          }
+        return data;
+
+      case VTK_POLY_DATA:
+          {
+          vtkSmartPointer<vtkPolyData> pd = vtkSmartPointer<vtkPolyData>::New();
+          pd->SetPoints(this->DecodePoints());
+          pd->SetVerts(this->DecodeCells());
+          pd->SetLines(this->DecodeCells());
+          pd->SetPolys(this->DecodeCells());
+          pd->SetStrips(this->DecodeCells());
+          data = pd;
+          }
+        break;
+
+      case VTK_UNSTRUCTURED_GRID:
+          {
+          vtkSmartPointer<vtkUnstructuredGrid> ug =
+            vtkSmartPointer<vtkUnstructuredGrid>::New();
+          ug->SetPoints(this->DecodePoints());
+          int hasCells;
+          this->Descriptor >> hasCells;
+          if (hasCells)
+            {
+            int attributeType;
+            vtkSmartPointer<vtkDataArray> types =
+              this->DecodeArray(attributeType);
+            vtkSmartPointer<vtkDataArray> locations =
+              this->DecodeArray(attributeType);
+            vtkSmartPointer<vtkCellArray> cells = this->DecodeCells();
+            ug->SetCells(vtkUnsignedCharArray::SafeDownCast(types),
+              vtkIdTypeArray::SafeDownCast(locations), cells);
+            }
+          data = ug;
+          }
+        break;
+
+      case VTK_IMAGE_DATA:
+          {
+          vtkSmartPointer<vtkImageData> id = vtkSmartPointer<vtkImageData>::New();
+          int extent[6];
+          double origin[3], spacing[3];
+          for (int cc=0; cc < 6; cc++)
+            {
+            this->Descriptor >> extent[cc];
+            }
+          for (int cc=0; cc < 3; cc++)
+            {
+            this->Descriptor >> origin[cc] >> spacing[cc];
+            }
+          id->SetExtent(extent);
+          id->SetOrigin(origin);
+          id->SetSpacing(spacing);
+          data = id;
+          }
+        break;
+
+      default:
+        this->Valid = false;
+        return NULL;
+        }
+
+      vtkDataSet* ds = vtkDataSet::SafeDownCast(data);
+      this->DecodeFieldData(ds->GetPointData());
+      this->DecodeFieldData(ds->GetCellData());
+      this->DecodeFieldData(ds->GetFieldData());
+      return data;
+      }
+    };
 };
 
 
@@ -769,14 +1339,7 @@ void vtkMPIMoveData::DataServerSendToRenderServer(vtkDataObject* output)
     return;
     }
 
-  //int fixme;
-  // We might be able to eliminate this marshal.
-  this->ClearBuffer();
-  this->MarshalDataToBuffer(output);
-
-  com->Send(&(this->NumberOfBuffers), 1, 1, 23480);
-  com->Send(this->BufferLengths, this->NumberOfBuffers, 1, 23481);
-  com->Send(this->Buffers, this->BufferTotalLength, 1, 23482);
+  this->SendDataObject(com, output, 23480);
 }
 
 //-----------------------------------------------------------------------------
@@ -791,24 +1354,7 @@ void vtkMPIMoveData::RenderServerReceiveFromDataServer(vtkDataObject* output)
     return;
     }
 
-  this->ClearBuffer();
-  com->Receive(&(this->NumberOfBuffers), 1, 1, 23480);
-  this->BufferLengths = new vtkIdType[this->NumberOfBuffers];
-  com->Receive(this->BufferLengths, this->NumberOfBuffers, 1, 23481);
-  // Compute additional buffer information.
-  this->BufferOffsets = new vtkIdType[this->NumberOfBuffers];
-  this->BufferTotalLength = 0;
-  for (int idx = 0; idx < this->NumberOfBuffers; ++idx)
-    {
-    this->BufferOffsets[idx] = this->BufferTotalLength;
-    this->BufferTotalLength += this->BufferLengths[idx];
-    }
-  this->Buffers = new char[this->BufferTotalLength];
-  com->Receive(this->Buffers, this->BufferTotalLength, 1, 23482);
-
-  //int fixme;  // Can we avoid this?
-  this->ReconstructDataFromBuffer(output);
-  this->ClearBuffer();
+  this->ReceiveDataObject(com, output, 23480);
 }
 
 //-----------------------------------------------------------------------------
@@ -828,14 +1374,7 @@ void vtkMPIMoveData::DataServerZeroSendToRenderServerZero(vtkDataObject* data)
       return;
       }
 
-    //int fixme;
-    // We might be able to eliminate this marshal.
-    this->ClearBuffer();
-    this->MarshalDataToBuffer(data);
-    com->Send(&(this->NumberOfBuffers), 1, 1, 23480);
-    com->Send(this->BufferLengths, this->NumberOfBuffers, 1, 23481);
-    com->Send(this->Buffers, this->BufferTotalLength, 1, 23482);
-    this->ClearBuffer();
+    this->SendDataObject(com, data, 23480);
     }
 }
 
@@ -855,24 +1394,7 @@ void vtkMPIMoveData::RenderServerZeroReceiveFromDataServerZero(vtkDataObject* da
       return;
       }
 
-    this->ClearBuffer();
-    com->Receive(&(this->NumberOfBuffers), 1, 1, 23480);
-    this->BufferLengths = new vtkIdType[this->NumberOfBuffers];
-    com->Receive(this->BufferLengths, this->NumberOfBuffers, 1, 23481);
-    // Compute additional buffer information.
-    this->BufferOffsets = new vtkIdType[this->NumberOfBuffers];
-    this->BufferTotalLength = 0;
-    for (int idx = 0; idx < this->NumberOfBuffers; ++idx)
-      {
-      this->BufferOffsets[idx] = this->BufferTotalLength;
-      this->BufferTotalLength += this->BufferLengths[idx];
-      }
-    this->Buffers = new char[this->BufferTotalLength];
-    com->Receive(this->Buffers, this->BufferTotalLength, 1, 23482);
-
-    //int fixme;  // Can we avoid this?
-    this->ReconstructDataFromBuffer(data);
-    this->ClearBuffer();
+    this->ReceiveDataObject(com, data, 23480);
     }
 }
 
@@ -889,15 +1411,8 @@ void vtkMPIMoveData::DataServerSendToClient(vtkDataObject* output)
   if (myId == 0)
     {
     vtkTimerLog::MarkStartEvent("Dataserver sending to client");
-    this->ClearBuffer();
-    this->MarshalDataToBuffer(output);
-    this->ClientDataServerSocketController->Send(
-                                     &(this->NumberOfBuffers), 1, 1, 23490);
-    this->ClientDataServerSocketController->Send(this->BufferLengths,
-                                     this->NumberOfBuffers, 1, 23491);
-    this->ClientDataServerSocketController->Send(this->Buffers,
-                                     this->BufferTotalLength, 1, 23492);
-    this->ClearBuffer();
+    this->SendDataObject(
+      this->ClientDataServerSocketController->GetCommunicator(), output, 23490);
     vtkTimerLog::MarkEndEvent("Dataserver sending to client");
     }
 }
@@ -913,24 +1428,7 @@ void vtkMPIMoveData::ClientReceiveFromDataServer(vtkDataObject* output)
     return;
     }
 
-  this->ClearBuffer();
-  com->Receive(&(this->NumberOfBuffers), 1, 1, 23490);
-  this->BufferLengths = new vtkIdType[this->NumberOfBuffers];
-  com->Receive(this->BufferLengths, this->NumberOfBuffers,
-                                  1, 23491);
-  // Compute additional buffer information.
-  this->BufferOffsets = new vtkIdType[this->NumberOfBuffers];
-  this->BufferTotalLength = 0;
-  for (int idx = 0; idx < this->NumberOfBuffers; ++idx)
-    {
-    this->BufferOffsets[idx] = this->BufferTotalLength;
-    this->BufferTotalLength += this->BufferLengths[idx];
-    }
-  this->Buffers = new char[this->BufferTotalLength];
-  com->Receive(this->Buffers, this->BufferTotalLength,
-                                  1, 23492);
-  this->ReconstructDataFromBuffer(output);
-  this->ClearBuffer();
+  this->ReceiveDataObject(com, output, 23490);
 }
 
 
@@ -1018,76 +1516,143 @@ void vtkMPIMoveData::ClearBuffer()
 }
 
 //-----------------------------------------------------------------------------
-void vtkMPIMoveData::MarshalDataToBuffer(vtkDataObject* data)
+void vtkMPIMoveData::MarshalDataToBuffer(vtkDataObject* data,
+  std::vector<vtkDataArray*>* detachedArrays)
 {
-  vtkDataSet* dataSet = vtkDataSet::SafeDownCast(data);
-  vtkImageData* imageData = vtkImageData::SafeDownCast(data);
-  vtkGraph* graph = vtkGraph::SafeDownCast(data);
+  char* buffer =NULL;
+  vtkIdType buffer_length = 0;
 
-  // Protect from empty data.
-  if ((dataSet && dataSet->GetNumberOfPoints() == 0) ||
-    (graph && graph->GetNumberOfVertices() == 0))
+  if (vtkMPIMoveDataCanEncodeRaw(data))
     {
-    this->NumberOfBuffers = 0;
-    }
+    // Raw encoding: a small descriptor followed by the array memory. No
+    // formatting or parsing is involved.
+    vtkTimerLog::MarkStartEvent("Raw marshal");
+    vtkMPIMoveDataRawEncoder encoder;
+    encoder.EncodeDataObject(data);
 
-  // Copy input to isolate reader from the pipeline.
-  vtkDataWriter* writer = vtkGenericDataObjectWriter::New();
-  writer->SetInputData(data);
-  if (imageData)
-    {
-    // We add the image extents to the header, since the writer doesn't preserve
-    // the extents.
-    int *extent = imageData->GetExtent();
-    double* origin = imageData->GetOrigin();
-    vtksys_ios::ostringstream stream;
-    stream << "EXTENT " << extent[0] << " " <<
-      extent[1] << " " <<
-      extent[2] << " " <<
-      extent[3] << " " <<
-      extent[4] << " " <<
-      extent[5];
-    stream << " ORIGIN " << origin[0] << " " << origin[1] << " " << origin[2];
-    writer->SetHeader(stream.str().c_str());
+    std::vector<unsigned char> descriptor;
+    encoder.Descriptor.GetRawData(descriptor);
+
+    // Payloads compressed with zlib have to be part of the buffer.
+    bool detach = (detachedArrays != NULL &&
+      !vtkMPIMoveData::UseZLibCompression);
+
+    buffer_length = RAW_HEADER_SIZE +
+      vtkMPIMoveDataPad8(static_cast<vtkIdType>(descriptor.size()));
+    if (!detach)
+      {
+      for (size_t cc=0; cc < encoder.Arrays.size(); cc++)
+        {
+        buffer_length += vtkMPIMoveDataPad8(
+          vtkMPIMoveDataArrayBytes(encoder.Arrays[cc]));
+        }
+      }
+
+    buffer = new char[buffer_length];
+    memset(buffer, 0, RAW_HEADER_SIZE);
+    memcpy(buffer, "vtkr", 4);
+    buffer[4] = detach? RAW_FLAG_DETACHED_ARRAYS : 0;
+    vtkTypeUInt64 descriptor_length = descriptor.size();
+    for (int cc=0; cc < 8; cc++)
+      {
+      buffer[8+cc] = static_cast<char>(descriptor_length & 0x0ff);
+      descriptor_length = descriptor_length >> 8;
+      }
+    if (!descriptor.empty())
+      {
+      memcpy(buffer + RAW_HEADER_SIZE, &descriptor[0], descriptor.size());
+      }
+
+    vtkIdType offset = RAW_HEADER_SIZE +
+      vtkMPIMoveDataPad8(static_cast<vtkIdType>(descriptor.size()));
+    for (size_t cc=0; cc < encoder.Arrays.size(); cc++)
+      {
+      vtkDataArray* array = encoder.Arrays[cc];
+      if (detach)
+        {
+        detachedArrays->push_back(array);
+        continue;
+        }
+      vtkIdType numBytes = vtkMPIMoveDataArrayBytes(array);
+      if (numBytes > 0)
+        {
+        memcpy(buffer + offset, array->GetVoidPointer(0), numBytes);
+        }
+      offset += vtkMPIMoveDataPad8(numBytes);
+      }
+    vtkTimerLog::MarkEndEvent("Raw marshal");
     }
+  else
+    {
+    vtkDataSet* dataSet = vtkDataSet::SafeDownCast(data);
+    vtkImageData* imageData = vtkImageData::SafeDownCast(data);
+    vtkGraph* graph = vtkGraph::SafeDownCast(data);
 
-  writer->SetFileTypeToBinary();
-  writer->WriteToOutputStringOn();
-  writer->Write();
+    // Protect from empty data.
+    if ((dataSet && dataSet->GetNumberOfPoints() == 0) ||
+      (graph && graph->GetNumberOfVertices() == 0))
+      {
+      this->NumberOfBuffers = 0;
+      }
 
-  char* buffer =NULL;
-  vtkIdType buffer_length = 0;
+    // Copy input to isolate reader from the pipeline.
+    vtkDataWriter* writer = vtkGenericDataObjectWriter::New();
+    writer->SetInputData(data);
+    if (imageData)
+      {
+      // We add the image extents to the header, since the writer doesn't preserve
+      // the extents.
+      int *extent = imageData->GetExtent();
+      double* origin = imageData->GetOrigin();
+      vtksys_ios::ostringstream stream;
+      stream << "EXTENT " << extent[0] << " " <<
+        extent[1] << " " <<
+        extent[2] << " " <<
+        extent[3] << " " <<
+        extent[4] << " " <<
+        extent[5];
+      stream << " ORIGIN " << origin[0] << " " << origin[1] << " " << origin[2];
+      writer->SetHeader(stream.str().c_str());
+      }
+
+    writer->SetFileTypeToBinary();
+    writer->WriteToOutputStringOn();
+    writer->Write();
+
+    buffer_length = writer->GetOutputStringLength();
+    buffer = writer->RegisterAndGetOutputString();
+
+    writer->Delete();
+    writer = 0;
+    }
 
   if (vtkMPIMoveData::UseZLibCompression)
     {
     vtkTimerLog::MarkStartEvent("Zlib compress");
     // Use z-lib compression.
-    uLongf out_size =compressBound(writer->GetOutputStringLength());
-    buffer = new char[out_size + 8]; 
-    memcpy(buffer, "zlib0000", 8);
+    uLongf out_size =compressBound(buffer_length);
+    char* compressed = new char[out_size + 8];
+    memcpy(compressed, "zlib0000", 8);
 
-    compress2(reinterpret_cast<Bytef*>(buffer + 8), 
+    compress2(reinterpret_cast<Bytef*>(compressed + 8),
       &out_size,
-      reinterpret_cast<const Bytef*>(writer->GetOutputString()),
-      writer->GetOutputStringLength(), /* compression_level */ Z_DEFAULT_COMPRESSION);
+      reinterpret_cast<const Bytef*>(buffer),
+      buffer_length, /* compression_level */ Z_DEFAULT_COMPRESSION);
     vtkTimerLog::MarkEndEvent("Zlib compress");
-    int in_size = static_cast<int>(writer->GetOutputStringLength());
+    int in_size = static_cast<int>(buffer_length);
     for (int cc=0; cc < 4; cc++)
       {
       // the first 4 bytes in the header are "zlib" which helps the receiver
       // identify that zlib compression has been used.
       // the next 4 bytes are the original length since zlib doesn't provide
       // that to the receiver.
-      buffer[4+cc] = (in_size & 0x0ff);
+      compressed[4+cc] = (in_size & 0x0ff);
       in_size = in_size >> 8;
       }
+    delete [] buffer;
+    buffer = compressed;
     buffer_length = out_size + 8;
     }
-  else
-    {
-    buffer_length = writer->GetOutputStringLength();
-    buffer = writer->RegisterAndGetOutputString();
-    }
 
   // Get string.
   this->NumberOfBuffers = 1;
@@ -1097,13 +1662,11 @@ void vtkMPIMoveData::MarshalDataToBuffer(vtkDataObject* data)
   this->BufferOffsets[0] = 0;
   this->Buffers = buffer;
   this->BufferTotalLength = this->BufferLengths[0];
-
-  writer->Delete();
-  writer = 0;
 }
 
 //-----------------------------------------------------------------------------
-void vtkMPIMoveData::ReconstructDataFromBuffer(vtkDataObject* data)
+void vtkMPIMoveData::ReconstructDataFromBuffer(vtkDataObject* data,
+  vtkCommunicator* com, int arrayTag, std::vector<vtkIdType>* arrayMessages)
 {
   if (this->NumberOfBuffers == 0 || this->Buffers == 0)
     {
@@ -1143,6 +1706,60 @@ void vtkMPIMoveData::ReconstructDataFromBuffer(vtkDataObject* data)
       bufferLength = uncompressed_length;
       }
 
+    if (bufferLength >= RAW_HEADER_SIZE && strncmp(bufferArray, "vtkr", 4) == 0)
+      {
+      vtkTimerLog::MarkStartEvent("Raw unmarshal");
+      vtkTypeUInt64 descriptor_length = 0;
+      for (int cc=7; cc >= 0; cc--)
+        {
+        descriptor_length = (descriptor_length << 8) |
+          (0xff & static_cast<unsigned char>(bufferArray[8+cc]));
+        }
+
+      vtkMPIMoveDataRawSource source;
+      if (bufferArray[4] & RAW_FLAG_DETACHED_ARRAYS)
+        {
+        source.Communicator = arrayMessages? com : NULL;
+        source.Tag = arrayTag;
+        source.MessageSizes = arrayMessages;
+        }
+      else
+        {
+        source.Buffer = bufferArray;
+        source.Length = bufferLength;
+        source.Position = RAW_HEADER_SIZE +
+          vtkMPIMoveDataPad8(static_cast<vtkIdType>(descriptor_length));
+        }
+
+      vtkMPIMoveDataRawDecoder decoder(&source);
+      decoder.Descriptor.SetRawData(
+        reinterpret_cast<const unsigned char*>(bufferArray + RAW_HEADER_SIZE),
+        static_cast<unsigned int>(descriptor_length));
+      vtkSmartPointer<vtkDataObject> piece;
+      if ((source.Buffer || source.Communicator) && decoder.ReadHeader())
+        {
+        piece = decoder.DecodeDataObject();
+        }
+      if (piece && decoder.Valid)
+        {
+        pieces.push_back(piece);
+        }
+      else
+        {
+        vtkErrorMacro("Failed to decode raw data buffer.");
+        }
+      if (source.MessageSizes)
+        {
+        // leave the messages not received for the caller to drain.
+        arrayMessages->erase(arrayMessages->begin(),
+          arrayMessages->begin() + source.NumberOfMessagesRead);
+        }
+      vtkTimerLog::MarkEndEvent("Raw unmarshal");
+      delete [] realBuffer;
+      realBuffer = 0;
+      continue;
+      }
+
     // Setup a reader.
     vtkDataReader *reader = vtkGenericDataObjectReader::New();
     reader->ReadFromInputStringOn();
@@ -1192,6 +1809,91 @@ void vtkMPIMoveData::ReconstructDataFromBuffer(vtkDataObject* data)
   vtkMPIMoveDataMerge(pieces, data);
 }
 
+//-----------------------------------------------------------------------------
+void vtkMPIMoveData::SendDataObject(
+  vtkCommunicator* com, vtkDataObject* data, int tag)
+{
+  std::vector<vtkDataArray*> arrays;
+  this->ClearBuffer();
+  this->MarshalDataToBuffer(data, &arrays);
+  com->Send(&(this->NumberOfBuffers), 1, 1, tag);
+  com->Send(this->BufferLengths, this->NumberOfBuffers, 1, tag+1);
+  com->Send(this->Buffers, this->BufferTotalLength, 1, tag+2);
+
+  // Announce the array messages, so that the receiver can drain all of them
+  // even when it fails to decode the data.
+  std::vector<vtkIdType> sizes;
+  for (size_t cc=0; cc < arrays.size(); cc++)
+    {
+    vtkIdType numBytes = vtkMPIMoveDataArrayBytes(arrays[cc]);
+    if (numBytes > 0)
+      {
+      sizes.push_back(numBytes);
+      }
+    }
+  vtkIdType numMessages = static_cast<vtkIdType>(sizes.size());
+  com->Send(&numMessages, 1, 1, tag+3);
+  if (numMessages > 0)
+    {
+    com->Send(&sizes[0], numMessages, 1, tag+3);
+    }
+
+  // Send raw array memory directly, without staging it in this->Buffers.
+  for (size_t cc=0; cc < arrays.size(); cc++)
+    {
+    vtkIdType numBytes = vtkMPIMoveDataArrayBytes(arrays[cc]);
+    if (numBytes > 0)
+      {
+      com->Send(static_cast<char*>(arrays[cc]->GetVoidPointer(0)), numBytes,
+        1, tag+3);
+      }
+    }
+  this->ClearBuffer();
+}
+
+//-----------------------------------------------------------------------------
+void vtkMPIMoveData::ReceiveDataObject(
+  vtkCommunicator* com, vtkDataObject* data, int tag)
+{
+  this->ClearBuffer();
+  com->Receive(&(this->NumberOfBuffers), 1, 1, tag);
+  this->BufferLengths = new vtkIdType[this->NumberOfBuffers];
+  com->Receive(this->BufferLengths, this->NumberOfBuffers, 1, tag+1);
+  // Compute additional buffer information.
+  this->BufferOffsets = new vtkIdType[this->NumberOfBuffers];
+  this->BufferTotalLength = 0;
+  for (int idx = 0; idx < this->NumberOfBuffers; ++idx)
+    {
+    this->BufferOffsets[idx] = this->BufferTotalLength;
+    this->BufferTotalLength += this->BufferLengths[idx];
+    }
+  this->Buffers = new char[this->BufferTotalLength];
+  com->Receive(this->Buffers, this->BufferTotalLength, 1, tag+2);
+
+  vtkIdType numMessages = 0;
+  com->Receive(&numMessages, 1, 1, tag+3);
+  std::vector<vtkIdType> sizes(numMessages > 0? numMessages : 0);
+  if (numMessages > 0)
+    {
+    com->Receive(&sizes[0], numMessages, 1, tag+3);
+    }
+
+  this->ReconstructDataFromBuffer(data, com, tag+3, &sizes);
+
+  // When decoding failed, array messages may be left. Receive them all, or
+  // they would be taken for the next transfer.
+  if (!sizes.empty())
+    {
+    std::vector<char> scratch;
+    for (size_t cc=0; cc < sizes.size(); cc++)
+      {
+      scratch.resize(static_cast<size_t>(sizes[cc]));
+      com->Receive(&scratch[0], sizes[cc], 1, tag+3);
+      }
+    }
+  this->ClearBuffer();
+}
+
 //-----------------------------------------------------------------------------
 void vtkMPIMoveData::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -25,7 +25,12 @@
 
 #include "vtkPVClientServerCoreRenderingModule.h" //needed for exports
 #include "vtkPassInputTypeAlgorithm.h"
+//BTX
+#include <vector> // needed for std::vector
+//ETX
 
+class vtkCommunicator;
+class vtkDataArray;
 class vtkMultiProcessController;
 class vtkSocketController;
 class vtkMPIMToNSocketConnection;
@@ -154,8 +159,40 @@ protected:
   vtkIdType  BufferTotalLength;
 
   void ClearBuffer();
-  void MarshalDataToBuffer(vtkDataObject* data);
-  void ReconstructDataFromBuffer(vtkDataObject* data);
+
+//BTX
+  // Description:
+  // Marshals \c data into this->Buffers. Polydata, unstructured grids, image
+  // data and multiblock/multipiece trees of those are encoded using a raw
+  // array-descriptor format (array type, tuples and components followed by
+  // the array memory); everything else goes through the legacy VTK writer.
+  // When \c detachedArrays is non-NULL and the raw format applies, the array
+  // payloads are not copied into the buffer. They are appended to
+  // \c detachedArrays instead and must be sent, in order, after the buffer.
+  void MarshalDataToBuffer(vtkDataObject* data,
+    std::vector<vtkDataArray*>* detachedArrays=NULL);
+
+  // Description:
+  // Reconstructs data from this->Buffers. When the buffers were marshaled
+  // with detached arrays, the array payloads are received from \c com using
+  // \c arrayTag, directly into the newly allocated arrays. \c arrayMessages
+  // holds the sizes of the array messages announced by the sender. The
+  // messages received are removed from it; the others are left for the
+  // caller to drain.
+  void ReconstructDataFromBuffer(vtkDataObject* data,
+    vtkCommunicator* com=NULL, int arrayTag=0,
+    std::vector<vtkIdType>* arrayMessages=NULL);
+//ETX
+
+  // Description:
+  // Point-to-point transfer over socket connections. The marshaled buffer is
+  // sent using tags \c tag, \c tag+1 and \c tag+2, and raw array payloads
+  // follow as separate messages on \c tag+3 without being copied into an
+  // intermediate buffer, after the number and sizes of these messages. The
+  // receiver takes every announced message off the connection, even when it
+  // fails to decode the data.
+  void SendDataObject(vtkCommunicator* com, vtkDataObject* data, int tag);
+  void ReceiveDataObject(vtkCommunicator* com, vtkDataObject* data, int tag);
 
   int MoveMode;
   int Server;
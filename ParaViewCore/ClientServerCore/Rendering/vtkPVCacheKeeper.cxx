@@ -23,24 +23,72 @@
 #include "vtkPVCacheKeeperPipeline.h"
 #include "vtkSmartPointer.h"
 
+#include <algorithm>
 #include <map>
+#include <vector>
 //----------------------------------------------------------------------------
-class vtkPVCacheKeeper::vtkCacheMap :
-  public std::map<double, vtkSmartPointer<vtkDataObject> >
+class vtkPVCacheKeeper::vtkCacheMap
 {
 public:
-  unsigned long GetActualMemorySize() 
+  struct vtkCacheEntry
+    {
+    vtkSmartPointer<vtkDataObject> Data;
+    unsigned long MemorySize;
+    vtkTypeUInt64 LastUsed;
+    };
+  typedef std::map<double, vtkCacheEntry> MapType;
+  MapType Entries;
+  vtkTypeUInt64 UseCounter;
+
+  vtkCacheMap() : UseCounter(0) {}
+
+  unsigned long GetActualMemorySize()
     {
     unsigned long actual_size = 0;
-    vtkCacheMap::iterator iter;
-    for (iter = this->begin(); iter != this->end(); ++iter)
+    MapType::iterator iter;
+    for (iter = this->Entries.begin(); iter != this->Entries.end(); ++iter)
       {
-      actual_size += iter->second.GetPointer()->GetActualMemorySize();
+      actual_size += iter->second.MemorySize;
       }
     return actual_size;
     }
+
+  // Description:
+  // Returns the entry to release according to the eviction policy, when
+  // caching data for time \c cacheTime.
+  MapType::iterator GetEvictionCandidate(int policy, double cacheTime)
+    {
+    MapType::iterator candidate = this->Entries.end();
+    double worst = 0.0;
+    MapType::iterator iter;
+    for (iter = this->Entries.begin(); iter != this->Entries.end(); ++iter)
+      {
+      double score;
+      if (policy == vtkCacheSizeKeeper::LEAST_RECENTLY_USED)
+        {
+        score = static_cast<double>(this->UseCounter - iter->second.LastUsed);
+        }
+      else
+        {
+        score = iter->first >= cacheTime?
+          (iter->first - cacheTime) : 2.0 * (cacheTime - iter->first);
+        }
+      if (candidate == this->Entries.end() || score > worst)
+        {
+        candidate = iter;
+        worst = score;
+        }
+      }
+    return candidate;
+    }
 };
 
+namespace
+{
+  // All cachers, in order of creation, which is the same on all processes.
+  std::vector<vtkPVCacheKeeper*> vtkPVCacheKeeperInstances;
+}
+
 vtkStandardNewMacro(vtkPVCacheKeeper);
 vtkCxxSetObjectMacro(vtkPVCacheKeeper, CacheSizeKeeper, vtkCacheSizeKeeper);
 //----------------------------------------------------------------------------
@@ -51,6 +99,7 @@ vtkPVCacheKeeper::vtkPVCacheKeeper()
   this->CachingEnabled = true; 
   this->CacheSizeKeeper = 0;
   this->SetCacheSizeKeeper(vtkCacheSizeKeeper::GetInstance());
+  vtkPVCacheKeeperInstances.push_back(this);
 }
 
 //----------------------------------------------------------------------------
@@ -63,6 +112,9 @@ vtkPVCacheKeeper::~vtkPVCacheKeeper()
 
   delete this->Cache;
   this->Cache = 0;
+
+  vtkPVCacheKeeperInstances.erase(std::find(vtkPVCacheKeeperInstances.begin(),
+      vtkPVCacheKeeperInstances.end(), this));
 }
 
 //----------------------------------------------------------------------------
@@ -70,7 +122,7 @@ void vtkPVCacheKeeper::RemoveAllCaches()
 {
   // cout << this << " RemoveAllCaches" << endl;
   unsigned long freed_size = this->Cache->GetActualMemorySize();
-  this->Cache->clear();
+  this->Cache->Entries.clear();
   if (freed_size > 0 && this->CacheSizeKeeper)
     {
     // Tell the cache size keeper about the newly freed memory size.
@@ -83,30 +135,78 @@ void vtkPVCacheKeeper::RemoveAllCaches()
 //----------------------------------------------------------------------------
 bool vtkPVCacheKeeper::IsCached(double cacheTime)
 {
-  vtkPVCacheKeeper::vtkCacheMap::iterator iter = this->Cache->find(cacheTime);
-  return (iter != this->Cache->end());
+  return this->Cache->Entries.find(cacheTime) != this->Cache->Entries.end();
 }
 
 //----------------------------------------------------------------------------
 bool vtkPVCacheKeeper::SaveData(vtkDataObject* output)
 {
-  if (!this->CacheSizeKeeper  || !this->CacheSizeKeeper->GetCacheFull())
+  // Once the cache is full, new data is only cached if old data may be
+  // released to make room for it, see ReleaseCachedData().
+  if (this->CacheSizeKeeper && this->CacheSizeKeeper->GetCacheFull() &&
+    this->CacheSizeKeeper->GetEvictionPolicy() ==
+    vtkCacheSizeKeeper::NO_EVICTION)
     {
-    vtkSmartPointer<vtkDataObject> cache;
-    cache.TakeReference(output->NewInstance());
-    cache->ShallowCopy(output);
-    (*this->Cache)[this->CacheTime] = cache;
+    return false;
+    }
 
-    if (this->CacheSizeKeeper)
+  vtkCacheMap::vtkCacheEntry& entry = this->Cache->Entries[this->CacheTime];
+  entry.Data.TakeReference(output->NewInstance());
+  entry.Data->ShallowCopy(output);
+  entry.MemorySize = entry.Data->GetActualMemorySize();
+  entry.LastUsed = ++this->Cache->UseCounter;
+
+  if (this->CacheSizeKeeper)
+    {
+    // Register used cache size.
+    this->CacheSizeKeeper->AddCacheSize(entry.MemorySize);
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVCacheKeeper::ReleaseEntry()
+{
+  if (this->Cache->Entries.empty() || !this->CacheSizeKeeper)
+    {
+    return false;
+    }
+  vtkCacheMap::MapType::iterator victim = this->Cache->GetEvictionCandidate(
+    this->CacheSizeKeeper->GetEvictionPolicy(), this->CacheTime);
+  this->CacheSizeKeeper->FreeCacheSize(victim->second.MemorySize);
+  this->Cache->Entries.erase(victim);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVCacheKeeper::HasCachedData(vtkCacheSizeKeeper* keeper)
+{
+  for (size_t cc=0; cc < vtkPVCacheKeeperInstances.size(); cc++)
+    {
+    vtkPVCacheKeeper* cacher = vtkPVCacheKeeperInstances[cc];
+    if (cacher->CacheSizeKeeper == keeper && !cacher->Cache->Entries.empty())
       {
-      // Register used cache size.
-      this->CacheSizeKeeper->AddCacheSize(cache->GetActualMemorySize());
+      return true;
       }
-    return true;
     }
   return false;
 }
 
+//----------------------------------------------------------------------------
+bool vtkPVCacheKeeper::ReleaseCachedData(vtkCacheSizeKeeper* keeper)
+{
+  bool released = false;
+  for (size_t cc=0; cc < vtkPVCacheKeeperInstances.size(); cc++)
+    {
+    vtkPVCacheKeeper* cacher = vtkPVCacheKeeperInstances[cc];
+    if (cacher->CacheSizeKeeper == keeper && cacher->ReleaseEntry())
+      {
+      released = true;
+      }
+    }
+  return released;
+}
+
 //----------------------------------------------------------------------------
 vtkExecutive* vtkPVCacheKeeper::CreateDefaultExecutive()
 {
@@ -160,9 +260,12 @@ int vtkPVCacheKeeper::RequestData(vtkInformation* vtkNotUsed(reqInfo),
 
   if (this->CachingEnabled)
     {
-    if (this->IsCached(this->CacheTime))
+    vtkCacheMap::MapType::iterator iter =
+      this->Cache->Entries.find(this->CacheTime);
+    if (iter != this->Cache->Entries.end())
       {
-      output->ShallowCopy((*this->Cache)[this->CacheTime]);
+      iter->second.LastUsed = ++this->Cache->UseCounter;
+      output->ShallowCopy(iter->second.Data);
       //cout << this << " using Cache: " << this->CacheTime << endl;
       }
     else
@@ -61,6 +61,18 @@ public:
   vtkGetMacro(CachingEnabled, bool);
   vtkBooleanMacro(CachingEnabled, bool);
 
+  // Description:
+  // Releases, in every cacher reporting to \c keeper, the entry that comes
+  // first for the keeper's eviction policy. Returns true if any entry was
+  // released. vtkPVView::Update() calls this, on all processes, until the
+  // cache fits in its limit again, so that all processes keep the same time
+  // steps cached.
+  static bool ReleaseCachedData(vtkCacheSizeKeeper* keeper);
+
+  // Description:
+  // Returns true if any cacher reporting to \c keeper holds cached data.
+  static bool HasCachedData(vtkCacheSizeKeeper* keeper);
+
 //BTX
 protected:
   vtkPVCacheKeeper();
@@ -83,6 +95,11 @@ protected:
   // false.
   bool SaveData(vtkDataObject*);
 
+  // Description:
+  // Releases the entry that comes first for the eviction policy. Returns
+  // false if there was none.
+  bool ReleaseEntry();
+
   bool CachingEnabled;
   double CacheTime;
   vtkCacheSizeKeeper* CacheSizeKeeper;
@@ -14,15 +14,179 @@
 =========================================================================*/
 #include "vtkPVClientServerSynchronizedRenderers.h"
 
+#include "vtkCompositeMultiProcessController.h"
+#include "vtkLZ4ImageCompressor.h"
 #include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
 #include "vtkOpenGLRenderer.h"
+#include "vtkSmartPointer.h"
 #include "vtkSquirtCompressor.h"
+#include "vtkTiledImageCompressor.h"
+#include "vtkTiledZlibImageCompressor.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkZlibImageCompressor.h"
 
+#include <algorithm>
+#include <map>
+#include <set>
 #include <vtksys/ios/sstream>
 #include <assert.h>
+#include <string.h>
+
+namespace
+{
+  // Tiles are numbered in row major order starting at the bottom-left corner
+  // of the image; the dirty tiles bitmap has one bit per tile.
+  inline bool vtkIsTileDirty(const unsigned char* bitmap, int tile)
+    {
+    return (bitmap[tile / 8] & (1 << (tile % 8))) != 0;
+    }
+
+  //----------------------------------------------------------------------------
+  // Compares each tile of current and previous, fills the bitmap and packs the
+  // pixels of the dirty tiles, tile after tile and row after row, in packed.
+  // Returns the number of dirty tiles.
+  int vtkPackDirtyTiles(const unsigned char* current,
+    const unsigned char* previous, int width, int height, int numComps,
+    int tileSize, vtkUnsignedCharArray* bitmap, vtkUnsignedCharArray* packed)
+    {
+    const int numTilesX = (width + tileSize - 1) / tileSize;
+    const int numTilesY = (height + tileSize - 1) / tileSize;
+    const vtkIdType rowBytes = static_cast<vtkIdType>(width) * numComps;
+    bitmap->SetNumberOfComponents(1);
+    bitmap->SetNumberOfTuples((numTilesX * numTilesY + 7) / 8);
+    memset(bitmap->GetPointer(0), 0, bitmap->GetNumberOfTuples());
+    unsigned char* bits = bitmap->GetPointer(0);
+
+    int numDirty = 0;
+    vtkIdType numDirtyPixels = 0;
+    for (int ty=0, tile=0; ty < numTilesY; ty++)
+      {
+      const int y0 = ty * tileSize;
+      const int y1 = std::min(height, y0 + tileSize);
+      for (int tx=0; tx < numTilesX; tx++, tile++)
+        {
+        const int x0 = tx * tileSize;
+        const int x1 = std::min(width, x0 + tileSize);
+        const vtkIdType offset = static_cast<vtkIdType>(x0) * numComps;
+        const size_t length = static_cast<size_t>(x1 - x0) * numComps;
+        for (int y=y0; y < y1; y++)
+          {
+          if (memcmp(current + y * rowBytes + offset,
+              previous + y * rowBytes + offset, length) != 0)
+            {
+            bits[tile / 8] |= static_cast<unsigned char>(1 << (tile % 8));
+            numDirty++;
+            numDirtyPixels += static_cast<vtkIdType>(x1 - x0) * (y1 - y0);
+            break;
+            }
+          }
+        }
+      }
+
+    packed->SetNumberOfComponents(numComps);
+    packed->SetNumberOfTuples(numDirtyPixels);
+    unsigned char* out = packed->GetPointer(0);
+    for (int ty=0, tile=0; ty < numTilesY; ty++)
+      {
+      const int y0 = ty * tileSize;
+      const int y1 = std::min(height, y0 + tileSize);
+      for (int tx=0; tx < numTilesX; tx++, tile++)
+        {
+        if (!vtkIsTileDirty(bits, tile))
+          {
+          continue;
+          }
+        const int x0 = tx * tileSize;
+        const int x1 = std::min(width, x0 + tileSize);
+        const vtkIdType offset = static_cast<vtkIdType>(x0) * numComps;
+        const size_t length = static_cast<size_t>(x1 - x0) * numComps;
+        for (int y=y0; y < y1; y++, out += length)
+          {
+          memcpy(out, current + y * rowBytes + offset, length);
+          }
+        }
+      }
+    return numDirty;
+    }
+
+  //----------------------------------------------------------------------------
+  vtkIdType vtkCountDirtyPixels(const unsigned char* bits, int width,
+    int height, int tileSize)
+    {
+    const int numTilesX = (width + tileSize - 1) / tileSize;
+    const int numTilesY = (height + tileSize - 1) / tileSize;
+    vtkIdType numPixels = 0;
+    for (int ty=0, tile=0; ty < numTilesY; ty++)
+      {
+      const int th = std::min(height, (ty + 1) * tileSize) - ty * tileSize;
+      for (int tx=0; tx < numTilesX; tx++, tile++)
+        {
+        if (vtkIsTileDirty(bits, tile))
+          {
+          const int tw = std::min(width, (tx + 1) * tileSize) - tx * tileSize;
+          numPixels += static_cast<vtkIdType>(tw) * th;
+          }
+        }
+      }
+    return numPixels;
+    }
+
+  //----------------------------------------------------------------------------
+  // Inverse of vtkPackDirtyTiles: copies the packed tiles into the image.
+  void vtkUnpackDirtyTiles(unsigned char* image, int width, int height,
+    int numComps, int tileSize, const unsigned char* bits,
+    const unsigned char* packed)
+    {
+    const int numTilesX = (width + tileSize - 1) / tileSize;
+    const int numTilesY = (height + tileSize - 1) / tileSize;
+    const vtkIdType rowBytes = static_cast<vtkIdType>(width) * numComps;
+    for (int ty=0, tile=0; ty < numTilesY; ty++)
+      {
+      const int y0 = ty * tileSize;
+      const int y1 = std::min(height, y0 + tileSize);
+      for (int tx=0; tx < numTilesX; tx++, tile++)
+        {
+        if (!vtkIsTileDirty(bits, tile))
+          {
+          continue;
+          }
+        const int x0 = tx * tileSize;
+        const int x1 = std::min(width, x0 + tileSize);
+        const vtkIdType offset = static_cast<vtkIdType>(x0) * numComps;
+        const size_t length = static_cast<size_t>(x1 - x0) * numComps;
+        for (int y=y0; y < y1; y++, packed += length)
+          {
+          memcpy(image + y * rowBytes + offset, packed, length);
+          }
+        }
+      }
+    }
+}
+
+class vtkPVClientServerSynchronizedRenderers::vtkInternals
+{
+public:
+  // The last image delivered to a destination: the reference for the next
+  // delta sent to it.
+  struct LastImageType
+    {
+    vtkSmartPointer<vtkUnsignedCharArray> Image;
+    int Size[2];
+    bool LossLess;
+    };
+  std::map<int, LastImageType> LastImages;
+
+  // The destinations images were sent to, pruned as clients disconnect.
+  std::set<int> Destinations;
+
+  LastImageType* GetLastImage(int destination)
+    {
+    std::map<int, LastImageType>::iterator iter =
+      this->LastImages.find(destination);
+    return iter != this->LastImages.end()? &iter->second : NULL;
+    }
+};
 
 vtkStandardNewMacro(vtkPVClientServerSynchronizedRenderers);
 vtkCxxSetObjectMacro(vtkPVClientServerSynchronizedRenderers, Compressor,
@@ -33,14 +197,87 @@ vtkPVClientServerSynchronizedRenderers::vtkPVClientServerSynchronizedRenderers()
   this->Compressor = NULL;
   this->ConfigureCompressor("vtkSquirtCompressor 0 3");
   this->LossLessCompression = true;
+  this->ImageDeltaTileSize = 0;
+  this->Internals = new vtkInternals();
+  this->FullImageRequested = false;
 }
 
 //----------------------------------------------------------------------------
 vtkPVClientServerSynchronizedRenderers::~vtkPVClientServerSynchronizedRenderers()
 {
   this->SetCompressor(NULL);
+  delete this->Internals;
 }
 
+//----------------------------------------------------------------------------
+void vtkPVClientServerSynchronizedRenderers::SetImageDeltaTileSize(int size)
+{
+  size = size > 0? size : 0;
+  if (this->ImageDeltaTileSize != size)
+    {
+    this->ImageDeltaTileSize = size;
+    // the next images must be sent in full.
+    this->Internals->LastImages.clear();
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkPVClientServerSynchronizedRenderers::GetImageDestination()
+{
+  // on the server, each collaboration client has its own controller.
+  vtkCompositeMultiProcessController* controller =
+    vtkCompositeMultiProcessController::SafeDownCast(this->ParallelController);
+  return controller? controller->GetActiveControllerID() : 0;
+}
+
+//----------------------------------------------------------------------------
+vtkTiledImageCompressor*
+vtkPVClientServerSynchronizedRenderers::GetDeltaCompressor()
+{
+  vtkTiledImageCompressor* compressor =
+    vtkTiledImageCompressor::SafeDownCast(this->Compressor);
+  return (compressor && compressor->GetDeltaMode())? compressor : NULL;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVClientServerSynchronizedRenderers::GetFullImageRequestsEnabled()
+{
+  return this->ImageDeltaTileSize > 0 || this->GetDeltaCompressor() != NULL;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVClientServerSynchronizedRenderers::MasterStartRender()
+{
+  this->Superclass::MasterStartRender();
+  if (this->GetFullImageRequestsEnabled())
+    {
+    // tell the server whether the client lost its reference image.
+    int fullImage = this->FullImageRequested? 1 : 0;
+    this->ParallelController->Send(&fullImage, 1, 1, 0x023431);
+    this->FullImageRequested = false;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVClientServerSynchronizedRenderers::SlaveStartRender()
+{
+  this->Superclass::SlaveStartRender();
+  if (this->GetFullImageRequestsEnabled())
+    {
+    int fullImage = 0;
+    this->ParallelController->Receive(&fullImage, 1, 0, 0x023431);
+    if (fullImage)
+      {
+      this->DropLastImage();
+      if (vtkTiledImageCompressor* compressor = this->GetDeltaCompressor())
+        {
+        compressor->SetDestination(this->GetImageDestination());
+        compressor->ResetDelta();
+        }
+      }
+    }
+}
 
 //----------------------------------------------------------------------------
 void vtkPVClientServerSynchronizedRenderers::MasterEndRender()
@@ -57,18 +294,40 @@ void vtkPVClientServerSynchronizedRenderers::MasterEndRender()
   if (header[0] > 0)
     {
     rawImage.Resize(header[1], header[2], header[3]);
-    if (this->Compressor)
+    bool valid = true;
+    if (header[0] == 2)
+      {
+      valid = this->ReceiveImageDelta(rawImage);
+      if (!valid)
+        {
+        vtkErrorMacro("Failed to apply image delta.");
+        }
+      }
+    else if (this->Compressor)
       {
       vtkUnsignedCharArray* data = vtkUnsignedCharArray::New();
       this->ParallelController->Receive(data, 1, 0x023430);
-      this->Decompress(data, rawImage.GetRawPtr());
+      valid = this->Decompress(data, rawImage.GetRawPtr());
       data->Delete();
       }
     else
       {
       this->ParallelController->Receive(rawImage.GetRawPtr(), 1, 0x023430);
       }
-    rawImage.MarkValid();
+
+    if (valid)
+      {
+      rawImage.MarkValid();
+      this->SaveLastImage(rawImage);
+      }
+    else
+      {
+      // nothing to show, and no reference for the next delta: ask the server
+      // for a full image on the next render.
+      rawImage.MarkInValid();
+      this->DropLastImage();
+      this->FullImageRequested = this->GetFullImageRequestsEnabled();
+      }
     }
 }
 
@@ -80,8 +339,16 @@ void vtkPVClientServerSynchronizedRenderers::SlaveEndRender()
 
   vtkRawImage &rawImage = this->CaptureRenderedImage();
 
+  this->PruneImageHistories();
+  this->Internals->Destinations.insert(this->GetImageDestination());
+
+  vtkUnsignedCharArray* dirtyTiles = vtkUnsignedCharArray::New();
+  vtkUnsignedCharArray* tileData = vtkUnsignedCharArray::New();
+  bool sendDelta = rawImage.IsValid() &&
+    this->ComputeImageDelta(rawImage, dirtyTiles, tileData);
+
   int header[4];
-  header[0] = rawImage.IsValid()? 1 : 0;
+  header[0] = rawImage.IsValid()? (sendDelta? 2 : 1) : 0;
   header[1] = rawImage.GetWidth();
   header[2] = rawImage.GetHeight();
   header[3] = rawImage.IsValid()?
@@ -89,11 +356,211 @@ void vtkPVClientServerSynchronizedRenderers::SlaveEndRender()
 
   // send the image to the client.
   this->ParallelController->Send(header, 4, 1, 0x023430);
-  if (rawImage.IsValid())
+  if (sendDelta)
+    {
+    // when no tile changed, there is nothing to compress.
+    this->ParallelController->Send(dirtyTiles, 1, 0x023430);
+    this->ParallelController->Send(tileData->GetNumberOfTuples() > 0?
+      this->Compress(tileData) : tileData, 1, 0x023430);
+    }
+  else if (rawImage.IsValid())
     {
     this->ParallelController->Send(
       this->Compress(rawImage.GetRawPtr()), 1, 0x023430);
     }
+  if (rawImage.IsValid())
+    {
+    this->SaveLastImage(rawImage);
+    }
+  dirtyTiles->Delete();
+  tileData->Delete();
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVClientServerSynchronizedRenderers::EncodeImageDelta(
+  vtkUnsignedCharArray* current, vtkUnsignedCharArray* previous, int width,
+  int height, int tileSize, vtkUnsignedCharArray* dirtyTiles,
+  vtkUnsignedCharArray* tileData)
+{
+  if (tileSize <= 0 || width <= 0 || height <= 0 ||
+    previous->GetNumberOfComponents() != current->GetNumberOfComponents() ||
+    previous->GetNumberOfTuples() != current->GetNumberOfTuples() ||
+    current->GetNumberOfTuples() != static_cast<vtkIdType>(width) * height)
+    {
+    return false;
+    }
+
+  const int numTiles =
+    ((width + tileSize - 1) / tileSize) * ((height + tileSize - 1) / tileSize);
+  int numDirty = vtkPackDirtyTiles(current->GetPointer(0),
+    previous->GetPointer(0), width, height, current->GetNumberOfComponents(),
+    tileSize, dirtyTiles, tileData);
+  return numDirty < numTiles;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVClientServerSynchronizedRenderers::DecodeImageDelta(
+  vtkUnsignedCharArray* previous, int width, int height, int tileSize,
+  vtkUnsignedCharArray* dirtyTiles, vtkUnsignedCharArray* tileData,
+  vtkUnsignedCharArray* output)
+{
+  const int numComps = output->GetNumberOfComponents();
+  if (tileSize <= 0 || width <= 0 || height <= 0 ||
+    previous->GetNumberOfComponents() != numComps ||
+    previous->GetNumberOfTuples() != static_cast<vtkIdType>(width) * height)
+    {
+    return false;
+    }
+  const int numTiles =
+    ((width + tileSize - 1) / tileSize) * ((height + tileSize - 1) / tileSize);
+  if (dirtyTiles->GetNumberOfTuples() != (numTiles + 7) / 8 ||
+    tileData->GetNumberOfTuples() != vtkCountDirtyPixels(
+      dirtyTiles->GetPointer(0), width, height, tileSize) ||
+    (tileData->GetNumberOfTuples() > 0 &&
+     tileData->GetNumberOfComponents() != numComps))
+    {
+    return false;
+    }
+
+  output->SetNumberOfTuples(previous->GetNumberOfTuples());
+  memcpy(output->GetPointer(0), previous->GetPointer(0),
+    previous->GetNumberOfTuples() * numComps);
+  vtkUnpackDirtyTiles(output->GetPointer(0), width, height, numComps,
+    tileSize, dirtyTiles->GetPointer(0), tileData->GetPointer(0));
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVClientServerSynchronizedRenderers::ComputeImageDelta(
+  vtkRawImage& image, vtkUnsignedCharArray* dirtyTiles,
+  vtkUnsignedCharArray* tileData)
+{
+  vtkInternals::LastImageType* last =
+    this->Internals->GetLastImage(this->GetImageDestination());
+  if (this->ImageDeltaTileSize <= 0 || last == NULL ||
+    last->Size[0] != image.GetWidth() || last->Size[1] != image.GetHeight())
+    {
+    return false;
+    }
+
+  // After lossy interactive renders, the client's copy differs from ours;
+  // a still render must then replace the whole image.
+  if (this->LossLessCompression && !last->LossLess)
+    {
+    return false;
+    }
+
+  return vtkPVClientServerSynchronizedRenderers::EncodeImageDelta(
+    image.GetRawPtr(), last->Image, image.GetWidth(), image.GetHeight(),
+    this->ImageDeltaTileSize, dirtyTiles, tileData);
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVClientServerSynchronizedRenderers::ReceiveImageDelta(
+  vtkRawImage& image)
+{
+  vtkUnsignedCharArray* dirtyTiles = vtkUnsignedCharArray::New();
+  vtkUnsignedCharArray* tileData = vtkUnsignedCharArray::New();
+  this->ParallelController->Receive(dirtyTiles, 1, 0x023430);
+
+  vtkUnsignedCharArray* output = image.GetRawPtr();
+  const int tileSize = this->ImageDeltaTileSize;
+  const int numTiles = tileSize > 0 ?
+    ((image.GetWidth() + tileSize - 1) / tileSize) *
+    ((image.GetHeight() + tileSize - 1) / tileSize) : 0;
+  vtkInternals::LastImageType* last =
+    this->Internals->GetLastImage(this->GetImageDestination());
+  bool valid = (tileSize > 0 && last != NULL &&
+    last->Size[0] == image.GetWidth() &&
+    last->Size[1] == image.GetHeight() &&
+    dirtyTiles->GetNumberOfTuples() == (numTiles + 7) / 8);
+
+  // the server sends the tiles as long as the bitmap is well formed, whether
+  // or not we can apply them.
+  vtkIdType numPixels = (tileSize > 0 &&
+    dirtyTiles->GetNumberOfTuples() == (numTiles + 7) / 8)?
+    vtkCountDirtyPixels(dirtyTiles->GetPointer(0), image.GetWidth(),
+      image.GetHeight(), tileSize) : 0;
+  if (this->Compressor && numPixels > 0)
+    {
+    vtkUnsignedCharArray* data = vtkUnsignedCharArray::New();
+    this->ParallelController->Receive(data, 1, 0x023430);
+    tileData->SetNumberOfComponents(output->GetNumberOfComponents());
+    tileData->SetNumberOfTuples(numPixels);
+    valid = this->Decompress(data, tileData) && valid;
+    data->Delete();
+    }
+  else
+    {
+    // uncompressed tiles, or the empty payload sent when no tile changed.
+    this->ParallelController->Receive(tileData, 1, 0x023430);
+    }
+
+  valid = valid && vtkPVClientServerSynchronizedRenderers::DecodeImageDelta(
+    last->Image, image.GetWidth(), image.GetHeight(), tileSize, dirtyTiles,
+    tileData, output);
+  dirtyTiles->Delete();
+  tileData->Delete();
+  return valid;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVClientServerSynchronizedRenderers::DropLastImage()
+{
+  this->Internals->LastImages.erase(this->GetImageDestination());
+}
+
+//----------------------------------------------------------------------------
+void vtkPVClientServerSynchronizedRenderers::SaveLastImage(vtkRawImage& image)
+{
+  if (this->ImageDeltaTileSize > 0)
+    {
+    vtkInternals::LastImageType& last =
+      this->Internals->LastImages[this->GetImageDestination()];
+    if (!last.Image)
+      {
+      last.Image = vtkSmartPointer<vtkUnsignedCharArray>::New();
+      }
+    last.Image->DeepCopy(image.GetRawPtr());
+    last.Size[0] = image.GetWidth();
+    last.Size[1] = image.GetHeight();
+    last.LossLess = this->LossLessCompression;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVClientServerSynchronizedRenderers::PruneImageHistories()
+{
+  vtkCompositeMultiProcessController* controller =
+    vtkCompositeMultiProcessController::SafeDownCast(this->ParallelController);
+  if (!controller)
+    {
+    return;
+    }
+  std::set<int> connected;
+  for (int cc=0; cc < controller->GetNumberOfControllers(); cc++)
+    {
+    connected.insert(controller->GetControllerId(cc));
+    }
+
+  vtkTiledImageCompressor* compressor =
+    vtkTiledImageCompressor::SafeDownCast(this->Compressor);
+  std::set<int>::iterator iter = this->Internals->Destinations.begin();
+  while (iter != this->Internals->Destinations.end())
+    {
+    if (connected.find(*iter) != connected.end())
+      {
+      ++iter;
+      continue;
+      }
+    this->Internals->LastImages.erase(*iter);
+    if (compressor)
+      {
+      compressor->SetDestination(*iter);
+      compressor->ResetDelta();
+      }
+    this->Internals->Destinations.erase(iter++);
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -102,6 +569,10 @@ vtkUnsignedCharArray* vtkPVClientServerSynchronizedRenderers::Compress(
 {
   if (this->Compressor)
     {
+    if (vtkTiledImageCompressor* compressor = this->GetDeltaCompressor())
+      {
+      compressor->SetDestination(this->GetImageDestination());
+      }
     this->Compressor->SetLossLessMode(this->LossLessCompression);
     this->Compressor->SetInput(data);
     if (this->Compressor->Compress() == 0)
@@ -116,7 +587,7 @@ vtkUnsignedCharArray* vtkPVClientServerSynchronizedRenderers::Compress(
 }
 
 //----------------------------------------------------------------------------
-void vtkPVClientServerSynchronizedRenderers::Decompress(
+bool vtkPVClientServerSynchronizedRenderers::Decompress(
   vtkUnsignedCharArray* data, vtkUnsignedCharArray* outputBuffer)
 {
   if (this->Compressor)
@@ -127,12 +598,13 @@ void vtkPVClientServerSynchronizedRenderers::Decompress(
     if (this->Compressor->Decompress() == 0)
       {
       vtkErrorMacro("Image de-compression failed!");
+      return false;
       }
+    return true;
     }
-  else
-    {
-    vtkErrorMacro("No compressor present.");
-    }
+
+  vtkErrorMacro("No compressor present.");
+  return false;
 }
 
 
@@ -161,6 +633,14 @@ void vtkPVClientServerSynchronizedRenderers::ConfigureCompressor(const char *str
       {
       comp=vtkZlibImageCompressor::New();
       }
+    else if (className=="vtkLZ4ImageCompressor")
+      {
+      comp=vtkLZ4ImageCompressor::New();
+      }
+    else if (className=="vtkTiledZlibImageCompressor")
+      {
+      comp=vtkTiledZlibImageCompressor::New();
+      }
     else if (className=="NULL")
       {
       this->SetCompressor(0);
@@ -209,4 +689,6 @@ void vtkPVClientServerSynchronizedRenderers::PushImageToScreen()
 void vtkPVClientServerSynchronizedRenderers::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "LossLessCompression: " << this->LossLessCompression << endl;
+  os << indent << "ImageDeltaTileSize: " << this->ImageDeltaTileSize << endl;
 }
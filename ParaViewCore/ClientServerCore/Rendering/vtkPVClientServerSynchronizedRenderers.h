@@ -17,6 +17,13 @@
 // vtkPVClientServerSynchronizedRenderers is similar to
 // vtkClientServerSynchronizedRenderers except that it optionally uses image
 // compressors to compress the image before transmitting.
+//
+// When ImageDeltaTileSize is set, consecutive images of the same size are
+// delivered as deltas: only the tiles that changed since the last delivered
+// image are compressed and sent, together with a bitmap of the dirty tiles,
+// and the client patches its cached copy of the previous image. On a
+// collaboration server, the previous image is kept separately for each
+// client, since each of them only receives the images rendered for it.
 
 #ifndef __vtkPVClientServerSynchronizedRenderers_h
 #define __vtkPVClientServerSynchronizedRenderers_h
@@ -25,6 +32,7 @@
 #include "vtkSynchronizedRenderers.h"
 
 class vtkImageCompressor;
+class vtkTiledImageCompressor;
 class vtkUnsignedCharArray;
 
 class VTKPVCLIENTSERVERCORERENDERING_EXPORT vtkPVClientServerSynchronizedRenderers : public vtkSynchronizedRenderers
@@ -47,6 +55,34 @@ public:
   // user settings.
   virtual void ConfigureCompressor(const char *stream);
 
+  // Description:
+  // When set to a positive value, the image is split into square tiles of
+  // ImageDeltaTileSize pixels and, when the previous image delivered had the
+  // same size, only the tiles that changed are sent to the client. 0 (default)
+  // disables delta delivery. Must be set identically on the client and the
+  // server.
+  void SetImageDeltaTileSize(int size);
+  vtkGetMacro(ImageDeltaTileSize, int);
+
+  // Description:
+  // Fills \c dirtyTiles, one bit per tile of \c tileSize pixels, with the
+  // tiles of \c current that differ from \c previous, two images of \c width
+  // x \c height pixels, and packs the pixels of these tiles in \c tileData.
+  // Returns false when a full image must be sent instead, i.e. when the
+  // images do not match in size or every tile changed.
+  static bool EncodeImageDelta(vtkUnsignedCharArray* current,
+    vtkUnsignedCharArray* previous, int width, int height, int tileSize,
+    vtkUnsignedCharArray* dirtyTiles, vtkUnsignedCharArray* tileData);
+
+  // Description:
+  // Inverse of EncodeImageDelta(): fills \c output with \c previous patched
+  // with the tiles in \c dirtyTiles and \c tileData. \c output must have the
+  // number of components of the image. Returns false when the delta does not
+  // apply to \c previous.
+  static bool DecodeImageDelta(vtkUnsignedCharArray* previous, int width,
+    int height, int tileSize, vtkUnsignedCharArray* dirtyTiles,
+    vtkUnsignedCharArray* tileData, vtkUnsignedCharArray* output);
+
 //BTX
 protected:
   vtkPVClientServerSynchronizedRenderers();
@@ -64,14 +100,76 @@ protected:
   vtkGetObjectMacro(Compressor,vtkImageCompressor);
 
   vtkUnsignedCharArray* Compress(vtkUnsignedCharArray*);
-  void Decompress(vtkUnsignedCharArray* input, vtkUnsignedCharArray* outputBuffer);
+
+  // Description:
+  // Returns false if the image could not be decompressed.
+  bool Decompress(vtkUnsignedCharArray* input, vtkUnsignedCharArray* outputBuffer);
+
+  // Description:
+  // Identifies the client an image is sent to: the active client on a
+  // collaboration server, 0 otherwise.
+  int GetImageDestination();
+
+  // Description:
+  // Returns the compressor when it encodes frames as deltas, NULL otherwise.
+  vtkTiledImageCompressor* GetDeltaCompressor();
+
+  // Description:
+  // Returns true when images depend on the previous ones, either through
+  // ImageDeltaTileSize or a compressor in delta mode. The client then tells
+  // the server, on every render, whether it needs a full image.
+  bool GetFullImageRequestsEnabled();
+
+  // Description:
+  // Overridden to let the server know when the client needs a full image
+  // because it could not decode the previous one.
+  virtual void MasterStartRender();
+  virtual void SlaveStartRender();
 
   virtual void MasterEndRender();
   virtual void SlaveEndRender();
 
+  // Description:
+  // Fills \c dirtyTiles and \c tileData with the tiles of \c image that differ
+  // from the last image delivered to the current destination. Returns false
+  // when a full image must be sent instead.
+  bool ComputeImageDelta(vtkRawImage& image,
+    vtkUnsignedCharArray* dirtyTiles, vtkUnsignedCharArray* tileData);
+
+  // Description:
+  // Receives the dirty tiles sent by the server and patches them over a copy
+  // of the last image received in \c image. Returns false, after receiving all the
+  // messages of the delta, if it could not be applied.
+  bool ReceiveImageDelta(vtkRawImage& image);
+
+  // Description:
+  // Keeps a copy of \c image as the reference for the next delta to the
+  // current destination.
+  void SaveLastImage(vtkRawImage& image);
+
+  // Description:
+  // Forgets the last image of the current destination, so that the next
+  // image sent to it is in full.
+  void DropLastImage();
+
+  // Description:
+  // Forgets the images, and the compressor history, kept for the
+  // collaboration clients that are no longer connected.
+  void PruneImageHistories();
+
   vtkImageCompressor* Compressor;
   bool LossLessCompression;
+
+  int ImageDeltaTileSize;
+
+  // Description:
+  // Set on the client when the last image could not be decoded, to request
+  // a full image on the next render.
+  bool FullImageRequested;
 private:
+  class vtkInternals;
+  vtkInternals* Internals;
+
   vtkPVClientServerSynchronizedRenderers(const vtkPVClientServerSynchronizedRenderers&); // Not implemented
   void operator=(const vtkPVClientServerSynchronizedRenderers&); // Not implemented
 //ETX
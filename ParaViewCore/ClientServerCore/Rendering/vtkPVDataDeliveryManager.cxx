@@ -27,6 +27,7 @@
 #include "vtkPVDataRepresentation.h"
 #include "vtkPVRenderView.h"
 #include "vtkPVStreamingMacros.h"
+#include "vtkPVTraceRecorder.h"
 #include "vtkPVTrivialProducer.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
@@ -501,6 +502,13 @@ void vtkPVDataDeliveryManager::Deliver(int use_lod, unsigned int size, unsigned
 
     vtkDataObject* data = item->GetDataObject();
 
+    vtkPVTraceSpan span(use_lod? "Deliver LOD" : "Deliver",
+      item->Representation.GetPointer());
+    if (span.IsActive() && data)
+      {
+      span.SetBytes(static_cast<vtkTypeInt64>(data->GetActualMemorySize()) * 1024);
+      }
+
 //    if (data != NULL && data->IsA("vtkUniformGridAMR"))
 //      {
 //      // we are dealing with AMR datasets.
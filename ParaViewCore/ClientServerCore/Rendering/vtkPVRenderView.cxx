@@ -57,6 +57,7 @@
 #include "vtkPVStreamingMacros.h"
 #include "vtkPVSynchronizedRenderer.h"
 #include "vtkPVSynchronizedRenderWindows.h"
+#include "vtkPVTraceRecorder.h"
 #include "vtkPVTrackballMultiRotate.h"
 #include "vtkPVTrackballRoll.h"
 #include "vtkPVTrackballRotate.h"
@@ -85,7 +86,9 @@
 #include "vtkPistonMapper.h"
 #endif
 
+#include <algorithm>
 #include <assert.h>
+#include <math.h>
 #include <vector>
 #include <set>
 #include <map>
@@ -179,6 +182,13 @@ vtkPVRenderView::vtkPVRenderView()
   this->RemoteRenderingThreshold = 0;
   this->LODRenderingThreshold = 0;
   this->LODResolution = 0.5;
+  this->LODFrameBudget = 0.0;
+  this->SuggestedLODResolution = -1.0;
+  for (int cc = 0; cc < 9; cc++)
+    {
+    this->ResetCameraState[cc] = 0.0;
+    }
+  this->InteractiveLODResolution = -1.0;
   this->UseOutlineForLODRendering = false;
   this->UseLightKit = false;
   this->Interactor = 0;
@@ -885,6 +895,7 @@ void vtkPVRenderView::ResetCamera()
   double bounds[6];
   this->GeometryBounds.GetBounds(bounds);
   this->RenderView->GetRenderer()->ResetCamera(bounds);
+  this->RecordResetCamera(bounds);
 
   this->InvokeEvent(vtkCommand::ResetCameraEvent);
 }
@@ -896,9 +907,53 @@ void vtkPVRenderView::ResetCamera(double bounds[6])
   // Remember, vtkRenderer::ResetCamera() calls
   // vtkRenderer::ResetCameraClippingPlanes() with the given bounds.
   this->RenderView->GetRenderer()->ResetCamera(bounds);
+  this->RecordResetCamera(bounds);
   this->InvokeEvent(vtkCommand::ResetCameraEvent);
 }
 
+//----------------------------------------------------------------------------
+void vtkPVRenderView::RecordResetCamera(const double bounds[6])
+{
+  this->ResetCameraBounds.Reset();
+  this->ResetCameraBounds.AddBounds(const_cast<double*>(bounds));
+  vtkCamera* camera = this->GetActiveCamera();
+  camera->GetPosition(this->ResetCameraState);
+  camera->GetFocalPoint(this->ResetCameraState + 3);
+  camera->GetViewUp(this->ResetCameraState + 6);
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVRenderView::GetNeedsStreamingCameraRefit()
+{
+  if (!this->ResetCameraBounds.IsValid() || !this->GeometryBounds.IsValid())
+    {
+    return false;
+    }
+  vtkBoundingBox bbox(this->ResetCameraBounds);
+  bbox.AddBox(this->GeometryBounds);
+  if (bbox == this->ResetCameraBounds)
+    {
+    return false;
+    }
+
+  // The camera must still be where ResetCamera() put it, the user may have
+  // framed something else since.
+  double state[9];
+  vtkCamera* camera = this->GetActiveCamera();
+  camera->GetPosition(state);
+  camera->GetFocalPoint(state + 3);
+  camera->GetViewUp(state + 6);
+  double scale = std::max(1.0, this->ResetCameraBounds.GetMaxLength());
+  for (int cc = 0; cc < 9; cc++)
+    {
+    if (fabs(state[cc] - this->ResetCameraState[cc]) > 1e-6 * scale)
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 bool vtkPVRenderView::TestCollaborationCounter()
 {
@@ -1009,6 +1064,7 @@ void vtkPVRenderView::SynchronizeForCollaboration()
 void vtkPVRenderView::Update()
 {
   vtkTimerLog::MarkStartEvent("RenderView::Update");
+  vtkPVTraceSpan span("RenderView::Update", this);
 
   // reset the bounds, so that representations can provide us with bounds
   // information during update.
@@ -1102,10 +1158,17 @@ void vtkPVRenderView::CopyViewUpdateOptions(vtkPVRenderView* otherView)
 void vtkPVRenderView::UpdateLOD()
 {
   vtkTimerLog::MarkStartEvent("RenderView::UpdateLOD");
+  vtkPVTraceSpan span("RenderView::UpdateLOD", this);
 
   // Update LOD geometry.
 
-  this->RequestInformation->Set(LOD_RESOLUTION(), this->LODResolution);
+  double resolution = this->LODResolution;
+  if (this->InteractiveLODResolution >= 0.0 &&
+    this->InteractiveLODResolution < resolution)
+    {
+    resolution = this->InteractiveLODResolution;
+    }
+  this->RequestInformation->Set(LOD_RESOLUTION(), resolution);
   if (this->UseOutlineForLODRendering)
     {
     this->RequestInformation->Set(USE_OUTLINE_FOR_LOD(), 1);
@@ -1142,6 +1205,7 @@ void vtkPVRenderView::UpdateLOD()
 void vtkPVRenderView::StillRender()
 {
   vtkTimerLog::MarkStartEvent("Still Render");
+  vtkPVTraceSpan span("Still Render", this);
   this->GetRenderWindow()->SetDesiredUpdateRate(0.002);
 
   this->Internals->PreRender(this->RenderView);
@@ -1155,15 +1219,55 @@ void vtkPVRenderView::StillRender()
 void vtkPVRenderView::InteractiveRender()
 {
   vtkTimerLog::MarkStartEvent("Interactive Render");
+  vtkPVTraceSpan span("Interactive Render", this);
   this->GetRenderWindow()->SetDesiredUpdateRate(5.0);
 
   this->Internals->PreRender(this->RenderView);
 
+  // Time the whole render, compositing and image delivery included, which is
+  // what the frame budget is about.
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
   this->Render(true, false);
+  timer->StopTimer();
+  this->UpdateSuggestedLODResolution(timer->GetElapsedTime());
 
   vtkTimerLog::MarkEndEvent("Interactive Render");
 }
 
+//----------------------------------------------------------------------------
+void vtkPVRenderView::UpdateSuggestedLODResolution(double time)
+{
+  if (this->LODFrameBudget <= 0.0)
+    {
+    this->SuggestedLODResolution = -1.0;
+    return;
+    }
+  if (!this->GetUseLODForInteractiveRender() ||
+    this->GetUseOutlineForLODRendering())
+    {
+    return;
+    }
+
+  const double step = 0.25;
+  double resolution = this->LODResolution;
+  if (this->SuggestedLODResolution >= 0.0 &&
+    this->SuggestedLODResolution < resolution)
+    {
+    resolution = this->SuggestedLODResolution;
+    }
+  if (time > this->LODFrameBudget)
+    {
+    resolution = std::max(0.0, (ceil(resolution / step) - 1) * step);
+    }
+  else if (time < 0.5 * this->LODFrameBudget)
+    {
+    resolution = std::min(this->LODResolution,
+      (floor(resolution / step) + 1) * step);
+    }
+  this->SuggestedLODResolution = resolution;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVRenderView::Render(bool interactive, bool skip_rendering)
 {
@@ -1758,6 +1862,7 @@ double vtkPVRenderView::GetZbufferDataAtPoint(int x, int y)
 void vtkPVRenderView::StreamingUpdate(const double view_planes[24])
 {
   vtkTimerLog::MarkStartEvent("vtkPVRenderView::StreamingUpdate");
+  vtkPVTraceSpan span("vtkPVRenderView::StreamingUpdate", this);
 
   // Provide information about the view planes to the representations.
   // Representations are free to ignore them.
@@ -1770,6 +1875,9 @@ void vtkPVRenderView::StreamingUpdate(const double view_planes[24])
   this->CallProcessViewRequest(vtkPVRenderView::REQUEST_STREAMING_UPDATE(),
     this->RequestInformation, this->ReplyInformationVector);
 
+  // Streamed pieces may have extended the bounds.
+  this->SynchronizeGeometryBounds();
+
   vtkTimerLog::MarkEndEvent("vtkPVRenderView::StreamingUpdate");
 }
 
@@ -1781,6 +1889,7 @@ void vtkPVRenderView::DeliverStreamedPieces(
   // representation as "next piece". Representation can decide what to do with
   // it, including adding to the existing datastructure.
   vtkTimerLog::MarkStartEvent("vtkPVRenderView::DeliverStreamedPieces");
+  vtkPVTraceSpan span("vtkPVRenderView::DeliverStreamedPieces", this);
   this->Internals->DeliveryManager->DeliverStreamedPieces(
     size, representation_ids);
 
@@ -1804,6 +1913,7 @@ void vtkPVRenderView::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "UseLightKit: " << this->UseLightKit << endl;
+  os << indent << "LODFrameBudget: " << this->LODFrameBudget << endl;
 }
 
 //----------------------------------------------------------------------------
@@ -1812,6 +1922,12 @@ void vtkPVRenderView::ConfigureCompressor(const char* configuration)
   this->SynchronizedRenderers->ConfigureCompressor(configuration);
 }
 
+//----------------------------------------------------------------------------
+void vtkPVRenderView::SetImageDeltaTileSize(int size)
+{
+  this->SynchronizedRenderers->SetImageDeltaTileSize(size);
+}
+
 //----------------------------------------------------------------------------
 void vtkPVRenderView::InvalidateCachedSelection()
 {
@@ -130,6 +130,13 @@ public:
   void ResetCamera();
   void ResetCamera(double bounds[6]);
 
+  // Description:
+  // Returns true when streamed pieces extended the geometry bounds beyond the
+  // ones the last ResetCamera() fit the camera to, and the camera has not
+  // been moved since. vtkSMRenderViewProxy resets the camera again once
+  // streaming completes in that case.
+  bool GetNeedsStreamingCameraRefit();
+
   // Description:
   // Triggers a high-resolution render.
   // @CallOnAllProcessess
@@ -189,6 +196,32 @@ public:
   vtkSetMacro(UseOutlineForLODRendering, bool);
   vtkGetMacro(UseOutlineForLODRendering, bool);
 
+  // Description:
+  // Get/Set the time, in seconds, that interactive renders may take. When
+  // positive, the LOD resolution used for interactive renders is lowered in
+  // steps of 0.25 as long as interactive renders take longer than this
+  // budget, and raised back (never above LODResolution) when they take less
+  // than half of it. 0 (default) disables this and always uses LODResolution.
+  vtkSetClampMacro(LODFrameBudget, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(LODFrameBudget, double);
+
+  // Description:
+  // Returns the LOD resolution this view suggests for the next interactive
+  // render, given LODFrameBudget and the duration of the last interactive
+  // render on this process, or -1 when LODFrameBudget is 0.
+  // vtkSMRenderViewProxy passes the suggestion of the client on to
+  // SetInteractiveLODResolution(). On the client, a remote interactive render
+  // lasts until the image from the server is received, so the suggestion
+  // accounts for the server side of the frame too.
+  vtkGetMacro(SuggestedLODResolution, double);
+
+  // Description:
+  // Get/Set the LOD resolution requested by UpdateLOD(), if lower than
+  // LODResolution. Negative values (default) are ignored.
+  // @CallOnAllProcessess
+  vtkSetMacro(InteractiveLODResolution, double);
+  vtkGetMacro(InteractiveLODResolution, double);
+
   // Description:
   // Passes the compressor configuration to the client-server synchronizer, if
   // any. This affects the image compression used to relay images back to the
@@ -198,6 +231,14 @@ public:
   // @CallOnAllProcessess
   void ConfigureCompressor(const char* configuration);
 
+  // Description:
+  // When positive, images relayed back to the client after the first one are
+  // sent as the tiles of ImageDeltaTileSize x ImageDeltaTileSize pixels that
+  // changed since the previous image. 0 disables delta image delivery.
+  // See vtkPVClientServerSynchronizedRenderers::SetImageDeltaTileSize().
+  // @CallOnAllProcessess
+  void SetImageDeltaTileSize(int size);
+
   // Description:
   // Resets the clipping range. One does not need to call this directly ever. It
   // is called periodically by the vtkRenderer to reset the camera range.
@@ -211,6 +252,8 @@ public:
   vtkBooleanMacro(UseLightKit, bool);
 
   // Description:
+  // Representations that streamed a piece add its bounds to the geometry
+  // bounds with SetGeometryBounds() during REQUEST_STREAMING_UPDATE().
   void StreamingUpdate(const double view_planes[24]);
   void DeliverStreamedPieces(unsigned int size, unsigned int *representation_ids);
 
@@ -611,11 +654,20 @@ protected:
   // Returns true if LOD rendering should be used based on the geometry size.
   bool ShouldUseLODRendering(double geometry);
 
+  // Description:
+  // Updates SuggestedLODResolution after an interactive render that took
+  // \c time seconds.
+  void UpdateSuggestedLODResolution(double time);
+
   // Description:
   // Synchronizes bounds information on all nodes.
   // @CallOnAllProcessess
   void SynchronizeGeometryBounds();
 
+  // Description:
+  // Records the bounds and the camera after a ResetCamera().
+  void RecordResetCamera(const double bounds[6]);
+
   // Description:
   // Set the last selection object.
   void SetLastSelection(vtkSelection*);
@@ -699,6 +751,12 @@ protected:
   double LODRenderingThreshold;
   vtkBoundingBox GeometryBounds;
 
+  // Description:
+  // Bounds and camera (position, focal point and view up) of the last
+  // ResetCamera(), used by GetNeedsStreamingCameraRefit().
+  vtkBoundingBox ResetCameraBounds;
+  double ResetCameraState[9];
+
   bool UseOffscreenRendering;
   bool UseOffscreenRenderingForScreenshots;
   bool UseInteractiveRenderingForScreenshots;
@@ -706,6 +764,9 @@ protected:
   bool RenderEmptyImages;
 
   double LODResolution;
+  double LODFrameBudget;
+  double SuggestedLODResolution;
+  double InteractiveLODResolution;
   bool UseLightKit;
 
   bool UsedLODForLastRender;
@@ -280,6 +280,21 @@ void vtkPVSynchronizedRenderer::ConfigureCompressor(const char* configuration)
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkPVSynchronizedRenderer::SetImageDeltaTileSize(int size)
+{
+  vtkPVClientServerSynchronizedRenderers* cssync =
+    vtkPVClientServerSynchronizedRenderers::SafeDownCast(this->CSSynchronizer);
+  if (cssync)
+    {
+    cssync->SetImageDeltaTileSize(size);
+    }
+  else
+    {
+    vtkDebugMacro("Not in client-server mode.");
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkPVSynchronizedRenderer::SetImageProcessingPass(
   vtkImageProcessingPass* pass)
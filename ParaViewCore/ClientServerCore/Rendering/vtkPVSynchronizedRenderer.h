@@ -104,6 +104,12 @@ public:
   void ConfigureCompressor(const char* configuration);
   void SetLossLessCompression(bool);
 
+  // Description:
+  // Passes the tile size used for delta image delivery to the client-server
+  // synchronizer, if any. See
+  // vtkPVClientServerSynchronizedRenderers::SetImageDeltaTileSize().
+  void SetImageDeltaTileSize(int);
+
   // Description:
   // Activates or de-activated the use of Depth Buffer in an ImageProcessingPass
   void SetUseDepthBuffer(bool);
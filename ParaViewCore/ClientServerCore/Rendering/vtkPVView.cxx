@@ -21,6 +21,7 @@
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkProcessModule.h"
+#include "vtkPVCacheKeeper.h"
 #include "vtkPVDataRepresentation.h"
 #include "vtkPVOptions.h"
 #include "vtkPVSession.h"
@@ -270,6 +271,30 @@ void vtkPVView::Update()
 
   this->CallProcessViewRequest(vtkPVView::REQUEST_UPDATE(),
     this->RequestInformation, this->ReplyInformationVector);
+
+  // Data cached while the cache was full may not fit. Release cached data
+  // until it does on all processes. Every process goes through the same
+  // number of rounds so that all keep the same time steps cached.
+  if (this->GetUseCache())
+    {
+    vtkCacheSizeKeeper* cacheSizeKeeper = vtkCacheSizeKeeper::GetInstance();
+    while (cacheSizeKeeper->GetEvictionPolicy() !=
+      vtkCacheSizeKeeper::NO_EVICTION)
+      {
+      unsigned int over_limit = 0;
+      if (cacheSizeKeeper->GetCacheSize() > cacheSizeKeeper->GetCacheLimit() &&
+        vtkPVCacheKeeper::HasCachedData(cacheSizeKeeper))
+        {
+        over_limit = 1;
+        }
+      this->SynchronizedWindows->SynchronizeSize(over_limit);
+      if (over_limit == 0)
+        {
+        break;
+        }
+      vtkPVCacheKeeper::ReleaseCachedData(cacheSizeKeeper);
+      }
+    }
   vtkTimerLog::MarkEndEvent("vtkPVView::Update");
 }
 
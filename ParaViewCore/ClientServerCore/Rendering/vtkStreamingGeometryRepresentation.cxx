@@ -0,0 +1,431 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkStreamingGeometryRepresentation.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkStreamingGeometryRepresentation.h"
+
+#include "vtkAlgorithmOutput.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMapper.h"
+#include "vtkMath.h"
+#include "vtkMatrix4x4.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPVCacheKeeper.h"
+#include "vtkPVLODActor.h"
+#include "vtkPVRenderView.h"
+#include "vtkPVStreamingMacros.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkStreamingPriorityQueue.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <assert.h>
+
+vtkStandardNewMacro(vtkStreamingGeometryRepresentation);
+//----------------------------------------------------------------------------
+vtkStreamingGeometryRepresentation::vtkStreamingGeometryRepresentation()
+{
+  this->NumberOfStreamingPieces = 16;
+  this->CurrentPiece = 0;
+  this->HasViewPlanes = false;
+  this->DeliveredDataMTime = 0;
+  this->StreamingCapablePipeline = false;
+  this->InStreamingUpdate = false;
+  for (int cc=0; cc < 24; cc++)
+    {
+    this->ViewPlanes[cc] = 0.0;
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkStreamingGeometryRepresentation::~vtkStreamingGeometryRepresentation()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkStreamingGeometryRepresentation::SetNumberOfStreamingPieces(int val)
+{
+  val = val < 1? 1 : (val > 1024? 1024 : val);
+  if (this->NumberOfStreamingPieces != val)
+    {
+    this->NumberOfStreamingPieces = val;
+
+    // the sub-pieces no longer cover the same regions.
+    this->PieceBounds.clear();
+    this->MarkModified();
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkStreamingGeometryRepresentation::ProcessViewRequest(
+  vtkInformationRequestKey* request_type,
+  vtkInformation* inInfo, vtkInformation* outInfo)
+{
+  // The superclass is skipped for REQUEST_RENDER() since it would reconnect
+  // the mapper to the delivered data, dropping the pieces streamed in so far.
+  int retVal = (request_type == vtkPVView::REQUEST_RENDER())?
+    this->vtkPVDataRepresentation::ProcessViewRequest(
+      request_type, inInfo, outInfo) :
+    this->Superclass::ProcessViewRequest(request_type, inInfo, outInfo);
+  if (!retVal)
+    {
+    return 0;
+    }
+
+  if (request_type == vtkPVView::REQUEST_UPDATE())
+    {
+    // let the view know that this representation is streaming capable (or
+    // not).
+    vtkPVRenderView::SetStreamable(inInfo, this,
+      this->StreamingCapablePipeline);
+    }
+  else if (request_type == vtkPVView::REQUEST_RENDER())
+    {
+    vtkAlgorithmOutput* producerPort =
+      vtkPVRenderView::GetPieceProducer(inInfo, this);
+    vtkAlgorithmOutput* producerPortLOD =
+      vtkPVRenderView::GetPieceProducerLOD(inInfo, this);
+
+    vtkAlgorithm* producer = producerPort->GetProducer();
+    vtkDataObject* delivered =
+      producer->GetOutputDataObject(producerPort->GetIndex());
+    if (this->RenderedData == NULL ||
+      this->DeliveredData.GetPointer() != delivered ||
+      this->DeliveredDataMTime != delivered->GetMTime())
+      {
+      // the full data was (re)delivered, start over.
+      vtkStreamingStatusMacro(<< this << ": using delivered data.");
+      this->RenderedData = vtkSmartPointer<vtkMultiBlockDataSet>::New();
+      this->RenderedData->SetBlock(0, delivered);
+      this->DeliveredData = delivered;
+      this->DeliveredDataMTime = delivered->GetMTime();
+      }
+    this->Mapper->SetInputDataObject(0, this->RenderedData);
+    this->LODMapper->SetInputConnection(0, producerPortLOD);
+
+    bool lod = this->SuppressLOD? false :
+      (inInfo->Has(vtkPVRenderView::USE_LOD()) == 1);
+    this->Actor->SetEnableLOD(lod? 1 : 0);
+    this->UpdateColoringParameters();
+    }
+  else if (request_type == vtkPVRenderView::REQUEST_STREAMING_UPDATE())
+    {
+    if (this->StreamingCapablePipeline)
+      {
+      // This is a streaming update request, request next piece.
+      double view_planes[24];
+      inInfo->Get(vtkPVRenderView::VIEW_PLANES(), view_planes);
+      if (this->StreamingUpdate(view_planes))
+        {
+        // since we indeed "had" a next piece to produce, give it to the view
+        // so it can deliver it to the rendering nodes.
+        vtkPVRenderView::SetNextStreamedPiece(
+          inInfo, this, this->ProcessedPiece);
+
+        // the first update only reported the bounds of the first sub-piece,
+        // report those of everything loaded so far.
+        vtkNew<vtkMatrix4x4> matrix;
+        this->Actor->GetMatrix(matrix.GetPointer());
+        vtkPVRenderView::SetGeometryBounds(inInfo, this->DataBounds,
+          matrix.GetPointer());
+        }
+      }
+    }
+  else if (request_type == vtkPVRenderView::REQUEST_PROCESS_STREAMED_PIECE())
+    {
+    vtkDataObject* piece = vtkPVRenderView::GetCurrentStreamedPiece(inInfo, this);
+    if (piece && this->RenderedData)
+      {
+      vtkStreamingStatusMacro( << this << ": received new piece.");
+
+      // add the piece to what we are already rendering.
+      this->RenderedData->SetBlock(
+        this->RenderedData->GetNumberOfBlocks(), piece);
+      this->RenderedData->Modified();
+      }
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkStreamingGeometryRepresentation::RequestInformation(
+  vtkInformation* request,
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  // A pipeline is streaming capable if the input can produce an arbitrary
+  // piece on request.
+  this->StreamingCapablePipeline = false;
+  if (inputVector[0]->GetNumberOfInformationObjects() == 1)
+    {
+    vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+    if (inInfo->Has(vtkAlgorithm::CAN_HANDLE_PIECE_REQUEST()) &&
+      inInfo->Get(vtkAlgorithm::CAN_HANDLE_PIECE_REQUEST()) != 0 &&
+      this->NumberOfStreamingPieces > 1 &&
+      vtkPVView::GetEnableStreaming())
+      {
+      this->StreamingCapablePipeline = true;
+      }
+    }
+
+  vtkStreamingStatusMacro(
+    << this << ": streaming capable input pipeline? "
+    << (this->StreamingCapablePipeline? "yes" : "no"));
+  return this->Superclass::RequestInformation(request, inputVector, outputVector);
+}
+
+//----------------------------------------------------------------------------
+int vtkStreamingGeometryRepresentation::RequestUpdateExtent(
+  vtkInformation* request,
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  if (!this->Superclass::RequestUpdateExtent(request, inputVector, outputVector))
+    {
+    return 0;
+    }
+
+  if (!this->StreamingCapablePipeline ||
+    inputVector[0]->GetNumberOfInformationObjects() != 1)
+    {
+    return 1;
+    }
+
+  if (!this->InStreamingUpdate)
+    {
+    // the input may have changed, start with the most important piece.
+    this->CurrentPiece = this->GetNextPiece(
+      this->HasViewPlanes? this->ViewPlanes : NULL, true);
+    }
+  assert(this->CurrentPiece >= 0);
+
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  int piece = vtkStreamingDemandDrivenPipeline::GetUpdatePiece(inInfo);
+  int numPieces = vtkStreamingDemandDrivenPipeline::GetUpdateNumberOfPieces(inInfo);
+  vtkStreamingDemandDrivenPipeline::SetUpdateExtent(inInfo,
+    piece * this->NumberOfStreamingPieces + this->CurrentPiece,
+    numPieces * this->NumberOfStreamingPieces,
+    vtkStreamingDemandDrivenPipeline::GetUpdateGhostLevel(inInfo));
+
+  // sub-pieces are adjacent even when running on a single process, so ghost
+  // cells are needed to avoid internal surfaces.
+  if (this->RequestGhostCellsIfNeeded &&
+    (vtkUnstructuredGrid::GetData(inInfo) != NULL ||
+     vtkCompositeDataSet::GetData(inInfo) != NULL) &&
+    !inInfo->Has(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()) &&
+    vtkStreamingDemandDrivenPipeline::GetUpdateGhostLevel(inInfo) < 1)
+    {
+    vtkStreamingDemandDrivenPipeline::SetUpdateGhostLevel(inInfo, 1);
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkStreamingGeometryRepresentation::RequestData(vtkInformation* request,
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  if (!this->Superclass::RequestData(request, inputVector, outputVector))
+    {
+    return 0;
+    }
+
+  this->ProcessedPiece = NULL;
+  if (!this->InStreamingUpdate)
+    {
+    // the input changed, so whatever was streamed so far is no longer valid.
+    this->LoadedPieces.assign(this->NumberOfStreamingPieces, false);
+    this->LoadedBounds.Reset();
+    this->RenderedData = NULL;
+    this->DeliveredData = NULL;
+
+    // keep this result apart from the CacheKeeper output, which the streaming
+    // passes overwrite with each sub-piece.
+    vtkDataObject* output = this->CacheKeeper->GetOutputDataObject(0);
+    this->ProcessedData.TakeReference(output->NewInstance());
+    this->ProcessedData->ShallowCopy(output);
+    this->Decimator->SetInputDataObject(0, this->ProcessedData);
+    this->LODOutlineFilter->SetInputDataObject(0, this->ProcessedData);
+    }
+
+  if (!this->StreamingCapablePipeline ||
+    inputVector[0]->GetNumberOfInformationObjects() != 1)
+    {
+    return 1;
+    }
+
+  if (static_cast<int>(this->PieceBounds.size()) != this->NumberOfStreamingPieces)
+    {
+    this->PieceBounds.assign(this->NumberOfStreamingPieces, vtkBoundingBox());
+    }
+
+  // DataBounds was just computed by the superclass for the current sub-piece.
+  vtkBoundingBox pieceBounds;
+  if (vtkMath::AreBoundsInitialized(this->DataBounds))
+    {
+    pieceBounds.SetBounds(this->DataBounds);
+    }
+  this->PieceBounds[this->CurrentPiece] = pieceBounds;
+  this->LoadedPieces[this->CurrentPiece] = true;
+  this->LoadedBounds.AddBox(pieceBounds);
+
+  // report the bounds of everything loaded so far to the view.
+  if (this->LoadedBounds.IsValid())
+    {
+    this->LoadedBounds.GetBounds(this->DataBounds);
+    }
+
+  if (this->InStreamingUpdate)
+    {
+    // the cache-keeper output is reused on the next execution, so hand the
+    // view a shallow copy.
+    this->ProcessedPiece = vtkSmartPointer<vtkMultiBlockDataSet>::New();
+    this->ProcessedPiece->ShallowCopy(this->CacheKeeper->GetOutputDataObject(0));
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+bool vtkStreamingGeometryRepresentation::StreamingUpdate(
+  const double view_planes[24])
+{
+  assert(this->InStreamingUpdate == false);
+
+  std::copy(view_planes, view_planes + 24, this->ViewPlanes);
+  this->HasViewPlanes = true;
+
+  // When caching for animation playback, the representation does not
+  // re-execute on the cached timesteps, so we don't stream at all.
+  if (this->GetUseCache() ||
+    static_cast<int>(this->LoadedPieces.size()) != this->NumberOfStreamingPieces)
+    {
+    return false;
+    }
+
+  // all processes have the same number of sub-pieces and load one per pass,
+  // hence they run out of pieces together.
+  int next = this->GetNextPiece(view_planes, false);
+  if (next < 0)
+    {
+    return false;
+    }
+
+  this->CurrentPiece = next;
+  this->InStreamingUpdate = true;
+  vtkStreamingStatusMacro(<< this << ": requesting piece: " << next);
+
+  // This ensure that the representation re-executes.
+  this->MarkModified();
+
+  // Execute the pipeline.
+  this->Update();
+
+  this->InStreamingUpdate = false;
+  return this->ProcessedPiece != NULL;
+}
+
+//----------------------------------------------------------------------------
+int vtkStreamingGeometryRepresentation::GetNextPiece(
+  const double* view_planes, bool ignore_loaded)
+{
+  int numPieces = this->NumberOfStreamingPieces;
+  bool known_bounds = (static_cast<int>(this->PieceBounds.size()) == numPieces);
+  bool known_loaded = (static_cast<int>(this->LoadedPieces.size()) == numPieces);
+
+  vtkStreamingPriorityQueue<> queue;
+  int first_unknown = -1;
+  for (int cc=0; cc < numPieces; cc++)
+    {
+    if (!ignore_loaded && known_loaded && this->LoadedPieces[cc])
+      {
+      continue;
+      }
+    if (known_bounds && this->PieceBounds[cc].IsValid())
+      {
+      vtkStreamingPriorityQueueItem item;
+      item.Identifier = static_cast<unsigned int>(cc);
+      item.Bounds = this->PieceBounds[cc];
+      queue.push(item);
+      }
+    else if (first_unknown == -1)
+      {
+      first_unknown = cc;
+      }
+    }
+
+  if (queue.empty())
+    {
+    return first_unknown;
+    }
+  if (view_planes == NULL)
+    {
+    // without a view, fall back to the natural order.
+    int first_known = static_cast<int>(queue.top().Identifier);
+    for (; !queue.empty(); queue.pop())
+      {
+      first_known = std::min(first_known,
+        static_cast<int>(queue.top().Identifier));
+      }
+    return (first_unknown >= 0 && first_unknown < first_known)?
+      first_unknown : first_known;
+    }
+
+  double clamp_bounds[6];
+  vtkMath::UninitializeBounds(clamp_bounds);
+  queue.UpdatePriorities(view_planes, clamp_bounds);
+  if (queue.empty())
+    {
+    return first_unknown;
+    }
+
+  // pieces known to be visible come first, then those never seen and finally
+  // the ones outside the view frustum.
+  if (queue.top().Priority > 0 || first_unknown == -1)
+    {
+    return static_cast<int>(queue.top().Identifier);
+    }
+  return first_unknown;
+}
+
+//----------------------------------------------------------------------------
+vtkDataObject* vtkStreamingGeometryRepresentation::GetGeometryToDeliver()
+{
+  if (this->ProcessedData)
+    {
+    return this->ProcessedData;
+    }
+  return this->Superclass::GetGeometryToDeliver();
+}
+
+//----------------------------------------------------------------------------
+vtkDataObject* vtkStreamingGeometryRepresentation::GetRenderedDataObject(
+  int port)
+{
+  if (this->RenderedData)
+    {
+    return this->RenderedData;
+    }
+  return this->Superclass::GetRenderedDataObject(port);
+}
+
+//----------------------------------------------------------------------------
+void vtkStreamingGeometryRepresentation::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfStreamingPieces: "
+     << this->NumberOfStreamingPieces << endl;
+  os << indent << "StreamingCapablePipeline: "
+     << this->StreamingCapablePipeline << endl;
+}
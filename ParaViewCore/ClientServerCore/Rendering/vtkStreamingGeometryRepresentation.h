@@ -0,0 +1,173 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkStreamingGeometryRepresentation.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkStreamingGeometryRepresentation - geometry representation that
+// streams pieces from piece-aware sources.
+// .SECTION Description
+// vtkStreamingGeometryRepresentation is a vtkGeometryRepresentation that,
+// when streaming is enabled (vtkPVView::GetEnableStreaming()) and the input
+// advertises vtkAlgorithm::CAN_HANDLE_PIECE_REQUEST(), splits the piece
+// assigned to each process into NumberOfStreamingPieces sub-pieces. The first
+// update only reads a single sub-piece, so that an image is available quickly.
+// The remaining sub-pieces are then requested one at a time during the view's
+// streaming passes and are rendered as they arrive.
+//
+// The bounds of the data are not known before all sub-pieces are read, so
+// the first update only reports those of the first sub-piece. The bounds of
+// each streamed sub-piece are reported to the view as it arrives, and a
+// camera fit to the first sub-piece is fit again to the whole data once
+// streaming completes (see vtkPVRenderView::GetNeedsStreamingCameraRefit()).
+//
+// Sub-pieces are ordered using vtkStreamingPriorityQueue: pieces whose bounds
+// are known from an earlier load (e.g. a previous timestep) are ranked by
+// their screen coverage, pieces with unknown bounds come next, and pieces
+// that are known to be outside the view frustum are streamed last.
+//
+// When the input cannot handle piece requests, this representation behaves
+// exactly like vtkGeometryRepresentation.
+// .SECTION See Also
+// vtkAMRStreamingVolumeRepresentation vtkStreamingPriorityQueue
+
+#ifndef __vtkStreamingGeometryRepresentation_h
+#define __vtkStreamingGeometryRepresentation_h
+
+#include "vtkGeometryRepresentation.h"
+#include "vtkBoundingBox.h" // needed for vtkBoundingBox.
+#include "vtkSmartPointer.h" // needed for vtkSmartPointer.
+#include "vtkWeakPointer.h" // needed for vtkWeakPointer.
+#include <vector> // needed for std::vector.
+
+class vtkMultiBlockDataSet;
+
+class VTKPVCLIENTSERVERCORERENDERING_EXPORT vtkStreamingGeometryRepresentation :
+  public vtkGeometryRepresentation
+{
+public:
+  static vtkStreamingGeometryRepresentation* New();
+  vtkTypeMacro(vtkStreamingGeometryRepresentation, vtkGeometryRepresentation);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Overridden to handle the streaming passes.
+  virtual int ProcessViewRequest(vtkInformationRequestKey* request_type,
+    vtkInformation* inInfo, vtkInformation* outInfo);
+
+  // Description:
+  // Set the number of sub-pieces each process splits its share of the data
+  // into when streaming. Default is 16.
+  void SetNumberOfStreamingPieces(int);
+  vtkGetMacro(NumberOfStreamingPieces, int);
+
+  // Description:
+  // Returns the data object that is rendered from the given input port.
+  virtual vtkDataObject* GetRenderedDataObject(int port);
+
+//BTX
+protected:
+  vtkStreamingGeometryRepresentation();
+  ~vtkStreamingGeometryRepresentation();
+
+  // Description:
+  // Overridden to check if the input pipeline is streaming capable.
+  virtual int RequestInformation(vtkInformation* request,
+    vtkInformationVector** inputVector, vtkInformationVector* outputVector);
+
+  // Description:
+  // Overridden to request the current sub-piece when the input pipeline is
+  // streaming capable.
+  virtual int RequestUpdateExtent(vtkInformation* request,
+    vtkInformationVector** inputVector, vtkInformationVector* outputVector);
+
+  // Description:
+  // Overridden to keep track of the sub-pieces loaded so far. When not in
+  // StreamingUpdate, this resets the streaming state since the input changed.
+  virtual int RequestData(vtkInformation* request,
+    vtkInformationVector** inputVector, vtkInformationVector* outputVector);
+
+  // Description:
+  // Returns true if this representation has a "next piece" that it streamed.
+  // Picks the sub-piece to load using the view planes and re-executes the
+  // representation to produce its geometry.
+  bool StreamingUpdate(const double view_planes[24]);
+
+  // Description:
+  // Overridden to deliver ProcessedData rather than the CacheKeeper output,
+  // which only holds the most recently streamed sub-piece.
+  virtual vtkDataObject* GetGeometryToDeliver();
+
+  // Description:
+  // Returns the index of the next sub-piece to request, or -1 if all
+  // sub-pieces have been loaded. When \c ignore_loaded is true, all
+  // sub-pieces are considered not loaded. \c view_planes may be NULL.
+  int GetNextPiece(const double* view_planes, bool ignore_loaded);
+
+  int NumberOfStreamingPieces;
+
+  // Description:
+  // Sub-piece requested in the current/most recent update.
+  int CurrentPiece;
+
+  // Description:
+  // Flags for sub-pieces already loaded since the input last changed.
+  std::vector<bool> LoadedPieces;
+
+  // Description:
+  // Bounds of each sub-piece, as seen when it was last loaded. These are kept
+  // when the input changes, since they are a good estimate for the next
+  // timestep.
+  std::vector<vtkBoundingBox> PieceBounds;
+
+  // Description:
+  // Union of the bounds of the sub-pieces loaded since the input last changed.
+  vtkBoundingBox LoadedBounds;
+
+  // Description:
+  // View planes used for the most recent StreamingUpdate(), if any.
+  double ViewPlanes[24];
+  bool HasViewPlanes;
+
+  // Description:
+  // Geometry produced by the most recent regular (non-streaming) update. This
+  // is what is delivered to the rendering nodes and decimated for LOD, so
+  // that later view updates do not replace the streamed pieces with the last
+  // one.
+  vtkSmartPointer<vtkDataObject> ProcessedData;
+
+  // Description:
+  // Geometry for the piece generated in the most recent StreamingUpdate().
+  vtkSmartPointer<vtkMultiBlockDataSet> ProcessedPiece;
+
+  // Description:
+  // On rendering nodes, the delivered geometry followed by all the streamed
+  // pieces received since, one block each.
+  vtkSmartPointer<vtkMultiBlockDataSet> RenderedData;
+  vtkWeakPointer<vtkDataObject> DeliveredData;
+  unsigned long DeliveredDataMTime;
+
+private:
+  vtkStreamingGeometryRepresentation(const vtkStreamingGeometryRepresentation&); // Not implemented
+  void operator=(const vtkStreamingGeometryRepresentation&); // Not implemented
+
+  // Description:
+  // Set in RequestInformation() if the input pipeline supports streaming. This
+  // is valid only on the data-server nodes.
+  bool StreamingCapablePipeline;
+
+  // Description:
+  // Set while StreamingUpdate() is re-executing the representation.
+  bool InStreamingUpdate;
+//ETX
+};
+
+#endif
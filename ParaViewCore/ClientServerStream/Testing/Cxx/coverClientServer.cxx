@@ -278,6 +278,26 @@ bool do_test()
     return false;
     }
   }
+  vtkClientServerStream css6;
+  {
+  const unsigned char* data;
+  size_t length;
+  css5.GetData(&data, &length);
+  memcpy(css6.AllocateData(length), data, length);
+  if(!css6.CommitData())
+    {
+    cerr << "FAILED: CommitData failed." << endl;
+    return false;
+    }
+  }
+  vtkClientServerStream css7;
+  vtkClientServerStream css8(css1);
+  css7.Swap(css8);
+  if(css8.GetNumberOfMessages() != 0)
+    {
+    cerr << "FAILED: Swap did not exchange stream contents." << endl;
+    return false;
+    }
 
   if(!do_check(css1))
     {
@@ -306,6 +326,17 @@ bool do_test()
     cerr << "FAILED: (Get/Set)Data did not copy stream properly." << endl;
     return false;
     }
+  if(!do_check(css6))
+    {
+    cerr << "FAILED: (Allocate/Commit)Data did not copy stream properly."
+         << endl;
+    return false;
+    }
+  if(!do_check(css7))
+    {
+    cerr << "FAILED: Swap did not move stream properly." << endl;
+    return false;
+    }
   return true;
 }
 
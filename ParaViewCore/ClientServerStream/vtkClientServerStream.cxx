@@ -188,6 +188,11 @@ const vtkClientServerStreamInternals::ValueOffsetsType::size_type
 vtkClientServerStreamInternals::InvalidStartIndex =
 static_cast<vtkClientServerStreamInternals::ValueOffsetsType::size_type>(-1);
 
+// Streams are often reset and refilled.  Reset keeps the memory already
+// allocated for the stream data up to this size to avoid reallocating it
+// every time, and releases larger buffers.
+static const size_t vtkClientServerStreamMaximumRetainedCapacity = 64*1024;
+
 //----------------------------------------------------------------------------
 vtkClientServerStream::vtkClientServerStream(vtkObjectBase* owner)
 {
@@ -225,6 +230,54 @@ void vtkClientServerStream::Copy(const vtkClientServerStream* source)
   *this = *source;
 }
 
+//----------------------------------------------------------------------------
+void vtkClientServerStream::Swap(vtkClientServerStream& other)
+{
+  if(this == &other)
+    {
+    return;
+    }
+
+  vtkClientServerStreamInternals* tmp = this->Internal;
+  this->Internal = other.Internal;
+  other.Internal = tmp;
+
+  // Each stream keeps its owner.  Move the object references held on
+  // behalf of the previous owner to the new one.
+  vtkObjectBase* owner = other.Internal->Objects.Owner;
+  vtkObjectBase* otherOwner = this->Internal->Objects.Owner;
+  if(owner != otherOwner)
+    {
+    vtkClientServerStreamInternals::ObjectsType::iterator i;
+    for(i = this->Internal->Objects.begin();
+        i != this->Internal->Objects.end(); ++i)
+      {
+      if(owner)
+        {
+        (*i)->Register(owner);
+        }
+      if(otherOwner)
+        {
+        (*i)->UnRegister(otherOwner);
+        }
+      }
+    for(i = other.Internal->Objects.begin();
+        i != other.Internal->Objects.end(); ++i)
+      {
+      if(otherOwner)
+        {
+        (*i)->Register(otherOwner);
+        }
+      if(owner)
+        {
+        (*i)->UnRegister(owner);
+        }
+      }
+    this->Internal->Objects.Owner = owner;
+    other.Internal->Objects.Owner = otherOwner;
+    }
+}
+
 //----------------------------------------------------------------------------
 vtkClientServerStream&
 vtkClientServerStream::Write(const void* data, size_t length)
@@ -241,9 +294,12 @@ vtkClientServerStream::Write(const void* data, size_t length)
     return *this;
     }
 
-  // Copy the value into the data.
-  this->Internal->Data.resize(this->Internal->Data.size() + length);
-  memcpy(&*(this->Internal->Data.end() - length), data, length);
+  // Append the value to the data.  Unlike resize followed by memcpy, this
+  // does not first zero the new bytes.  Either way the vector grows
+  // geometrically.
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  this->Internal->Data.insert(this->Internal->Data.end(), bytes,
+                              bytes + length);
   return *this;
 }
 
@@ -256,8 +312,16 @@ void vtkClientServerStream::Reserve(size_t size)
 //----------------------------------------------------------------------------
 void vtkClientServerStream::Reset()
 {
-  // Empty the entire stream.
-  vtkClientServerStreamInternals::DataType().swap(this->Internal->Data);
+  // Empty the entire stream, releasing large buffers.
+  if(this->Internal->Data.capacity() >
+     vtkClientServerStreamMaximumRetainedCapacity)
+    {
+    vtkClientServerStreamInternals::DataType().swap(this->Internal->Data);
+    }
+  else
+    {
+    this->Internal->Data.clear();
+    }
 
   this->Internal->ValueOffsets.erase(this->Internal->ValueOffsets.begin(),
                                      this->Internal->ValueOffsets.end());
@@ -1447,6 +1511,25 @@ int vtkClientServerStream::SetData(const unsigned char* data, size_t length)
     this->Internal->Data.insert(this->Internal->Data.begin(), data, data+length);
     }
 
+  return this->CommitData();
+}
+
+//----------------------------------------------------------------------------
+unsigned char* vtkClientServerStream::AllocateData(size_t length)
+{
+  // Reset and replace the byte order entry with room for the data.
+  // Shrinking does not reallocate: the returned pointer is never null, even
+  // for empty data.
+  this->Reset();
+  this->Internal->Data.resize(length + 1);
+  unsigned char* data = &*this->Internal->Data.begin();
+  this->Internal->Data.resize(length);
+  return data;
+}
+
+//----------------------------------------------------------------------------
+int vtkClientServerStream::CommitData()
+{
   // Parse the stream to fill in ValueOffsets and MessageIndexes and
   // to perform byte-swapping if necessary.
   if(this->ParseData())
@@ -87,6 +87,12 @@ public:
   // Copy the stream contents from another stream.
   void Copy(const vtkClientServerStream* source);
 
+  // Description:
+  // Exchange the contents of this stream with another stream in constant
+  // time, without copying the stream data.  References to vtk objects
+  // stored in the streams are transferred to the new owner.
+  void Swap(vtkClientServerStream& other);
+
   //--------------------------------------------------------------------------
   // Stream reading methods:
 
@@ -284,6 +290,15 @@ public:
   // deemed valid.  In the case of 0, the stream will have been reset.
   int SetData(const unsigned char* data, size_t length);
 
+  // Description:
+  // Alternative to SetData that avoids copying the data.  AllocateData
+  // destroys any data already in the stream and returns a buffer of the
+  // given length that the caller fills directly, e.g. by receiving into it
+  // from a communicator.  CommitData must then be called to parse the data,
+  // with the same meaning for its return value as SetData.
+  unsigned char* AllocateData(size_t length);
+  int CommitData();
+
   //--------------------------------------------------------------------------
   // Utility methods:
 
@@ -0,0 +1,106 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVXMLElementBinary.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkNew.h"
+#include "vtkPVXMLElement.h"
+#include "vtkPVXMLParser.h"
+#include "vtkSmartPointer.h"
+
+#include <iostream>
+#include <string>
+
+namespace
+{
+  const char TestXML[] =
+    "<ServerManagerConfiguration>\n"
+    "  <ProxyGroup name=\"sources\">\n"
+    "    <SourceProxy name=\"Sphere\" class=\"vtkSphereSource\" label=\"\">\n"
+    "      <DoubleVectorProperty id=\"radius\" name=\"Radius\"\n"
+    "        default_values=\"0.5\" number_of_elements=\"1\">\n"
+    "        <Documentation>Radius of the\n"
+    "        sphere &amp; &lt;more&gt; \xc3\xa9</Documentation>\n"
+    "      </DoubleVectorProperty>\n"
+    "      <Hints><Property name=\"Radius\" show=\"0\"/></Hints>\n"
+    "    </SourceProxy>\n"
+    "  </ProxyGroup>\n"
+    "  <ProxyGroup name=\"empty\"/>\n"
+    "</ServerManagerConfiguration>\n";
+}
+
+#define TEST_ASSERT(cond)                                                     \
+  if (!(cond))                                                                \
+    {                                                                         \
+    std::cerr << "ERROR: Failed at line " << __LINE__ << ": " #cond           \
+              << std::endl;                                                   \
+    return EXIT_FAILURE;                                                      \
+    }
+
+// Checks that vtkPVXMLElement::NewFromBinary() rebuilds the tree written by
+// vtkPVXMLElement::SerializeBinary() and rejects truncated buffers.
+int TestPVXMLElementBinary(int, char*[])
+{
+  vtkNew<vtkPVXMLParser> parser;
+  TEST_ASSERT(parser->Parse(TestXML) != 0);
+  vtkPVXMLElement* root = parser->GetRootElement();
+  TEST_ASSERT(root != NULL);
+
+  std::string buffer;
+  root->SerializeBinary(buffer);
+  TEST_ASSERT(!buffer.empty());
+
+  vtkSmartPointer<vtkPVXMLElement> copy;
+  copy.TakeReference(
+    vtkPVXMLElement::NewFromBinary(buffer.data(), buffer.size()));
+  TEST_ASSERT(copy != NULL);
+  TEST_ASSERT(root->Equals(copy));
+
+  // the rebuilt tree is linked like a parsed one.
+  TEST_ASSERT(copy->GetNumberOfNestedElements() == 2);
+  vtkPVXMLElement* sphere = copy->GetNestedElement(0)->GetNestedElement(0);
+  TEST_ASSERT(sphere != NULL);
+  TEST_ASSERT(std::string(sphere->GetAttribute("label")) == "");
+  vtkPVXMLElement* radius = sphere->FindNestedElement("radius");
+  TEST_ASSERT(radius != NULL);
+  TEST_ASSERT(std::string(radius->GetName()) == "DoubleVectorProperty");
+  TEST_ASSERT(radius->GetParent() == sphere);
+  TEST_ASSERT(radius->GetParent()->GetParent()->GetParent() == copy);
+  vtkPVXMLElement* doc = radius->FindNestedElementByName("Documentation");
+  TEST_ASSERT(doc != NULL);
+  TEST_ASSERT(doc->LookupElement("radius") == radius);
+  TEST_ASSERT(std::string(doc->GetCharacterData()) ==
+    root->GetNestedElement(0)->GetNestedElement(0)->FindNestedElement(
+      "radius")->FindNestedElementByName("Documentation")->GetCharacterData());
+  TEST_ASSERT(copy->GetNestedElement(1)->GetNumberOfNestedElements() == 0);
+
+  // serializing the copy gives the same buffer.
+  std::string copyBuffer;
+  copy->SerializeBinary(copyBuffer);
+  TEST_ASSERT(copyBuffer == buffer);
+
+  // truncated buffers are rejected.
+  for (size_t length = 0; length < buffer.size(); length++)
+    {
+    vtkPVXMLElement* truncated =
+      vtkPVXMLElement::NewFromBinary(buffer.data(), length);
+    if (truncated)
+      {
+      truncated->Delete();
+      std::cerr << "ERROR: A buffer truncated to " << length << " of "
+                << buffer.size() << " bytes was accepted." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  TEST_ASSERT(vtkPVXMLElement::NewFromBinary(NULL, 0) == NULL);
+  return EXIT_SUCCESS;
+}
@@ -39,6 +39,56 @@ struct vtkPVXMLElementInternals
   std::string CharacterData;
 };
 
+// Helpers for the binary form. Sizes are stored as 32 bit little endian
+// integers so that the form does not depend on the architecture.
+static void vtkPVXMLElementAppendSize(std::string& buffer, size_t size)
+{
+  vtkTypeUInt32 value = static_cast<vtkTypeUInt32>(size);
+  for (int cc=0; cc < 4; ++cc)
+    {
+    buffer += static_cast<char>((value >> (8*cc)) & 0xff);
+    }
+}
+
+static void vtkPVXMLElementAppendString(std::string& buffer,
+                                        const std::string& str)
+{
+  vtkPVXMLElementAppendSize(buffer, str.size());
+  buffer.append(str);
+}
+
+static bool vtkPVXMLElementReadSize(const char*& data, const char* end,
+                                    size_t& size)
+{
+  if (end - data < 4)
+    {
+    return false;
+    }
+  vtkTypeUInt32 value = 0;
+  for (int cc=0; cc < 4; ++cc)
+    {
+    value |= static_cast<vtkTypeUInt32>(
+      static_cast<unsigned char>(data[cc])) << (8*cc);
+    }
+  data += 4;
+  size = static_cast<size_t>(value);
+  return true;
+}
+
+static bool vtkPVXMLElementReadString(const char*& data, const char* end,
+                                      std::string& str)
+{
+  size_t size;
+  if (!vtkPVXMLElementReadSize(data, end, size) ||
+    static_cast<size_t>(end - data) < size)
+    {
+    return false;
+    }
+  str.assign(data, size);
+  data += size;
+  return true;
+}
+
 // Function to check if a string is full of whitespace characters.
 static bool vtkIsSpace(const std::string& str)
 {
@@ -777,3 +827,102 @@ void vtkPVXMLElement::RemoveAttribute(const char* name)
 }
 
 //----------------------------------------------------------------------------
+void vtkPVXMLElement::SerializeBinary(std::string& buffer)
+{
+  // Name and id are written with a leading flag since either may be NULL.
+  buffer += this->Name? '\1' : '\0';
+  vtkPVXMLElementAppendString(buffer, this->Name? this->Name : "");
+  buffer += this->Id? '\1' : '\0';
+  vtkPVXMLElementAppendString(buffer, this->Id? this->Id : "");
+
+  size_t numAttributes = this->Internal->AttributeNames.size();
+  vtkPVXMLElementAppendSize(buffer, numAttributes);
+  for (size_t cc=0; cc < numAttributes; ++cc)
+    {
+    vtkPVXMLElementAppendString(buffer, this->Internal->AttributeNames[cc]);
+    vtkPVXMLElementAppendString(buffer, this->Internal->AttributeValues[cc]);
+    }
+  vtkPVXMLElementAppendString(buffer, this->Internal->CharacterData);
+
+  vtkPVXMLElementAppendSize(buffer, this->Internal->NestedElements.size());
+  vtkPVXMLElementInternals::VectorOfElements::iterator iter;
+  for (iter = this->Internal->NestedElements.begin();
+    iter != this->Internal->NestedElements.end(); ++iter)
+    {
+    (*iter)->SerializeBinary(buffer);
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkPVXMLElement* vtkPVXMLElement::NewFromBinary(const char* data,
+                                                size_t length)
+{
+  if (!data)
+    {
+    return NULL;
+    }
+  vtkPVXMLElement* element = vtkPVXMLElement::New();
+  if (!element->ReadBinary(data, data + length))
+    {
+    element->Delete();
+    return NULL;
+    }
+  return element;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVXMLElement::ReadBinary(const char*& data, const char* end)
+{
+  std::string str;
+  if (end - data < 1)
+    {
+    return false;
+    }
+  bool hasName = (*data++ != 0);
+  if (!vtkPVXMLElementReadString(data, end, str) || end - data < 1)
+    {
+    return false;
+    }
+  this->SetName(hasName? str.c_str() : NULL);
+  bool hasId = (*data++ != 0);
+  if (!vtkPVXMLElementReadString(data, end, str))
+    {
+    return false;
+    }
+  this->SetId(hasId? str.c_str() : NULL);
+
+  size_t numAttributes;
+  if (!vtkPVXMLElementReadSize(data, end, numAttributes))
+    {
+    return false;
+    }
+  for (size_t cc=0; cc < numAttributes; ++cc)
+    {
+    std::string value;
+    if (!vtkPVXMLElementReadString(data, end, str) ||
+      !vtkPVXMLElementReadString(data, end, value))
+      {
+      return false;
+      }
+    this->Internal->AttributeNames.push_back(str);
+    this->Internal->AttributeValues.push_back(value);
+    }
+
+  size_t numNested;
+  if (!vtkPVXMLElementReadString(data, end, this->Internal->CharacterData) ||
+    !vtkPVXMLElementReadSize(data, end, numNested))
+    {
+    return false;
+    }
+  for (size_t cc=0; cc < numNested; ++cc)
+    {
+    vtkSmartPointer<vtkPVXMLElement> nested =
+      vtkSmartPointer<vtkPVXMLElement>::New();
+    if (!nested->ReadBinary(data, end))
+      {
+      return false;
+      }
+    this->AddNestedElement(nested);
+    }
+  return true;
+}
@@ -209,6 +209,16 @@ public:
   // Copy the attributes from current XML element content into the provided one.
   void CopyAttributesTo(vtkPVXMLElement* other);
 
+  //BTX
+  // Description:
+  // Append a compact binary form of this element and all nested elements to
+  // buffer. NewFromBinary() rebuilds the same tree (names, ids, attributes
+  // and character data) without going through vtkPVXMLParser. It returns
+  // NULL if data does not hold a complete tree.
+  void SerializeBinary(std::string& buffer);
+  static vtkPVXMLElement* NewFromBinary(const char* data, size_t length);
+  //ETX
+
 protected:
   vtkPVXMLElement();
   ~vtkPVXMLElement();
@@ -226,6 +236,9 @@ protected:
   void ReadXMLAttributes(const char** atts);
   void AddCharacterData(const char* data, int length);
 
+  // Read the binary form written by SerializeBinary() into this element,
+  // moving data past it. Returns false if the form is truncated.
+  bool ReadBinary(const char*& data, const char* end);
 
   // Internal utility methods.
   vtkPVXMLElement* LookupElementInScope(const char* id);
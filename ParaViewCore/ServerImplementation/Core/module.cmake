@@ -6,6 +6,7 @@ vtk_module(vtkPVServerImplementationCore
     vtkprotobuf
   PRIVATE_DEPENDS
     vtksys
+    vtkzlib
   TEST_LABELS
     PARAVIEW
 )
@@ -644,13 +644,11 @@ void vtkPVSessionCore::ExecuteStreamSatelliteCallback()
 {
   int byte_size[2] = {0, 0};
   this->ParallelController->Broadcast(byte_size, 2, 0);
-  unsigned char *raw_data = new unsigned char[byte_size[0] + 1];
-  this->ParallelController->Broadcast(raw_data, byte_size[0], 0);
-
   vtkClientServerStream stream;
-  stream.SetData(raw_data, byte_size[0]);
+  unsigned char *raw_data = stream.AllocateData(byte_size[0]);
+  this->ParallelController->Broadcast(raw_data, byte_size[0], 0);
+  stream.CommitData();
   this->ExecuteStreamInternal(stream, byte_size[1] != 0);
-  delete [] raw_data;
 }
 
 //----------------------------------------------------------------------------
@@ -930,107 +928,78 @@ void vtkPVSessionCore::GatherInformationStatelliteCallback()
 }
 
 //----------------------------------------------------------------------------
-#define SafeDeleteArray( array_ptr ) { \
-  if( array_ptr != NULL )              \
-    {                                  \
-    delete [] array_ptr;               \
-    array_ptr = NULL;                  \
-    }                                  \
-}
-
 bool vtkPVSessionCore::CollectInformation(vtkPVInformation* info)
 {
-  // Sanity checks
-  assert("pre: NULL PV information!" && (info != NULL) );
-
-  // STEP 0: temporary variables
-  int rank   = this->ParallelController->GetLocalProcessId();
-  int nranks = this->ParallelController->GetNumberOfProcesses();
-
-  if( nranks == 1 )
+  if (this->ParallelController->GetNumberOfProcesses() == 1)
     {
     /* short-circuit */
     return true;
     }
 
-  vtkIdType *rcvcounts     = NULL;   /* significant only at rank 0 */
-  vtkIdType *offSet        = NULL;   /* significant only at rank 0 */
-  int rbufsize             = 0;      /* significant only at rank 0 */
-  unsigned char* rcvbuffer = NULL;   /* significant only at rank 0 */
+  vtkPVSessionCore::ReduceInformation(this->ParallelController, info);
 
-  // STEP 1: Initialize data-structures at rank 0
-  if( rank == 0 )
-    {
-    rcvcounts = new vtkIdType[ nranks ];
-    offSet    = new vtkIdType[ nranks ];
-    } // END if rank == 0
+  // Barrier synchronization
+  this->ParallelController->Barrier();
+  return true;
+}
 
-  // STEP 2: Serialize the vtkPVInformation object
+//----------------------------------------------------------------------------
+void vtkPVSessionCore::ReduceInformation(
+  vtkMultiProcessController* controller, vtkPVInformation* info)
+{
+  int rank   = controller->GetLocalProcessId();
+  int nranks = controller->GetNumberOfProcesses();
+
+  // Binomial tree reduction: at each level, ranks with the current bit set
+  // send their (already reduced) information to the rank with that bit cleared
+  // and drop out, while the others receive and merge it. The root thus merges
+  // log2(nranks) partial results instead of one per rank, and since lower
+  // ranks always receive from higher ones, the information is still merged in
+  // rank order.
+  // A satellite that failed to gather information (info == NULL) takes part
+  // in the reduction with empty information so that the root does not hang.
   vtkClientServerStream stream;
-  info->CopyToStream( &stream );
-
-  const unsigned char* data;
-  size_t length;
-
-  // Get pointer to the raw stream data. Note, this is a shallow copy, no
-  // need to delete the data.
-  stream.GetData( &data, &length);
-  vtkIdType local_length = static_cast<vtkIdType>( length );
-
-  // STEP 3: Get number of bytes that each process will send
-  this->ParallelController->Gather(&local_length,rcvcounts,1,0);
-
-  // STEP 4: Allocate temporary arrays at rank 0
-  if( rank == 0 )
+  for (int mask = 1; mask < nranks; mask <<= 1)
     {
-    // STEP 4.1: Calculate rcvbuffer size & allocate rcvbuffer
-    rbufsize = rcvcounts[0];
-    for( int i=1; i < nranks; ++i )
+    if (rank & mask)
       {
-      rbufsize += rcvcounts[ i ];
+      stream.Reset();
+      if (info)
+        {
+        info->CopyToStream(&stream);
+        }
+      const unsigned char* data;
+      size_t length;
+      stream.GetData(&data, &length);
+      vtkIdType local_length = info? static_cast<vtkIdType>(length) : 0;
+      controller->Send(&local_length, 1, rank - mask, ROOT_SATELLITE_INFO_TAG);
+      if (local_length > 0)
+        {
+        controller->Send(data, local_length, rank - mask,
+          ROOT_SATELLITE_INFO_TAG);
+        }
+      break;
       }
-    rcvbuffer = new unsigned char[ rbufsize ];
-
-    // STEP 4.2: populate offset array
-    offSet[ 0 ] = 0;
-    for( int i=1; i < nranks; ++i )
+    else if (rank + mask < nranks)
       {
-      offSet[ i ] = offSet[ i-1 ] + rcvcounts[ i-1 ];
+      vtkIdType remote_length = 0;
+      controller->Receive(&remote_length, 1, rank + mask,
+        ROOT_SATELLITE_INFO_TAG);
+      if (remote_length > 0)
+        {
+        unsigned char* data = stream.AllocateData(remote_length);
+        controller->Receive(data, remote_length, rank + mask,
+          ROOT_SATELLITE_INFO_TAG);
+        if (stream.CommitData() && info)
+          {
+          vtkPVInformation* tempInfo = info->NewInstance();
+          tempInfo->CopyFromStream(&stream);
+          info->AddInformation(tempInfo);
+          tempInfo->Delete();
+          }
+        }
       }
-    } // END if rank==0
-
-  // STEP 5: GatherV all data from satellites
-  this->ParallelController->GatherV(
-      data, rcvbuffer, local_length, rcvcounts, offSet, 0);
-
-  // STEP 6: Deserialize data from other ranks at rank 0 and add them to
-  // the information object associated with rank 0.
-  if( rank == 0 )
-    {
-    vtkClientServerStream rcvStream;
-    for( int i=1; i < nranks; ++i )
-      {
-      rcvStream.SetData( &rcvbuffer[ offSet[i] ],rcvcounts[ i ] );
-      vtkPVInformation* tempInfo = info->NewInstance();
-      tempInfo->CopyFromStream( &rcvStream );
-      info->AddInformation( tempInfo );
-      tempInfo->Delete();
-      } // END for all remote ranks
-    } // END if rank == 0
-
-  // STEP 7: De-allocate temporary arrays at rank 0
-  SafeDeleteArray(rcvcounts);
-  SafeDeleteArray(offSet);
-  SafeDeleteArray(rcvbuffer);
-
-  // Sanity checks -- ensure we return all dynamically allocated memory
-  assert( "post: rcvcounts should be NULL" && (rcvcounts == NULL) );
-  assert( "post: offSet should be NULL" && (offSet == NULL) );
-  assert( "post: rcvbuffer should be NULL" && (rcvbuffer == NULL) );
-
-  // STEP 8: Barrier synchronization
-  this->ParallelController->Barrier();
-  return true;
+    }
 }
 
 //----------------------------------------------------------------------------
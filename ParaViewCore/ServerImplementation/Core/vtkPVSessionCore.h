@@ -113,6 +113,15 @@ public:
                                   vtkPVInformation* information,
                                   vtkTypeUInt32 globalid );
 
+  // Description:
+  // Merges the information gathered on every process of \c controller into
+  // \c info on the root process, through a binomial tree so that the root
+  // merges log2(P) partial results instead of one per process. Processes
+  // are merged in rank order. Must be called on all processes; the
+  // information on the other processes is left partially merged.
+  static void ReduceInformation(vtkMultiProcessController* controller,
+    vtkPVInformation* info);
+
   // Description:
   // Returns the number of processes. This simply calls the
   // GetNumberOfProcesses() on this->ParallelController
@@ -35,6 +35,7 @@
 #include "vtkSMMessage.h"
 #include "vtkSocketCommunicator.h"
 #include "vtkSocketController.h"
+#include "vtk_zlib.h"
 
 #include <assert.h>
 #include <string>
@@ -489,15 +490,15 @@ void vtkPVSessionServer::OnClientServerMessageRMI(void* message, int message_len
 //      msg.PrintDebugString();
 //      cout << "=================================" << endl;
 
-      // Do we skip the processing ?
-      if(!this->Internal->StoreShareOnly(&msg))
-        {
-        this->PushState(&msg);
-        }
+      this->PushStateFromClient(&msg);
+      }
+    break;
 
-      // Notify when ProxyManager state has changed
-      // or any other state change
-      this->NotifyOtherClients(&msg);
+  case vtkPVSessionServer::PUSH_BATCH:
+      {
+      int compressed, raw_size, size;
+      stream >> compressed >> raw_size >> size;
+      this->ReceivePushBatch(compressed, raw_size, size);
       }
     break;
 
@@ -543,14 +544,13 @@ void vtkPVSessionServer::OnClientServerMessageRMI(void* message, int message_len
       {
       int ignore_errors, size;
       stream >> ignore_errors >> size;
-      unsigned char* css_data = new unsigned char[size+1];
+      vtkClientServerStream cssStream;
+      unsigned char* css_data = cssStream.AllocateData(size);
       this->Internal->GetActiveController()->Receive(css_data, size, 1,
         vtkPVSessionServer::EXECUTE_STREAM_TAG);
-      vtkClientServerStream cssStream;
-      cssStream.SetData(css_data, size);
+      cssStream.CommitData();
       this->ExecuteStream(vtkPVSession::CLIENT_AND_SERVERS,
         cssStream, ignore_errors != 0);
-      delete [] css_data;
       }
     break;
 
@@ -572,6 +572,145 @@ void vtkPVSessionServer::OnClientServerMessageRMI(void* message, int message_len
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkPVSessionServer::PushStateFromClient(vtkSMMessage* msg)
+{
+  // Do we skip the processing ?
+  if(!this->Internal->StoreShareOnly(msg))
+    {
+    this->PushState(msg);
+    }
+
+  // Notify when ProxyManager state has changed
+  // or any other state change
+  this->NotifyOtherClients(msg);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVSessionServer::ReceivePushBatch(int compressed, int rawSize, int size)
+{
+  if (size <= 0 || rawSize <= 0)
+    {
+    return;
+    }
+
+  std::vector<unsigned char> data(size);
+  this->Internal->GetActiveController()->Receive(&data[0], size, 1,
+    vtkPVSessionServer::PUSH_BATCH_TAG);
+
+  // Unpack the whole batch before pushing anything, so that a corrupted batch
+  // is dropped as a whole rather than applied in part.
+  std::vector<vtkSMMessage> states;
+  if (!vtkPVSessionServer::UnpackPushBatch(&data[0], size, compressed != 0,
+      rawSize, states))
+    {
+    vtkErrorMacro("Failed to unpack the batch of pushed states. "
+      "None of its states were pushed.");
+    return;
+    }
+  for (size_t cc=0; cc < states.size(); cc++)
+    {
+    this->PushStateFromClient(&states[cc]);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVSessionServer::AppendToPushBatch(
+  std::vector<unsigned char>& batch, const std::string& state)
+{
+  vtkTypeUInt32 length = static_cast<vtkTypeUInt32>(state.size());
+  for (int cc=0; cc < 4; cc++)
+    {
+    batch.push_back(static_cast<unsigned char>((length >> (8*cc)) & 0xff));
+    }
+  batch.insert(batch.end(), state.begin(), state.end());
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVSessionServer::CompressPushBatch(
+  const std::vector<unsigned char>& batch,
+  std::vector<unsigned char>& compressedBatch)
+{
+  if (batch.size() < static_cast<size_t>(PUSH_BATCH_COMPRESSION_THRESHOLD))
+    {
+    return false;
+    }
+
+  uLongf out_size = compressBound(static_cast<uLong>(batch.size()));
+  compressedBatch.resize(out_size);
+  if (compress2(&compressedBatch[0], &out_size, &batch[0],
+      static_cast<uLong>(batch.size()), Z_DEFAULT_COMPRESSION) != Z_OK ||
+    out_size >= static_cast<uLongf>(batch.size()))
+    {
+    compressedBatch.clear();
+    return false;
+    }
+  compressedBatch.resize(out_size);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVSessionServer::UnpackPushBatch(const unsigned char* data, int size,
+  bool compressed, int rawSize, std::vector<vtkSMMessage>& states)
+{
+  states.clear();
+  if (data == NULL || size <= 0 || rawSize <= 0)
+    {
+    return false;
+    }
+
+  std::vector<unsigned char> raw_data;
+  if (compressed)
+    {
+    raw_data.resize(rawSize);
+    uLongf raw_length = static_cast<uLongf>(rawSize);
+    if (uncompress(&raw_data[0], &raw_length, data,
+        static_cast<uLong>(size)) != Z_OK ||
+      raw_length != static_cast<uLongf>(rawSize))
+      {
+      return false;
+      }
+    data = &raw_data[0];
+    size = rawSize;
+    }
+  else if (size != rawSize)
+    {
+    return false;
+    }
+
+  // Each state is preceded by its length, as a 32 bit little endian integer.
+  size_t pos = 0;
+  size_t data_size = static_cast<size_t>(size);
+  while (pos < data_size)
+    {
+    if (pos + 4 > data_size)
+      {
+      states.clear();
+      return false;
+      }
+    size_t length = 0;
+    for (int cc=0; cc < 4; cc++)
+      {
+      length |= static_cast<size_t>(data[pos+cc]) << (8*cc);
+      }
+    pos += 4;
+    if (length > data_size - pos)
+      {
+      states.clear();
+      return false;
+      }
+    states.push_back(vtkSMMessage());
+    if (!states.back().ParseFromArray(length > 0? data + pos : NULL,
+        static_cast<int>(length)))
+      {
+      states.clear();
+      return false;
+      }
+    pos += length;
+    }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVSessionServer::SendLastResultToClient()
 {
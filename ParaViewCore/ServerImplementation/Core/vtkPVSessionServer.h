@@ -26,6 +26,11 @@
 #include "vtkPVServerImplementationCoreModule.h" //needed for exports
 #include "vtkPVSessionBase.h"
 
+//BTX
+#include <string> // needed for std::string
+#include <vector> // needed for std::vector
+//ETX
+
 class vtkMultiProcessController;
 class vtkMultiProcessStream;
 
@@ -75,15 +80,22 @@ public:
     REGISTER_SI                     = 16,
     UNREGISTER_SI                   = 17,
     LAST_RESULT                     = 18,
+    PUSH_BATCH                      = 19,
     SERVER_NOTIFICATION_MESSAGE_RMI = 55624,
     CLIENT_SERVER_MESSAGE_RMI       = 55625,
     CLOSE_SESSION                   = 55626,
     REPLY_GATHER_INFORMATION_TAG    = 55627,
     REPLY_PULL                      = 55628,
     REPLY_LAST_RESULT               = 55629,
-    EXECUTE_STREAM_TAG              = 55630
+    EXECUTE_STREAM_TAG              = 55630,
+    PUSH_BATCH_TAG                  = 55631
   };
 
+  // Description:
+  // Batches of pushed states smaller than this many bytes are not worth
+  // compressing.
+  enum { PUSH_BATCH_COMPRESSION_THRESHOLD = 1024 };
+
   // Description:
   // Enable or Disable multi-connection support.
   // The MultipleConnection is only used inside the DATA_SERVER to support
@@ -105,6 +117,20 @@ public:
   // Sends the message to all but the active client-session.
   virtual void NotifyOtherClients(const vtkSMMessage*);
 
+  // Description:
+  // Helpers for the PUSH_BATCH message, shared with vtkSMSessionClient.
+  // AppendToPushBatch() appends a serialized state to the batch, preceded by
+  // its length as a 32 bit little endian integer. CompressPushBatch()
+  // compresses the batch and returns false when it is too small or does not
+  // shrink, in which case it is sent as is. UnpackPushBatch() reverses both
+  // and returns false, with no states, if the batch is corrupted.
+  static void AppendToPushBatch(std::vector<unsigned char>& batch,
+    const std::string& state);
+  static bool CompressPushBatch(const std::vector<unsigned char>& batch,
+    std::vector<unsigned char>& compressedBatch);
+  static bool UnpackPushBatch(const unsigned char* data, int size,
+    bool compressed, int rawSize, std::vector<vtkSMMessage>& states);
+
 protected:
   vtkPVSessionServer();
   ~vtkPVSessionServer();
@@ -119,6 +145,16 @@ protected:
   // Sends the last result to client.
   void SendLastResultToClient();
 
+  // Description:
+  // Called when the client pushes a state, either on its own (PUSH) or as
+  // part of a batch (PUSH_BATCH).
+  void PushStateFromClient(vtkSMMessage* msg);
+
+  // Description:
+  // Receives a batch of pushed states queued by the client (see
+  // vtkSMSessionClient::BeginPushTransaction()) and pushes them in order.
+  void ReceivePushBatch(int compressed, int rawSize, int size);
+
   vtkMPIMToNSocketConnection* MPIMToNSocketConnection;
 
   bool MultipleConnection;
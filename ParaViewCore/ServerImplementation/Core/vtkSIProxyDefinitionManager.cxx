@@ -17,6 +17,7 @@
 #include "vtkCollection.h"
 #include "vtkCollectionIterator.h"
 #include "vtkCommand.h"
+#include "vtkMultiProcessController.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVConfig.h"
@@ -35,14 +36,20 @@
 #include "vtkStringList.h"
 #include "vtkTimerLog.h"
 
+#include <vtksys/ios/fstream>
 #include <vtksys/ios/sstream>
 #include <map>
+#include <vtksys/Directory.hxx>
 #include <vtksys/RegularExpression.hxx>
+#include <vtksys/SystemTools.hxx>
+#include <iterator>
 #include <set>
 #include <string>
 #include <vector>
 
 #include <assert.h>
+#include <stdio.h>
+#include <time.h>
 
 // this file must be included after vtkPVConfig etc. are included.
 // #include "vtkSMGeneratedModules.h"
@@ -54,6 +61,133 @@ typedef vtkSmartPointer<vtkPVXMLElement>        XMLElement;
 typedef std::map<vtkStdString, XMLElement>   StrToXmlMap;
 typedef std::map<vtkStdString, StrToXmlMap>  StrToStrToXmlMap;
 
+//****************************************************************************/
+//                    Binary definition cache
+//****************************************************************************/
+namespace
+{
+  // See vtkSIProxyDefinitionManager::SetDefinitionCacheDirectory().
+  std::string DefinitionCacheDirectory;
+  bool DefinitionCacheDirectoryInitialized = false;
+
+  // Change the version whenever the layout written by
+  // vtkPVXMLElement::SerializeBinary() changes.
+  const char DefinitionCacheMagic[] = "PVDEFS01";
+  const size_t DefinitionCacheMagicLength = sizeof(DefinitionCacheMagic) - 1;
+
+  // The cache file is named after a 64-bit FNV-1a hash of the XML and its
+  // length.
+  std::string GetDefinitionCacheFileName(const char* dir, const char* xml)
+    {
+    const vtkTypeUInt64 prime =
+      (static_cast<vtkTypeUInt64>(0x00000100) << 32) | 0x000001b3;
+    vtkTypeUInt64 hash =
+      (static_cast<vtkTypeUInt64>(0xcbf29ce4) << 32) | 0x84222325;
+    size_t length = 0;
+    for (; xml[length]; length++)
+      {
+      hash ^= static_cast<unsigned char>(xml[length]);
+      hash *= prime;
+      }
+
+    char name[64];
+    sprintf(name, "%08x%08x-%lu.pvdefs",
+      static_cast<unsigned int>(hash >> 32),
+      static_cast<unsigned int>(hash & 0xffffffff),
+      static_cast<unsigned long>(length));
+    return std::string(dir) + "/" + name;
+    }
+
+  // Reads the serialized tree (without the magic) from a cache entry.
+  bool ReadDefinitionCache(const std::string& fileName, std::string& buffer)
+    {
+    vtksys_ios::ifstream file(fileName.c_str(), ios::in | ios::binary);
+    if (!file)
+      {
+      return false;
+      }
+    buffer.assign((std::istreambuf_iterator<char>(file)),
+      std::istreambuf_iterator<char>());
+    if (buffer.size() < DefinitionCacheMagicLength ||
+      buffer.compare(0, DefinitionCacheMagicLength, DefinitionCacheMagic) != 0)
+      {
+      buffer.clear();
+      return false;
+      }
+    buffer.erase(0, DefinitionCacheMagicLength);
+    return true;
+    }
+
+  // Failures are ignored, the XML will simply be parsed again next time.
+  void WriteDefinitionCache(const std::string& fileName,
+    const std::string& buffer)
+    {
+    // Write to a temporary file and rename it so that readers never see a
+    // partially written entry.
+    vtksys_ios::ostringstream tmpName;
+    tmpName << fileName << "." << static_cast<unsigned long>(
+      vtksys::SystemTools::GetTime() * 1.0e6) << ".tmp";
+    std::string tmpFileName = tmpName.str();
+
+    bool success = false;
+      {
+      vtksys_ios::ofstream file(tmpFileName.c_str(), ios::out | ios::binary);
+      if (!file)
+        {
+        return;
+        }
+      file.write(DefinitionCacheMagic, DefinitionCacheMagicLength);
+      file.write(buffer.data(), buffer.size());
+      file.close();
+      success = !file.fail();
+      }
+    if (!success || rename(tmpFileName.c_str(), fileName.c_str()) != 0)
+      {
+      remove(tmpFileName.c_str());
+      }
+    }
+
+  // Removes temporary files left behind by writers that did not finish, and
+  // entries that have not been written for a while. Since editing an XML
+  // yields a new entry, the old one would otherwise stay forever. Entries
+  // still in use are simply written again after they expire.
+  void PruneDefinitionCache(const char* dir)
+    {
+    const long tmpMaxAge = 3600;
+    const long entryMaxAge = 30 * 24 * 3600;
+
+    vtksys::Directory directory;
+    if (!directory.Load(dir))
+      {
+      return;
+      }
+    long now = static_cast<long>(time(NULL));
+    for (unsigned long cc=0; cc < directory.GetNumberOfFiles(); cc++)
+      {
+      std::string name = directory.GetFile(cc);
+      long maxAge;
+      if (name.find(".pvdefs.") != std::string::npos &&
+        vtksys::SystemTools::StringEndsWith(name.c_str(), ".tmp"))
+        {
+        maxAge = tmpMaxAge;
+        }
+      else if (vtksys::SystemTools::StringEndsWith(name.c_str(), ".pvdefs"))
+        {
+        maxAge = entryMaxAge;
+        }
+      else
+        {
+        continue;
+        }
+      std::string path = std::string(dir) + "/" + name;
+      if (now - vtksys::SystemTools::ModifiedTime(path.c_str()) > maxAge)
+        {
+        remove(path.c_str());
+        }
+      }
+    }
+}
+
 class vtkSIProxyDefinitionManager::vtkInternals
 {
 public:
@@ -808,10 +942,115 @@ bool vtkSIProxyDefinitionManager::LoadConfigurationXMLFromString(const char* xml
 //---------------------------------------------------------------------------
 bool vtkSIProxyDefinitionManager::LoadConfigurationXMLFromString( const char* xmlContent,
                                                                   bool attachHints)
+{
+  vtkSmartPointer<vtkPVXMLElement> root;
+  root.TakeReference(this->NewConfigurationXML(xmlContent));
+  return this->LoadConfigurationXML(root, attachHints);
+}
+
+//---------------------------------------------------------------------------
+vtkPVXMLElement* vtkSIProxyDefinitionManager::NewConfigurationXML(
+  const char* xmlContent)
+{
+  const char* cacheDir =
+    vtkSIProxyDefinitionManager::GetDefinitionCacheDirectory();
+  if (!xmlContent || !cacheDir || !cacheDir[0])
+    {
+    return vtkSIProxyDefinitionManager::ParseConfigurationXML(xmlContent);
+    }
+
+  // Only the root process touches the cache; it sends the serialized tree to
+  // the others so that they do not all hit the (often shared) cache directory.
+  vtkMultiProcessController* controller =
+    vtkMultiProcessController::GetGlobalController();
+  bool parallel = controller && controller->GetNumberOfProcesses() > 1;
+  bool isRoot = !controller || controller->GetLocalProcessId() == 0;
+
+  vtkPVXMLElement* root = NULL;
+  std::string buffer;
+  if (isRoot)
+    {
+    std::string cacheFileName =
+      GetDefinitionCacheFileName(cacheDir, xmlContent);
+    if (ReadDefinitionCache(cacheFileName, buffer))
+      {
+      root = vtkPVXMLElement::NewFromBinary(buffer.data(), buffer.size());
+      }
+    if (!root)
+      {
+      buffer.clear();
+      root = vtkSIProxyDefinitionManager::ParseConfigurationXML(xmlContent);
+      if (root)
+        {
+        // Serialize before LoadConfigurationXML() attaches hints to the tree.
+        root->SerializeBinary(buffer);
+        vtksys::SystemTools::MakeDirectory(cacheDir);
+        static bool pruned = false;
+        if (!pruned)
+          {
+          PruneDefinitionCache(cacheDir);
+          pruned = true;
+          }
+        WriteDefinitionCache(cacheFileName, buffer);
+        }
+      }
+    }
+
+  if (parallel)
+    {
+    vtkIdType length = static_cast<vtkIdType>(buffer.size());
+    controller->Broadcast(&length, 1, 0);
+    if (length > 0)
+      {
+      buffer.resize(static_cast<size_t>(length));
+      controller->Broadcast(&buffer[0], length, 0);
+      }
+    if (!isRoot)
+      {
+      root = length > 0?
+        vtkPVXMLElement::NewFromBinary(buffer.data(), buffer.size()) : NULL;
+      if (!root)
+        {
+        // report the same parse errors as the root.
+        root = vtkSIProxyDefinitionManager::ParseConfigurationXML(xmlContent);
+        }
+      }
+    }
+  return root;
+}
+
+//---------------------------------------------------------------------------
+vtkPVXMLElement* vtkSIProxyDefinitionManager::ParseConfigurationXML(
+  const char* xmlContent)
 {
   vtkNew<vtkPVXMLParser> parser;
-  return (parser->Parse(xmlContent) != 0) &&
-      this->LoadConfigurationXML( parser->GetRootElement(), attachHints );
+  if (!parser->Parse(xmlContent) || !parser->GetRootElement())
+    {
+    return NULL;
+    }
+  vtkPVXMLElement* root = parser->GetRootElement();
+  root->Register(NULL);
+  return root;
+}
+
+//---------------------------------------------------------------------------
+void vtkSIProxyDefinitionManager::SetDefinitionCacheDirectory(const char* dir)
+{
+  DefinitionCacheDirectory = dir? dir : "";
+  DefinitionCacheDirectoryInitialized = true;
+}
+
+//---------------------------------------------------------------------------
+const char* vtkSIProxyDefinitionManager::GetDefinitionCacheDirectory()
+{
+  if (!DefinitionCacheDirectoryInitialized)
+    {
+    const char* env =
+      vtksys::SystemTools::GetEnv("PV_PROXY_DEFINITION_CACHE_DIR");
+    DefinitionCacheDirectory = env? env : "";
+    DefinitionCacheDirectoryInitialized = true;
+    }
+  return DefinitionCacheDirectory.c_str();
 }
 
 //---------------------------------------------------------------------------
@@ -869,6 +1108,8 @@ bool vtkSIProxyDefinitionManager::LoadConfigurationXML(vtkPVXMLElement* root, bo
 void vtkSIProxyDefinitionManager::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "DefinitionCacheDirectory: "
+     << vtkSIProxyDefinitionManager::GetDefinitionCacheDirectory() << endl;
 }
 //---------------------------------------------------------------------------
 // vtkSIProxyDefinitionManager::ALL_DEFINITIONS    = 0
@@ -64,6 +64,19 @@ public:
   // from legacy XML
   static void PatchXMLProperty(vtkPVXMLElement* propElement);
 
+  // Description:
+  // Set/Get the directory used to cache the parsed ServerManager XML (core
+  // and plugins) in binary form. Each XML input is stored in a file named
+  // after a hash of its content and is read back from there instead of being
+  // parsed again; editing the XML simply yields a new cache entry. Only the
+  // root process reads and writes the cache, and broadcasts the tree to the
+  // other processes; the directory must therefore be the same on all
+  // processes. Leftover temporary files and entries not written for 30 days
+  // are removed. Defaults to the PV_PROXY_DEFINITION_CACHE_DIR environment
+  // variable. The cache is not used when empty.
+  static void SetDefinitionCacheDirectory(const char* dir);
+  static const char* GetDefinitionCacheDirectory();
+
   // Description:
   // Returns a registered proxy definition or return a NULL otherwise.
   // Moreover, error can be throw if the definition was not found if the
@@ -238,6 +251,15 @@ protected:
   bool LoadConfigurationXML(vtkPVXMLElement* root, bool attachShowInMenuHints);
   bool LoadConfigurationXMLFromString(const char* xmlContent, bool attachShowInMenuHints);
 
+  // Description:
+  // Returns the root element for xmlContent, read from the definition cache
+  // when possible and parsed (and added to the cache) otherwise. When the
+  // cache is used, this is a collective operation on the global controller.
+  // The caller must Delete() the returned element. Returns NULL if parsing
+  // failed.
+  vtkPVXMLElement* NewConfigurationXML(const char* xmlContent);
+  static vtkPVXMLElement* ParseConfigurationXML(const char* xmlContent);
+
   // Description:
   // Callback called when a plugin is loaded.
   void OnPluginLoaded(vtkObject* caller, unsigned long event, void* calldata);
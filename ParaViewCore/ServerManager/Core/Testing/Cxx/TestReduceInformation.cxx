@@ -0,0 +1,221 @@
+/*=========================================================================
+
+Program:   ParaView
+Module:    TestReduceInformation.cxx
+
+Copyright (c) Kitware, Inc.
+All rights reserved.
+See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkClientServerStream.h"
+#include "vtkDoubleArray.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkMultiProcessController.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkProcessModule.h"
+#include "vtkPVArrayInformation.h"
+#include "vtkPVCompositeDataInformation.h"
+#include "vtkPVDataInformation.h"
+#include "vtkPVDataSetAttributesInformation.h"
+#include "vtkPVSessionCore.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+
+#include <iostream>
+#include <vector>
+
+namespace
+{
+  const int BLOCKS_PER_RANK = 3;
+
+  // Every rank owns BLOCKS_PER_RANK blocks of a multiblock dataset with
+  // BLOCKS_PER_RANK blocks per rank, the others are empty on that rank.
+  // Block sizes and the "Rank" array differ from rank to rank.
+  vtkSmartPointer<vtkMultiBlockDataSet> NewData(int rank, int nranks)
+    {
+    vtkSmartPointer<vtkMultiBlockDataSet> data =
+      vtkSmartPointer<vtkMultiBlockDataSet>::New();
+    data->SetNumberOfBlocks(nranks * BLOCKS_PER_RANK);
+    for (int cc=0; cc < BLOCKS_PER_RANK; cc++)
+      {
+      vtkNew<vtkSphereSource> sphere;
+      sphere->SetCenter(3.0 * rank, cc, 0);
+      sphere->SetThetaResolution(8 + rank + cc);
+      sphere->Update();
+
+      vtkNew<vtkPolyData> block;
+      block->ShallowCopy(sphere->GetOutput());
+      vtkNew<vtkDoubleArray> ranks;
+      ranks->SetName("Rank");
+      ranks->SetNumberOfTuples(block->GetNumberOfPoints());
+      ranks->FillComponent(0, rank * 10 + cc);
+      block->GetPointData()->AddArray(ranks.GetPointer());
+      data->SetBlock(rank * BLOCKS_PER_RANK + cc, block.GetPointer());
+      }
+    return data;
+    }
+
+  // The reference: every rank sends its information straight to the root,
+  // which merges them in rank order.
+  void GatherToRoot(vtkMultiProcessController* controller,
+    vtkPVDataInformation* info)
+    {
+    const int tag = 3827;
+    int rank = controller->GetLocalProcessId();
+    if (rank != 0)
+      {
+      vtkClientServerStream stream;
+      info->CopyToStream(&stream);
+      const unsigned char* data;
+      size_t length;
+      stream.GetData(&data, &length);
+      vtkIdType size = static_cast<vtkIdType>(length);
+      controller->Send(&size, 1, 0, tag);
+      controller->Send(data, size, 0, tag);
+      return;
+      }
+    for (int cc=1; cc < controller->GetNumberOfProcesses(); cc++)
+      {
+      vtkIdType size;
+      controller->Receive(&size, 1, cc, tag);
+      std::vector<unsigned char> data(size);
+      controller->Receive(&data[0], size, cc, tag);
+      vtkClientServerStream stream;
+      stream.SetData(&data[0], data.size());
+      vtkNew<vtkPVDataInformation> remote;
+      remote->CopyFromStream(&stream);
+      info->AddInformation(remote.GetPointer());
+      }
+    }
+
+  bool CompareSummary(vtkPVDataInformation* actual,
+    vtkPVDataInformation* expected)
+    {
+    double actualBounds[6], expectedBounds[6];
+    actual->GetBounds(actualBounds);
+    expected->GetBounds(expectedBounds);
+    for (int cc=0; cc < 6; cc++)
+      {
+      if (actualBounds[cc] != expectedBounds[cc])
+        {
+        std::cerr << "ERROR: Bounds differ." << std::endl;
+        return false;
+        }
+      }
+    if (actual->GetNumberOfPoints() != expected->GetNumberOfPoints() ||
+      actual->GetNumberOfCells() != expected->GetNumberOfCells() ||
+      actual->GetNumberOfDataSets() != expected->GetNumberOfDataSets() ||
+      actual->GetMemorySize() != expected->GetMemorySize())
+      {
+      std::cerr << "ERROR: Counts differ: " << actual->GetNumberOfPoints()
+                << " points, " << actual->GetNumberOfCells() << " cells, "
+                << actual->GetNumberOfDataSets() << " datasets, expected "
+                << expected->GetNumberOfPoints() << ", "
+                << expected->GetNumberOfCells() << ", "
+                << expected->GetNumberOfDataSets() << "." << std::endl;
+      return false;
+      }
+    vtkPVArrayInformation* actualArray =
+      actual->GetPointDataInformation()->GetArrayInformation("Rank");
+    vtkPVArrayInformation* expectedArray =
+      expected->GetPointDataInformation()->GetArrayInformation("Rank");
+    if (!actualArray || !expectedArray ||
+      actualArray->GetComponentRange(0)[0] !=
+      expectedArray->GetComponentRange(0)[0] ||
+      actualArray->GetComponentRange(0)[1] !=
+      expectedArray->GetComponentRange(0)[1])
+      {
+      std::cerr << "ERROR: The \"Rank\" ranges differ." << std::endl;
+      return false;
+      }
+    return true;
+    }
+
+  bool CompareBlocks(vtkPVDataInformation* actual,
+    vtkPVDataInformation* expected)
+    {
+    vtkPVCompositeDataInformation* actualBlocks =
+      actual->GetCompositeDataInformation();
+    vtkPVCompositeDataInformation* expectedBlocks =
+      expected->GetCompositeDataInformation();
+    if (actualBlocks->GetNumberOfChildren() !=
+      expectedBlocks->GetNumberOfChildren())
+      {
+      std::cerr << "ERROR: " << actualBlocks->GetNumberOfChildren()
+                << " blocks instead of "
+                << expectedBlocks->GetNumberOfChildren() << "." << std::endl;
+      return false;
+      }
+    for (unsigned int cc=0; cc < expectedBlocks->GetNumberOfChildren(); cc++)
+      {
+      vtkPVDataInformation* actualChild = actualBlocks->GetDataInformation(cc);
+      vtkPVDataInformation* expectedChild =
+        expectedBlocks->GetDataInformation(cc);
+      if (!actualChild || !expectedChild ||
+        actualChild->GetNumberOfPoints() != expectedChild->GetNumberOfPoints())
+        {
+        std::cerr << "ERROR: Block " << cc << " differs." << std::endl;
+        return false;
+        }
+      }
+    return true;
+    }
+}
+
+// Checks that the tree reduction used to collect information from the
+// satellites merges the same information as gathering every process'
+// information on the root, with and without the per-block information.
+// Run it on several MPI processes, ideally not a power of two.
+int TestReduceInformation(int argc, char* argv[])
+{
+  vtkProcessModule::Initialize(vtkProcessModule::PROCESS_BATCH, argc, argv);
+  vtkMultiProcessController* controller =
+    vtkMultiProcessController::GetGlobalController();
+  int rank = controller->GetLocalProcessId();
+  int nranks = controller->GetNumberOfProcesses();
+
+  vtkSmartPointer<vtkMultiBlockDataSet> data = NewData(rank, nranks);
+  int status = EXIT_SUCCESS;
+  for (int skip=0; skip < 2; skip++)
+    {
+    vtkNew<vtkPVDataInformation> reduced;
+    reduced->SetSkipCompositeDataInformation(skip != 0);
+    reduced->CopyFromObject(data);
+    vtkPVSessionCore::ReduceInformation(controller, reduced.GetPointer());
+
+    vtkNew<vtkPVDataInformation> gathered;
+    gathered->CopyFromObject(data);
+    GatherToRoot(controller, gathered.GetPointer());
+
+    if (rank == 0)
+      {
+      if (!CompareSummary(reduced.GetPointer(), gathered.GetPointer()) ||
+        (!skip && !CompareBlocks(reduced.GetPointer(), gathered.GetPointer())))
+        {
+        std::cerr << "ERROR: Reduction over " << nranks << " processes "
+                  << (skip? "without" : "with")
+                  << " per-block information differs from the gather."
+                  << std::endl;
+        status = EXIT_FAILURE;
+        }
+      if (gathered->GetNumberOfDataSets() != nranks * BLOCKS_PER_RANK)
+        {
+        std::cerr << "ERROR: " << gathered->GetNumberOfDataSets()
+                  << " datasets were gathered." << std::endl;
+        status = EXIT_FAILURE;
+        }
+      }
+    }
+
+  controller->Broadcast(&status, 1, 0);
+  vtkProcessModule::Finalize();
+  return status;
+}
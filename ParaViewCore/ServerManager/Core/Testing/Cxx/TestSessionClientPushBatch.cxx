@@ -0,0 +1,276 @@
+/*=========================================================================
+
+Program:   ParaView
+Module:    TestSessionClientPushBatch.cxx
+
+Copyright (c) Kitware, Inc.
+All rights reserved.
+See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkDummyController.h"
+#include "vtkInitializationHelper.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkProcessModule.h"
+#include "vtkPVSession.h"
+#include "vtkPVSessionServer.h"
+#include "vtkSMMessage.h"
+#include "vtkSMSessionClient.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  // A session client that records the batches it would send to the servers
+  // instead of sending them.
+  class vtkRecordingSessionClient : public vtkSMSessionClient
+  {
+  public:
+    static vtkRecordingSessionClient* New();
+    vtkTypeMacro(vtkRecordingSessionClient, vtkSMSessionClient);
+
+    struct Batch
+      {
+      vtkMultiProcessController* Controller;
+      std::vector<vtkTypeUInt64> Ids;
+      };
+    std::vector<Batch> Batches;
+
+    void SetControllers(vtkMultiProcessController* dataServer,
+      vtkMultiProcessController* renderServer)
+      {
+      this->SetDataServerController(dataServer);
+      this->SetRenderServerController(renderServer);
+      }
+
+  protected:
+    vtkRecordingSessionClient() {}
+    ~vtkRecordingSessionClient()
+      {
+      this->SetControllers(NULL, NULL);
+      }
+
+    // Goes through the same packing as the real thing and unpacks the batch
+    // as the server would.
+    virtual void SendPushBatch(vtkMultiProcessController* controller,
+      const std::vector<unsigned char>& batch)
+      {
+      Batch record;
+      record.Controller = controller;
+      std::vector<unsigned char> compressed;
+      bool isCompressed =
+        vtkPVSessionServer::CompressPushBatch(batch, compressed);
+      const std::vector<unsigned char>& data = isCompressed? compressed : batch;
+      std::vector<vtkSMMessage> states;
+      if (vtkPVSessionServer::UnpackPushBatch(&data[0],
+          static_cast<int>(data.size()), isCompressed,
+          static_cast<int>(batch.size()), states))
+        {
+        for (size_t cc=0; cc < states.size(); cc++)
+          {
+          record.Ids.push_back(states[cc].global_id());
+          }
+        }
+      this->Batches.push_back(record);
+      }
+
+  private:
+    vtkRecordingSessionClient(const vtkRecordingSessionClient&);
+    void operator=(const vtkRecordingSessionClient&);
+  };
+  vtkStandardNewMacro(vtkRecordingSessionClient);
+
+  vtkSMMessage NewState(vtkTypeUInt64 id, vtkTypeUInt32 location)
+    {
+    vtkSMMessage state;
+    state.set_global_id(id);
+    state.set_location(location);
+    return state;
+    }
+
+  void Push(vtkSMSessionClient* session, vtkTypeUInt64 id,
+    vtkTypeUInt32 location)
+    {
+    vtkSMMessage state = NewState(id, location);
+    session->PushState(&state);
+    }
+
+  bool CheckBatch(const vtkRecordingSessionClient::Batch& batch,
+    vtkMultiProcessController* controller, const vtkTypeUInt64* ids,
+    size_t numberOfIds)
+    {
+    return batch.Controller == controller &&
+      batch.Ids == std::vector<vtkTypeUInt64>(ids, ids + numberOfIds);
+    }
+
+  // Packs numberOfStates states, with increasing ids, in a batch.
+  std::vector<unsigned char> NewBatch(int numberOfStates)
+    {
+    std::vector<unsigned char> batch;
+    for (int cc=0; cc < numberOfStates; cc++)
+      {
+      vtkPVSessionServer::AppendToPushBatch(batch,
+        NewState(cc + 1, vtkPVSession::DATA_SERVER).SerializeAsString());
+      }
+    return batch;
+    }
+
+  bool CheckStates(const std::vector<vtkSMMessage>& states,
+    int numberOfStates)
+    {
+    if (static_cast<int>(states.size()) != numberOfStates)
+      {
+      return false;
+      }
+    for (int cc=0; cc < numberOfStates; cc++)
+      {
+      if (states[cc].global_id() != static_cast<vtkTypeUInt64>(cc + 1) ||
+        states[cc].location() != vtkPVSession::DATA_SERVER)
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+}
+
+#define TEST_ASSERT(cond)                                                     \
+  if (!(cond))                                                                \
+    {                                                                         \
+    std::cerr << "ERROR: Failed at line " << __LINE__ << ": " #cond           \
+              << std::endl;                                                   \
+    return EXIT_FAILURE;                                                      \
+    }
+
+// Checks that batches of pushed states survive packing, compression and
+// unpacking, that corrupted batches are rejected as a whole, and that
+// vtkSMSessionClient sends the queued states, in order, only when the
+// outermost push transaction ends or something else must reach the servers.
+int TestSessionClientPushBatch(int argc, char* argv[])
+{
+  (void) argc;
+  vtkInitializationHelper::Initialize(argv[0], vtkProcessModule::PROCESS_CLIENT);
+
+  // small batches are sent as is.
+  std::vector<unsigned char> batch = NewBatch(3);
+  std::vector<unsigned char> compressed;
+  TEST_ASSERT(!vtkPVSessionServer::CompressPushBatch(batch, compressed));
+  std::vector<vtkSMMessage> states;
+  TEST_ASSERT(vtkPVSessionServer::UnpackPushBatch(&batch[0],
+      static_cast<int>(batch.size()), false, static_cast<int>(batch.size()),
+      states));
+  TEST_ASSERT(CheckStates(states, 3));
+
+  // batches truncated within their last state are rejected.
+  for (size_t length = NewBatch(2).size() + 1; length < batch.size(); length++)
+    {
+    if (vtkPVSessionServer::UnpackPushBatch(&batch[0],
+        static_cast<int>(length), false, static_cast<int>(length), states) ||
+      !states.empty())
+      {
+      std::cerr << "ERROR: A batch truncated to " << length << " of "
+                << batch.size() << " bytes was accepted." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // a state that does not parse rejects the whole batch.
+  std::vector<unsigned char> invalid = NewBatch(2);
+  vtkSMMessage incomplete;
+  incomplete.set_global_id(3);
+  vtkPVSessionServer::AppendToPushBatch(invalid,
+    incomplete.SerializePartialAsString());
+  TEST_ASSERT(!vtkPVSessionServer::UnpackPushBatch(&invalid[0],
+      static_cast<int>(invalid.size()), false,
+      static_cast<int>(invalid.size()), states));
+  TEST_ASSERT(states.empty());
+
+  // large batches are compressed.
+  batch = NewBatch(500);
+  TEST_ASSERT(vtkPVSessionServer::CompressPushBatch(batch, compressed));
+  TEST_ASSERT(compressed.size() < batch.size());
+  TEST_ASSERT(vtkPVSessionServer::UnpackPushBatch(&compressed[0],
+      static_cast<int>(compressed.size()), true,
+      static_cast<int>(batch.size()), states));
+  TEST_ASSERT(CheckStates(states, 500));
+  TEST_ASSERT(!vtkPVSessionServer::UnpackPushBatch(&compressed[0],
+      static_cast<int>(compressed.size()), true,
+      static_cast<int>(batch.size()) - 1, states));
+  TEST_ASSERT(!vtkPVSessionServer::UnpackPushBatch(&compressed[0],
+      static_cast<int>(compressed.size()) / 2, true,
+      static_cast<int>(batch.size()), states));
+  TEST_ASSERT(states.empty());
+
+  // flush ordering.
+  vtkNew<vtkDummyController> dataServer;
+  vtkNew<vtkDummyController> renderServer;
+  vtkRecordingSessionClient* session = vtkRecordingSessionClient::New();
+  session->SetControllers(dataServer.GetPointer(), renderServer.GetPointer());
+
+  session->BeginPushTransaction();
+  Push(session, 1, vtkPVSession::DATA_SERVER);
+  Push(session, 2, vtkPVSession::RENDER_SERVER);
+  Push(session, 3, vtkPVSession::DATA_SERVER_ROOT);
+  Push(session, 4, vtkPVSession::SERVERS);
+  session->BeginPushTransaction();
+  Push(session, 5, vtkPVSession::DATA_SERVER);
+  session->EndPushTransaction();
+  // nothing is sent before the outermost transaction ends.
+  TEST_ASSERT(session->GetPushTransactionDepth() == 1);
+  TEST_ASSERT(session->Batches.empty());
+
+  // an explicit flush sends one batch per server, in push order, and keeps
+  // the transaction open.
+  session->FlushPushTransaction();
+  TEST_ASSERT(session->GetPushTransactionDepth() == 1);
+  TEST_ASSERT(session->Batches.size() == 2);
+  const vtkTypeUInt64 dataIds[] = { 1, 3, 4, 5 };
+  const vtkTypeUInt64 renderIds[] = { 2, 4 };
+  for (size_t cc=0; cc < 2; cc++)
+    {
+    const vtkRecordingSessionClient::Batch& sent = session->Batches[cc];
+    TEST_ASSERT(
+      CheckBatch(sent, dataServer.GetPointer(), dataIds, 4) ||
+      CheckBatch(sent, renderServer.GetPointer(), renderIds, 2));
+    }
+  TEST_ASSERT(session->Batches[0].Controller !=
+    session->Batches[1].Controller);
+  session->Batches.clear();
+  session->FlushPushTransaction();
+  TEST_ASSERT(session->Batches.empty());
+
+  // states pushed after the flush go when the transaction ends.
+  Push(session, 6, vtkPVSession::DATA_SERVER);
+  Push(session, 7, vtkPVSession::DATA_SERVER);
+  session->EndPushTransaction();
+  TEST_ASSERT(session->GetPushTransactionDepth() == 0);
+  TEST_ASSERT(session->Batches.size() == 1);
+  const vtkTypeUInt64 lastIds[] = { 6, 7 };
+  TEST_ASSERT(
+    CheckBatch(session->Batches[0], dataServer.GetPointer(), lastIds, 2));
+  session->Batches.clear();
+
+  // disconnecting sends the queued states before anything else.
+  session->BeginPushTransaction();
+  Push(session, 8, vtkPVSession::DATA_SERVER);
+  TEST_ASSERT(session->Batches.empty());
+  session->PreDisconnection();
+  TEST_ASSERT(session->Batches.size() == 1);
+  const vtkTypeUInt64 closeIds[] = { 8 };
+  TEST_ASSERT(
+    CheckBatch(session->Batches[0], dataServer.GetPointer(), closeIds, 1));
+  session->EndPushTransaction();
+  TEST_ASSERT(session->Batches.size() == 1);
+
+  session->Delete();
+  vtkInitializationHelper::Finalize();
+  return EXIT_SUCCESS;
+}
@@ -41,12 +41,14 @@
 #include "vtkSMSessionProxyManager.h"
 #include "vtkSocketCommunicator.h"
 
+#include <map>
 #include <string>
 #include <vtksys/ios/sstream>
 #include <vtksys/RegularExpression.hxx>
 
 #include <assert.h>
 #include <set>
+#include <vector>
 
 //****************************************************************************/
 //                    Internal Classes and typedefs
@@ -59,6 +61,23 @@ namespace
     vtkSMSessionClient* self = reinterpret_cast<vtkSMSessionClient*>(localArg);
     self->OnServerNotificationMessageRMI(remoteArg, remoteArgLength);
     }
+
+};
+
+//****************************************************************************/
+// States pushed during a push transaction, queued per controller. Each state
+// is preceded by its length as a 32 bit little endian integer.
+class vtkSMSessionClient::vtkPushQueue
+{
+public:
+  typedef std::map<vtkMultiProcessController*,
+                   std::vector<unsigned char> > BatchesType;
+  BatchesType Batches;
+
+  void Add(vtkMultiProcessController* controller, const std::string& message)
+    {
+    vtkPVSessionServer::AppendToPushBatch(this->Batches[controller], message);
+    }
 };
 //****************************************************************************/
 vtkStandardNewMacro(vtkSMSessionClient);
@@ -92,6 +111,8 @@ vtkSMSessionClient::vtkSMSessionClient() : Superclass(false)
   // Default value
   this->NoMoreDelete = false;
   this->NotBusy = 0;
+  this->PushTransactionDepth = 0;
+  this->PushQueue = new vtkPushQueue();
 }
 
 //----------------------------------------------------------------------------
@@ -120,6 +141,9 @@ vtkSMSessionClient::~vtkSMSessionClient()
 
   delete this->ServerLastInvokeResult;
   this->ServerLastInvokeResult = NULL;
+
+  delete this->PushQueue;
+  this->PushQueue = NULL;
 }
 
 //----------------------------------------------------------------------------
@@ -456,6 +480,7 @@ bool vtkSMSessionClient::IsMPIInitialized(vtkTypeUInt32 servers)
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::CloseSession()
 {
+  this->FlushPushTransaction();
   if (this->DataServerController)
     {
     this->DataServerController->TriggerRMIOnAllChildren(
@@ -476,6 +501,7 @@ void vtkSMSessionClient::CloseSession()
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::PreDisconnection()
 {
+  this->FlushPushTransaction();
   this->NoMoreDelete = true;
 }
 
@@ -525,16 +551,27 @@ void vtkSMSessionClient::PushState(vtkSMMessage* message)
     }
   if (num_controllers > 0)
     {
-    vtkMultiProcessStream stream;
-    stream << static_cast<int>(vtkPVSessionServer::PUSH);
-    stream << message->SerializeAsString();
-    std::vector<unsigned char> raw_message;
-    stream.GetRawData(raw_message);
-    for (int cc=0; cc < num_controllers; cc++)
+    std::string serialized_message = message->SerializeAsString();
+    if (this->PushTransactionDepth > 0)
       {
-      controllers[cc]->TriggerRMIOnAllChildren(
-          &raw_message[0], static_cast<int>(raw_message.size()),
-          vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+      for (int cc=0; cc < num_controllers; cc++)
+        {
+        this->PushQueue->Add(controllers[cc], serialized_message);
+        }
+      }
+    else
+      {
+      vtkMultiProcessStream stream;
+      stream << static_cast<int>(vtkPVSessionServer::PUSH);
+      stream << serialized_message;
+      std::vector<unsigned char> raw_message;
+      stream.GetRawData(raw_message);
+      for (int cc=0; cc < num_controllers; cc++)
+        {
+        controllers[cc]->TriggerRMIOnAllChildren(
+            &raw_message[0], static_cast<int>(raw_message.size()),
+            vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+        }
       }
     }
 
@@ -566,14 +603,22 @@ void vtkSMSessionClient::PushState(vtkSMMessage* message)
         msg.set_share_only(true);
         msg.set_client_id(this->ServerInformation->GetClientId());
 
-        vtkMultiProcessStream stream;
-        stream << static_cast<int>(vtkPVSessionServer::PUSH);
-        stream << msg.SerializeAsString();
-        std::vector<unsigned char> raw_message;
-        stream.GetRawData(raw_message);
-        this->DataServerController->TriggerRMIOnAllChildren(
-            &raw_message[0], static_cast<int>(raw_message.size()),
-            vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+        if (this->PushTransactionDepth > 0)
+          {
+          this->PushQueue->Add(this->DataServerController,
+            msg.SerializeAsString());
+          }
+        else
+          {
+          vtkMultiProcessStream stream;
+          stream << static_cast<int>(vtkPVSessionServer::PUSH);
+          stream << msg.SerializeAsString();
+          std::vector<unsigned char> raw_message;
+          stream.GetRawData(raw_message);
+          this->DataServerController->TriggerRMIOnAllChildren(
+              &raw_message[0], static_cast<int>(raw_message.size()),
+              vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+          }
         }
       else if(!remoteObject)
         {
@@ -600,6 +645,7 @@ void vtkSMSessionClient::PushState(vtkSMMessage* message)
 void vtkSMSessionClient::PullState(vtkSMMessage* message)
 {
   this->StartBusyWork();
+  this->FlushPushTransaction();
   vtkTypeUInt32 location = this->GetRealLocation(message->location());
   message->set_location(location);
 
@@ -659,6 +705,8 @@ void vtkSMSessionClient::ExecuteStream(
     return;
     }
 
+  this->FlushPushTransaction();
+
   location = this->GetRealLocation(location);
 
   vtkMultiProcessController* controllers[2] = {NULL, NULL};
@@ -706,6 +754,7 @@ void vtkSMSessionClient::ExecuteStream(
 const vtkClientServerStream& vtkSMSessionClient::GetLastResult(vtkTypeUInt32 location)
 {
   this->StartBusyWork();
+  this->FlushPushTransaction();
   location = this->GetRealLocation(location);
 
   vtkMultiProcessController* controller = NULL;
@@ -739,10 +788,10 @@ const vtkClientServerStream& vtkSMSessionClient::GetLastResult(vtkTypeUInt32 loc
     // Get the reply
     int size=0;
     controller->Receive(&size, 1, 1, vtkPVSessionServer::REPLY_LAST_RESULT);
-    unsigned char* raw_data = new unsigned char[size+1];
+    // Receive directly into the stream to avoid copying the result.
+    unsigned char* raw_data = this->ServerLastInvokeResult->AllocateData(size);
     controller->Receive(raw_data, size, 1, vtkPVSessionServer::REPLY_LAST_RESULT);
-    this->ServerLastInvokeResult->SetData(raw_data, size);
-    delete [] raw_data;
+    this->ServerLastInvokeResult->CommitData();
     this->EndBusyWork();
     return *this->ServerLastInvokeResult;
     }
@@ -756,6 +805,7 @@ bool vtkSMSessionClient::GatherInformation(
   vtkTypeUInt32 location, vtkPVInformation* information, vtkTypeUInt32 globalid)
 {
   this->StartBusyWork();
+  this->FlushPushTransaction();
   if (this->RenderServerController == NULL)
     {
     // re-route all render-server messages to data-server.
@@ -822,17 +872,16 @@ bool vtkSMSessionClient::GatherInformation(
       this->EndBusyWork();
       return false;
       }
-    unsigned char* data2 = new unsigned char[length2];
+    vtkClientServerStream csstream;
+    unsigned char* data2 = csstream.AllocateData(length2);
     if (!controller->Receive((char*)data2, length2, 1,
         vtkPVSessionServer::REPLY_GATHER_INFORMATION_TAG))
       {
       vtkErrorMacro("Failed to receive information correctly.");
-      delete [] data2;
       this->EndBusyWork();
       return false;
       }
-    vtkClientServerStream csstream;
-    csstream.SetData(data2, length2);
+    csstream.CommitData();
     if (add_local_info)
       {
       vtkPVInformation* tempInfo = information->NewInstance();
@@ -844,7 +893,6 @@ bool vtkSMSessionClient::GatherInformation(
       {
       information->CopyFromStream(&csstream);
       }
-    delete [] data2;
     }
   this->EndBusyWork();
   return false;
@@ -858,6 +906,7 @@ void vtkSMSessionClient::UnRegisterSIObject(vtkSMMessage* message)
     return;
     }
 
+  this->FlushPushTransaction();
   vtkTypeUInt32 location = this->GetRealLocation(message->location());
   message->set_location(location);
   message->set_client_id(this->GetServerInformation()->GetClientId());
@@ -902,6 +951,7 @@ void vtkSMSessionClient::RegisterSIObject(vtkSMMessage* message)
     return;
     }
 
+  this->FlushPushTransaction();
   vtkTypeUInt32 location = this->GetRealLocation(message->location());
   message->set_location(location);
   message->set_client_id(this->GetServerInformation()->GetClientId());
@@ -942,10 +992,84 @@ void vtkSMSessionClient::RegisterSIObject(vtkSMMessage* message)
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::BeginPushTransaction()
+{
+  this->PushTransactionDepth++;
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::EndPushTransaction()
+{
+  if (this->PushTransactionDepth <= 0)
+    {
+    vtkErrorMacro("EndPushTransaction() called without BeginPushTransaction().");
+    return;
+    }
+  if (--this->PushTransactionDepth == 0)
+    {
+    this->FlushPushTransaction();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::FlushPushTransaction()
+{
+  if (this->PushQueue->Batches.empty())
+    {
+    return;
+    }
+
+  // Swap the queue out first, sending may process events that push states.
+  vtkPushQueue::BatchesType batches;
+  batches.swap(this->PushQueue->Batches);
+  for (vtkPushQueue::BatchesType::iterator iter = batches.begin();
+    iter != batches.end(); ++iter)
+    {
+    // The controller may be gone if the connection was closed meanwhile.
+    if ((iter->first == this->DataServerController ||
+        iter->first == this->RenderServerController) &&
+      iter->first != NULL && !iter->second.empty())
+      {
+      this->SendPushBatch(iter->first, iter->second);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::SendPushBatch(vtkMultiProcessController* controller,
+  const std::vector<unsigned char>& batch)
+{
+  int raw_size = static_cast<int>(batch.size());
+  const unsigned char* data = &batch[0];
+  int size = raw_size;
+  int compressed = 0;
+
+  std::vector<unsigned char> compressed_batch;
+  if (vtkPVSessionServer::CompressPushBatch(batch, compressed_batch))
+    {
+    data = &compressed_batch[0];
+    size = static_cast<int>(compressed_batch.size());
+    compressed = 1;
+    }
+
+  vtkMultiProcessStream stream;
+  stream << static_cast<int>(vtkPVSessionServer::PUSH_BATCH)
+    << compressed << raw_size << size;
+  std::vector<unsigned char> raw_message;
+  stream.GetRawData(raw_message);
+  controller->TriggerRMIOnAllChildren(
+    &raw_message[0], static_cast<int>(raw_message.size()),
+    vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+  controller->Send(data, size, 1, vtkPVSessionServer::PUSH_BATCH_TAG);
+}
+
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "PushTransactionDepth: " << this->PushTransactionDepth
+     << endl;
 }
 //----------------------------------------------------------------------------
 vtkTypeUInt32 vtkSMSessionClient::GetNextGlobalUniqueIdentifier()
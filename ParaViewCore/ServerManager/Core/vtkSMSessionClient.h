@@ -24,6 +24,10 @@
 #include "vtkPVServerManagerCoreModule.h" //needed for exports
 #include "vtkSMSession.h"
 
+//BTX
+#include <vector> // needed for std::vector
+//ETX
+
 class vtkMultiProcessController;
 class vtkPVServerInformation;
 class vtkSMCollaborationManager;
@@ -98,6 +102,26 @@ public:
   virtual const vtkClientServerStream& GetLastResult(vtkTypeUInt32 location);
 //ETX
 
+  // Description:
+  // Push transactions. Between BeginPushTransaction() and
+  // EndPushTransaction(), PushState() still updates the client right away but
+  // queues the messages for the servers instead of sending each one on its
+  // own. The queue is sent as a single, compressed message when the outermost
+  // transaction ends. It is also sent as soon as the client needs to talk to
+  // the servers for anything else (e.g. PullState(), GatherInformation(),
+  // ExecuteStream()), so the servers always see messages in the order they
+  // were issued. Transactions may be nested.
+  void BeginPushTransaction();
+  void EndPushTransaction();
+
+  // Description:
+  // Sends the queued messages, if any, without ending the transaction.
+  void FlushPushTransaction();
+
+  // Description:
+  // Returns the nesting level of the current push transaction, 0 if none.
+  vtkGetMacro(PushTransactionDepth, int);
+
   // Description:
   // When Connect() is waiting for a server to connect back to the client (in
   // reverse connect mode), then it periodically fires ProgressEvent.
@@ -200,6 +224,13 @@ protected:
   // render-server exists.
   vtkTypeUInt32 GetRealLocation(vtkTypeUInt32);
 
+  // Description:
+  // Sends a batch of states queued during a push transaction to the server
+  // behind the controller, compressed when large enough. See
+  // vtkPVSessionServer::ReceivePushBatch().
+  virtual void SendPushBatch(vtkMultiProcessController* controller,
+    const std::vector<unsigned char>& batch);
+
   // Both maybe the same when connected to pvserver.
   vtkMultiProcessController* RenderServerController;
   vtkMultiProcessController* DataServerController;
@@ -239,6 +270,9 @@ private:
   void operator=(const vtkSMSessionClient&); // Not implemented
 
   int NotBusy;
+  int PushTransactionDepth;
+  class vtkPushQueue;
+  vtkPushQueue* PushQueue;
   vtkTypeUInt32 LastGlobalID;
   vtkTypeUInt32 LastGlobalIDAvailable;
 //ETX
@@ -1199,7 +1199,20 @@ void vtkSMSessionProxyManager::LoadXMLState( vtkPVXMLElement* rootElement,
     {
     spLoader = loader;
     }
-  if (spLoader->LoadState(rootElement, keepOriginalIds))
+  // Loading a state pushes the state of every proxy; send those to the server
+  // in as few messages as possible.
+  vtkSMSessionClient* client =
+    vtkSMSessionClient::SafeDownCast(this->GetSession());
+  if (client)
+    {
+    client->BeginPushTransaction();
+    }
+  bool loaded = spLoader->LoadState(rootElement, keepOriginalIds) != 0;
+  if (client)
+    {
+    client->EndPushTransaction();
+    }
+  if (loaded)
     {
     vtkSMProxyManager::LoadStateInformation info;
     info.RootElement = rootElement;
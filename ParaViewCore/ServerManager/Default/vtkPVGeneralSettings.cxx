@@ -15,7 +15,9 @@
 #include "vtkPVGeneralSettings.h"
 
 #include "vtkCacheSizeKeeper.h"
+#include "vtkFileSeriesReader.h"
 #include "vtkObjectFactory.h"
+#include "vtkPEnSightGoldBinaryReader.h"
 #include "vtkProcessModuleAutoMPI.h"
 #include "vtkSISourceProxy.h"
 #include "vtkSMInputArrayDomain.h"
@@ -142,6 +144,70 @@ void vtkPVGeneralSettings::SetAnimationGeometryCacheLimit(unsigned long val)
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkPVGeneralSettings::SetAnimationGeometryCacheEvictionPolicy(int val)
+{
+  if (this->GetAnimationGeometryCacheEvictionPolicy() != val)
+    {
+    vtkCacheSizeKeeper::GetInstance()->SetEvictionPolicy(val);
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkPVGeneralSettings::GetAnimationGeometryCacheEvictionPolicy()
+{
+  return vtkCacheSizeKeeper::GetInstance()->GetEvictionPolicy();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVGeneralSettings::SetNumberOfFilesToPrefetch(int val)
+{
+  vtkFileSeriesReader::SetNumberOfFilesToPrefetch(val);
+}
+
+//----------------------------------------------------------------------------
+int vtkPVGeneralSettings::GetNumberOfFilesToPrefetch()
+{
+  return vtkFileSeriesReader::GetNumberOfFilesToPrefetch();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVGeneralSettings::SetSaveFileSeriesTimeIndex(bool val)
+{
+  vtkFileSeriesReader::SetSaveFileSeriesTimeIndex(val);
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVGeneralSettings::GetSaveFileSeriesTimeIndex()
+{
+  return vtkFileSeriesReader::GetSaveFileSeriesTimeIndex();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVGeneralSettings::SetDistributeFileSeriesTimeQueries(bool val)
+{
+  vtkFileSeriesReader::SetDistributeFileSeriesTimeQueries(val);
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVGeneralSettings::GetDistributeFileSeriesTimeQueries()
+{
+  return vtkFileSeriesReader::GetDistributeFileSeriesTimeQueries();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVGeneralSettings::SetMemoryMapEnSightFiles(bool val)
+{
+  vtkPEnSightGoldBinaryReader::SetUseMemoryMapping(val);
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVGeneralSettings::GetMemoryMapEnSightFiles()
+{
+  return vtkPEnSightGoldBinaryReader::GetUseMemoryMapping();
+}
+
 //----------------------------------------------------------------------------
 void vtkPVGeneralSettings::SetScalarBarMode(int val)
 {
@@ -206,5 +272,7 @@ void vtkPVGeneralSettings::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "ScalarBarMode: " << this->ScalarBarMode << "\n";
   os << indent << "CacheGeometryForAnimation: " << this->CacheGeometryForAnimation << "\n";
   os << indent << "AnimationGeometryCacheLimit: " << this->AnimationGeometryCacheLimit << "\n";
+  os << indent << "AnimationGeometryCacheEvictionPolicy: "
+     << this->GetAnimationGeometryCacheEvictionPolicy() << "\n";
   os << indent << "PropertiesPanelMode: " << this->PropertiesPanelMode << "\n";
 }
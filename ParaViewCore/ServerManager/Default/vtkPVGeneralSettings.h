@@ -123,6 +123,31 @@ public:
   void SetAnimationGeometryCacheLimit(unsigned long val);
   vtkGetMacro(AnimationGeometryCacheLimit, unsigned long);
 
+  // Description:
+  // Set how cached animation geometry is released once the cache is full.
+  // Forwarded to vtkCacheSizeKeeper::SetEvictionPolicy().
+  void SetAnimationGeometryCacheEvictionPolicy(int val);
+  int GetAnimationGeometryCacheEvictionPolicy();
+
+  // Description:
+  // Set the number of files of a file series to read ahead in the background.
+  // Forwarded to vtkFileSeriesReader.
+  void SetNumberOfFilesToPrefetch(int val);
+  int GetNumberOfFilesToPrefetch();
+
+  // Description:
+  // Control how the time values of the files of a file series are
+  // collected. Forwarded to vtkFileSeriesReader.
+  void SetSaveFileSeriesTimeIndex(bool val);
+  bool GetSaveFileSeriesTimeIndex();
+  void SetDistributeFileSeriesTimeQueries(bool val);
+  bool GetDistributeFileSeriesTimeQueries();
+
+  // Description:
+  // Forwarded for vtkPEnSightGoldBinaryReader.
+  void SetMemoryMapEnSightFiles(bool val);
+  bool GetMemoryMapEnSightFiles();
+
   // Description:
   // Forwarded for vtkSMParaViewPipelineControllerWithRendering.
   void SetInheritRepresentationProperties(bool val);
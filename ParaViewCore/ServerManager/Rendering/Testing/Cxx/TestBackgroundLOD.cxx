@@ -0,0 +1,168 @@
+/*=========================================================================
+
+Program:   ParaView
+Module:    TestBackgroundLOD.cxx
+
+Copyright (c) Kitware, Inc.
+All rights reserved.
+See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkAlgorithm.h"
+#include "vtkAlgorithmOutput.h"
+#include "vtkCompositeRepresentation.h"
+#include "vtkDataSet.h"
+#include "vtkGeometryRepresentation.h"
+#include "vtkInitializationHelper.h"
+#include "vtkNew.h"
+#include "vtkProcessModule.h"
+#include "vtkPVDataDeliveryManager.h"
+#include "vtkPVRenderView.h"
+#include "vtkSMParaViewPipelineController.h"
+#include "vtkSMPropertyHelper.h"
+#include "vtkSMRepresentationProxy.h"
+#include "vtkSMSession.h"
+#include "vtkSMSessionProxyManager.h"
+#include "vtkSmartPointer.h"
+#include "vtkSMViewProxy.h"
+
+namespace
+{
+  // Shows \c source in a new render view that uses LOD for every interactive
+  // render, with or without building the LOD levels in the background.
+  vtkSMViewProxy* NewView(vtkSMParaViewPipelineController* controller,
+    vtkSMSessionProxyManager* pxm, vtkSMProxy* source, bool background,
+    vtkGeometryRepresentation** geometry)
+    {
+    vtkSMViewProxy* view = vtkSMViewProxy::SafeDownCast(
+      pxm->NewProxy("views", "RenderView"));
+    controller->InitializeProxy(view);
+    vtkSMPropertyHelper(view, "LODThreshold").Set(0.0);
+    view->UpdateVTKObjects();
+
+    vtkSmartPointer<vtkSMProxy> repr;
+    repr.TakeReference(view->CreateDefaultRepresentation(source, 0));
+    controller->PreInitializeProxy(repr);
+    vtkSMPropertyHelper(repr, "Input").Set(source);
+    controller->PostInitializeProxy(repr);
+    repr->UpdateVTKObjects();
+    vtkSMPropertyHelper(view, "Representations").Add(repr);
+    view->UpdateVTKObjects();
+
+    vtkCompositeRepresentation* composite =
+      vtkCompositeRepresentation::SafeDownCast(repr->GetClientSideObject());
+    *geometry = composite? vtkGeometryRepresentation::SafeDownCast(
+      composite->GetActiveRepresentation()) : NULL;
+    if (*geometry)
+      {
+      (*geometry)->SetBuildLODInBackground(background);
+      }
+    return view;
+    }
+
+  // Renders \c view interactively at the given LOD resolution and returns
+  // the LOD geometry it rendered.
+  vtkDataSet* RenderLOD(vtkSMViewProxy* view,
+    vtkGeometryRepresentation* geometry, double resolution)
+    {
+    vtkSMPropertyHelper(view, "LODResolution").Set(resolution);
+    view->UpdateVTKObjects();
+    view->InteractiveRender();
+
+    vtkPVRenderView* rv = vtkPVRenderView::SafeDownCast(
+      view->GetClientSideObject());
+    vtkAlgorithmOutput* producer =
+      rv->GetDeliveryManager()->GetProducer(geometry, true);
+    if (!producer)
+      {
+      return NULL;
+      }
+    return vtkDataSet::SafeDownCast(
+      producer->GetProducer()->GetOutputDataObject(producer->GetIndex()));
+    }
+}
+
+int TestBackgroundLOD(int argc, char* argv[])
+{
+  (void) argc;
+  vtkInitializationHelper::Initialize(argv[0], vtkProcessModule::PROCESS_CLIENT);
+
+  // Create a new session.
+  vtkSMSession* session = vtkSMSession::New();
+  vtkSMSessionProxyManager* pxm = session->GetSessionProxyManager();
+  vtkNew<vtkSMParaViewPipelineController> controller;
+  controller->InitializeSession(session);
+
+  vtkSMProxy* sphere = pxm->NewProxy("sources", "SphereSource");
+  controller->InitializeProxy(sphere);
+  vtkSMPropertyHelper(sphere, "ThetaResolution").Set(256);
+  vtkSMPropertyHelper(sphere, "PhiResolution").Set(256);
+  sphere->UpdateVTKObjects();
+
+  vtkGeometryRepresentation* onDemand = NULL;
+  vtkGeometryRepresentation* background = NULL;
+  vtkSMViewProxy* onDemandView =
+    NewView(controller.GetPointer(), pxm, sphere, false, &onDemand);
+  vtkSMViewProxy* backgroundView =
+    NewView(controller.GetPointer(), pxm, sphere, true, &background);
+  if (!onDemand || !background)
+    {
+    cerr << "ERROR: Failed at line " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+  onDemandView->StillRender();
+  backgroundView->StillRender();
+
+  // The first resolution is built first in the background, the others come
+  // from the levels built afterwards. All must match the geometry decimated
+  // on demand.
+  int status = EXIT_SUCCESS;
+  const double resolutions[] = { 0.5, 0.25, 1.0 };
+  for (int cc = 0; cc < 3; cc++)
+    {
+    vtkDataSet* expected = RenderLOD(onDemandView, onDemand, resolutions[cc]);
+    vtkDataSet* actual = RenderLOD(backgroundView, background, resolutions[cc]);
+    if (!expected || !actual || expected->GetNumberOfPoints() == 0)
+      {
+      cerr << "ERROR: No LOD geometry at resolution " << resolutions[cc]
+           << endl;
+      status = EXIT_FAILURE;
+      break;
+      }
+    if (!background->GetLODBuiltInBackground())
+      {
+      cerr << "ERROR: The LOD at resolution " << resolutions[cc]
+           << " was not built in the background." << endl;
+      status = EXIT_FAILURE;
+      }
+    if (onDemand->GetLODBuiltInBackground())
+      {
+      cerr << "ERROR: The on demand LOD at resolution " << resolutions[cc]
+           << " was built in the background." << endl;
+      status = EXIT_FAILURE;
+      }
+    if (expected->GetNumberOfPoints() != actual->GetNumberOfPoints() ||
+      expected->GetNumberOfCells() != actual->GetNumberOfCells())
+      {
+      cerr << "ERROR: LOD geometry built in the background at resolution "
+           << resolutions[cc] << " has " << actual->GetNumberOfPoints()
+           << " points and " << actual->GetNumberOfCells()
+           << " cells, expected " << expected->GetNumberOfPoints()
+           << " points and " << expected->GetNumberOfCells() << " cells."
+           << endl;
+      status = EXIT_FAILURE;
+      }
+    }
+
+  onDemandView->Delete();
+  backgroundView->Delete();
+  sphere->Delete();
+  session->Delete();
+  vtkInitializationHelper::Finalize();
+  return status;
+}
@@ -0,0 +1,198 @@
+/*=========================================================================
+
+Program:   ParaView
+Module:    TestStreamingGeometryRepresentation.cxx
+
+Copyright (c) Kitware, Inc.
+All rights reserved.
+See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkCamera.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkDataSet.h"
+#include "vtkInitializationHelper.h"
+#include "vtkNew.h"
+#include "vtkProcessModule.h"
+#include "vtkPVDataRepresentation.h"
+#include "vtkPVRenderView.h"
+#include "vtkPVView.h"
+#include "vtkSMParaViewPipelineController.h"
+#include "vtkSMPropertyHelper.h"
+#include "vtkSMRenderViewProxy.h"
+#include "vtkSMRepresentationProxy.h"
+#include "vtkSMSession.h"
+#include "vtkSMSessionProxyManager.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+
+#include <math.h>
+
+namespace
+{
+  double GetFocalPointOffset(vtkSMRenderViewProxy* view)
+    {
+    double focal[3];
+    view->GetActiveCamera()->GetFocalPoint(focal);
+    return sqrt(focal[0] * focal[0] + focal[1] * focal[1] +
+      focal[2] * focal[2]);
+    }
+
+  // Returns the number of cells the representation renders, over all the
+  // pieces streamed so far.
+  vtkIdType GetNumberOfRenderedCells(vtkSMProxy* repr)
+    {
+    vtkPVDataRepresentation* representation =
+      vtkPVDataRepresentation::SafeDownCast(repr->GetClientSideObject());
+    vtkCompositeDataSet* rendered = vtkCompositeDataSet::SafeDownCast(
+      representation->GetRenderedDataObject(0));
+    if (!rendered)
+      {
+      return 0;
+      }
+    vtkIdType numCells = 0;
+    vtkCompositeDataIterator* iter = rendered->NewIterator();
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+      iter->GoToNextItem())
+      {
+      vtkDataSet* ds = vtkDataSet::SafeDownCast(iter->GetCurrentDataObject());
+      numCells += ds? ds->GetNumberOfCells() : 0;
+      }
+    iter->Delete();
+    return numCells;
+    }
+}
+
+// Shows a sphere, centered on the origin, with the streaming surface
+// representation. The camera is first fit to the only sub-piece loaded, off
+// the origin, and must be fit to the whole sphere once streaming completes.
+int TestStreamingGeometryRepresentation(int argc, char* argv[])
+{
+  (void) argc;
+  vtkInitializationHelper::Initialize(argv[0], vtkProcessModule::PROCESS_CLIENT);
+  vtkPVView::SetEnableStreaming(true);
+
+  // Create a new session.
+  vtkSMSession* session = vtkSMSession::New();
+  vtkSMSessionProxyManager* pxm = session->GetSessionProxyManager();
+  vtkNew<vtkSMParaViewPipelineController> controller;
+  controller->InitializeSession(session);
+
+  // vtkSphereSource handles piece requests.
+  vtkSMProxy* sphere = pxm->NewProxy("sources", "SphereSource");
+  controller->InitializeProxy(sphere);
+  vtkSMPropertyHelper(sphere, "ThetaResolution").Set(64);
+  vtkSMPropertyHelper(sphere, "PhiResolution").Set(32);
+  sphere->UpdateVTKObjects();
+
+  vtkSMRenderViewProxy* view = vtkSMRenderViewProxy::SafeDownCast(
+    pxm->NewProxy("views", "RenderView"));
+  controller->InitializeProxy(view);
+  view->UpdateVTKObjects();
+
+  vtkSmartPointer<vtkSMProxy> repr;
+  repr.TakeReference(view->CreateDefaultRepresentation(sphere, 0));
+  controller->PreInitializeProxy(repr);
+  vtkSMPropertyHelper(repr, "Input").Set(sphere);
+  vtkSMPropertyHelper(repr, "Representation").Set("Streaming Surface");
+  controller->PostInitializeProxy(repr);
+  repr->UpdateVTKObjects();
+  vtkSMPropertyHelper(view, "Representations").Add(repr);
+  view->UpdateVTKObjects();
+
+  view->Update();
+  view->ResetCamera();
+  view->StillRender();
+
+  int status = EXIT_SUCCESS;
+  if (GetFocalPointOffset(view) < 1e-3)
+    {
+    cerr << "ERROR: The first update loaded more than one sub-piece." << endl;
+    status = EXIT_FAILURE;
+    }
+
+  int passes = 0;
+  while (view->StreamingUpdate(true) && passes < 64)
+    {
+    passes++;
+    }
+  if (passes != 15)
+    {
+    cerr << "ERROR: Streamed " << passes << " sub-pieces, expected 15."
+         << endl;
+    status = EXIT_FAILURE;
+    }
+
+  vtkPVRenderView* rv = vtkPVRenderView::SafeDownCast(
+    view->GetClientSideObject());
+  if (rv->GetNeedsStreamingCameraRefit() || GetFocalPointOffset(view) > 1e-3)
+    {
+    cerr << "ERROR: The camera was not fit to the whole sphere once "
+         << "streaming completed." << endl;
+    status = EXIT_FAILURE;
+    }
+
+  // Once streaming completes, the whole sphere is rendered, and stays so
+  // through view updates that do not change the input.
+  vtkNew<vtkSphereSource> reference;
+  reference->SetThetaResolution(64);
+  reference->SetPhiResolution(32);
+  reference->Update();
+  vtkIdType expectedCells = reference->GetOutput()->GetNumberOfCells();
+  if (GetNumberOfRenderedCells(repr) != expectedCells)
+    {
+    cerr << "ERROR: Rendered " << GetNumberOfRenderedCells(repr)
+         << " cells once streaming completed, expected " << expectedCells
+         << "." << endl;
+    status = EXIT_FAILURE;
+    }
+  vtkSMPropertyHelper(repr, "Ambient").Set(0.2);
+  repr->UpdateVTKObjects();
+  view->Update();
+  view->StillRender();
+  if (GetNumberOfRenderedCells(repr) != expectedCells)
+    {
+    cerr << "ERROR: Rendered " << GetNumberOfRenderedCells(repr)
+         << " cells after a view update, expected " << expectedCells
+         << "." << endl;
+    status = EXIT_FAILURE;
+    }
+  if (view->StreamingUpdate(true))
+    {
+    cerr << "ERROR: A view update restarted streaming." << endl;
+    status = EXIT_FAILURE;
+    }
+
+  // Once moved by the user, the camera must be left alone.
+  view->GetActiveCamera()->Azimuth(30);
+  vtkSMPropertyHelper(sphere, "Center").Set(0, 2.0);
+  sphere->UpdateVTKObjects();
+  view->Update();
+  view->StillRender();
+  double focal[3];
+  view->GetActiveCamera()->GetFocalPoint(focal);
+  while (view->StreamingUpdate(true) && passes < 128)
+    {
+    passes++;
+    }
+  double newFocal[3];
+  view->GetActiveCamera()->GetFocalPoint(newFocal);
+  if (focal[0] != newFocal[0] || focal[1] != newFocal[1] ||
+    focal[2] != newFocal[2])
+    {
+    cerr << "ERROR: Streaming moved a camera the user had moved." << endl;
+    status = EXIT_FAILURE;
+    }
+
+  view->Delete();
+  sphere->Delete();
+  session->Delete();
+  vtkInitializationHelper::Finalize();
+  return status;
+}
@@ -38,6 +38,7 @@
 #include "vtkPVOptions.h"
 #include "vtkPVRenderView.h"
 #include "vtkPVServerInformation.h"
+#include "vtkPVSession.h"
 #include "vtkPVXMLElement.h"
 #include "vtkRenderer.h"
 #include "vtkRenderWindow.h"
@@ -97,6 +98,7 @@ vtkSMRenderViewProxy::vtkSMRenderViewProxy()  :
   this->NewMasterObserverId = 0;
   this->DeliveryManager = NULL;
   this->NeedsUpdateLOD = true;
+  this->InteractiveLODResolution = -1.0;
   this->InteractorHelper->SetViewProxy(this);
 }
 
@@ -252,7 +254,20 @@ bool vtkSMRenderViewProxy::StreamingUpdate(bool render_if_needed)
 
   // Now fetch any pieces that the server streamed back to the client.
   bool something_delivered = this->DeliveryManager->DeliverStreamedPieces();
-  if (render_if_needed && something_delivered)
+
+  // Once streaming completes, refit the camera if it was fit to the pieces
+  // available before streaming and was not moved since.
+  bool refit = !something_delivered && view->GetNeedsStreamingCameraRefit();
+  if (refit)
+    {
+    vtkClientServerStream resetStream;
+    resetStream << vtkClientServerStream::Invoke
+                << VTKOBJECT(this)
+                << "ResetCamera"
+                << vtkClientServerStream::End;
+    this->ExecuteStream(resetStream);
+    }
+  if (render_if_needed && (something_delivered || refit))
     {
     this->StillRender();
     }
@@ -272,6 +287,26 @@ vtkTypeUInt32 vtkSMRenderViewProxy::PreRender(bool interactive)
 
   if (interactive && rv->GetUseLODForInteractiveRender())
     {
+    // When the view is trying to fit interactive renders in a frame budget,
+    // it may suggest a different LOD resolution. Pass it on to all processes;
+    // the LOD geometries then need to be updated. The client times its
+    // interactive renders up to the arrival of the image when rendering is
+    // remote, so its suggestion accounts for the whole frame without asking
+    // the server.
+    double resolution = rv->GetSuggestedLODResolution();
+    if (resolution != this->InteractiveLODResolution)
+      {
+      vtkClientServerStream stream;
+      stream << vtkClientServerStream::Invoke
+             << VTKOBJECT(this)
+             << "SetInteractiveLODResolution"
+             << resolution
+             << vtkClientServerStream::End;
+      this->ExecuteStream(stream);
+      this->InteractiveLODResolution = resolution;
+      this->NeedsUpdateLOD = true;
+      }
+
     // for interactive renders, we need to determine if we are going to use LOD.
     // If so, we may need to update the LOD geometries.
     this->UpdateLOD();
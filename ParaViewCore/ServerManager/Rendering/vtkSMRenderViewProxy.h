@@ -241,6 +241,9 @@ protected:
   vtkSMDataDeliveryManager* DeliveryManager;
   bool NeedsUpdateLOD;
 
+  // LOD resolution last passed to vtkPVRenderView::SetInteractiveLODResolution().
+  double InteractiveLODResolution;
+
 private:
   vtkSMRenderViewProxy(const vtkSMRenderViewProxy&); // Not implemented
   void operator=(const vtkSMRenderViewProxy&); // Not implemented
@@ -0,0 +1,298 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestCGNSReaderThreads.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Reads multi-zone files with one and with several threads, the outputs
+// must be identical. An HDF5 file written by the test must be read
+// concurrently, straight from the file, when the reader supports it; other
+// files fall back to a single thread and the outputs still match.
+
+#include "vtkCGNSReader.h"
+#include "vtkCellData.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkDataArray.h"
+#include "vtkDataSet.h"
+#include "vtkFieldData.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPointSet.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+
+#include <cgnslib.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+const int NUMBER_OF_ZONES = 3;
+const int NI = 17;
+const int NJ = 11;
+const int NK = 7;
+
+//------------------------------------------------------------------------------
+// Writes a file with structured zones, each with coordinates and a vertex
+// field, in the HDF5 format that can be read concurrently when available.
+bool WriteFile(const std::string& fileName)
+{
+#ifdef VTK_CGNS_LINK_TO_HDF5
+  if (cg_set_file_type(CG_FILE_HDF5) != CG_OK)
+    {
+    return false;
+    }
+#endif
+  int fn, B;
+  if (cg_open(fileName.c_str(), CG_MODE_WRITE, &fn) != CG_OK)
+    {
+    return false;
+    }
+  bool success = cg_base_write(fn, "Base", 3, 3, &B) == CG_OK;
+
+  std::vector<double> x(NI * NJ * NK), y(x.size()), z(x.size()), p(x.size());
+  for (int zone = 0; success && zone < NUMBER_OF_ZONES; ++zone)
+    {
+    for (int k = 0, n = 0; k < NK; ++k)
+      {
+      for (int j = 0; j < NJ; ++j)
+        {
+        for (int i = 0; i < NI; ++i, ++n)
+          {
+          x[n] = i + zone * NI;
+          y[n] = 0.5 * j;
+          z[n] = 0.25 * k;
+          p[n] = zone + 0.001 * n;
+          }
+        }
+      }
+    cgsize_t size[9] = { NI, NJ, NK, NI - 1, NJ - 1, NK - 1, 0, 0, 0 };
+    char zoneName[33];
+    sprintf(zoneName, "Zone%d", zone + 1);
+    int Z, C, S, F;
+    success =
+      cg_zone_write(fn, B, zoneName, size, CGNS_ENUMV(Structured), &Z) == CG_OK &&
+      cg_coord_write(fn, B, Z, CGNS_ENUMV(RealDouble), "CoordinateX",
+                     &x[0], &C) == CG_OK &&
+      cg_coord_write(fn, B, Z, CGNS_ENUMV(RealDouble), "CoordinateY",
+                     &y[0], &C) == CG_OK &&
+      cg_coord_write(fn, B, Z, CGNS_ENUMV(RealDouble), "CoordinateZ",
+                     &z[0], &C) == CG_OK &&
+      cg_sol_write(fn, B, Z, "FlowSolution", CGNS_ENUMV(Vertex), &S) == CG_OK &&
+      cg_field_write(fn, B, Z, S, CGNS_ENUMV(RealDouble), "Pressure",
+                     &p[0], &F) == CG_OK;
+    }
+  return cg_close(fn) == CG_OK && success;
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkMultiBlockDataSet> Read(const char* fileName,
+                                           int numberOfThreads,
+                                           int* numberOfDirectReads = NULL)
+{
+  vtkNew<vtkCGNSReader> reader;
+  reader->SetFileName(fileName);
+  reader->SetNumberOfThreads(numberOfThreads);
+  reader->UpdateInformation();
+  reader->EnableAllBases();
+  reader->EnableAllPointArrays();
+  reader->EnableAllCellArrays();
+  reader->Update();
+
+  vtkSmartPointer<vtkMultiBlockDataSet> output =
+    vtkSmartPointer<vtkMultiBlockDataSet>::New();
+  output->ShallowCopy(reader->GetOutput());
+  if (numberOfDirectReads)
+    {
+    *numberOfDirectReads = reader->GetNumberOfDirectReads();
+    }
+  return output;
+}
+
+bool CompareArrays(vtkDataArray* expected, vtkDataArray* actual,
+                   const char* what)
+{
+  if (!actual ||
+      expected->GetNumberOfTuples() != actual->GetNumberOfTuples() ||
+      expected->GetNumberOfComponents() != actual->GetNumberOfComponents())
+    {
+    std::cerr << "Mismatch in size of " << what << "." << std::endl;
+    return false;
+    }
+  for (vtkIdType i = 0; i < expected->GetNumberOfTuples(); ++i)
+    {
+    for (int c = 0; c < expected->GetNumberOfComponents(); ++c)
+      {
+      if (expected->GetComponent(i, c) != actual->GetComponent(i, c))
+        {
+        std::cerr << "Mismatch in " << what << " at tuple " << i << "."
+                  << std::endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+bool CompareFields(vtkFieldData* expected, vtkFieldData* actual)
+{
+  if (expected->GetNumberOfArrays() != actual->GetNumberOfArrays())
+    {
+    std::cerr << "Mismatch in number of arrays." << std::endl;
+    return false;
+    }
+  for (int a = 0; a < expected->GetNumberOfArrays(); ++a)
+    {
+    vtkDataArray* array = expected->GetArray(a);
+    if (array && !CompareArrays(array, actual->GetArray(array->GetName()),
+                                array->GetName()))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+bool Compare(vtkMultiBlockDataSet* expected, vtkMultiBlockDataSet* actual)
+{
+  vtkSmartPointer<vtkCompositeDataIterator> iter;
+  iter.TakeReference(expected->NewIterator());
+  int numberOfBlocks = 0;
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+    {
+    vtkDataSet* ds = vtkDataSet::SafeDownCast(iter->GetCurrentDataObject());
+    vtkDataSet* other = vtkDataSet::SafeDownCast(actual->GetDataSet(iter));
+    if (!ds)
+      {
+      continue;
+      }
+    ++numberOfBlocks;
+    if (!other || ds->GetNumberOfPoints() != other->GetNumberOfPoints() ||
+        ds->GetNumberOfCells() != other->GetNumberOfCells())
+      {
+      std::cerr << "Mismatch in block " << numberOfBlocks << "." << std::endl;
+      return false;
+      }
+    vtkPointSet* ps = vtkPointSet::SafeDownCast(ds);
+    if (ps && ps->GetPoints() &&
+        !CompareArrays(ps->GetPoints()->GetData(),
+                       vtkPointSet::SafeDownCast(other)->GetPoints()->GetData(),
+                       "coordinates"))
+      {
+      return false;
+      }
+    if (!CompareFields(ds->GetPointData(), other->GetPointData()) ||
+        !CompareFields(ds->GetCellData(), other->GetCellData()))
+      {
+      return false;
+      }
+    }
+  if (numberOfBlocks < 2)
+    {
+    std::cerr << "Expected several zones, got " << numberOfBlocks << "."
+              << std::endl;
+    return false;
+    }
+  return true;
+}
+}
+
+//------------------------------------------------------------------------------
+// The coordinates and field of the last point of the last zone, as written.
+bool CheckLastPoint(vtkMultiBlockDataSet* output)
+{
+  vtkSmartPointer<vtkCompositeDataIterator> iter;
+  iter.TakeReference(output->NewIterator());
+  vtkDataSet* last = NULL;
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+    {
+    last = vtkDataSet::SafeDownCast(iter->GetCurrentDataObject());
+    }
+  vtkIdType n = NI * NJ * NK - 1;
+  vtkDataArray* pressure =
+    last ? last->GetPointData()->GetArray("Pressure") : NULL;
+  if (!pressure || last->GetNumberOfPoints() != n + 1)
+    {
+    std::cerr << "Missing zone or field." << std::endl;
+    return false;
+    }
+  double point[3];
+  last->GetPoint(n, point);
+  if (point[0] != (NI - 1) + (NUMBER_OF_ZONES - 1) * NI ||
+      point[1] != 0.5 * (NJ - 1) || point[2] != 0.25 * (NK - 1) ||
+      pressure->GetComponent(n, 0) != (NUMBER_OF_ZONES - 1) + 0.001 * n)
+    {
+    std::cerr << "Unexpected values at the last point." << std::endl;
+    return false;
+    }
+  return true;
+}
+}
+
+int TestCGNSReaderThreads(int argc, char* argv[])
+{
+  char* fileName =
+    vtkTestUtilities::ExpandDataFileName(argc, argv, "VisItBridge/5blocks.cgns");
+
+  vtkSmartPointer<vtkMultiBlockDataSet> serial = Read(fileName, 1);
+  vtkSmartPointer<vtkMultiBlockDataSet> threaded = Read(fileName, 4);
+  delete [] fileName;
+  if (!Compare(serial, threaded))
+    {
+    return EXIT_FAILURE;
+    }
+
+  char* tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!tempDir)
+    {
+    std::cerr << "Could not determine temporary directory." << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string writtenFileName =
+    std::string(tempDir) + "/TestCGNSReaderThreads.cgns";
+  delete [] tempDir;
+  if (!WriteFile(writtenFileName))
+    {
+    std::cerr << "Could not write " << writtenFileName << "." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  int serialDirectReads, threadedDirectReads;
+  serial = Read(writtenFileName.c_str(), 1, &serialDirectReads);
+  threaded = Read(writtenFileName.c_str(), 4, &threadedDirectReads);
+  if (!Compare(serial, threaded) || !CheckLastPoint(serial) ||
+      !CheckLastPoint(threaded))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Every coordinate and field array must have been read concurrently.
+#ifdef VTK_CGNS_LINK_TO_HDF5
+  const int expectedDirectReads = NUMBER_OF_ZONES * 4;
+#else
+  const int expectedDirectReads = 0;
+#endif
+  if (serialDirectReads != 0 || threadedDirectReads != expectedDirectReads)
+    {
+    std::cerr << "Expected " << expectedDirectReads << " concurrent reads, got "
+              << threadedDirectReads << " (" << serialDirectReads
+              << " with one thread)." << std::endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
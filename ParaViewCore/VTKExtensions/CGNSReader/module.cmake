@@ -19,6 +19,8 @@ vtk_module(vtkPVVTKExtensionsCGNSReader
       vtkPVVTKExtensionsCore
     PRIVATE_DEPENDS
       ${cgns_private_depends}
+    TEST_DEPENDS
+      vtkTestingCore
     KIT
       vtkPVExtensions
 )
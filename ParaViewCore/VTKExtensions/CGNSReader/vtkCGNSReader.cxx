@@ -75,6 +75,16 @@ namespace
     private:
       int pair[2];
   };
+
+  // Resets vtkCGNSReader::ReadPlan on every way out of RequestData.
+  class ReadPlanGuard
+  {
+  public:
+    ReadPlanGuard(CGNSRead::ReadPlan*& plan) : Plan(plan) {}
+    ~ReadPlanGuard() { this->Plan = 0; }
+  private:
+    CGNSRead::ReadPlan*& Plan;
+  };
 }
 
 //----------------------------------------------------------------------------
@@ -87,6 +97,9 @@ vtkCGNSReader::vtkCGNSReader()
   this->ActualTimeStep = 0;
   this->DoublePrecisionMesh = 1;
   this->CreateEachSolutionAsBlock = 0;
+  this->NumberOfThreads = 1;
+  this->NumberOfDirectReads = 0;
+  this->ReadPlan = 0;
 
   this->PointDataArraySelection = vtkDataArraySelection::New();
   this->CellDataArraySelection = vtkDataArraySelection::New();
@@ -561,6 +574,36 @@ int vtkCGNSReader::AttachReferenceValue(const int base, vtkDataSet* ds)
   return 0;
 }
 
+//------------------------------------------------------------------------------
+int vtkCGNSReader::ReadSolutionData(double solId, double varId, int cellDim,
+                                    const cgsize_t* srcStart,
+                                    const cgsize_t* srcEnd,
+                                    const cgsize_t* srcStride,
+                                    const cgsize_t* memDims,
+                                    const cgsize_t* memStart,
+                                    const cgsize_t* memEnd,
+                                    const cgsize_t* memStride, void* data)
+{
+  if (!this->ReadPlan)
+    {
+    return cgio_read_data(this->cgioNum, varId,
+                          srcStart, srcEnd, srcStride, cellDim, memDims,
+                          memStart, memEnd, memStride, data);
+    }
+
+  CGNSRead::char_33 solName;
+  CGNSRead::char_33 varName;
+  if (cgio_get_name(this->cgioNum, solId, solName) != CG_OK ||
+      cgio_get_name(this->cgioNum, varId, varName) != CG_OK)
+    {
+    return CG_ERROR;
+    }
+  this->ReadPlan->Add(this->CurrentZonePath + "/" + solName + "/" + varName,
+                      cellDim, srcStart, srcEnd, srcStride, memDims,
+                      memStart, memEnd, memStride, data);
+  return CG_OK;
+}
+
 //------------------------------------------------------------------------------
 int vtkCGNSReader::GetCurvilinearZone(int base, int zone,
                                       int cellDim, int physicalDim,
@@ -648,7 +691,8 @@ int vtkCGNSReader::GetCurvilinearZone(int base, int zone,
                                          cellDim, nPts,
                                          srcStart, srcEnd, srcStride,
                                          memStart, memEnd, memStride, memDims,
-                                         points);
+                                         points, this->ReadPlan,
+                                         this->CurrentZonePath + "/" + GridCoordName);
 
     }
   else // SINGLE PRECISION MESHPOINTS
@@ -657,7 +701,8 @@ int vtkCGNSReader::GetCurvilinearZone(int base, int zone,
                                          cellDim, nPts,
                                          srcStart, srcEnd, srcStride,
                                          memStart, memEnd, memStride, memDims,
-                                         points );
+                                         points, this->ReadPlan,
+                                         this->CurrentZonePath + "/" + GridCoordName);
     }
 
   //----------------------------------------------------------------------------
@@ -772,11 +817,11 @@ int vtkCGNSReader::GetCurvilinearZone(int base, int zone,
           // quick transfer of data because data types is given by cgns database
           if (cgnsVars[ff].isComponent == false)
             {
-            if (cgio_read_data(this->cgioNum, cgioVarId,
-                               fieldSrcStart, fieldSrcEnd, fieldSrcStride,
-                               cellDim, fieldMemDims,
-                               fieldMemStart, fieldMemEnd, fieldMemStride,
-                               (void *) vtkVars[ff]->GetVoidPointer(0)) != CG_OK)
+            if (this->ReadSolutionData(cgioSolId, cgioVarId,
+                                       fieldSrcStart, fieldSrcEnd, fieldSrcStride,
+                                       cellDim, fieldMemDims,
+                                       fieldMemStart, fieldMemEnd, fieldMemStride,
+                                       (void *) vtkVars[ff]->GetVoidPointer(0)) != CG_OK)
               {
               char message[81];
               cgio_error_message(message);
@@ -785,11 +830,11 @@ int vtkCGNSReader::GetCurvilinearZone(int base, int zone,
             }
           else
             {
-            if (cgio_read_data(this->cgioNum, cgioVarId,
-                               fieldSrcStart, fieldSrcEnd, fieldSrcStride,
-                               cellDim, fieldVectMemDims,
-                               fieldVectMemStart, fieldVectMemEnd, fieldVectMemStride,
-                               (void *) vtkVars[ff]->GetVoidPointer(cgnsVars[ff].xyzIndex-1)) != CG_OK)
+            if (this->ReadSolutionData(cgioSolId, cgioVarId,
+                                       fieldSrcStart, fieldSrcEnd, fieldSrcStride,
+                                       cellDim, fieldVectMemDims,
+                                       fieldVectMemStart, fieldVectMemEnd, fieldVectMemStride,
+                                       (void *) vtkVars[ff]->GetVoidPointer(cgnsVars[ff].xyzIndex-1)) != CG_OK)
               {
               char message[81];
               cgio_error_message(message);
@@ -964,11 +1009,11 @@ int vtkCGNSReader::GetCurvilinearZone(int base, int zone,
           // quick transfer of data because data types is given by cgns database
           if (cgnsVars[ff].isComponent == false)
             {
-            if (cgio_read_data(this->cgioNum, cgioVarId,
-                               fieldSrcStart, fieldSrcEnd, fieldSrcStride,
-                               cellDim, fieldMemDims,
-                               fieldMemStart, fieldMemEnd, fieldMemStride,
-                               (void *) vtkVars[ff]->GetVoidPointer(0)) != CG_OK)
+            if (this->ReadSolutionData(cgioSolId, cgioVarId,
+                                       fieldSrcStart, fieldSrcEnd, fieldSrcStride,
+                                       cellDim, fieldMemDims,
+                                       fieldMemStart, fieldMemEnd, fieldMemStride,
+                                       (void *) vtkVars[ff]->GetVoidPointer(0)) != CG_OK)
               {
               char message[81];
               cgio_error_message(message);
@@ -977,11 +1022,11 @@ int vtkCGNSReader::GetCurvilinearZone(int base, int zone,
             }
           else
             {
-            if (cgio_read_data(this->cgioNum, cgioVarId,
-                               fieldSrcStart, fieldSrcEnd, fieldSrcStride,
-                               cellDim, fieldVectMemDims,
-                               fieldVectMemStart, fieldVectMemEnd, fieldVectMemStride,
-                               (void *) vtkVars[ff]->GetVoidPointer(cgnsVars[ff].xyzIndex-1)) != CG_OK)
+            if (this->ReadSolutionData(cgioSolId, cgioVarId,
+                                       fieldSrcStart, fieldSrcEnd, fieldSrcStride,
+                                       cellDim, fieldVectMemDims,
+                                       fieldVectMemStart, fieldVectMemEnd, fieldVectMemStride,
+                                       (void *) vtkVars[ff]->GetVoidPointer(cgnsVars[ff].xyzIndex-1)) != CG_OK)
               {
               char message[81];
               cgio_error_message(message);
@@ -1148,11 +1193,11 @@ int vtkCGNSReader::GetCurvilinearZone(int base, int zone,
           // quick transfer of data because data types is given by cgns database
           if (cgnsVars[ff].isComponent == false)
             {
-            if (cgio_read_data(this->cgioNum, cgioVarId,
-                               fieldSrcStart, fieldSrcEnd, fieldSrcStride,
-                               cellDim, fieldMemDims,
-                               fieldMemStart, fieldMemEnd, fieldMemStride,
-                               (void *)vtkVars[ff]->GetVoidPointer(0)) != CG_OK)
+            if (this->ReadSolutionData(cgioSolId, cgioVarId,
+                                       fieldSrcStart, fieldSrcEnd, fieldSrcStride,
+                                       cellDim, fieldMemDims,
+                                       fieldMemStart, fieldMemEnd, fieldMemStride,
+                                       (void *)vtkVars[ff]->GetVoidPointer(0)) != CG_OK)
               {
               char message[81];
               cgio_error_message(message);
@@ -1161,11 +1206,11 @@ int vtkCGNSReader::GetCurvilinearZone(int base, int zone,
             }
           else
             {
-            if (cgio_read_data(this->cgioNum, cgioVarId,
-                               fieldSrcStart, fieldSrcEnd, fieldSrcStride,
-                               cellDim, fieldVectMemDims,
-                               fieldVectMemStart, fieldVectMemEnd, fieldVectMemStride,
-                               (void *) vtkVars[ff]->GetVoidPointer(cgnsVars[ff].xyzIndex-1)) != CG_OK)
+            if (this->ReadSolutionData(cgioSolId, cgioVarId,
+                                       fieldSrcStart, fieldSrcEnd, fieldSrcStride,
+                                       cellDim, fieldVectMemDims,
+                                       fieldVectMemStart, fieldVectMemEnd, fieldVectMemStride,
+                                       (void *) vtkVars[ff]->GetVoidPointer(cgnsVars[ff].xyzIndex-1)) != CG_OK)
               {
               char message[81];
               cgio_error_message(message);
@@ -1324,7 +1369,8 @@ int vtkCGNSReader::GetUnstructuredZone(int base, int zone,
                                          nCoordsArray, cellDim, nPts,
                                          srcStart ,srcEnd, srcStride,
                                          memStart, memEnd, memStride, memDims,
-                                         points);
+                                         points, this->ReadPlan,
+                                         this->CurrentZonePath + "/" + GridCoordName);
     }
   else  // SINGLE PRECISION MESHPOINTS
     {
@@ -1332,7 +1378,8 @@ int vtkCGNSReader::GetUnstructuredZone(int base, int zone,
                                          nCoordsArray, cellDim, nPts,
                                          srcStart, srcEnd, srcStride,
                                          memStart, memEnd, memStride, memDims,
-                                         points);
+                                         points, this->ReadPlan,
+                                         this->CurrentZonePath + "/" + GridCoordName);
     }
 
   this->UpdateProgress(0.2);
@@ -1838,11 +1885,11 @@ int vtkCGNSReader::GetUnstructuredZone(int base, int zone,
       // quick transfer of data because data types is given by cgns database
       if (cgnsVars[ff].isComponent == false)
         {
-        if ( cgio_read_data(this->cgioNum, cgioVarId,
-                            fieldSrcStart, fieldSrcEnd, fieldSrcStride,
-                            m_num_dims, fieldMemDims,
-                            fieldMemStart, fieldMemEnd, fieldMemStride,
-                            (void *) vtkVars[ff]->GetVoidPointer(0)) != CG_OK)
+        if ( this->ReadSolutionData(cgioSolId, cgioVarId,
+                                    fieldSrcStart, fieldSrcEnd, fieldSrcStride,
+                                    m_num_dims, fieldMemDims,
+                                    fieldMemStart, fieldMemEnd, fieldMemStride,
+                                    (void *) vtkVars[ff]->GetVoidPointer(0)) != CG_OK)
           {
           char message[81];
           cgio_error_message(message);
@@ -1851,11 +1898,11 @@ int vtkCGNSReader::GetUnstructuredZone(int base, int zone,
         }
       else
         {
-        if (cgio_read_data(this->cgioNum, cgioVarId,
-                           fieldSrcStart, fieldSrcEnd, fieldSrcStride,
-                           m_num_dims, fieldVectMemDims,
-                           fieldVectMemStart, fieldVectMemEnd, fieldVectMemStride,
-                           (void *) vtkVars[ff]->GetVoidPointer(cgnsVars[ff].xyzIndex-1)) != CG_OK)
+        if (this->ReadSolutionData(cgioSolId, cgioVarId,
+                                   fieldSrcStart, fieldSrcEnd, fieldSrcStride,
+                                   m_num_dims, fieldVectMemDims,
+                                   fieldVectMemStart, fieldVectMemEnd, fieldVectMemStride,
+                                   (void *) vtkVars[ff]->GetVoidPointer(cgnsVars[ff].xyzIndex-1)) != CG_OK)
           {
           char message[81];
           cgio_error_message(message);
@@ -2317,6 +2364,12 @@ int vtkCGNSReader::RequestData(vtkInformation *vtkNotUsed(request),
   vtkDebugMacro(<< "CGNSReader::RequestData: Reading from file <"
                 << this->FileName << ">...");
 
+  // With several threads, coordinates and fields are read once all zones
+  // are set up.
+  CGNSRead::ReadPlan readPlan;
+  ReadPlanGuard readPlanGuard(this->ReadPlan);
+  this->NumberOfDirectReads = 0;
+
   // Openning with cgio layer
   ier = cgio_open_file(this->FileName, CGIO_MODE_READ, 0, &(this->cgioNum));
   if (ier != CG_OK)
@@ -2326,6 +2379,20 @@ int vtkCGNSReader::RequestData(vtkInformation *vtkNotUsed(request),
     }
   cgio_get_root_id(this->cgioNum, &(this->rootId));
 
+  if (this->NumberOfThreads > 1)
+    {
+    if (CGNSRead::ReadPlan::SupportsConcurrentReads(this->cgioNum))
+      {
+      this->ReadPlan = &readPlan;
+      }
+    else
+      {
+      vtkWarningMacro(<< "Only HDF5 files can be read with several threads, "
+                      << "reading " << this->FileName
+                      << " with a single thread.");
+      }
+    }
+
 
   // Get base id list :
   std::vector<double> baseIds;
@@ -2504,6 +2571,7 @@ int vtkCGNSReader::RequestData(vtkInformation *vtkNotUsed(request),
 
 
       mbase->GetMetaData(zone)->Set(vtkCompositeDataSet::NAME(), zoneName);
+      this->CurrentZonePath = std::string("/") + curBaseInfo.name + "/" + zoneName;
 
       double famId;
       if (CGNSRead::getFirstNodeId(this->cgioNum,
@@ -2578,6 +2646,24 @@ int vtkCGNSReader::RequestData(vtkInformation *vtkNotUsed(request),
     blockIndex++;
     }
 
+  if (this->ReadPlan)
+    {
+    std::string error;
+    int failures = this->ReadPlan->Execute(this->FileName, this->cgioNum,
+                                           this->rootId,
+                                           this->NumberOfThreads, error);
+    this->NumberOfDirectReads = this->ReadPlan->GetNumberOfDirectReads();
+    if (failures > 0)
+      {
+      vtkErrorMacro(<< failures << " coordinates or fields could not be read, "
+                    << "first error: " << error);
+      }
+    else if (!error.empty())
+      {
+      vtkWarningMacro(<< error);
+      }
+    }
+
 errorData:
   cgio_close_file(this->cgioNum);
 
@@ -2697,6 +2783,8 @@ void vtkCGNSReader::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "File Name: "
      << (this->FileName ? this->FileName : "(none)") << "\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+  os << indent << "NumberOfDirectReads: " << this->NumberOfDirectReads << "\n";
 }
 
 //------------------------------------------------------------------------------
@@ -102,6 +102,24 @@ public:
   vtkGetMacro(CreateEachSolutionAsBlock,int);
   vtkBooleanMacro(CreateEachSolutionAsBlock,int);
 
+  // Description:
+  // Set/get the number of threads used to read coordinates and solution
+  // fields. With more than one thread, the reads of all selected zones are
+  // collected while the output is built. Once every array is allocated, the
+  // values stored contiguously in the file are located through HDF5 and
+  // read concurrently, each thread reading the file with its own descriptor,
+  // bypassing the CGNS and HDF5 libraries that serialize reads. The other
+  // reads go through cgio. This is only done for HDF5 files when CGNS uses
+  // the HDF5 library of VTK; otherwise a warning is emitted and the file is
+  // read with a single thread. Default is 1: every read happens in place.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NumberOfThreads, int);
+
+  // Description:
+  // Get the number of coordinate and field arrays that the last update read
+  // concurrently, straight from the file.
+  vtkGetMacro(NumberOfDirectReads, int);
+
 #ifdef PARAVIEW_USE_MPI
   // Description:
   // Set/get the communication object used to relay a list of files
@@ -184,6 +202,15 @@ protected:
                        std::vector<vtkDataArray *>& vtkVars);
 
   int AttachReferenceValue(const int base, vtkDataSet* ds);
+
+  // Description:
+  // Read a solution field with cgio_read_data(), or add the read to ReadPlan
+  // when reads are deferred. Returns CG_OK on success.
+  int ReadSolutionData(double solId, double varId, int cellDim,
+                       const cgsize_t* srcStart, const cgsize_t* srcEnd,
+                       const cgsize_t* srcStride, const cgsize_t* memDims,
+                       const cgsize_t* memStart, const cgsize_t* memEnd,
+                       const cgsize_t* memStride, void* data);
 #endif
 
 private:
@@ -196,6 +223,12 @@ private:
   int LoadBndPatch; // option to set section loading for unstructured grid
   int DoublePrecisionMesh; // option to set mesh loading to double precision
   int CreateEachSolutionAsBlock; // debug option to create
+  int NumberOfThreads; // threads used to read coordinates and fields
+  int NumberOfDirectReads; // arrays read concurrently by the last update
+
+  // Reads deferred until all zones are set up, when NumberOfThreads > 1.
+  CGNSRead::ReadPlan* ReadPlan;
+  std::string CurrentZonePath; // "/base/zone" path of the zone being read
 
   // For internal cgio calls (low level IO)
   int cgioNum; // cgio file reference
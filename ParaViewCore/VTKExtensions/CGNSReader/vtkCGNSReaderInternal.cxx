@@ -18,8 +18,246 @@
 
 #include <algorithm>
 #include "vtkCellType.h"
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
 #include "cgio_helpers.h"
 
+#ifdef VTK_CGNS_LINK_TO_HDF5
+# include "vtk_hdf5.h"
+#endif
+
+#include <fcntl.h>
+#include <string.h>
+#if defined(_WIN32)
+# include <io.h>
+#else
+# include <unistd.h>
+#endif
+
+namespace
+{
+//------------------------------------------------------------------------------
+// State shared by the threads executing the direct reads of a
+// CGNSRead::ReadPlan.
+struct ReadPlanState
+{
+  const char* FileName;
+  std::vector<CGNSRead::ReadTask*> Tasks;
+  vtkSimpleMutexLock Lock;
+  std::size_t NextTask;
+  int NumberOfFailures;
+  int NumberOfDirectReads;
+  std::string Error;
+
+  void AddFailure(const std::string& message, int numberOfFailures)
+    {
+    this->Lock.Lock();
+    this->NumberOfFailures += numberOfFailures;
+    if (this->Error.empty())
+      {
+      this->Error = message;
+      }
+    this->Lock.Unlock();
+    }
+};
+
+//------------------------------------------------------------------------------
+cgsize_t GetTaskSize(const CGNSRead::ReadTask& task)
+{
+  cgsize_t size = 1;
+  for (int n = 0; n < task.CellDim; n++)
+    {
+    size *= (task.SrcEnd[n] - task.SrcStart[n]) / task.SrcStride[n] + 1;
+    }
+  return size;
+}
+
+#ifdef VTK_CGNS_LINK_TO_HDF5
+//------------------------------------------------------------------------------
+// True if the task reads all the values of a node with dims dimensions, the
+// values then only have to be placed in memory as they are stored.
+bool IsWholeNodeRead(const CGNSRead::ReadTask& task, const hsize_t* dims,
+                     int rank)
+{
+  if (rank != task.CellDim)
+    {
+    return false;
+    }
+  // Depending on the CGNS version, the dimensions of the dataset are in the
+  // order of the node or reversed; the values are in Fortran order anyway.
+  bool same = true;
+  bool reversed = true;
+  for (int n = 0; n < task.CellDim; n++)
+    {
+    if (task.SrcStart[n] != 1 || task.SrcStride[n] != 1 ||
+        (task.MemEnd[n] - task.MemStart[n]) / task.MemStride[n] !=
+        task.SrcEnd[n] - task.SrcStart[n])
+      {
+      return false;
+      }
+    same = same &&
+      dims[n] == static_cast<hsize_t>(task.SrcEnd[n]);
+    reversed = reversed &&
+      dims[rank - 1 - n] == static_cast<hsize_t>(task.SrcEnd[n]);
+    }
+  return same || reversed;
+}
+#endif
+
+//------------------------------------------------------------------------------
+// True if the values of the task are stored contiguously in memory, in the
+// order of the file.
+bool IsContiguousInMemory(const CGNSRead::ReadTask& task)
+{
+  for (int n = 0; n < task.CellDim; n++)
+    {
+    if (task.MemStart[n] != 1 || task.MemStride[n] != 1 ||
+        task.MemEnd[n] != task.MemDims[n])
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Places the values of the task, read in file order, at their strided
+// location in memory, as cgio_read_data() would.
+void ScatterValues(const CGNSRead::ReadTask& task, const char* values)
+{
+  const std::size_t valueSize = static_cast<std::size_t>(
+    task.NumberOfBytes / GetTaskSize(task));
+  cgsize_t count[3] = {1, 1, 1};
+  for (int n = 0; n < task.CellDim; n++)
+    {
+    count[n] = task.SrcEnd[n] - task.SrcStart[n] + 1;
+    }
+  char* data = static_cast<char*>(task.Data);
+  for (cgsize_t k = 0; k < count[2]; k++)
+    {
+    for (cgsize_t j = 0; j < count[1]; j++)
+      {
+      vtkTypeInt64 row =
+        ((task.MemStart[2] - 1 + k * task.MemStride[2]) * task.MemDims[1] +
+         task.MemStart[1] - 1 + j * task.MemStride[1]) * task.MemDims[0] +
+        task.MemStart[0] - 1;
+      for (cgsize_t i = 0; i < count[0]; i++, values += valueSize)
+        {
+        memcpy(data + (row + i * task.MemStride[0]) * valueSize, values,
+               valueSize);
+        }
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+bool IsLargerTask(const CGNSRead::ReadTask* a, const CGNSRead::ReadTask* b)
+{
+  return a->NumberOfBytes > b->NumberOfBytes;
+}
+
+//------------------------------------------------------------------------------
+// Reads size bytes at offset with a file descriptor of the calling thread.
+bool ReadAt(int fd, vtkTypeInt64 offset, char* data, vtkTypeInt64 size)
+{
+#if defined(_WIN32)
+  if (_lseeki64(fd, offset, SEEK_SET) != offset)
+    {
+    return false;
+    }
+#endif
+  while (size > 0)
+    {
+    // keep each request well below the 2GB limit of some platforms.
+    unsigned int chunk = static_cast<unsigned int>(
+      std::min<vtkTypeInt64>(size, 1 << 30));
+#if defined(_WIN32)
+    int count = _read(fd, data, chunk);
+#else
+    ssize_t count = pread(fd, data, chunk, static_cast<off_t>(offset));
+#endif
+    if (count <= 0)
+      {
+      return false;
+      }
+    data += count;
+    offset += count;
+    size -= count;
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE ExecuteDirectReads(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  ReadPlanState* state = static_cast<ReadPlanState*>(info->UserData);
+
+  // Each thread reads through its own descriptor: no library and no lock is
+  // involved past this point.
+#if defined(_WIN32)
+  int fd = _open(state->FileName, _O_RDONLY | _O_BINARY);
+#else
+  int fd = open(state->FileName, O_RDONLY);
+#endif
+  if (fd < 0)
+    {
+    // Tasks left to other threads, or counted as failed by Execute().
+    state->AddFailure(std::string("Cannot open ") + state->FileName, 0);
+    return VTK_THREAD_RETURN_VALUE;
+    }
+
+  std::vector<char> buffer;
+  for (;;)
+    {
+    state->Lock.Lock();
+    std::size_t index = state->NextTask;
+    if (index < state->Tasks.size())
+      {
+      state->NextTask++;
+      }
+    state->Lock.Unlock();
+    if (index >= state->Tasks.size())
+      {
+      break;
+      }
+
+    // Values interleaved in memory, such as coordinates, are scattered
+    // from a buffer of the thread.
+    CGNSRead::ReadTask& task = *state->Tasks[index];
+    bool contiguous = IsContiguousInMemory(task);
+    if (!contiguous)
+      {
+      buffer.resize(static_cast<std::size_t>(task.NumberOfBytes));
+      }
+    char* values = contiguous ? static_cast<char*>(task.Data) : &buffer[0];
+    bool read = ReadAt(fd, task.FileOffset, values, task.NumberOfBytes);
+    if (read && !contiguous)
+      {
+      ScatterValues(task, values);
+      }
+    if (!read)
+      {
+      state->AddFailure(task.Path + " : short read", 1);
+      }
+    else
+      {
+      state->Lock.Lock();
+      state->NumberOfDirectReads++;
+      state->Lock.Unlock();
+      }
+    }
+
+#if defined(_WIN32)
+  _close(fd);
+#else
+  close(fd);
+#endif
+  return VTK_THREAD_RETURN_VALUE;
+}
+}
+
 namespace CGNSRead
 {
 //------------------------------------------------------------------------------
@@ -597,6 +835,204 @@ void fillVectorsFromVars(std::vector< CGNSRead::CGNSVariable >&  vars,
     }
 }
 
+//------------------------------------------------------------------------------
+void ReadPlan::Add(const std::string& path, const int cellDim,
+                   const cgsize_t* srcStart, const cgsize_t* srcEnd,
+                   const cgsize_t* srcStride, const cgsize_t* memDims,
+                   const cgsize_t* memStart, const cgsize_t* memEnd,
+                   const cgsize_t* memStride, void* data)
+{
+  ReadTask task;
+  task.Path = path;
+  task.CellDim = cellDim;
+  for (int n = 0; n < 3; n++)
+    {
+    // Only the first cellDim entries are used by cgio_read_data.
+    bool used = n < cellDim;
+    task.SrcStart[n] = used ? srcStart[n] : 1;
+    task.SrcEnd[n] = used ? srcEnd[n] : 1;
+    task.SrcStride[n] = used ? srcStride[n] : 1;
+    task.MemDims[n] = used ? memDims[n] : 1;
+    task.MemStart[n] = used ? memStart[n] : 1;
+    task.MemEnd[n] = used ? memEnd[n] : 1;
+    task.MemStride[n] = used ? memStride[n] : 1;
+    }
+  task.Data = data;
+  task.FileOffset = -1;
+  task.NumberOfBytes = 0;
+  this->Tasks.push_back(task);
+}
+
+//------------------------------------------------------------------------------
+bool ReadPlan::SupportsConcurrentReads(int cgioNum)
+{
+#ifdef VTK_CGNS_LINK_TO_HDF5
+  // Only HDF5 files can be read directly: the ADF layer gives no way to
+  // locate the values of a node in the file.
+  int fileType;
+  return cgio_get_file_type(cgioNum, &fileType) == CG_OK &&
+    fileType == CGIO_FILE_HDF5;
+#else
+  // The HDF5 library used by CGNS is unknown, and with it the layout of the
+  // file.
+  (void)cgioNum;
+  return false;
+#endif
+}
+
+//------------------------------------------------------------------------------
+void ReadPlan::LocateTasks(const char* fileName)
+{
+  for (std::size_t i = 0; i < this->Tasks.size(); i++)
+    {
+    this->Tasks[i].FileOffset = -1;
+    this->Tasks[i].NumberOfBytes = 0;
+    }
+#ifdef VTK_CGNS_LINK_TO_HDF5
+  // The file is already opened by cgio: HDF5 shares it as long as it is
+  // opened with the same close degree, which depends on the CGNS version.
+  hid_t file = -1;
+  H5F_close_degree_t degrees[2] = { H5F_CLOSE_STRONG, H5F_CLOSE_DEFAULT };
+  for (int d = 0; d < 2 && file < 0; d++)
+    {
+    hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+    H5Pset_fclose_degree(fapl, degrees[d]);
+    H5E_BEGIN_TRY
+      {
+      file = H5Fopen(fileName, H5F_ACC_RDONLY, fapl);
+      }
+    H5E_END_TRY;
+    H5Pclose(fapl);
+    }
+  if (file < 0)
+    {
+    return;
+    }
+  char fileId[2048];
+  H5Fget_name(file, fileId, sizeof(fileId));
+
+  for (std::size_t i = 0; i < this->Tasks.size(); i++)
+    {
+    ReadTask& task = this->Tasks[i];
+    // The values of a CGNS node are stored in its " data" dataset.
+    hid_t dataset;
+    H5E_BEGIN_TRY
+      {
+      dataset = H5Dopen2(file, (task.Path + "/ data").c_str(), H5P_DEFAULT);
+      }
+    H5E_END_TRY;
+    if (dataset < 0)
+      {
+      continue;
+      }
+    hid_t plist = H5Dget_create_plist(dataset);
+    hid_t type = H5Dget_type(dataset);
+    hid_t nativeType = H5Tget_native_type(type, H5T_DIR_ASCEND);
+    hid_t space = H5Dget_space(dataset);
+    hid_t datasetFile = H5Iget_file_id(dataset);
+    char datasetFileId[2048];
+    H5Fget_name(datasetFile, datasetFileId, sizeof(datasetFileId));
+    haddr_t offset = H5Dget_offset(dataset);
+    hsize_t dims[H5S_MAX_RANK];
+    int rank = H5Sget_simple_extent_dims(space, dims, NULL);
+    // Values that are all read, contiguous, in this file (not behind an
+    // external link) and already in the memory representation cgio would
+    // convert them to.
+    if (GetTaskSize(task) > 0 && IsWholeNodeRead(task, dims, rank) &&
+        H5Pget_layout(plist) == H5D_CONTIGUOUS && offset != HADDR_UNDEF &&
+        strcmp(fileId, datasetFileId) == 0 &&
+        H5Tequal(type, nativeType) > 0)
+      {
+      task.FileOffset = static_cast<vtkTypeInt64>(offset);
+      task.NumberOfBytes = static_cast<vtkTypeInt64>(GetTaskSize(task)) *
+        static_cast<vtkTypeInt64>(H5Tget_size(type));
+      }
+    H5Fclose(datasetFile);
+    H5Sclose(space);
+    H5Tclose(nativeType);
+    H5Tclose(type);
+    H5Pclose(plist);
+    H5Dclose(dataset);
+    }
+  H5Fclose(file);
+#else
+  (void)fileName;
+#endif
+}
+
+//------------------------------------------------------------------------------
+int ReadPlan::Execute(const char* fileName, int cgioNum, double rootId,
+                      int numThreads, std::string& error)
+{
+  this->NumberOfDirectReads = 0;
+  if (this->Tasks.empty())
+    {
+    return 0;
+    }
+
+  // Locating the values goes through HDF5, on this thread only.
+  this->LocateTasks(fileName);
+
+  ReadPlanState state;
+  state.FileName = fileName;
+  state.NextTask = 0;
+  state.NumberOfFailures = 0;
+  state.NumberOfDirectReads = 0;
+
+  for (std::size_t i = 0; i < this->Tasks.size(); i++)
+    {
+    ReadTask& task = this->Tasks[i];
+    if (task.FileOffset >= 0)
+      {
+      state.Tasks.push_back(&task);
+      continue;
+      }
+    // Partial reads, or values that need conversion, go through cgio.
+    double nodeId;
+    int ier = cgio_get_node_id(cgioNum, rootId, task.Path.c_str(), &nodeId);
+    if (ier == CG_OK)
+      {
+      ier = cgio_read_data(cgioNum, nodeId,
+                           task.SrcStart, task.SrcEnd, task.SrcStride,
+                           task.CellDim, task.MemDims,
+                           task.MemStart, task.MemEnd, task.MemStride,
+                           task.Data);
+      cgio_release_id(cgioNum, nodeId);
+      }
+    if (ier != CG_OK)
+      {
+      char message[CGIO_MAX_ERROR_LENGTH+1];
+      cgio_error_message(message);
+      state.AddFailure(task.Path + " : " + message, 1);
+      }
+    }
+
+  if (!state.Tasks.empty())
+    {
+    // Start with the largest reads so that threads finish at about the same
+    // time.
+    std::stable_sort(state.Tasks.begin(), state.Tasks.end(), IsLargerTask);
+    if (static_cast<std::size_t>(numThreads) > state.Tasks.size())
+      {
+      numThreads = static_cast<int>(state.Tasks.size());
+      }
+    vtkMultiThreader* threader = vtkMultiThreader::New();
+    threader->SetNumberOfThreads(numThreads > 1 ? numThreads : 1);
+    threader->SetSingleMethod(ExecuteDirectReads, &state);
+    threader->SingleMethodExecute();
+    threader->Delete();
+
+    // Tasks left over when no thread could open the file.
+    state.NumberOfFailures +=
+      static_cast<int>(state.Tasks.size() - state.NextTask);
+    this->NumberOfDirectReads = state.NumberOfDirectReads;
+    }
+
+  error = state.Error;
+  this->Tasks.clear();
+  return state.NumberOfFailures;
+}
+
 //------------------------------------------------------------------------------
 bool vtkCGNSMetaData::Parse(const char* cgnsFileName)
 {
@@ -357,13 +357,78 @@ void CGNS2VTKorder(const vtkIdType size, const int *cells_types,
 //------------------------------------------------------------------------------
 void CGNS2VTKorderMonoElem(const vtkIdType size, const int cell_type,
                            vtkIdType *elements);
+//------------------------------------------------------------------------------
+// A cgio_read_data() call deferred to ReadPlan::Execute(). The node is
+// identified by its path, which is also the path of its group in an HDF5
+// file.
+struct ReadTask
+{
+  std::string Path;
+  int CellDim;
+  cgsize_t SrcStart[3];
+  cgsize_t SrcEnd[3];
+  cgsize_t SrcStride[3];
+  cgsize_t MemDims[3];
+  cgsize_t MemStart[3];
+  cgsize_t MemEnd[3];
+  cgsize_t MemStride[3];
+  void* Data;
+  // Where the values are stored in the file, when they can be copied as they
+  // are, -1 otherwise.
+  vtkTypeInt64 FileOffset;
+  vtkTypeInt64 NumberOfBytes;
+};
+
+//------------------------------------------------------------------------------
+// Collects the bulk reads of coordinates and solution fields so that they can
+// be run concurrently once every output array has been allocated. Neither
+// cgio nor HDF5 can serve reads from several threads at once, so the values
+// stored contiguously in an HDF5 file are located through HDF5 first, then
+// read straight from the file by threads with their own file descriptor.
+class ReadPlan
+{
+public:
+  ReadPlan() : NumberOfDirectReads(0) {}
+
+  void Add(const std::string& path, const int cellDim,
+           const cgsize_t* srcStart, const cgsize_t* srcEnd,
+           const cgsize_t* srcStride, const cgsize_t* memDims,
+           const cgsize_t* memStart, const cgsize_t* memEnd,
+           const cgsize_t* memStride, void* data);
+
+  std::size_t GetNumberOfTasks() const { return this->Tasks.size(); }
+
+  // Returns true if the file opened as cgioNum can be read directly: it must
+  // be an HDF5 file, and CGNS must use the HDF5 library of VTK.
+  static bool SupportsConcurrentReads(int cgioNum);
+
+  // Run all tasks, then clear the plan. Direct reads run on up to numThreads
+  // threads, largest first; the other tasks are read with cgio through
+  // cgioNum. Returns the number of reads that failed; the message of the
+  // first failure is stored in error.
+  int Execute(const char* fileName, int cgioNum, double rootId,
+              int numThreads, std::string& error);
+
+  // Number of tasks read directly from the file by the last Execute().
+  int GetNumberOfDirectReads() const { return this->NumberOfDirectReads; }
+
+private:
+  // Sets the FileOffset and NumberOfBytes of the tasks that read the whole
+  // values of a node stored contiguously, in their native representation.
+  void LocateTasks(const char* fileName);
+
+  std::vector<ReadTask> Tasks;
+  int NumberOfDirectReads;
+};
+
 //------------------------------------------------------------------------------
 template <typename T, typename Y>
 int get_XYZ_mesh(const int cgioNum, const std::vector<double>& gridChildId,
                  const std::size_t& nCoordsArray, const int cellDim, const vtkIdType nPts,
                  const cgsize_t* srcStart, const cgsize_t* srcEnd, const cgsize_t* srcStride,
                  const cgsize_t* memStart, const cgsize_t* memEnd, const cgsize_t* memStride,
-                 const cgsize_t* memDims, vtkPoints* points)
+                 const cgsize_t* memDims, vtkPoints* points,
+                 ReadPlan* plan = 0, const std::string& gridPath = std::string())
 {
   T *coords = static_cast<T * >(points->GetVoidPointer(0));
   T *currentCoord = static_cast<T * >(&(coords[0]));
@@ -425,8 +490,14 @@ int get_XYZ_mesh(const int cgioNum, const std::vector<double>& gridChildId,
 
     coordId = gridChildId[c-1];
 
-    // quick transfer of data if same data types
-    if (sameType == true)
+    // quick transfer of data if same data types, deferred to the plan if any
+    if (sameType == true && plan)
+      {
+      plan->Add(gridPath + "/" + coordName, cellDim,
+                srcStart, srcEnd, srcStride, memEnd,
+                memStart, memEnd, memStride, (void *) currentCoord);
+      }
+    else if (sameType == true)
       {
       if (cgio_read_data(cgioNum, coordId,
                          srcStart, srcEnd, srcStride, cellDim , memEnd,
@@ -24,6 +24,7 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVPostFilterExecutive.h"
+#include "vtkPVTraceRecorder.h"
 
 #include <assert.h>
 
@@ -97,6 +98,29 @@ void vtkPVCompositeDataPipeline::ResetPipelineInformation(
   this->Superclass::ResetPipelineInformation(port, info);
 }
 
+//----------------------------------------------------------------------------
+int vtkPVCompositeDataPipeline::ExecuteData(vtkInformation* request,
+  vtkInformationVector** inInfoVec, vtkInformationVector* outInfoVec)
+{
+  vtkPVTraceSpan span("ExecuteData", this->Algorithm);
+  int retVal = this->Superclass::ExecuteData(request, inInfoVec, outInfoVec);
+  if (span.IsActive())
+    {
+    vtkTypeInt64 bytes = 0;
+    for (int cc=0; cc < outInfoVec->GetNumberOfInformationObjects(); cc++)
+      {
+      vtkDataObject* output =
+        outInfoVec->GetInformationObject(cc)->Get(vtkDataObject::DATA_OBJECT());
+      if (output)
+        {
+        bytes += static_cast<vtkTypeInt64>(output->GetActualMemorySize()) * 1024;
+        }
+      }
+    span.SetBytes(bytes);
+    }
+  return retVal;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVCompositeDataPipeline::PrintSelf(ostream& os, vtkIndent indent)
 {
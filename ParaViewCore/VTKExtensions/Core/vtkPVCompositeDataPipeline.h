@@ -21,6 +21,8 @@
 //     algorithms are passed along to the input vtkPVPostFilter, if one exists.
 //     vtkPVPostFilter is used to automatically extract components or generated
 //     derived arrays such as magnitude array for vectors.
+// \li Tracing :- when vtkPVTraceRecorder is enabled, each execution of an
+//     algorithm is recorded as a span along with the size of its outputs.
 
 #ifndef __vtkPVCompositeDataPipeline_h
 #define __vtkPVCompositeDataPipeline_h
@@ -47,6 +49,11 @@ protected:
   // Remove update/whole extent when resetting pipeline information.
   virtual void ResetPipelineInformation(int port, vtkInformation*);
 
+  // Overridden to record the execution with vtkPVTraceRecorder.
+  virtual int ExecuteData(vtkInformation* request,
+                          vtkInformationVector** inInfoVec,
+                          vtkInformationVector* outInfoVec);
+
 private:
   vtkPVCompositeDataPipeline(const vtkPVCompositeDataPipeline&);  // Not implemented.
   void operator=(const vtkPVCompositeDataPipeline&);  // Not implemented.
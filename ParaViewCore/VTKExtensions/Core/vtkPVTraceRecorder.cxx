@@ -0,0 +1,257 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVTraceRecorder.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVTraceRecorder.h"
+
+#include "vtkMultiProcessController.h"
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
+#include "vtkObjectFactory.h"
+
+#include <vtksys/SystemTools.hxx>
+#include <vtksys/ios/sstream>
+
+#include <algorithm>
+#include <deque>
+
+namespace
+{
+  // All events are kept here. The lock protects everything but
+  // vtkPVTraceRecorder::Enabled, which is only read without it to make
+  // disabled recording free.
+  class vtkPVTraceRecorderBuffer
+    {
+  public:
+    vtkPVTraceRecorderBuffer() : MaxNumberOfEvents(100000) {}
+
+    vtkSimpleMutexLock Lock;
+    std::deque<vtkPVTraceRecorder::Event> Events;
+    // spans that have begun but not ended yet, innermost last.
+    std::vector<vtkPVTraceRecorder::Event> OpenSpans;
+    std::vector<vtkMultiThreaderIDType> Threads;
+    size_t MaxNumberOfEvents;
+
+    // Must be called with the lock held.
+    int GetThreadIndex(vtkMultiThreaderIDType id)
+      {
+      for (size_t cc=0; cc < this->Threads.size(); cc++)
+        {
+        if (vtkMultiThreader::ThreadsEqual(this->Threads[cc], id))
+          {
+          return static_cast<int>(cc);
+          }
+        }
+      this->Threads.push_back(id);
+      return static_cast<int>(this->Threads.size() - 1);
+      }
+    };
+
+  vtkPVTraceRecorderBuffer TraceBuffer;
+
+  std::string GetObjectName(vtkObject* obj)
+    {
+    if (!obj)
+      {
+      return std::string();
+      }
+    vtksys_ios::ostringstream str;
+    str << obj->GetClassName() << "(" << obj << ")";
+    return str.str();
+    }
+}
+
+bool vtkPVTraceRecorder::Enabled = false;
+double vtkPVTraceRecorder::ClockOffset = 0.0;
+
+vtkStandardNewMacro(vtkPVTraceRecorder);
+//----------------------------------------------------------------------------
+vtkPVTraceRecorder::vtkPVTraceRecorder()
+{
+}
+
+//----------------------------------------------------------------------------
+vtkPVTraceRecorder::~vtkPVTraceRecorder()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTraceRecorder::SetEnabled(bool val)
+{
+  TraceBuffer.Lock.Lock();
+  vtkPVTraceRecorder::Enabled = val;
+  if (!val)
+    {
+    TraceBuffer.OpenSpans.clear();
+    }
+  TraceBuffer.Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVTraceRecorder::GetEnabled()
+{
+  return vtkPVTraceRecorder::Enabled;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTraceRecorder::SetMaxNumberOfEvents(int val)
+{
+  TraceBuffer.Lock.Lock();
+  TraceBuffer.MaxNumberOfEvents = static_cast<size_t>(val > 1? val : 1);
+  while (TraceBuffer.Events.size() > TraceBuffer.MaxNumberOfEvents)
+    {
+    TraceBuffer.Events.pop_front();
+    }
+  TraceBuffer.Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+int vtkPVTraceRecorder::GetMaxNumberOfEvents()
+{
+  TraceBuffer.Lock.Lock();
+  int val = static_cast<int>(TraceBuffer.MaxNumberOfEvents);
+  TraceBuffer.Lock.Unlock();
+  return val;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTraceRecorder::ClearEvents()
+{
+  TraceBuffer.Lock.Lock();
+  TraceBuffer.Events.clear();
+  TraceBuffer.Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+int vtkPVTraceRecorder::GetNumberOfEvents()
+{
+  TraceBuffer.Lock.Lock();
+  int val = static_cast<int>(TraceBuffer.Events.size());
+  TraceBuffer.Lock.Unlock();
+  return val;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTraceRecorder::BeginSpan(const char* name, vtkObject* obj)
+{
+  if (!vtkPVTraceRecorder::Enabled)
+    {
+    return;
+    }
+
+  // build the event outside the lock.
+  vtkPVTraceRecorder::Event event;
+  event.Name = name? name : "";
+  event.Object = GetObjectName(obj);
+  event.Duration = 0.0;
+  event.Bytes = 0;
+  vtkMultiThreaderIDType thread = vtkMultiThreader::GetCurrentThreadID();
+  event.Time = vtksys::SystemTools::GetTime();
+
+  TraceBuffer.Lock.Lock();
+  event.Thread = TraceBuffer.GetThreadIndex(thread);
+  TraceBuffer.OpenSpans.push_back(event);
+  TraceBuffer.Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTraceRecorder::EndSpan(
+  const char* name, vtkObject* obj, vtkTypeInt64 bytes)
+{
+  if (!vtkPVTraceRecorder::Enabled)
+    {
+    return;
+    }
+
+  double time = vtksys::SystemTools::GetTime();
+  std::string spanName = name? name : "";
+  std::string object = GetObjectName(obj);
+  vtkMultiThreaderIDType thread = vtkMultiThreader::GetCurrentThreadID();
+
+  TraceBuffer.Lock.Lock();
+  int threadIndex = TraceBuffer.GetThreadIndex(thread);
+  // match the innermost open span of this thread.
+  for (size_t cc=TraceBuffer.OpenSpans.size(); cc > 0; cc--)
+    {
+    vtkPVTraceRecorder::Event& span = TraceBuffer.OpenSpans[cc-1];
+    if (span.Thread == threadIndex && span.Name == spanName &&
+      span.Object == object)
+      {
+      span.Duration = time - span.Time;
+      span.Bytes = bytes;
+      if (TraceBuffer.Events.size() >= TraceBuffer.MaxNumberOfEvents)
+        {
+        TraceBuffer.Events.pop_front();
+        }
+      TraceBuffer.Events.push_back(span);
+      TraceBuffer.OpenSpans.erase(TraceBuffer.OpenSpans.begin() + (cc-1));
+      break;
+      }
+    }
+  TraceBuffer.Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTraceRecorder::SynchronizeClocks(
+  vtkMultiProcessController* controller)
+{
+  vtkPVTraceRecorder::ClockOffset = 0.0;
+  if (!controller || controller->GetNumberOfProcesses() <= 1)
+    {
+    return;
+    }
+
+  // All processes read their clock as they leave a barrier and compare it to
+  // the one read on the root. Processes leave the barrier at slightly
+  // different times, so keep the median of a few rounds.
+  const int numberOfRounds = 5;
+  std::vector<double> offsets(numberOfRounds);
+  for (int round=0; round < numberOfRounds; round++)
+    {
+    controller->Barrier();
+    double localTime = vtksys::SystemTools::GetTime();
+    double rootTime = localTime;
+    controller->Broadcast(&rootTime, 1, 0);
+    offsets[round] = rootTime - localTime;
+    }
+  std::sort(offsets.begin(), offsets.end());
+  vtkPVTraceRecorder::ClockOffset =
+    controller->GetLocalProcessId() == 0? 0.0 : offsets[numberOfRounds/2];
+}
+
+//----------------------------------------------------------------------------
+double vtkPVTraceRecorder::GetClockOffset()
+{
+  return vtkPVTraceRecorder::ClockOffset;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTraceRecorder::GetEvents(std::vector<Event>& events)
+{
+  TraceBuffer.Lock.Lock();
+  events.assign(TraceBuffer.Events.begin(), TraceBuffer.Events.end());
+  TraceBuffer.Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTraceRecorder::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Enabled: " << vtkPVTraceRecorder::GetEnabled() << endl;
+  os << indent << "MaxNumberOfEvents: "
+     << vtkPVTraceRecorder::GetMaxNumberOfEvents() << endl;
+  os << indent << "NumberOfEvents: "
+     << vtkPVTraceRecorder::GetNumberOfEvents() << endl;
+  os << indent << "ClockOffset: "
+     << vtkPVTraceRecorder::GetClockOffset() << endl;
+}
@@ -0,0 +1,171 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVTraceRecorder.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVTraceRecorder - records timed spans for timeline traces.
+// .SECTION Description
+// vtkPVTraceRecorder keeps a per-process buffer of timed spans. Each span
+// records its wall-clock start time and duration, the thread that generated
+// it, the object it pertains to (if any) and the number of bytes produced or
+// moved. Unlike vtkTimerLog, events are kept structured so that they can be
+// gathered from all processes (see vtkPVTraceInformation) and laid out on a
+// single timeline.
+//
+// Like vtkTimerLog, the API is static; instances exist only so that the
+// recorder can be controlled through a proxy. Recording is off by default.
+// When off, BeginSpan()/EndSpan() return right away. A span is only added to
+// the buffer once it ends, so the buffer never holds half a span. The buffer
+// keeps at most MaxNumberOfEvents spans, dropping the oldest ones first.
+//
+// Each process reads its own clock. SynchronizeClocks() estimates the offset
+// of the local clock to the one of the root process of a controller; it is
+// called by vtkProcessModule once MPI is initialized, and the offset is
+// applied to the times gathered by vtkPVTraceInformation.
+//
+// vtkPVTraceSpan is a convenience class that records a span for the duration
+// of a scope.
+// .SECTION See Also
+// vtkPVTraceInformation vtkTimerLog
+
+#ifndef __vtkPVTraceRecorder_h
+#define __vtkPVTraceRecorder_h
+
+#include "vtkObject.h"
+#include "vtkPVVTKExtensionsCoreModule.h" // needed for export macro
+
+class vtkMultiProcessController;
+
+//BTX
+#include <string> // needed for vtkPVTraceRecorder::Event
+#include <vector> // needed for GetEvents()
+//ETX
+
+class VTKPVVTKEXTENSIONSCORE_EXPORT vtkPVTraceRecorder : public vtkObject
+{
+public:
+  static vtkPVTraceRecorder* New();
+  vtkTypeMacro(vtkPVTraceRecorder, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Turn recording on/off on this process. Off by default. Turning recording
+  // off discards the spans that have begun but not yet ended.
+  static void SetEnabled(bool);
+  static bool GetEnabled();
+
+  // Description:
+  // Set the maximum number of events kept on this process. Default is 100000.
+  static void SetMaxNumberOfEvents(int);
+  static int GetMaxNumberOfEvents();
+
+  // Description:
+  // Discard all recorded events.
+  static void ClearEvents();
+
+  // Description:
+  // Returns the number of events currently recorded. Spans that have begun
+  // but not yet ended are not counted.
+  static int GetNumberOfEvents();
+
+  // Description:
+  // Record the start/end of a span. \c name and \c obj must match for the
+  // begin and end of a span, which must happen on the same thread; spans may
+  // be nested. \c obj, if non-null, identifies the object (e.g. the
+  // algorithm) the span pertains to. \c bytes is the amount of data produced
+  // or moved during the span, if known. An end without a matching begin is
+  // ignored. Safe to call from any thread.
+  static void BeginSpan(const char* name, vtkObject* obj=NULL);
+  static void EndSpan(const char* name, vtkObject* obj=NULL,
+    vtkTypeInt64 bytes=0);
+
+  // Description:
+  // Estimates the offset, in seconds, to add to this process' clock to get
+  // the clock of the root process of \c controller. This is a collective
+  // operation. The offset is 0 on the root process or when \c controller is
+  // NULL or has a single process.
+  static void SynchronizeClocks(vtkMultiProcessController* controller);
+  static double GetClockOffset();
+
+//BTX
+  class Event
+    {
+  public:
+    std::string Name;
+    std::string Object;
+    double Time;        // wall-clock start time in seconds.
+    double Duration;    // in seconds.
+    int Thread;         // index of the thread, in order of first event.
+    vtkTypeInt64 Bytes;
+    };
+
+  // Description:
+  // Copies the recorded spans, in the order in which they ended. Times are
+  // read from this process' clock, see GetClockOffset().
+  static void GetEvents(std::vector<Event>& events);
+//ETX
+
+protected:
+  vtkPVTraceRecorder();
+  ~vtkPVTraceRecorder();
+
+private:
+  vtkPVTraceRecorder(const vtkPVTraceRecorder&); // Not implemented
+  void operator=(const vtkPVTraceRecorder&); // Not implemented
+
+  static bool Enabled;
+  static double ClockOffset;
+};
+
+//BTX
+// Records a span on construction/destruction, when recording is enabled.
+class VTKPVVTKEXTENSIONSCORE_EXPORT vtkPVTraceSpan
+{
+public:
+  vtkPVTraceSpan(const char* name, vtkObject* obj=NULL) :
+    Name(name), Object(obj), Bytes(0),
+    Active(vtkPVTraceRecorder::GetEnabled())
+    {
+    if (this->Active)
+      {
+      vtkPVTraceRecorder::BeginSpan(this->Name, this->Object);
+      }
+    }
+  ~vtkPVTraceSpan()
+    {
+    if (this->Active)
+      {
+      vtkPVTraceRecorder::EndSpan(this->Name, this->Object, this->Bytes);
+      }
+    }
+
+  // Description:
+  // Bytes to report with the end event.
+  void SetBytes(vtkTypeInt64 bytes) { this->Bytes = bytes; }
+
+  // Description:
+  // Returns true if the span is being recorded. Useful to skip computing the
+  // number of bytes otherwise.
+  bool IsActive() const { return this->Active; }
+
+private:
+  vtkPVTraceSpan(const vtkPVTraceSpan&); // Not implemented
+  void operator=(const vtkPVTraceSpan&); // Not implemented
+
+  const char* Name;
+  vtkObject* Object;
+  vtkTypeInt64 Bytes;
+  bool Active;
+};
+//ETX
+
+#endif
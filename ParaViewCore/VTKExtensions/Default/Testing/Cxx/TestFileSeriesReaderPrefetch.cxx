@@ -0,0 +1,251 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestFileSeriesReaderPrefetch.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Reads a series of files with vtkFileSeriesReader, with and without
+// prefetching the following files in the background. Every time step must
+// hold the bytes of its file, including a file rewritten after it was
+// prefetched.
+
+#include "vtkCharArray.h"
+#include "vtkClientServerInterpreter.h"
+#include "vtkClientServerInterpreterInitializer.h"
+#include "vtkClientServerStream.h"
+#include "vtkFieldData.h"
+#include "vtkFileSeriesReader.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTestUtilities.h"
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+const int NumberOfFiles = 6;
+const int FileSize = 1 << 16;
+
+// A reader without time whose output holds the bytes of its file in a
+// "Contents" field data array.
+class vtkTestContentsReader : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkTestContentsReader* New();
+  vtkTypeMacro(vtkTestContentsReader, vtkPolyDataAlgorithm);
+
+  vtkSetStringMacro(FileName);
+  vtkGetStringMacro(FileName);
+
+protected:
+  vtkTestContentsReader() : FileName(NULL)
+    {
+    this->SetNumberOfInputPorts(0);
+    }
+  ~vtkTestContentsReader()
+    {
+    this->SetFileName(NULL);
+    }
+
+  int RequestData(vtkInformation*, vtkInformationVector**,
+    vtkInformationVector* outputVector)
+    {
+    std::ifstream file(this->FileName? this->FileName : "",
+      std::ios::in | std::ios::binary);
+    if (!file)
+      {
+      vtkErrorMacro("Cannot open " << (this->FileName? this->FileName : ""));
+      return 0;
+      }
+    std::string bytes((std::istreambuf_iterator<char>(file)),
+      std::istreambuf_iterator<char>());
+    vtkNew<vtkCharArray> contents;
+    contents->SetName("Contents");
+    contents->SetNumberOfTuples(static_cast<vtkIdType>(bytes.size()));
+    if (!bytes.empty())
+      {
+      memcpy(contents->GetPointer(0), bytes.data(), bytes.size());
+      }
+    vtkPolyData::GetData(outputVector)->GetFieldData()->AddArray(
+      contents.GetPointer());
+    return 1;
+    }
+
+  char* FileName;
+
+private:
+  vtkTestContentsReader(const vtkTestContentsReader&);
+  void operator=(const vtkTestContentsReader&);
+};
+vtkStandardNewMacro(vtkTestContentsReader);
+
+// vtkFileSeriesReader sets the file name through the client-server
+// interpreter.
+int vtkTestContentsReaderCommand(vtkClientServerInterpreter*,
+  vtkObjectBase* object, const char* method, const vtkClientServerStream& msg,
+  vtkClientServerStream& result, void*)
+{
+  vtkTestContentsReader* reader = vtkTestContentsReader::SafeDownCast(object);
+  char* fileName = NULL;
+  if (reader && strcmp(method, "SetFileName") == 0 &&
+    msg.GetNumberOfArguments(0) == 3 && msg.GetArgument(0, 2, &fileName))
+    {
+    reader->SetFileName(fileName);
+    return 1;
+    }
+  result.Reset();
+  result << vtkClientServerStream::Error << "Unsupported call to " << method
+         << vtkClientServerStream::End;
+  return 0;
+}
+
+std::string FileContents(int index, int version)
+{
+  std::string contents(FileSize, '\0');
+  for (int cc=0; cc < FileSize; cc++)
+    {
+    contents[cc] = static_cast<char>((cc * (index + 1) + 7 * version) & 0xff);
+    }
+  return contents;
+}
+
+bool WriteFile(const std::string& fileName, const std::string& contents)
+{
+  std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary);
+  file.write(contents.data(), contents.size());
+  file.close();
+  return !file.fail();
+}
+
+vtkSmartPointer<vtkFileSeriesReader> NewSeries(
+  const std::vector<std::string>& fileNames)
+{
+  vtkSmartPointer<vtkFileSeriesReader> series =
+    vtkSmartPointer<vtkFileSeriesReader>::New();
+  vtkNew<vtkTestContentsReader> reader;
+  series->SetReader(reader.GetPointer());
+  series->SetFileNameMethod("SetFileName");
+  for (size_t cc=0; cc < fileNames.size(); cc++)
+    {
+    series->AddFileName(fileNames[cc].c_str());
+    }
+  return series;
+}
+
+// Reads time step \c index, which is the index of the file as the files have
+// no time, and compares the output with \c expected.
+bool Check(vtkFileSeriesReader* series, int index, const std::string& expected)
+{
+  series->UpdateInformation();
+  series->GetOutputInformation(0)->Set(
+    vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP(), index);
+  series->Update();
+  vtkPolyData* output = vtkPolyData::SafeDownCast(
+    series->GetOutputDataObject(0));
+  vtkCharArray* contents = output? vtkCharArray::SafeDownCast(
+    output->GetFieldData()->GetArray("Contents")) : NULL;
+  if (!contents ||
+    contents->GetNumberOfTuples() != static_cast<vtkIdType>(expected.size()) ||
+    memcmp(contents->GetPointer(0), expected.data(), expected.size()) != 0)
+    {
+    std::cerr << "ERROR: Time step " << index << " does not hold the bytes "
+              << "of its file with " << vtkFileSeriesReader::
+                   GetNumberOfFilesToPrefetch()
+              << " files prefetched." << std::endl;
+    return false;
+    }
+  return true;
+}
+}
+
+int TestFileSeriesReaderPrefetch(int argc, char* argv[])
+{
+  char* tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!tempDir)
+    {
+    std::cerr << "Could not determine temporary directory." << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string dir = tempDir;
+  delete [] tempDir;
+
+  std::vector<std::string> fileNames;
+  std::vector<std::string> contents;
+  for (int cc=0; cc < NumberOfFiles; cc++)
+    {
+    std::ostringstream fileName;
+    fileName << dir << "/prefetch_" << cc << ".bin";
+    fileNames.push_back(fileName.str());
+    contents.push_back(FileContents(cc, 0));
+    if (!WriteFile(fileNames[cc], contents[cc]))
+      {
+      std::cerr << "Could not write " << fileNames[cc] << "." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  vtkClientServerInterpreterInitializer::GetGlobalInterpreter()->
+    AddCommandFunction("vtkTestContentsReader", vtkTestContentsReaderCommand);
+
+  int status = EXIT_SUCCESS;
+  const int prefetch[] = { 0, 2, NumberOfFiles };
+  for (int p=0; p < 3 && status == EXIT_SUCCESS; p++)
+    {
+    vtkFileSeriesReader::SetNumberOfFilesToPrefetch(prefetch[p]);
+    vtkSmartPointer<vtkFileSeriesReader> series = NewSeries(fileNames);
+
+    // forward, as when playing an animation, then backward.
+    for (int cc=0; cc < NumberOfFiles && status == EXIT_SUCCESS; cc++)
+      {
+      if (!Check(series, cc, contents[cc]))
+        {
+        status = EXIT_FAILURE;
+        }
+      }
+    for (int cc=NumberOfFiles - 1; cc >= 0 && status == EXIT_SUCCESS; cc--)
+      {
+      if (!Check(series, cc, contents[cc]))
+        {
+        status = EXIT_FAILURE;
+        }
+      }
+    }
+
+  // a file rewritten after it was prefetched is read as it is now.
+  if (status == EXIT_SUCCESS)
+    {
+    vtkFileSeriesReader::SetNumberOfFilesToPrefetch(3);
+    vtkSmartPointer<vtkFileSeriesReader> series = NewSeries(fileNames);
+    contents[2] = FileContents(2, 1);
+    if (!Check(series, 0, contents[0]) ||
+      !WriteFile(fileNames[2], contents[2]) ||
+      !Check(series, 1, contents[1]) || !Check(series, 2, contents[2]))
+      {
+      status = EXIT_FAILURE;
+      }
+    }
+
+  vtkFileSeriesReader::SetNumberOfFilesToPrefetch(0);
+  return status;
+}
@@ -0,0 +1,335 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestFileSeriesReaderTimeIndex.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Opens a series of files with vtkFileSeriesReader saving the time values to
+// a time index. Opening the series again must only query the files whose
+// size or modification time changed, or all of them when the time values of
+// the first file changed, and report the same time steps as querying every
+// file.
+
+#include "vtkClientServerInterpreter.h"
+#include "vtkClientServerInterpreterInitializer.h"
+#include "vtkClientServerStream.h"
+#include "vtkFileSeriesReader.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTestUtilities.h"
+
+#include <vtksys/SystemTools.hxx>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string.h>
+#include <vector>
+
+#if defined(_WIN32)
+# include <sys/utime.h>
+#else
+# include <utime.h>
+#endif
+
+namespace
+{
+const int NumberOfFiles = 5;
+
+// A reader reporting the time values listed in its file. It records the
+// files it was queried for.
+class vtkTestTimeReader : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkTestTimeReader* New();
+  vtkTypeMacro(vtkTestTimeReader, vtkPolyDataAlgorithm);
+
+  vtkSetStringMacro(FileName);
+  vtkGetStringMacro(FileName);
+
+  std::set<std::string> QueriedFiles;
+
+protected:
+  vtkTestTimeReader() : FileName(NULL)
+    {
+    this->SetNumberOfInputPorts(0);
+    }
+  ~vtkTestTimeReader()
+    {
+    this->SetFileName(NULL);
+    }
+
+  int RequestInformation(vtkInformation*, vtkInformationVector**,
+    vtkInformationVector* outputVector)
+    {
+    std::string fileName = this->FileName? this->FileName : "";
+    this->QueriedFiles.insert(fileName);
+    std::ifstream file(fileName.c_str());
+    std::vector<double> times;
+    double time;
+    while (file >> time)
+      {
+      times.push_back(time);
+      }
+    if (times.empty())
+      {
+      vtkErrorMacro("No time values in " << fileName);
+      return 0;
+      }
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(), &times[0],
+      static_cast<int>(times.size()));
+    double range[2] = { times.front(), times.back() };
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), range, 2);
+    return 1;
+    }
+
+  char* FileName;
+
+private:
+  vtkTestTimeReader(const vtkTestTimeReader&);
+  void operator=(const vtkTestTimeReader&);
+};
+vtkStandardNewMacro(vtkTestTimeReader);
+
+// vtkFileSeriesReader sets the file name through the client-server
+// interpreter.
+int vtkTestTimeReaderCommand(vtkClientServerInterpreter*,
+  vtkObjectBase* object, const char* method, const vtkClientServerStream& msg,
+  vtkClientServerStream& result, void*)
+{
+  vtkTestTimeReader* reader = vtkTestTimeReader::SafeDownCast(object);
+  char* fileName = NULL;
+  if (reader && strcmp(method, "SetFileName") == 0 &&
+    msg.GetNumberOfArguments(0) == 3 && msg.GetArgument(0, 2, &fileName))
+    {
+    reader->SetFileName(fileName);
+    return 1;
+    }
+  result.Reset();
+  result << vtkClientServerStream::Error << "Unsupported call to " << method
+         << vtkClientServerStream::End;
+  return 0;
+}
+
+typedef std::vector<std::vector<double> > FileTimesType;
+
+bool WriteTimes(const std::string& fileName, const std::vector<double>& times)
+{
+  std::ofstream file(fileName.c_str());
+  for (size_t cc=0; cc < times.size(); cc++)
+    {
+    file << (cc > 0? " " : "") << times[cc];
+    }
+  file << "\n";
+  file.close();
+  return !file.fail();
+}
+
+// The time steps of the series, as the files do not overlap.
+std::vector<double> SeriesTimes(const FileTimesType& fileTimes)
+{
+  std::vector<double> times;
+  for (size_t cc=0; cc < fileTimes.size(); cc++)
+    {
+    times.insert(times.end(), fileTimes[cc].begin(), fileTimes[cc].end());
+    }
+  return times;
+}
+
+bool SetModifiedTime(const std::string& fileName, long mtime)
+{
+#if defined(_WIN32)
+  struct _utimbuf times;
+  times.actime = times.modtime = mtime;
+  return _utime(fileName.c_str(), &times) == 0;
+#else
+  struct utimbuf times;
+  times.actime = times.modtime = mtime;
+  return utime(fileName.c_str(), &times) == 0;
+#endif
+}
+
+// Opens the series and checks the files that were queried for time values,
+// other than the first and the last ones which are always queried, and the
+// time steps reported.
+bool Open(const std::vector<std::string>& fileNames,
+  const std::set<int>& expectedQueries, const std::vector<double>& expectedTimes,
+  const char* step)
+{
+  vtkNew<vtkFileSeriesReader> series;
+  vtkNew<vtkTestTimeReader> reader;
+  series->SetReader(reader.GetPointer());
+  series->SetFileNameMethod("SetFileName");
+  for (size_t cc=0; cc < fileNames.size(); cc++)
+    {
+    series->AddFileName(fileNames[cc].c_str());
+    }
+  series->UpdateInformation();
+
+  for (int cc=1; cc < NumberOfFiles - 1; cc++)
+    {
+    bool queried = reader->QueriedFiles.count(fileNames[cc]) > 0;
+    if (queried != (expectedQueries.count(cc) > 0))
+      {
+      std::cerr << "ERROR: " << step << ": file " << cc << " was "
+                << (queried? "" : "not ") << "queried." << std::endl;
+      return false;
+      }
+    }
+
+  vtkInformation* outInfo = series->GetOutputInformation(0);
+  int numTimes = outInfo->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+  double* times = outInfo->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+  if (numTimes != static_cast<int>(expectedTimes.size()) ||
+    !std::equal(expectedTimes.begin(), expectedTimes.end(), times))
+    {
+    std::cerr << "ERROR: " << step << ": unexpected time steps:";
+    for (int cc=0; cc < numTimes; cc++)
+      {
+      std::cerr << " " << times[cc];
+      }
+    std::cerr << std::endl;
+    return false;
+    }
+  return true;
+}
+}
+
+int TestFileSeriesReaderTimeIndex(int argc, char* argv[])
+{
+  char* tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!tempDir)
+    {
+    std::cerr << "Could not determine temporary directory." << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string dir = tempDir;
+  delete [] tempDir;
+
+  // file i holds time steps i and i + 0.5.
+  std::vector<std::string> fileNames;
+  FileTimesType fileTimes(NumberOfFiles);
+  for (int cc=0; cc < NumberOfFiles; cc++)
+    {
+    std::ostringstream fileName;
+    fileName << dir << "/timeindex_" << cc << ".txt";
+    fileNames.push_back(fileName.str());
+    fileTimes[cc].push_back(cc);
+    fileTimes[cc].push_back(cc + 0.5);
+    if (!WriteTimes(fileNames[cc], fileTimes[cc]))
+      {
+      std::cerr << "Could not write " << fileNames[cc] << "." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  std::string indexName = fileNames[0] + ".timeindex";
+  vtksys::SystemTools::RemoveFile(indexName.c_str());
+
+  vtkClientServerInterpreterInitializer::GetGlobalInterpreter()->
+    AddCommandFunction("vtkTestTimeReader", vtkTestTimeReaderCommand);
+  vtkFileSeriesReader::SetSaveFileSeriesTimeIndex(true);
+  int status = EXIT_FAILURE;
+  std::set<int> all;
+  for (int cc=1; cc < NumberOfFiles - 1; cc++)
+    {
+    all.insert(cc);
+    }
+  std::set<int> none;
+  std::set<int> changed;
+
+  do
+    {
+    // the first time, every file is queried and the index is saved...
+    if (!Open(fileNames, all, SeriesTimes(fileTimes), "first open"))
+      {
+      break;
+      }
+    if (!vtksys::SystemTools::FileExists(indexName.c_str()))
+      {
+      std::cerr << "ERROR: " << indexName << " was not written." << std::endl;
+      break;
+      }
+
+    // ... then the time values come from the index.
+    if (!Open(fileNames, none, SeriesTimes(fileTimes), "unchanged"))
+      {
+      break;
+      }
+
+    // a file whose size changed is queried again.
+    fileTimes[2][1] = 2.25;
+    fileTimes[2].push_back(2.75);
+    if (!WriteTimes(fileNames[2], fileTimes[2]))
+      {
+      break;
+      }
+    changed.insert(2);
+    if (!Open(fileNames, changed, SeriesTimes(fileTimes), "size changed") ||
+      !Open(fileNames, none, SeriesTimes(fileTimes), "size change saved"))
+      {
+      break;
+      }
+
+    // so is a file of the same size whose modification time changed, moved
+    // forward so that the change is seen whatever the resolution of the file
+    // system.
+    fileTimes[3][1] = 3.7;
+    if (!WriteTimes(fileNames[3], fileTimes[3]) ||
+      !SetModifiedTime(fileNames[3],
+        vtksys::SystemTools::ModifiedTime(fileNames[3].c_str()) + 100))
+      {
+      break;
+      }
+    changed.clear();
+    changed.insert(3);
+    if (!Open(fileNames, changed, SeriesTimes(fileTimes), "time changed") ||
+      !Open(fileNames, none, SeriesTimes(fileTimes), "time change saved"))
+      {
+      break;
+      }
+
+    // the whole index is ignored when the first file reports other time
+    // values, even if its size and modification time did not change.
+    long mtime = vtksys::SystemTools::ModifiedTime(fileNames[0].c_str());
+    fileTimes[0][1] = 0.7;
+    if (!WriteTimes(fileNames[0], fileTimes[0]) ||
+      !SetModifiedTime(fileNames[0], mtime))
+      {
+      break;
+      }
+    if (!Open(fileNames, all, SeriesTimes(fileTimes), "first file changed") ||
+      !Open(fileNames, none, SeriesTimes(fileTimes), "first file change saved"))
+      {
+      break;
+      }
+
+    // a series opened without the setting does not use the index.
+    vtkFileSeriesReader::SetSaveFileSeriesTimeIndex(false);
+    if (!Open(fileNames, all, SeriesTimes(fileTimes), "index not used"))
+      {
+      break;
+      }
+    status = EXIT_SUCCESS;
+    }
+  while (false);
+
+  vtkFileSeriesReader::SetSaveFileSeriesTimeIndex(false);
+  return status;
+}
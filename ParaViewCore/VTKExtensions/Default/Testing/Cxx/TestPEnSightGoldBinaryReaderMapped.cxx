@@ -0,0 +1,440 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPEnSightGoldBinaryReaderMapped.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Writes a small big endian EnSight Gold binary case with two parts, node and
+// element variables, and reads it with and without memory mapping. The
+// outputs must be identical and hold the values that were written.
+
+#include "vtkByteSwap.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkDummyController.h"
+#include "vtkIdList.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPEnSightGoldBinaryReader.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+// Part 1 has 5 points, two tetra4 and one bar3. Part 2 is a single hexa8.
+const int NumberOfPoints[2] = { 5, 8 };
+const int Tetra4[8] = { 1, 2, 3, 4,  2, 3, 4, 5 };
+const int Bar3[3] = { 1, 5, 2 };
+const int Hexa8[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+// Point i of part p is at (i, p, 0) so that node values, which are
+// functions of x, can be checked wherever the reader put the point.
+float NodeValue(float x, int part, int component)
+{
+  return 10 * x + 100 * part + component;
+}
+
+float CellValue(int cell, int part, int component)
+{
+  return cell + 100 * part + 10 * component;
+}
+
+class Writer
+{
+public:
+  Writer(const std::string& fileName)
+    : Stream(fileName.c_str(), std::ios::out | std::ios::binary)
+    {
+    }
+  void String(const char* str)
+    {
+    char line[80];
+    memset(line, 0, 80);
+    strncpy(line, str, 79);
+    this->Stream.write(line, 80);
+    }
+  void Int(int value)
+    {
+    vtkByteSwap::SwapWrite4BERange(&value, 1, &this->Stream);
+    }
+  void Ints(const int* values, int count)
+    {
+    vtkByteSwap::SwapWrite4BERange(values, count, &this->Stream);
+    }
+  void Floats(const std::vector<float>& values)
+    {
+    vtkByteSwap::SwapWrite4BERange(&values[0], values.size(), &this->Stream);
+    }
+  bool Good()
+    {
+    this->Stream.flush();
+    return this->Stream.good();
+    }
+
+private:
+  std::ofstream Stream;
+};
+
+bool WriteCase(const std::string& dir)
+{
+  std::ofstream caseFile((dir + "/mapped.case").c_str());
+  caseFile << "FORMAT\n"
+           << "type: ensight gold\n\n"
+           << "GEOMETRY\n"
+           << "model: mapped.geo\n\n"
+           << "VARIABLE\n"
+           << "scalar per node: pressure mapped.scl\n"
+           << "vector per node: velocity mapped.vec\n"
+           << "tensor symm per node: stress mapped.ten\n"
+           << "scalar per element: temperature mapped.escl\n"
+           << "vector per element: flux mapped.evec\n";
+  if (!caseFile.good())
+    {
+    return false;
+    }
+
+  Writer geo(dir + "/mapped.geo");
+  geo.String("C Binary");
+  geo.String("Memory mapping test");
+  geo.String("Two parts");
+  geo.String("node id off");
+  geo.String("element id off");
+  for (int part = 1; part <= 2; part++)
+    {
+    geo.String("part");
+    geo.Int(part);
+    geo.String(part == 1 ? "tetrahedra" : "hexahedron");
+    geo.String("coordinates");
+    int numPts = NumberOfPoints[part - 1];
+    geo.Int(numPts);
+    std::vector<float> plane(numPts);
+    for (int c = 0; c < 3; c++)
+      {
+      for (int i = 0; i < numPts; i++)
+        {
+        plane[i] = c == 0 ? i : (c == 1 ? part : 0);
+        }
+      geo.Floats(plane);
+      }
+    if (part == 1)
+      {
+      geo.String("tetra4");
+      geo.Int(2);
+      geo.Ints(Tetra4, 8);
+      geo.String("bar3");
+      geo.Int(1);
+      geo.Ints(Bar3, 3);
+      }
+    else
+      {
+      geo.String("hexa8");
+      geo.Int(1);
+      geo.Ints(Hexa8, 8);
+      }
+    }
+  if (!geo.Good())
+    {
+    return false;
+    }
+
+  const char* nodeFiles[3] = { "mapped.scl", "mapped.vec", "mapped.ten" };
+  const int nodeComponents[3] = { 1, 3, 6 };
+  for (int v = 0; v < 3; v++)
+    {
+    Writer var(dir + "/" + nodeFiles[v]);
+    var.String(nodeFiles[v]);
+    for (int part = 1; part <= 2; part++)
+      {
+      var.String("part");
+      var.Int(part);
+      var.String("coordinates");
+      int numPts = NumberOfPoints[part - 1];
+      std::vector<float> plane(numPts);
+      for (int c = 0; c < nodeComponents[v]; c++)
+        {
+        for (int i = 0; i < numPts; i++)
+          {
+          plane[i] = NodeValue(i, part, c);
+          }
+        var.Floats(plane);
+        }
+      }
+    if (!var.Good())
+      {
+      return false;
+      }
+    }
+
+  const char* cellFiles[2] = { "mapped.escl", "mapped.evec" };
+  const int cellComponents[2] = { 1, 3 };
+  for (int v = 0; v < 2; v++)
+    {
+    Writer var(dir + "/" + cellFiles[v]);
+    var.String(cellFiles[v]);
+    for (int part = 1; part <= 2; part++)
+      {
+      var.String("part");
+      var.Int(part);
+      // cells are numbered in the order of the element blocks.
+      const char* types[2] = { part == 1 ? "tetra4" : "hexa8", "bar3" };
+      int counts[2] = { part == 1 ? 2 : 1, 1 };
+      int first = 0;
+      for (int t = 0; t < (part == 1 ? 2 : 1); t++)
+        {
+        var.String(types[t]);
+        std::vector<float> plane(counts[t]);
+        for (int c = 0; c < cellComponents[v]; c++)
+          {
+          for (int i = 0; i < counts[t]; i++)
+            {
+            plane[i] = CellValue(first + i, part, c);
+            }
+          var.Floats(plane);
+          }
+        first += counts[t];
+        }
+      }
+    if (!var.Good())
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+vtkSmartPointer<vtkMultiBlockDataSet> Read(const std::string& dir,
+                                           bool mapped)
+{
+  vtkPEnSightGoldBinaryReader::SetUseMemoryMapping(mapped);
+  vtkNew<vtkPEnSightGoldBinaryReader> reader;
+  reader->SetFilePath(dir.c_str());
+  reader->SetCaseFileName("mapped.case");
+  reader->SetByteOrderToBigEndian();
+  reader->Update();
+  vtkPEnSightGoldBinaryReader::SetUseMemoryMapping(false);
+
+  vtkSmartPointer<vtkMultiBlockDataSet> output =
+    vtkSmartPointer<vtkMultiBlockDataSet>::New();
+  output->ShallowCopy(reader->GetOutput());
+  return output;
+}
+
+bool CompareArrays(vtkDataArray* expected, vtkDataArray* actual,
+                   const char* what)
+{
+  if (!expected || !actual ||
+      expected->GetNumberOfTuples() != actual->GetNumberOfTuples() ||
+      expected->GetNumberOfComponents() != actual->GetNumberOfComponents())
+    {
+    std::cerr << "Mismatch in size of " << what << "." << std::endl;
+    return false;
+    }
+  for (vtkIdType i = 0; i < expected->GetNumberOfTuples(); i++)
+    {
+    for (int c = 0; c < expected->GetNumberOfComponents(); c++)
+      {
+      if (expected->GetComponent(i, c) != actual->GetComponent(i, c))
+        {
+        std::cerr << "Mismatch in " << what << " at tuple " << i << "."
+                  << std::endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+bool Compare(vtkUnstructuredGrid* expected, vtkUnstructuredGrid* actual)
+{
+  if (!expected || !actual ||
+      expected->GetNumberOfCells() != actual->GetNumberOfCells() ||
+      !CompareArrays(expected->GetPoints()->GetData(),
+                     actual->GetPoints()->GetData(), "coordinates"))
+    {
+    std::cerr << "Mismatch in geometry." << std::endl;
+    return false;
+    }
+  vtkNew<vtkIdList> expectedIds;
+  vtkNew<vtkIdList> actualIds;
+  for (vtkIdType i = 0; i < expected->GetNumberOfCells(); i++)
+    {
+    expected->GetCellPoints(i, expectedIds.GetPointer());
+    actual->GetCellPoints(i, actualIds.GetPointer());
+    if (expected->GetCellType(i) != actual->GetCellType(i) ||
+        expectedIds->GetNumberOfIds() != actualIds->GetNumberOfIds())
+      {
+      std::cerr << "Mismatch in cell " << i << "." << std::endl;
+      return false;
+      }
+    for (vtkIdType j = 0; j < expectedIds->GetNumberOfIds(); j++)
+      {
+      if (expectedIds->GetId(j) != actualIds->GetId(j))
+        {
+        std::cerr << "Mismatch in connectivity of cell " << i << "."
+                  << std::endl;
+        return false;
+        }
+      }
+    }
+  const char* pointArrays[3] = { "pressure", "velocity", "stress" };
+  for (int a = 0; a < 3; a++)
+    {
+    if (!CompareArrays(expected->GetPointData()->GetArray(pointArrays[a]),
+                       actual->GetPointData()->GetArray(pointArrays[a]),
+                       pointArrays[a]))
+      {
+      return false;
+      }
+    }
+  const char* cellArrays[2] = { "temperature", "flux" };
+  for (int a = 0; a < 2; a++)
+    {
+    if (!CompareArrays(expected->GetCellData()->GetArray(cellArrays[a]),
+                       actual->GetCellData()->GetArray(cellArrays[a]),
+                       cellArrays[a]))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+// Checks the values read against the ones written.
+bool Check(vtkUnstructuredGrid* grid, int part)
+{
+  int numCells = part == 1 ? 3 : 1;
+  if (grid->GetNumberOfPoints() != NumberOfPoints[part - 1] ||
+      grid->GetNumberOfCells() != numCells)
+    {
+    std::cerr << "Part " << part << " has " << grid->GetNumberOfPoints()
+              << " points and " << grid->GetNumberOfCells() << " cells."
+              << std::endl;
+    return false;
+    }
+
+  const char* pointArrays[3] = { "pressure", "velocity", "stress" };
+  for (int a = 0; a < 3; a++)
+    {
+    vtkDataArray* array = grid->GetPointData()->GetArray(pointArrays[a]);
+    for (vtkIdType i = 0; i < grid->GetNumberOfPoints(); i++)
+      {
+      double x[3];
+      grid->GetPoint(i, x);
+      for (int c = 0; c < array->GetNumberOfComponents(); c++)
+        {
+        if (array->GetComponent(i, c) != NodeValue(x[0], part, c))
+          {
+          std::cerr << "Wrong " << pointArrays[a] << " at point " << i
+                    << " of part " << part << "." << std::endl;
+          return false;
+          }
+        }
+      }
+    }
+
+  const char* cellArrays[2] = { "temperature", "flux" };
+  for (int a = 0; a < 2; a++)
+    {
+    vtkDataArray* array = grid->GetCellData()->GetArray(cellArrays[a]);
+    for (vtkIdType i = 0; i < numCells; i++)
+      {
+      for (int c = 0; c < array->GetNumberOfComponents(); c++)
+        {
+        if (array->GetComponent(i, c) != CellValue(i, part, c))
+          {
+          std::cerr << "Wrong " << cellArrays[a] << " at cell " << i
+                    << " of part " << part << "." << std::endl;
+          return false;
+          }
+        }
+      }
+    }
+
+  // The cells use the nodes listed in the file, with the mid-edge node of
+  // the bar3 last.
+  const int* nodes[3] = { Tetra4, Tetra4 + 4, Hexa8 };
+  const int bar3Nodes[3] = { Bar3[0], Bar3[2], Bar3[1] };
+  vtkNew<vtkIdList> ids;
+  for (vtkIdType i = 0; i < numCells; i++)
+    {
+    const int* expected = part == 1 ? (i < 2 ? nodes[i] : bar3Nodes) : nodes[2];
+    grid->GetCellPoints(i, ids.GetPointer());
+    for (vtkIdType j = 0; j < ids->GetNumberOfIds(); j++)
+      {
+      if (grid->GetPoint(ids->GetId(j))[0] != expected[j] - 1)
+        {
+        std::cerr << "Wrong node " << j << " in cell " << i << " of part "
+                  << part << "." << std::endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+}
+
+int TestPEnSightGoldBinaryReaderMapped(int argc, char* argv[])
+{
+  char* tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!tempDir)
+    {
+    std::cerr << "Could not determine temporary directory." << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string dir = tempDir;
+  delete [] tempDir;
+
+  if (!WriteCase(dir))
+    {
+    std::cerr << "Could not write the case in " << dir << "." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The reader distributes cells over the processes of the global controller.
+  vtkNew<vtkDummyController> controller;
+  vtkMultiProcessController::SetGlobalController(controller.GetPointer());
+
+  vtkSmartPointer<vtkMultiBlockDataSet> stream = Read(dir, false);
+  vtkSmartPointer<vtkMultiBlockDataSet> mapped = Read(dir, true);
+
+  int status = EXIT_SUCCESS;
+  if (stream->GetNumberOfBlocks() != 2 || mapped->GetNumberOfBlocks() != 2)
+    {
+    std::cerr << "Expected 2 parts, got " << stream->GetNumberOfBlocks()
+              << " and " << mapped->GetNumberOfBlocks() << "." << std::endl;
+    status = EXIT_FAILURE;
+    }
+  for (unsigned int b = 0; b < 2 && status == EXIT_SUCCESS; b++)
+    {
+    vtkUnstructuredGrid* expected =
+      vtkUnstructuredGrid::SafeDownCast(stream->GetBlock(b));
+    vtkUnstructuredGrid* actual =
+      vtkUnstructuredGrid::SafeDownCast(mapped->GetBlock(b));
+    if (!expected || !Check(expected, b + 1) || !Compare(expected, actual))
+      {
+      std::cerr << "Part " << b + 1 << " differs." << std::endl;
+      status = EXIT_FAILURE;
+      }
+    }
+
+  vtkMultiProcessController::SetGlobalController(NULL);
+  return status;
+}
@@ -25,6 +25,8 @@ vtk_module(vtkPVVTKExtensionsDefault
     vtknetcdf
     vtksys
     vtkChartsCore
+  TEST_DEPENDS
+    vtkTestingCore
   KIT
     vtkPVExtensions
 )
@@ -17,21 +17,36 @@
 #include "vtkAlgorithm.h"
 #include "vtkArrayIteratorIncludes.h"
 #include "vtkCellData.h"
+#include "vtkCommunicator.h"
 #include "vtkDataArray.h"
 #include "vtkErrorCode.h"
 #include "vtkInformation.h"
+#include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPointSet.h"
 #include "vtkPolyData.h"
 #include "vtkPolyLineToRectilinearGridFilter.h"
+#include "vtkSMPTools.h"
 #include "vtkTable.h"
 #include "vtkSmartPointer.h"
 
+#include <algorithm>
+#include <iomanip>
+#include <string>
 #include <vector>
 #include <vtksys/ios/sstream>
 
+#include <stdio.h> // for snprintf
+
+#if defined(_WIN32) && !defined(__CYGWIN__)
+#  define SNPRINTF _snprintf
+#else
+#  define SNPRINTF snprintf
+#endif
+
 vtkStandardNewMacro(vtkCSVWriter);
+vtkCxxSetObjectMacro(vtkCSVWriter, Controller, vtkMultiProcessController);
 //-----------------------------------------------------------------------------
 vtkCSVWriter::vtkCSVWriter()
 {
@@ -44,6 +59,7 @@ vtkCSVWriter::vtkCSVWriter()
   this->FileName = 0;
   this->Precision = 5;
   this->UseScientificNotation = true;
+  this->Controller = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -52,6 +68,7 @@ vtkCSVWriter::~vtkCSVWriter()
   this->SetStringDelimiter(0);
   this->SetFieldDelimiter(0);
   this->SetFileName(0);
+  this->SetController(0);
   delete this->Stream;
 }
 
@@ -64,7 +81,7 @@ int vtkCSVWriter::FillInputPortInformation(
 }
 
 //-----------------------------------------------------------------------------
-bool vtkCSVWriter::OpenFile()
+bool vtkCSVWriter::OpenFile(bool truncate)
 {
   if ( !this->FileName )
     {
@@ -75,7 +92,15 @@ bool vtkCSVWriter::OpenFile()
 
   vtkDebugMacro(<<"Opening file for writing...");
 
-  ofstream *fptr = new ofstream(this->FileName, ios::out);
+  delete this->Stream;
+  this->Stream = 0;
+
+  // When the file is written collectively, it is created (and truncated) by
+  // the root process only; the other processes open it for update to write
+  // their byte range.
+  ofstream *fptr = truncate?
+    new ofstream(this->FileName, ios::out | ios::binary) :
+    new ofstream(this->FileName, ios::in | ios::out | ios::binary);
 
   if (fptr->fail())
     {
@@ -89,126 +114,193 @@ bool vtkCSVWriter::OpenFile()
   return true;
 }
 
-//-----------------------------------------------------------------------------
-template <class iterT>
-void vtkCSVWriterGetDataString(
-  iterT* iter, vtkIdType tupleIndex, ofstream* stream, vtkCSVWriter* writer,
-  bool* first)
+namespace
 {
-  int numComps = iter->GetNumberOfComponents();
-  vtkIdType index = tupleIndex* numComps;
-  for (int cc=0; cc < numComps; cc++)
+  // Formatting options shared by all threads formatting rows.
+  struct vtkCSVFormat
     {
-    if ((index+cc) < iter->GetNumberOfValues())
-      {
-      if (*first == false)
-        {
-        (*stream) << writer->GetFieldDelimiter();
-        }
-      *first = false;
-      (*stream) << iter->GetValue(index+cc);
-      }
-    else
+    vtkCSVWriter* Writer;
+    std::string FieldDelimiter;
+    int Precision;
+    bool UseScientificNotation;
+    const char* FloatFormat;
+    };
+
+  //---------------------------------------------------------------------------
+  // Fallback for types without a fast path: format exactly like the stream
+  // inserts used to.
+  template <class T>
+  void vtkCSVAppendValue(std::string& buffer, const T& value,
+    const vtkCSVFormat& format)
+    {
+    vtksys_ios::ostringstream str;
+    if (format.UseScientificNotation)
       {
-      if (*first == false)
-        {
-        (*stream) << writer->GetFieldDelimiter();
-        }
-      *first = false;
+      str << std::scientific;
       }
+    str << std::setprecision(format.Precision) << value;
+    buffer += str.str();
     }
-}
 
-//-----------------------------------------------------------------------------
-VTK_TEMPLATE_SPECIALIZE
-void vtkCSVWriterGetDataString(
-  vtkArrayIteratorTemplate<vtkStdString>* iter, vtkIdType tupleIndex,
-  ofstream* stream, vtkCSVWriter* writer, bool* first)
-{
-  int numComps = iter->GetNumberOfComponents();
-  vtkIdType index = tupleIndex* numComps;
-  for (int cc=0; cc < numComps; cc++)
+  //---------------------------------------------------------------------------
+  template <class T>
+  void vtkCSVAppendInteger(std::string& buffer, T value)
     {
-    if ((index+cc) < iter->GetNumberOfValues())
+    char text[32];
+    char* end = text + sizeof(text);
+    char* ptr = end;
+    bool negative = value < 0;
+    do
       {
-      if (*first == false)
-        {
-        (*stream) << writer->GetFieldDelimiter();
-        }
-      *first = false;
-      (*stream) << writer->GetString(iter->GetValue(index+cc));
+      int digit = static_cast<int>(value % 10);
+      *--ptr = static_cast<char>('0' + (negative? -digit : digit));
+      value /= 10;
       }
-    else
+    while (value != 0);
+    if (negative)
       {
-      if (*first == false)
-        {
-        (*stream) << writer->GetFieldDelimiter();
-        }
-      *first = false;
+      *--ptr = '-';
       }
+    buffer.append(ptr, end);
     }
-}
 
-//-----------------------------------------------------------------------------
-VTK_TEMPLATE_SPECIALIZE
-void vtkCSVWriterGetDataString(
-  vtkArrayIteratorTemplate<char>* iter, vtkIdType tupleIndex,
-  ofstream* stream, vtkCSVWriter* writer, bool* first)
-{
-  int numComps = iter->GetNumberOfComponents();
-  vtkIdType index = tupleIndex* numComps;
-  for (int cc=0; cc < numComps; cc++)
+  //---------------------------------------------------------------------------
+  void vtkCSVAppendReal(std::string& buffer, double value,
+    const vtkCSVFormat& format)
     {
-    if ((index+cc) < iter->GetNumberOfValues())
+    char text[128];
+    int length = SNPRINTF(text, sizeof(text), format.FloatFormat,
+      format.Precision, value);
+    if (length >= 0 && length < static_cast<int>(sizeof(text)))
       {
-      if (*first == false)
-        {
-        (*stream) << writer->GetFieldDelimiter();
-        }
-      *first = false;
-      (*stream) << static_cast<int>( iter->GetValue(index+cc) );
+      buffer.append(text, length);
       }
     else
       {
-      if (*first == false)
-        {
-        (*stream) << writer->GetFieldDelimiter();
-        }
-      *first = false;
+      vtkCSVAppendValue<double>(buffer, value, format);
       }
     }
-}
 
-//-----------------------------------------------------------------------------
-VTK_TEMPLATE_SPECIALIZE
-void vtkCSVWriterGetDataString(
-  vtkArrayIteratorTemplate<unsigned char>* iter, vtkIdType tupleIndex,
-  ofstream* stream, vtkCSVWriter* writer, bool* first)
-{
-  int numComps = iter->GetNumberOfComponents();
-  vtkIdType index = tupleIndex* numComps;
-  for (int cc=0; cc < numComps; cc++)
+  //---------------------------------------------------------------------------
+  // Fast paths. char and unsigned char are written as numbers.
+#define vtkCSVAppendIntegerValueMacro(type) \
+  void vtkCSVAppendValue(std::string& buffer, const type& value, \
+    const vtkCSVFormat&) \
+    { \
+    vtkCSVAppendInteger(buffer, value); \
+    }
+  vtkCSVAppendIntegerValueMacro(short)
+  vtkCSVAppendIntegerValueMacro(unsigned short)
+  vtkCSVAppendIntegerValueMacro(int)
+  vtkCSVAppendIntegerValueMacro(unsigned int)
+  vtkCSVAppendIntegerValueMacro(long)
+  vtkCSVAppendIntegerValueMacro(unsigned long)
+#if defined(VTK_TYPE_USE_LONG_LONG)
+  vtkCSVAppendIntegerValueMacro(long long)
+  vtkCSVAppendIntegerValueMacro(unsigned long long)
+#endif
+#if defined(VTK_TYPE_USE___INT64)
+  vtkCSVAppendIntegerValueMacro(__int64)
+  vtkCSVAppendIntegerValueMacro(unsigned __int64)
+#endif
+#undef vtkCSVAppendIntegerValueMacro
+
+  void vtkCSVAppendValue(std::string& buffer, const char& value,
+    const vtkCSVFormat&)
+    {
+    vtkCSVAppendInteger(buffer, static_cast<int>(value));
+    }
+
+  void vtkCSVAppendValue(std::string& buffer, const unsigned char& value,
+    const vtkCSVFormat&)
+    {
+    vtkCSVAppendInteger(buffer, static_cast<int>(value));
+    }
+
+  void vtkCSVAppendValue(std::string& buffer, const float& value,
+    const vtkCSVFormat& format)
+    {
+    vtkCSVAppendReal(buffer, value, format);
+    }
+
+  void vtkCSVAppendValue(std::string& buffer, const double& value,
+    const vtkCSVFormat& format)
+    {
+    vtkCSVAppendReal(buffer, value, format);
+    }
+
+  void vtkCSVAppendValue(std::string& buffer, const vtkStdString& value,
+    const vtkCSVFormat& format)
     {
-    if ((index+cc) < iter->GetNumberOfValues())
+    buffer += format.Writer->GetString(value);
+    }
+
+  //---------------------------------------------------------------------------
+  template <class iterT>
+  void vtkCSVAppendTuple(iterT* iter, vtkIdType tupleIndex,
+    std::string& buffer, const vtkCSVFormat& format, bool* first)
+    {
+    int numComps = iter->GetNumberOfComponents();
+    vtkIdType index = tupleIndex* numComps;
+    for (int cc=0; cc < numComps; cc++)
       {
       if (*first == false)
         {
-        (*stream) << writer->GetFieldDelimiter();
+        buffer += format.FieldDelimiter;
         }
       *first = false;
-      (*stream) << static_cast<int>( iter->GetValue(index+cc) );
+      if ((index+cc) < iter->GetNumberOfValues())
+        {
+        vtkCSVAppendValue(buffer, iter->GetValue(index+cc), format);
+        }
       }
-    else
+    }
+
+  //---------------------------------------------------------------------------
+  // Formats blocks of rows into separate buffers, concurrently.
+  class vtkCSVFormatRowsFunctor
+  {
+  public:
+    std::vector<vtkSmartPointer<vtkArrayIterator> >* Columns;
+    const vtkCSVFormat* Format;
+    std::vector<std::string>* Blocks;
+    vtkIdType FirstRow;
+    vtkIdType EndRow;
+    vtkIdType RowsPerBlock;
+
+    void operator()(vtkIdType begin, vtkIdType end)
       {
-      if (*first == false)
+      for (vtkIdType block = begin; block < end; ++block)
         {
-        (*stream) << writer->GetFieldDelimiter();
+        std::string& buffer = (*this->Blocks)[block];
+        buffer.clear();
+        vtkIdType firstRow = this->FirstRow + block * this->RowsPerBlock;
+        vtkIdType endRow = std::min(firstRow + this->RowsPerBlock, this->EndRow);
+        for (vtkIdType row = firstRow; row < endRow; ++row)
+          {
+          bool first = true;
+          std::vector<vtkSmartPointer<vtkArrayIterator> >::iterator iter;
+          for (iter = this->Columns->begin(); iter != this->Columns->end(); ++iter)
+            {
+            switch ((*iter)->GetDataType())
+              {
+              vtkArrayIteratorTemplateMacro(
+                vtkCSVAppendTuple(static_cast<VTK_TT*>(iter->GetPointer()),
+                  row, buffer, *this->Format, &first));
+              }
+            }
+          buffer += '\n';
+          }
         }
-      *first = false;
       }
-    }
-}
+  };
 
+  // Rows formatted by each task, and number of tasks formatted before the
+  // buffers are written out. This bounds the memory used for formatting
+  // to a few tens of megabytes regardless of the table size.
+  const vtkIdType vtkCSVRowsPerBlock = 16384;
+  const vtkIdType vtkCSVBlocksPerBatch = 64;
+}
 
 //-----------------------------------------------------------------------------
 vtkStdString vtkCSVWriter::GetString(vtkStdString string)
@@ -241,7 +333,37 @@ void vtkCSVWriter::WriteTable(vtkTable* table)
 {
   vtkIdType numRows = table->GetNumberOfRows();
   vtkDataSetAttributes* dsa = table->GetRowData();
-  if (!this->OpenFile())
+
+  vtkMultiProcessController* controller = this->Controller;
+  bool collective = (controller && controller->GetNumberOfProcesses() > 1);
+  int myId = collective? controller->GetLocalProcessId() : 0;
+
+  // Open the file. In collective mode, the root creates it first and the
+  // others open it once it exists.
+  int fileOpened = 1;
+  if (myId == 0)
+    {
+    fileOpened = this->OpenFile(true)? 1 : 0;
+    }
+  if (collective)
+    {
+    controller->Broadcast(&fileOpened, 1, 0);
+    if (!fileOpened)
+      {
+      if (myId != 0)
+        {
+        vtkErrorMacro(<< "Unable to open file: " << this->FileName);
+        this->SetErrorCode(vtkErrorCode::CannotOpenFileError);
+        }
+      return;
+      }
+    if (myId != 0 && !this->OpenFile(false))
+      {
+      // still take part in the collective operations below.
+      fileOpened = 0;
+      }
+    }
+  else if (!fileOpened)
     {
     return;
     }
@@ -251,6 +373,7 @@ void vtkCSVWriter::WriteTable(vtkTable* table)
   int cc;
   int numArrays = dsa->GetNumberOfArrays();
   bool first = true;
+  std::string header;
   // Write headers:
   for (cc=0; cc < numArrays; cc++)
     {
@@ -259,7 +382,7 @@ void vtkCSVWriter::WriteTable(vtkTable* table)
       {
       if (!first)
         {
-        (*this->Stream) << this->FieldDelimiter;
+        header += this->FieldDelimiter;
         }
       first = false;
 
@@ -269,39 +392,136 @@ void vtkCSVWriter::WriteTable(vtkTable* table)
         {
         array_name << ":" << comp;
         }
-      (*this->Stream) << this->GetString(array_name.str());
+      header += this->GetString(array_name.str());
       }
     vtkArrayIterator* iter = array->NewIterator();
     columnsIters.push_back(iter);
     iter->Delete();
     }
-  (*this->Stream) << "\n";
+  header += "\n";
+
+  vtkCSVFormat format;
+  format.Writer = this;
+  format.FieldDelimiter = this->FieldDelimiter? this->FieldDelimiter : "";
+  format.Precision = this->Precision;
+  format.UseScientificNotation = this->UseScientificNotation;
+  format.FloatFormat = this->UseScientificNotation? "%.*e" : "%.*g";
 
-  // push the floating point precision/notation type.
-  if (this->UseScientificNotation)
+  std::vector<std::string> blocks(vtkCSVBlocksPerBatch);
+  vtkCSVFormatRowsFunctor functor;
+  functor.Columns = &columnsIters;
+  functor.Format = &format;
+  functor.Blocks = &blocks;
+  functor.RowsPerBlock = vtkCSVRowsPerBlock;
+
+  const vtkIdType rowsPerBatch = vtkCSVRowsPerBlock * vtkCSVBlocksPerBatch;
+  int numBatches = static_cast<int>((numRows + rowsPerBatch - 1) / rowsPerBatch);
+  int numProcs = 1;
+  if (collective)
     {
-    (*this->Stream) << std::scientific;
+    int localBatches = numBatches;
+    controller->AllReduce(&localBatches, &numBatches, 1,
+      vtkCommunicator::MAX_OP);
+    numProcs = controller->GetNumberOfProcesses();
     }
-  
-  (*this->Stream) << std::setprecision(this->Precision);
 
-  for (vtkIdType index=0; index < numRows; index++)
+  // The header is written by the first process that has columns.
+  int headerWriter = 0;
+  if (collective)
     {
-    first = true;
-    std::vector<vtkSmartPointer<vtkArrayIterator> >::iterator iter;
-    for (iter = columnsIters.begin(); iter != columnsIters.end(); ++iter)
+    std::vector<int> hasColumns(numProcs);
+    int localHasColumns = numArrays > 0? 1 : 0;
+    controller->AllGather(&localHasColumns, &hasColumns[0], 1);
+    for (int proc = 0; proc < numProcs; proc++)
       {
-      switch ((*iter)->GetDataType())
+      if (hasColumns[proc])
         {
-        vtkArrayIteratorTemplateMacro(
-          vtkCSVWriterGetDataString(static_cast<VTK_TT*>(iter->GetPointer()),
-            index, this->Stream, this, &first));
+        headerWriter = proc;
+        break;
         }
       }
-    (*this->Stream) << "\n";
     }
 
-  this->Stream->close();
+  // Every batch of rows is formatted concurrently into a set of buffers which
+  // are then written out as large contiguous blocks. In collective mode,
+  // each process writes its share of the batch at an offset following the
+  // shares of the lower ranks.
+  std::vector<vtkIdType> sizes(numProcs);
+  vtkTypeInt64 offset = 0;
+  for (int batch = 0; batch <= numBatches; batch++)
+    {
+    vtkIdType numBlocks = 0;
+    if (batch == 0)
+      {
+      if (myId == headerWriter)
+        {
+        blocks[0] = header;
+        numBlocks = 1;
+        }
+      }
+    else
+      {
+      functor.FirstRow = std::min((batch - 1) * rowsPerBatch, numRows);
+      functor.EndRow = std::min(functor.FirstRow + rowsPerBatch, numRows);
+      numBlocks = (functor.EndRow - functor.FirstRow + vtkCSVRowsPerBlock - 1)
+        / vtkCSVRowsPerBlock;
+      vtkSMPTools::For(0, numBlocks, 1, functor);
+      }
+
+    vtkIdType localSize = 0;
+    for (vtkIdType block = 0; block < numBlocks; block++)
+      {
+      localSize += static_cast<vtkIdType>(blocks[block].size());
+      }
+
+    vtkTypeInt64 localOffset = offset;
+    if (collective)
+      {
+      controller->AllGather(&localSize, &sizes[0], 1);
+      for (int proc = 0; proc < numProcs; proc++)
+        {
+        if (proc < myId)
+          {
+          localOffset += sizes[proc];
+          }
+        offset += sizes[proc];
+        }
+      }
+
+    if (fileOpened && localSize > 0)
+      {
+      if (collective)
+        {
+        this->Stream->seekp(static_cast<std::streamoff>(localOffset));
+        }
+      for (vtkIdType block = 0; block < numBlocks; block++)
+        {
+        this->Stream->write(blocks[block].c_str(),
+          static_cast<std::streamsize>(blocks[block].size()));
+        }
+      }
+    }
+
+  int written = fileOpened;
+  if (fileOpened)
+    {
+    this->Stream->close();
+    written = this->Stream->fail()? 0 : 1;
+    }
+  if (collective)
+    {
+    // A process that could not open or write the file leaves a hole in it:
+    // every process reports the failure. This also makes sure the file is
+    // complete when the writer returns.
+    int localWritten = written;
+    controller->AllReduce(&localWritten, &written, 1,
+      vtkCommunicator::MIN_OP);
+    }
+  if (!written)
+    {
+    vtkErrorMacro(<< "Error writing file: " << this->FileName);
+    this->SetErrorCode(vtkErrorCode::OutOfDiskSpaceError);
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -317,4 +537,5 @@ void vtkCSVWriter::PrintSelf(ostream& os, vtkIndent indent)
     << endl;
   os << indent << "UseScientificNotation: " << this->UseScientificNotation << endl;
   os << indent << "Precision: " << this->Precision << endl;
+  os << indent << "Controller: " << this->Controller << endl;
 }
@@ -14,12 +14,18 @@
 =========================================================================*/
 // .NAME vtkCSVWriter - CSV writer for vtkTable
 // Writes a vtkTable as a delimited text file (such as CSV). 
+// Rows are formatted concurrently (using vtkSMPTools) into memory buffers
+// that are written out in large blocks. When a Controller with more than one
+// process is set, all processes write their rows into the same file
+// concurrently, each at the byte offset following the rows of the lower
+// ranks; Write() must then be called on all processes.
 #ifndef __vtkCSVWriter_h
 #define __vtkCSVWriter_h
 
 #include "vtkPVVTKExtensionsDefaultModule.h" //needed for exports
 #include "vtkWriter.h"
 
+class vtkMultiProcessController;
 class vtkStdString;
 class vtkTable;
 
@@ -64,6 +70,15 @@ public:
   vtkGetMacro(UseScientificNotation, bool);
   vtkBooleanMacro(UseScientificNotation, bool);
 
+  // Description:
+  // Get/Set the controller used to write the file collectively. When NULL
+  // (default) or when it has a single process, the local table is written
+  // serially. Otherwise, the header is taken from the first process with
+  // columns and the rows of every process are written in rank order. All
+  // processes are expected to have the same columns.
+  void SetController(vtkMultiProcessController*);
+  vtkGetObjectMacro(Controller, vtkMultiProcessController);
+
 //BTX
   // Description:
   // Internal method: decortes the "string" with the "StringDelimiter" if 
@@ -73,7 +88,10 @@ protected:
   vtkCSVWriter();
   ~vtkCSVWriter();
 
-  bool OpenFile();
+  // Description:
+  // Opens FileName for writing, creating/truncating it when \c truncate is
+  // true or opening the existing file for update otherwise.
+  bool OpenFile(bool truncate=true);
 
   virtual void WriteData();
   virtual void WriteTable(vtkTable* rectilinearGrid);
@@ -88,6 +106,7 @@ protected:
   bool UseStringDelimiter;
   int Precision;
   bool UseScientificNotation;
+  vtkMultiProcessController* Controller;
 
   ofstream* Stream;
 private:
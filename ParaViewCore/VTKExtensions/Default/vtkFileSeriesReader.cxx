@@ -27,11 +27,16 @@
 #include "vtkClientServerInterpreterInitializer.h"
 #include "vtkClientServerInterpreter.h"
 #include "vtkClientServerStream.h"
+#include "vtkConditionVariable.h"
+#include "vtkDoubleArray.h"
 #include "vtkGenericDataObjectReader.h"
 #include "vtkInformation.h"
 #include "vtkInformationIntegerKey.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkMultiProcessController.h"
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
 #include "vtkObjectFactory.h"
 #include "vtkStdString.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
@@ -42,16 +47,513 @@
 #define VTK_CREATE(type, name) \
   vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
 
+#include <vtksys/SystemTools.hxx>
+#include <vtksys/ios/sstream>
+
 #include <algorithm>
+#include <deque>
 #include <map>
 #include <set>
 #include <string>
 #include <vector>
 #include <ctype.h> // for isprint().
+#include <stdio.h>
+
+#if !defined(_WIN32)
+# include <fcntl.h>
+# include <unistd.h>
+#endif
 
 //=============================================================================
 vtkStandardNewMacro(vtkFileSeriesReader);
 
+int vtkFileSeriesReader::NumberOfFilesToPrefetch = 0;
+bool vtkFileSeriesReader::SaveFileSeriesTimeIndex = false;
+bool vtkFileSeriesReader::DistributeFileSeriesTimeQueries = false;
+
+//=============================================================================
+// Internal class that brings files into the operating system's file cache
+// ahead of time on a background thread, so that they are cached when the
+// reader gets to them. The pipeline itself is never touched from the
+// background thread.
+//
+// Where posix_fadvise() is available, the kernel is asked to read the files
+// ahead without copying them, which is cheap enough for every process to do
+// on its own node. Elsewhere files have to be read through a buffer; only
+// one process does that so that a file is not read once per process.
+class vtkFileSeriesReaderPrefetcher
+{
+public:
+  vtkFileSeriesReaderPrefetcher() :
+    Threader(vtkMultiThreader::New()),
+    Mutex(vtkMutexLock::New()),
+    Condition(vtkConditionVariable::New()),
+    ThreadId(-1),
+    Generation(0),
+    Stop(false)
+    {
+    }
+
+  ~vtkFileSeriesReaderPrefetcher()
+    {
+    if (this->ThreadId >= 0)
+      {
+      this->Mutex->Lock();
+      this->Stop = true;
+      this->Queue.clear();
+      this->Generation++;
+      this->Mutex->Unlock();
+      this->Condition->Signal();
+      this->Threader->TerminateThread(this->ThreadId);
+      }
+    this->Condition->Delete();
+    this->Mutex->Delete();
+    this->Threader->Delete();
+    }
+
+  // Description:
+  // Replaces the files waiting to be prefetched. A file being read is
+  // abandoned if it is not part of the new list.
+  void Prefetch(const std::vector<std::string>& files)
+    {
+    this->Mutex->Lock();
+    if (this->ThreadId < 0)
+      {
+      this->ThreadId = this->Threader->SpawnThread(
+        &vtkFileSeriesReaderPrefetcher::ThreadMain, this);
+      }
+    if (std::find(files.begin(), files.end(), this->Current) == files.end())
+      {
+      this->Generation++;
+      }
+    this->Queue.clear();
+    for (size_t cc=0; cc < files.size(); cc++)
+      {
+      if (files[cc] != this->Current &&
+        this->Done.find(files[cc]) == this->Done.end())
+        {
+        this->Queue.push_back(files[cc]);
+        }
+      }
+    // Files no longer ahead of the current one may be evicted from the file
+    // cache by now; forget about them.
+    std::set<std::string> done;
+    for (size_t cc=0; cc < files.size(); cc++)
+      {
+      if (this->Done.find(files[cc]) != this->Done.end())
+        {
+        done.insert(files[cc]);
+        }
+      }
+    this->Done.swap(done);
+    this->Mutex->Unlock();
+    this->Condition->Signal();
+    }
+
+  // Description:
+  // Returns whether this process can prefetch at all: true when the kernel
+  // can be advised, otherwise only for the processes that read files.
+  static bool CanPrefetch(bool readFiles)
+    {
+#if defined(POSIX_FADV_WILLNEED)
+    (void)readFiles;
+    return true;
+#else
+    return readFiles;
+#endif
+    }
+
+private:
+  static VTK_THREAD_RETURN_TYPE ThreadMain(void* arg)
+    {
+    vtkMultiThreader::ThreadInfo* info =
+      static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    static_cast<vtkFileSeriesReaderPrefetcher*>(info->UserData)->Run();
+    return VTK_THREAD_RETURN_VALUE;
+    }
+
+  // Description:
+  // Brings a file into the file cache. Returns true if the whole file was
+  // requested, false if it could not be opened or the request was
+  // cancelled.
+  bool Fetch(const std::string& fname, unsigned long generation,
+    std::vector<char>& buffer)
+    {
+#if defined(POSIX_FADV_WILLNEED)
+    (void)generation;
+    (void)buffer;
+    int fd = open(fname.c_str(), O_RDONLY);
+    if (fd < 0)
+      {
+      return false;
+      }
+    // Only schedules the read, the data is never copied.
+    bool complete = posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED) == 0;
+    close(fd);
+    return complete;
+#else
+    if (buffer.empty())
+      {
+      buffer.resize(1 << 20);
+      }
+    bool complete = false;
+    FILE* file = fopen(fname.c_str(), "rb");
+    if (file)
+      {
+      while (fread(&buffer[0], 1, buffer.size(), file) == buffer.size())
+        {
+        this->Mutex->Lock();
+        bool cancelled = (generation != this->Generation);
+        this->Mutex->Unlock();
+        if (cancelled)
+          {
+          break;
+          }
+        }
+      complete = (feof(file) != 0);
+      fclose(file);
+      }
+    return complete;
+#endif
+    }
+
+  void Run()
+    {
+    std::vector<char> buffer;
+    this->Mutex->Lock();
+    while (!this->Stop)
+      {
+      if (this->Queue.empty())
+        {
+        this->Condition->Wait(this->Mutex);
+        continue;
+        }
+      this->Current = this->Queue.front();
+      this->Queue.pop_front();
+      unsigned long generation = this->Generation;
+      std::string fname = this->Current;
+      this->Mutex->Unlock();
+
+      bool complete = this->Fetch(fname, generation, buffer);
+
+      this->Mutex->Lock();
+      if (complete && generation == this->Generation)
+        {
+        this->Done.insert(fname);
+        }
+      this->Current.clear();
+      }
+    this->Mutex->Unlock();
+    }
+
+  vtkMultiThreader* Threader;
+  vtkMutexLock* Mutex;
+  vtkConditionVariable* Condition;
+  int ThreadId;
+
+  // Protected by Mutex.
+  std::deque<std::string> Queue;
+  std::set<std::string> Done;
+  std::string Current;
+  unsigned long Generation;
+  bool Stop;
+};
+
+//=============================================================================
+// Internal class for the time information reported for a single file.
+class vtkFileSeriesReaderTimeRecord
+{
+public:
+  vtkFileSeriesReaderTimeRecord() : HasRange(false)
+    {
+    this->Range[0] = this->Range[1] = 0.0;
+    }
+
+  void CopyFrom(vtkInformation* info)
+    {
+    this->Steps.clear();
+    if (info->Has(vtkStreamingDemandDrivenPipeline::TIME_STEPS()))
+      {
+      double* steps = info->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+      int numSteps =
+        info->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+      this->Steps.assign(steps, steps + numSteps);
+      }
+    this->HasRange =
+      (info->Has(vtkStreamingDemandDrivenPipeline::TIME_RANGE()) != 0);
+    if (this->HasRange)
+      {
+      double* range = info->Get(vtkStreamingDemandDrivenPipeline::TIME_RANGE());
+      this->Range[0] = range[0];
+      this->Range[1] = range[1];
+      }
+    }
+
+  void CopyTo(vtkInformation* info) const
+    {
+    info->Remove(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+    info->Remove(vtkStreamingDemandDrivenPipeline::TIME_RANGE());
+    if (!this->Steps.empty())
+      {
+      info->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(),
+        &this->Steps[0], static_cast<int>(this->Steps.size()));
+      }
+    if (this->HasRange)
+      {
+      info->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(),
+        this->Range, 2);
+      }
+    }
+
+  std::vector<double> Steps;
+  bool HasRange;
+  double Range[2];
+};
+
+typedef std::map<int, vtkFileSeriesReaderTimeRecord>
+  vtkFileSeriesReaderTimeRecords;
+
+//=============================================================================
+// Internal class with the helpers to exchange time records between processes
+// and to save them in the index file of a series.
+class vtkFileSeriesReaderTimeIndex
+{
+public:
+  // Description:
+  // Appends the records to buffer as
+  // (index, has range, range[2], number of steps, steps...) tuples.
+  static void Pack(const vtkFileSeriesReaderTimeRecords& records,
+    vtkDoubleArray* buffer)
+    {
+    vtkFileSeriesReaderTimeRecords::const_iterator iter;
+    for (iter = records.begin(); iter != records.end(); ++iter)
+      {
+      const vtkFileSeriesReaderTimeRecord& record = iter->second;
+      buffer->InsertNextValue(iter->first);
+      buffer->InsertNextValue(record.HasRange? 1 : 0);
+      buffer->InsertNextValue(record.Range[0]);
+      buffer->InsertNextValue(record.Range[1]);
+      buffer->InsertNextValue(static_cast<double>(record.Steps.size()));
+      for (size_t cc=0; cc < record.Steps.size(); cc++)
+        {
+        buffer->InsertNextValue(record.Steps[cc]);
+        }
+      }
+    }
+
+  // Description:
+  // Adds the records packed in buffer, records already present are kept.
+  static void Unpack(vtkDoubleArray* buffer,
+    vtkFileSeriesReaderTimeRecords& records)
+    {
+    vtkIdType size = buffer->GetNumberOfTuples();
+    vtkIdType pos = 0;
+    while (pos + 5 <= size)
+      {
+      int index = static_cast<int>(buffer->GetValue(pos));
+      vtkFileSeriesReaderTimeRecord record;
+      record.HasRange = (buffer->GetValue(pos + 1) != 0.0);
+      record.Range[0] = buffer->GetValue(pos + 2);
+      record.Range[1] = buffer->GetValue(pos + 3);
+      vtkIdType numSteps = static_cast<vtkIdType>(buffer->GetValue(pos + 4));
+      pos += 5;
+      if (numSteps < 0 || pos + numSteps > size)
+        {
+        break;
+        }
+      for (vtkIdType cc=0; cc < numSteps; cc++)
+        {
+        record.Steps.push_back(buffer->GetValue(pos + cc));
+        }
+      pos += numSteps;
+      records.insert(vtkFileSeriesReaderTimeRecords::value_type(index, record));
+      }
+    }
+
+  // Description:
+  // Adds the records of the files whose size and modification time match
+  // the ones saved in the index. Records already present are kept. Returns
+  // false if the index cannot be read, or was written for another reader or
+  // for different time values of the first file, given by \c key.
+  static bool Read(const std::string& indexName, const char* readerName,
+    const vtkFileSeriesReaderTimeRecord& key,
+    const std::vector<std::string>& files,
+    vtkFileSeriesReaderTimeRecords& records)
+    {
+    ifstream index(indexName.c_str());
+    if (!index)
+      {
+      return false;
+      }
+    std::string line;
+    if (!std::getline(index, line) ||
+      line != vtkFileSeriesReaderTimeIndex::Header())
+      {
+      return false;
+      }
+    if (!std::getline(index, line) ||
+      line != std::string("reader ") + readerName)
+      {
+      return false;
+      }
+    if (!std::getline(index, line) ||
+      line != vtkFileSeriesReaderTimeIndex::GetKey(key))
+      {
+      return false;
+      }
+
+    // file name -> (stamp, record)
+    typedef std::map<std::string,
+      std::pair<std::string, vtkFileSeriesReaderTimeRecord> > EntriesType;
+    EntriesType entries;
+    while (index)
+      {
+      std::string stamp;
+      vtkFileSeriesReaderTimeRecord record;
+      size_t numSteps = 0;
+      int hasRange = 0;
+      if (!(index >> stamp >> hasRange >> record.Range[0] >> record.Range[1]
+          >> numSteps))
+        {
+        break;
+        }
+      record.HasRange = (hasRange != 0);
+      record.Steps.resize(numSteps);
+      for (size_t cc=0; cc < numSteps; cc++)
+        {
+        index >> record.Steps[cc];
+        }
+      // the file name is the rest of the line, after a single space.
+      std::string fname;
+      if (!index || index.get() != ' ' || !std::getline(index, fname))
+        {
+        break;
+        }
+      entries[fname] = std::make_pair(stamp, record);
+      }
+
+    for (size_t cc=0; cc < files.size(); cc++)
+      {
+      EntriesType::iterator iter = entries.find(files[cc]);
+      if (iter != entries.end() &&
+        iter->second.first == vtkFileSeriesReaderTimeIndex::GetStamp(files[cc]))
+        {
+        records.insert(vtkFileSeriesReaderTimeRecords::value_type(
+            static_cast<int>(cc), iter->second.second));
+        }
+      }
+    return true;
+    }
+
+  // Description:
+  // Saves the records along with the size and modification time of the
+  // files. Returns false if the index cannot be written. The index is written
+  // to a temporary file first, then renamed, so that processes reading the
+  // index meanwhile either see the old or the new one.
+  static bool Write(const std::string& indexName, const char* readerName,
+    const vtkFileSeriesReaderTimeRecord& key,
+    const std::vector<std::string>& files,
+    const vtkFileSeriesReaderTimeRecords& records)
+    {
+    vtksys_ios::ostringstream tmpName;
+    tmpName << indexName << "." << static_cast<unsigned long>(
+      vtksys::SystemTools::GetTime() * 1.0e6) << ".tmp";
+    std::string tmpIndexName = tmpName.str();
+    bool success = vtkFileSeriesReaderTimeIndex::WriteRecords(
+      tmpIndexName, readerName, key, files, records);
+#ifdef _WIN32
+    // rename() does not replace existing files on Windows.
+    if (success)
+      {
+      remove(indexName.c_str());
+      }
+#endif
+    if (!success || rename(tmpIndexName.c_str(), indexName.c_str()) != 0)
+      {
+      remove(tmpIndexName.c_str());
+      return false;
+      }
+    return true;
+    }
+
+private:
+  static const char* Header()
+    {
+    return "# ParaView file series time index 2";
+    }
+
+  // Description:
+  // Returns the line identifying the time values of the first file.
+  static std::string GetKey(const vtkFileSeriesReaderTimeRecord& key)
+    {
+    vtksys_ios::ostringstream line;
+    line.precision(17);
+    line << "first " << (key.HasRange? 1 : 0) << " " << key.Range[0] << " "
+         << key.Range[1] << " " << key.Steps.size();
+    for (size_t cc=0; cc < key.Steps.size(); cc++)
+      {
+      line << " " << key.Steps[cc];
+      }
+    return line.str();
+    }
+
+  static bool WriteRecords(const std::string& indexName,
+    const char* readerName, const vtkFileSeriesReaderTimeRecord& key,
+    const std::vector<std::string>& files,
+    const vtkFileSeriesReaderTimeRecords& records)
+    {
+    ofstream index(indexName.c_str());
+    if (!index)
+      {
+      return false;
+      }
+    index.precision(17);
+    index << vtkFileSeriesReaderTimeIndex::Header() << "\n"
+          << "reader " << readerName << "\n"
+          << vtkFileSeriesReaderTimeIndex::GetKey(key) << "\n";
+    vtkFileSeriesReaderTimeRecords::const_iterator iter;
+    for (iter = records.begin(); iter != records.end(); ++iter)
+      {
+      if (iter->first < 0 || iter->first >= static_cast<int>(files.size()))
+        {
+        continue;
+        }
+      const std::string& fname = files[iter->first];
+      std::string stamp = vtkFileSeriesReaderTimeIndex::GetStamp(fname);
+      if (stamp.empty())
+        {
+        continue;
+        }
+      const vtkFileSeriesReaderTimeRecord& record = iter->second;
+      index << stamp << " " << (record.HasRange? 1 : 0) << " "
+            << record.Range[0] << " " << record.Range[1] << " "
+            << record.Steps.size();
+      for (size_t cc=0; cc < record.Steps.size(); cc++)
+        {
+        index << " " << record.Steps[cc];
+        }
+      index << " " << fname << "\n";
+      }
+    index.close();
+    return !index.fail();
+    }
+
+  // Description:
+  // Returns "size:mtime" for the file, or an empty string if the file does
+  // not exist.
+  static std::string GetStamp(const std::string& fname)
+    {
+    long mtime = vtksys::SystemTools::ModifiedTime(fname.c_str());
+    if (mtime == 0)
+      {
+      return std::string();
+      }
+    vtksys_ios::ostringstream stamp;
+    stamp << vtksys::SystemTools::FileLength(fname.c_str()) << ":" << mtime;
+    return stamp.str();
+    }
+};
+
 //=============================================================================
 // Internal class for holding time ranges.
 class vtkFileSeriesReaderTimeRanges
@@ -373,6 +875,7 @@ struct vtkFileSeriesReaderInternals
   std::vector<std::string> FileNames;
   bool FileNameIsSet;
   vtkFileSeriesReaderTimeRanges *TimeRanges;
+  vtkFileSeriesReaderPrefetcher *Prefetcher;
 };
 
 //=============================================================================
@@ -384,6 +887,7 @@ vtkFileSeriesReader::vtkFileSeriesReader()
   this->Internal = new vtkFileSeriesReaderInternals;
   this->Internal->FileNameIsSet = false;
   this->Internal->TimeRanges = new vtkFileSeriesReaderTimeRanges;
+  this->Internal->Prefetcher = NULL;
 
   this->UseMetaFile = 0;
 
@@ -393,6 +897,7 @@ vtkFileSeriesReader::vtkFileSeriesReader()
 //-----------------------------------------------------------------------------
 vtkFileSeriesReader::~vtkFileSeriesReader()
 {
+  delete this->Internal->Prefetcher;
   delete this->Internal->TimeRanges;
   delete this->Internal;
 }
@@ -588,12 +1093,8 @@ int vtkFileSeriesReader::RequestInformation(
     // Record the reported file time info.
     this->Internal->TimeRanges->AddTimeRange(0, outInfo);
 
-    // Query all the other files for time info.
-    for (int i = 1; i < numFiles; i++)
-      {
-      this->RequestInformationForInput(i, request, outputVector);
-      this->Internal->TimeRanges->AddTimeRange(i, outInfo);
-      }
+    // Get the time info for all the other files.
+    this->RequestTimeInformation(request, outputVector);
     }
 
   // Now that we have collected all of the time information, set the aggregate
@@ -602,6 +1103,117 @@ int vtkFileSeriesReader::RequestInformation(
   return 1;
 }
 
+//-----------------------------------------------------------------------------
+void vtkFileSeriesReader::RequestTimeInformation(
+                                             vtkInformation *request,
+                                             vtkInformationVector *outputVector)
+{
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+  const std::vector<std::string>& files = this->Internal->FileNames;
+  int numFiles = static_cast<int>(files.size());
+  if (numFiles < 2)
+    {
+    return;
+    }
+
+  vtkMultiProcessController* controller =
+    vtkMultiProcessController::GetGlobalController();
+  int numProcs = controller? controller->GetNumberOfProcesses() : 1;
+  int myId = controller? controller->GetLocalProcessId() : 0;
+  bool distribute =
+    vtkFileSeriesReader::DistributeFileSeriesTimeQueries && (numProcs > 1);
+  const char* readerName = this->Reader->GetClassName();
+
+  // The first file has just been queried.
+  vtkFileSeriesReaderTimeRecords records;
+  records[0].CopyFrom(outInfo);
+
+  std::string indexName;
+  if (vtkFileSeriesReader::SaveFileSeriesTimeIndex)
+    {
+    indexName = (this->UseMetaFile && this->_MetaFileName)?
+      this->_MetaFileName : files[0];
+    indexName += ".timeindex";
+    if (!distribute || myId == 0)
+      {
+      vtkFileSeriesReaderTimeIndex::Read(
+        indexName, readerName, records[0], files, records);
+      }
+    if (distribute)
+      {
+      // All processes must agree on the files left to query.
+      VTK_CREATE(vtkDoubleArray, buffer);
+      if (myId == 0)
+        {
+        vtkFileSeriesReaderTimeIndex::Pack(records, buffer);
+        }
+      controller->Broadcast(buffer, 0);
+      vtkFileSeriesReaderTimeIndex::Unpack(buffer, records);
+      }
+    }
+
+  std::vector<int> missing;
+  for (int i = 1; i < numFiles; i++)
+    {
+    if (records.find(i) == records.end())
+      {
+      missing.push_back(i);
+      }
+    }
+
+  // Query the files that are not in the index, each process querying a
+  // contiguous part of them when distributing.
+  int numMissing = static_cast<int>(missing.size());
+  int begin = 0;
+  int end = numMissing;
+  if (distribute)
+    {
+    begin = static_cast<int>(
+      static_cast<vtkTypeInt64>(numMissing) * myId / numProcs);
+    end = static_cast<int>(
+      static_cast<vtkTypeInt64>(numMissing) * (myId + 1) / numProcs);
+    }
+  vtkFileSeriesReaderTimeRecords queried;
+  for (int cc = begin; cc < end; cc++)
+    {
+    this->RequestInformationForInput(missing[cc], request, outputVector);
+    queried[missing[cc]].CopyFrom(outInfo);
+    }
+  if (distribute)
+    {
+    VTK_CREATE(vtkDoubleArray, sendBuffer);
+    VTK_CREATE(vtkDoubleArray, recvBuffer);
+    vtkFileSeriesReaderTimeIndex::Pack(queried, sendBuffer);
+    controller->AllGatherV(sendBuffer, recvBuffer);
+    vtkFileSeriesReaderTimeIndex::Unpack(recvBuffer, queried);
+    }
+  records.insert(queried.begin(), queried.end());
+
+  if (vtkFileSeriesReader::SaveFileSeriesTimeIndex && numMissing > 0 && myId == 0)
+    {
+    if (!vtkFileSeriesReaderTimeIndex::Write(
+        indexName, readerName, records[0], files, records))
+      {
+      vtkDebugMacro("Could not write time index " << indexName);
+      }
+    }
+
+  // Add the time ranges in order, as if every file had been queried.
+  VTK_CREATE(vtkInformation, timeInfo);
+  for (int i = 1; i < numFiles; i++)
+    {
+    records[i].CopyTo(timeInfo);
+    this->Internal->TimeRanges->AddTimeRange(i, timeInfo);
+    }
+
+  // Querying every file in order left the output information of the last
+  // one, keep it that way.
+  if (this->_FileIndex != numFiles - 1)
+    {
+    this->RequestInformationForInput(numFiles - 1, request, outputVector);
+    }
+}
+
 //----------------------------------------------------------------------------
 int vtkFileSeriesReader::RequestUpdateExtent(
                                  vtkInformation* vtkNotUsed(request),
@@ -664,9 +1276,77 @@ int vtkFileSeriesReader::RequestData(vtkInformation *request,
     this->Internal->TimeRanges->GetAggregateTimeInfo(outInfo);
     }
 
+  this->PrefetchFiles(this->_FileIndex + 1);
   return retVal;
 }
 
+//-----------------------------------------------------------------------------
+void vtkFileSeriesReader::PrefetchFiles(int index)
+{
+  int count = vtkFileSeriesReader::NumberOfFilesToPrefetch;
+  int numFiles = static_cast<int>(this->GetNumberOfFileNames());
+  if (count <= 0 || index < 0 || numFiles < 2)
+    {
+    return;
+    }
+
+  // Without kernel read ahead, only the first process reads files.
+  vtkMultiProcessController* controller =
+    vtkMultiProcessController::GetGlobalController();
+  bool readFiles = !controller || controller->GetLocalProcessId() == 0;
+  if (!vtkFileSeriesReaderPrefetcher::CanPrefetch(readFiles))
+    {
+    return;
+    }
+
+  std::vector<std::string> files;
+  for (int cc=index; cc < numFiles && cc < index + count; cc++)
+    {
+    files.push_back(this->Internal->FileNames[cc]);
+    }
+  if (!this->Internal->Prefetcher)
+    {
+    this->Internal->Prefetcher = new vtkFileSeriesReaderPrefetcher();
+    }
+  this->Internal->Prefetcher->Prefetch(files);
+}
+
+//-----------------------------------------------------------------------------
+void vtkFileSeriesReader::SetNumberOfFilesToPrefetch(int count)
+{
+  vtkFileSeriesReader::NumberOfFilesToPrefetch = count > 0? count : 0;
+}
+
+//-----------------------------------------------------------------------------
+int vtkFileSeriesReader::GetNumberOfFilesToPrefetch()
+{
+  return vtkFileSeriesReader::NumberOfFilesToPrefetch;
+}
+
+//-----------------------------------------------------------------------------
+void vtkFileSeriesReader::SetSaveFileSeriesTimeIndex(bool use)
+{
+  vtkFileSeriesReader::SaveFileSeriesTimeIndex = use;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkFileSeriesReader::GetSaveFileSeriesTimeIndex()
+{
+  return vtkFileSeriesReader::SaveFileSeriesTimeIndex;
+}
+
+//-----------------------------------------------------------------------------
+void vtkFileSeriesReader::SetDistributeFileSeriesTimeQueries(bool distribute)
+{
+  vtkFileSeriesReader::DistributeFileSeriesTimeQueries = distribute;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkFileSeriesReader::GetDistributeFileSeriesTimeQueries()
+{
+  return vtkFileSeriesReader::DistributeFileSeriesTimeQueries;
+}
+
 //-----------------------------------------------------------------------------
 int vtkFileSeriesReader::RequestInformationForInput(
                                              int index,
@@ -803,6 +1483,12 @@ void vtkFileSeriesReader::PrintSelf(ostream& os, vtkIndent indent)
      << (this->_MetaFileName?this->_MetaFileName:"(none)") << endl;
   os << indent << "UseMetaFile: " << this->UseMetaFile << endl;
   os << indent << "IgnoreReaderTime: " << this->IgnoreReaderTime << endl;
+  os << indent << "NumberOfFilesToPrefetch: "
+     << vtkFileSeriesReader::NumberOfFilesToPrefetch << endl;
+  os << indent << "SaveFileSeriesTimeIndex: "
+     << vtkFileSeriesReader::SaveFileSeriesTimeIndex << endl;
+  os << indent << "DistributeFileSeriesTimeQueries: "
+     << vtkFileSeriesReader::DistributeFileSeriesTimeQueries << endl;
 }
 
 //-----------------------------------------------------------------------------
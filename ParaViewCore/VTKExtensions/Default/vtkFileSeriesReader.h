@@ -43,6 +43,20 @@
 // method is useful when the actual reader points to a set of files itself.  The
 // UseMetaFile toggles between these two methods of specifying files.
 //
+// When NumberOfFilesToPrefetch is set, after each time step is read the files
+// of the following time steps are brought into the operating system's file
+// cache by a background thread, so that they are cached when requested, for
+// instance by the next frame of an animation. Where posix_fadvise() is
+// available the kernel reads the files ahead on every process; elsewhere
+// only process 0 reads them.
+//
+// To report time, every file of the series has to be queried. Two global
+// settings reduce that cost for long series. With SaveFileSeriesTimeIndex,
+// the time values are saved to an index file next to the series and only the
+// files whose size or modification time changed are queried when the series
+// is opened again. With DistributeFileSeriesTimeQueries, the files are split
+// among the processes of the global controller.
+//
 
 #ifndef __vtkFileSeriesReader_h
 #define __vtkFileSeriesReader_h
@@ -108,6 +122,35 @@ public:
   vtkSetMacro(IgnoreReaderTime, int);
   vtkBooleanMacro(IgnoreReaderTime, int);
 
+  // Description:
+  // Get/Set the number of files following the one just read that are read
+  // ahead in the background. This is a global setting shared by all
+  // instances. 0 (default) disables prefetching.
+  static void SetNumberOfFilesToPrefetch(int count);
+  static int GetNumberOfFilesToPrefetch();
+
+  // Description:
+  // Get/Set whether the time values of the files are saved to an index file,
+  // named after the meta file, or the first file, with a ".timeindex"
+  // extension. Entries are reused as long as the reader class, file size and
+  // modification time match. The time values of the first file, which is
+  // always queried, are saved too: when they differ, e.g. because a reader
+  // setting that affects time changed, the whole index is ignored. The index
+  // is written by process 0 only, to a temporary file that then replaces the
+  // index, and failing to write it is not an error. This is a global setting
+  // shared by all instances. Off by default.
+  static void SetSaveFileSeriesTimeIndex(bool use);
+  static bool GetSaveFileSeriesTimeIndex();
+
+  // Description:
+  // Get/Set whether the files are queried for time values by all processes
+  // of the global controller, each querying a part of the series. This
+  // requires that RequestInformation is executed on all processes together,
+  // and that the reader does not communicate in RequestInformation. This is
+  // a global setting shared by all instances. Off by default.
+  static void SetDistributeFileSeriesTimeQueries(bool distribute);
+  static bool GetDistributeFileSeriesTimeQueries();
+
 protected:
   vtkFileSeriesReader();
   ~vtkFileSeriesReader();
@@ -139,6 +182,14 @@ protected:
                                      vtkInformation *request = NULL,
                                      vtkInformationVector *outputVector = NULL);
 
+  // Description:
+  // Adds the time information of all files but the first one to the time
+  // ranges, reusing the index file and distributing the queries as
+  // configured. Called by RequestInformation() when the reader provides
+  // time.
+  virtual void RequestTimeInformation(vtkInformation *request,
+                                      vtkInformationVector *outputVector);
+
   // Description:
   // Reads a metadata file and returns a list of filenames (in filesToRead).  If
   // the file could not be read correctly, 0 is returned.
@@ -165,6 +216,15 @@ protected:
   int IgnoreReaderTime;
 
   int ChooseInput(vtkInformation*);
+
+  // Description:
+  // Schedules the background read of the NumberOfFilesToPrefetch files
+  // starting at \c index.
+  void PrefetchFiles(int index);
+
+  static int NumberOfFilesToPrefetch;
+  static bool SaveFileSeriesTimeIndex;
+  static bool DistributeFileSeriesTimeQueries;
 private:
   vtkFileSeriesReader(const vtkFileSeriesReader&); // Not implemented.
   void operator=(const vtkFileSeriesReader&); // Not implemented.
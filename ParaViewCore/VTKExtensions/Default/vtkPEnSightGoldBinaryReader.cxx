@@ -16,18 +16,232 @@
 
 #include <sys/stat.h>
 #include <ctype.h>
+#include <string.h>
 #include <string>
 
+#if defined(_WIN32)
+# include "vtkWindows.h"
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <unistd.h>
+#endif
+
 vtkStandardNewMacro(vtkPEnSightGoldBinaryReader);
 
 // This is half the precision of an int.
 #define MAXIMUM_PART_ID 65536
 
+bool vtkPEnSightGoldBinaryReader::UseMemoryMapping = false;
+
+//----------------------------------------------------------------------------
+// Read-only mapping of a whole file, exposed as a stream buffer so that the
+// reader can keep using seekg/tellg/read on IFile. Seeking only moves the
+// read pointer and reads are plain copies out of the mapping.
+class vtkPEnSightGoldBinaryReaderMappedBuffer : public std::streambuf
+{
+public:
+  vtkPEnSightGoldBinaryReaderMappedBuffer() : Data(0), Size(0)
+#if defined(_WIN32)
+    , File(INVALID_HANDLE_VALUE), Mapping(0)
+#endif
+    {
+    }
+  ~vtkPEnSightGoldBinaryReaderMappedBuffer()
+    {
+    this->Close();
+    }
+
+  // Returns false if the file cannot be mapped, in which case it has to be
+  // read through an ifstream.
+  bool Open(const char* filename)
+    {
+    this->Close();
+#if defined(_WIN32)
+    this->File = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    LARGE_INTEGER size;
+    if (this->File == INVALID_HANDLE_VALUE ||
+        !GetFileSizeEx(this->File, &size) || size.QuadPart <= 0 ||
+        static_cast<unsigned long long>(size.QuadPart) >
+        static_cast<unsigned long long>(static_cast<size_t>(-1)))
+      {
+      this->Close();
+      return false;
+      }
+    this->Mapping = CreateFileMappingA(this->File, NULL, PAGE_READONLY,
+                                       0, 0, NULL);
+    void* data = this->Mapping ?
+      MapViewOfFile(this->Mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (!data)
+      {
+      this->Close();
+      return false;
+      }
+    this->Data = static_cast<char*>(data);
+    this->Size = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+      {
+      return false;
+      }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0 ||
+        static_cast<unsigned long long>(info.st_size) >
+        static_cast<unsigned long long>(static_cast<size_t>(-1)))
+      {
+      close(fd);
+      return false;
+      }
+    void* data = mmap(0, static_cast<size_t>(info.st_size), PROT_READ,
+                      MAP_PRIVATE, fd, 0);
+    // The mapping stays valid once the descriptor is closed.
+    close(fd);
+    if (data == MAP_FAILED)
+      {
+      return false;
+      }
+# if defined(MADV_RANDOM)
+    // Parts and time steps that are not wanted are skipped, so reading ahead
+    // of every fault would pull them in too. Ranges that are actually read
+    // are requested with WillNeed() instead.
+    madvise(data, static_cast<size_t>(info.st_size), MADV_RANDOM);
+# endif
+    this->Data = static_cast<char*>(data);
+    this->Size = static_cast<size_t>(info.st_size);
+#endif
+    this->setg(this->Data, this->Data, this->Data + this->Size);
+    return true;
+    }
+
+  void Close()
+    {
+#if defined(_WIN32)
+    if (this->Data)
+      {
+      UnmapViewOfFile(this->Data);
+      }
+    if (this->Mapping)
+      {
+      CloseHandle(this->Mapping);
+      this->Mapping = 0;
+      }
+    if (this->File != INVALID_HANDLE_VALUE)
+      {
+      CloseHandle(this->File);
+      this->File = INVALID_HANDLE_VALUE;
+      }
+#else
+    if (this->Data)
+      {
+      munmap(this->Data, this->Size);
+      }
+#endif
+    this->Data = 0;
+    this->Size = 0;
+    this->setg(0, 0, 0);
+    }
+
+  // Returns a pointer to \c length bytes at \c offset, or NULL if they are
+  // not all in the file. Does not move the read pointer.
+  const char* GetData(size_t offset, size_t length) const
+    {
+    if (offset > this->Size || this->Size - offset < length)
+      {
+      return NULL;
+      }
+    return this->Data + offset;
+    }
+
+  // Asks the system to read the pages holding \c length bytes at \c data
+  // before they are used. Only done for ranges of at least
+  // WillNeedThreshold bytes, smaller reads are left to page faults.
+  void WillNeed(const char* data, size_t length) const
+    {
+#if !defined(_WIN32) && defined(MADV_WILLNEED)
+    if (!this->Data || length < WillNeedThreshold)
+      {
+      return;
+      }
+    static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    // madvise() needs a page aligned address, the mapping itself is one.
+    size_t begin = static_cast<size_t>(data - this->Data);
+    size_t start = begin - begin % pageSize;
+    madvise(this->Data + start, begin + length - start, MADV_WILLNEED);
+#else
+    (void)data;
+    (void)length;
+#endif
+    }
+
+  enum { WillNeedThreshold = 65536 };
+
+protected:
+  virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                           std::ios_base::openmode)
+    {
+    off_type base = 0;
+    if (dir == std::ios_base::cur)
+      {
+      base = static_cast<off_type>(this->gptr() - this->eback());
+      }
+    else if (dir == std::ios_base::end)
+      {
+      base = static_cast<off_type>(this->Size);
+      }
+    return this->seekpos(pos_type(base + off), std::ios_base::in);
+    }
+
+  virtual pos_type seekpos(pos_type pos, std::ios_base::openmode)
+    {
+    off_type off = static_cast<off_type>(pos);
+    if (!this->Data || off < 0 || off > static_cast<off_type>(this->Size))
+      {
+      return pos_type(off_type(-1));
+      }
+    this->setg(this->Data, this->Data + off, this->Data + this->Size);
+    return pos;
+    }
+
+  virtual std::streamsize xsgetn(char* s, std::streamsize n)
+    {
+    std::streamsize avail =
+      static_cast<std::streamsize>(this->egptr() - this->gptr());
+    if (n > avail)
+      {
+      n = avail;
+      }
+    if (n > 0)
+      {
+      this->WillNeed(this->gptr(), static_cast<size_t>(n));
+      memcpy(s, this->gptr(), static_cast<size_t>(n));
+      // gbump() takes an int, which large arrays may overflow.
+      this->setg(this->eback(), this->gptr() + n, this->egptr());
+      }
+    return n;
+    }
+
+private:
+  vtkPEnSightGoldBinaryReaderMappedBuffer(
+    const vtkPEnSightGoldBinaryReaderMappedBuffer&); // Not implemented
+  void operator=(
+    const vtkPEnSightGoldBinaryReaderMappedBuffer&); // Not implemented
+
+  char* Data;
+  size_t Size;
+#if defined(_WIN32)
+  HANDLE File;
+  HANDLE Mapping;
+#endif
+};
+
 
 //----------------------------------------------------------------------------
 vtkPEnSightGoldBinaryReader::vtkPEnSightGoldBinaryReader()
 {
   this->IFile = NULL;
+  this->MappedBuffer = NULL;
   this->FileSize = 0;
   this->Fortran = 0;
   this->NodeIdsListed = 0;
@@ -47,12 +261,7 @@ vtkPEnSightGoldBinaryReader::vtkPEnSightGoldBinaryReader()
 //----------------------------------------------------------------------------
 vtkPEnSightGoldBinaryReader::~vtkPEnSightGoldBinaryReader()
 {
-  if (this->IFile)
-    {
-    this->IFile->close();
-    delete this->IFile;
-    this->IFile = NULL;
-    }
+  this->CloseFile();
   delete [] this->FloatBuffer[2];
   delete [] this->FloatBuffer[1];
   delete [] this->FloatBuffer[0];
@@ -69,12 +278,7 @@ int vtkPEnSightGoldBinaryReader::OpenFile(const char* filename)
     }
 
   // Close file from any previous image
-  if (this->IFile)
-    {
-    this->IFile->close();
-    delete this->IFile;
-    this->IFile = NULL;
-    }
+  this->CloseFile();
 
   // Open the new file
   vtkDebugMacro(<< "Opening file " << filename);
@@ -84,11 +288,29 @@ int vtkPEnSightGoldBinaryReader::OpenFile(const char* filename)
     // Find out how big the file is.
     this->FileSize = (long)(fs.st_size);
 
+    if (vtkPEnSightGoldBinaryReader::UseMemoryMapping)
+      {
+      this->MappedBuffer = new vtkPEnSightGoldBinaryReaderMappedBuffer;
+      if (this->MappedBuffer->Open(filename))
+        {
+        this->IFile = new istream(this->MappedBuffer);
+        }
+      else
+        {
+        vtkDebugMacro(<< "Could not map " << filename
+                      << ", reading it through a stream.");
+        delete this->MappedBuffer;
+        this->MappedBuffer = NULL;
+        }
+      }
+    if (!this->IFile)
+      {
 #ifdef _WIN32
-    this->IFile = new ifstream(filename, ios::in | ios::binary);
+      this->IFile = new ifstream(filename, ios::in | ios::binary);
 #else
-    this->IFile = new ifstream(filename, ios::in);
+      this->IFile = new ifstream(filename, ios::in);
 #endif
+      }
     }
   else
     {
@@ -167,6 +389,16 @@ int vtkPEnSightGoldBinaryReader::OpenFile(const char* filename)
   return 1;
 }
 
+//----------------------------------------------------------------------------
+void vtkPEnSightGoldBinaryReader::CloseFile()
+{
+  // Deleting an ifstream closes it. The stream must go before its mapping.
+  delete this->IFile;
+  this->IFile = NULL;
+  delete this->MappedBuffer;
+  this->MappedBuffer = NULL;
+}
+
 
 //----------------------------------------------------------------------------
 int vtkPEnSightGoldBinaryReader::InitializeFile(const char* fileName)
@@ -401,9 +633,7 @@ int vtkPEnSightGoldBinaryReader::ReadGeometryFile(const char* fileName, int time
         free(name);
         if (this->IFile)
           {
-          this->IFile->close();
-          delete this->IFile;
-          this->IFile = NULL;
+          this->CloseFile();
           }
         return 0;
         }
@@ -413,9 +643,7 @@ int vtkPEnSightGoldBinaryReader::ReadGeometryFile(const char* fileName, int time
 
   if (this->IFile)
     {
-    this->IFile->close();
-    delete this->IFile;
-    this->IFile = NULL;
+    this->CloseFile();
     }
   if (lineRead < 0)
     {
@@ -548,9 +776,7 @@ int vtkPEnSightGoldBinaryReader::SkipTimeStep()
     {
     if (this->IFile)
       {
-      this->IFile->close();
-      delete this->IFile;
-      this->IFile = NULL;
+      this->CloseFile();
       }
     return 0;
     }
@@ -1321,9 +1547,7 @@ int vtkPEnSightGoldBinaryReader::ReadMeasuredGeometryFile(const char* fileName,
 
   if (this->IFile)
     {
-    this->IFile->close();
-    delete this->IFile;
-    this->IFile = NULL;
+    this->CloseFile();
     }
   return 1;
 }
@@ -1464,10 +1688,7 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerNode(
       // For complex scalars, there is a file for the real part and another
       // file for the imaginary part, but we are storing them as a 2-component
       // array.
-      for (i = 0; i < numPts; i++)
-        {
-        this->InsertVariableComponent(scalars,i,component, &(scalarsRead[i]),partId,0,SCALAR_PER_NODE);
-        }
+      this->InsertVariableComponents(scalars, numPts, component, 1, scalarsRead, partId, 0, SCALAR_PER_NODE);
       scalars->SetName(description);
       output->GetPointData()->AddArray(scalars);
       if (!output->GetPointData()->GetScalars())
@@ -1479,9 +1700,7 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerNode(
       }
     if (this->IFile)
       {
-      this->IFile->close();
-      delete this->IFile;
-      this->IFile = NULL;
+      this->CloseFile();
       }
     return 1;
     }
@@ -1513,11 +1732,7 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerNode(
 
       scalarsRead = new float[numPts];
       this->ReadFloatArray(scalarsRead, numPts);
-
-      for (i = 0; i < numPts; i++)
-        {
-        this->InsertVariableComponent(scalars, i, component,&(scalarsRead[i]), realId, 0, SCALAR_PER_NODE);
-        }
+      this->InsertVariableComponents(scalars, numPts, component, 1, scalarsRead, realId, 0, SCALAR_PER_NODE);
       if (component == 0)
         {
         scalars->SetName(description);
@@ -1546,9 +1761,7 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerNode(
 
   if (this->IFile)
     {
-    this->IFile->close();
-    delete this->IFile;
-    this->IFile = NULL;
+    this->CloseFile();
     }
   return 1;
 }
@@ -1561,8 +1774,6 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerNode(
   char line[80];
   int partId, realId, numPts, i, lineRead;
   vtkFloatArray *vectors;
-  float tuple[3];
-  float *comp1, *comp2, *comp3;
   float *vectorsRead;
   vtkDataSet *output;
 
@@ -1705,9 +1916,7 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerNode(
       }
     if (this->IFile)
       {
-      this->IFile->close();
-      delete this->IFile;
-      this->IFile = NULL;
+      this->CloseFile();
       }
     return 1;
     }
@@ -1726,19 +1935,13 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerNode(
       this->ReadLine(line); // "coordinates" or "block"
       vectors->SetNumberOfComponents(3);
       vectors->SetNumberOfTuples(this->GetPointIds(realId)->GetLocalNumberOfIds());
-      comp1 = new float[numPts];
-      comp2 = new float[numPts];
-      comp3 = new float[numPts];
-      this->ReadFloatArray(comp1, numPts);
-      this->ReadFloatArray(comp2, numPts);
-      this->ReadFloatArray(comp3, numPts);
-      for (i = 0; i < numPts; i++)
+      // One plane per component, each a record of its own.
+      vectorsRead = new float[3 * numPts];
+      for (i = 0; i < 3; i++)
         {
-        tuple[0] = comp1[i];
-        tuple[1] = comp2[i];
-        tuple[2] = comp3[i];
-        this->InsertVariableComponent(vectors, i, -1, tuple, realId, 0, VECTOR_PER_NODE);
+        this->ReadFloatArray(vectorsRead + i * numPts, numPts);
         }
+      this->InsertVariableComponents(vectors, numPts, 0, 3, vectorsRead, realId, 0, VECTOR_PER_NODE);
       vectors->SetName(description);
       output->GetPointData()->AddArray(vectors);
       if (!output->GetPointData()->GetVectors())
@@ -1746,9 +1949,7 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerNode(
         output->GetPointData()->SetVectors(vectors);
         }
       vectors->Delete();
-      delete [] comp1;
-      delete [] comp2;
-      delete [] comp3;
+      delete [] vectorsRead;
       }
 
     this->IFile->peek();
@@ -1762,9 +1963,7 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerNode(
 
   if (this->IFile)
     {
-    this->IFile->close();
-    delete this->IFile;
-    this->IFile = NULL;
+    this->CloseFile();
     }
 
   return 1;
@@ -1778,8 +1977,7 @@ int vtkPEnSightGoldBinaryReader::ReadTensorsPerNode(
   char line[80];
   int partId, realId, numPts, i, lineRead;
   vtkFloatArray *tensors;
-  float *comp1, *comp2, *comp3, *comp4, *comp5, *comp6;
-  float tuple[6];
+  float *tensorsRead;
   vtkDataSet *output;
 
   // Initialize
@@ -1883,37 +2081,17 @@ int vtkPEnSightGoldBinaryReader::ReadTensorsPerNode(
       this->ReadLine(line); // "coordinates" or "block"
       tensors->SetNumberOfComponents(6);
       tensors->SetNumberOfTuples(this->GetPointIds(realId)->GetLocalNumberOfIds());
-      comp1 = new float[numPts];
-      comp2 = new float[numPts];
-      comp3 = new float[numPts];
-      comp4 = new float[numPts];
-      comp5 = new float[numPts];
-      comp6 = new float[numPts];
-      this->ReadFloatArray(comp1, numPts);
-      this->ReadFloatArray(comp2, numPts);
-      this->ReadFloatArray(comp3, numPts);
-      this->ReadFloatArray(comp4, numPts);
-      this->ReadFloatArray(comp5, numPts);
-      this->ReadFloatArray(comp6, numPts);
-      for (i = 0; i < numPts; i++)
+      // One plane per component, each a record of its own.
+      tensorsRead = new float[6 * numPts];
+      for (i = 0; i < 6; i++)
         {
-        tuple[0] = comp1[i];
-        tuple[1] = comp2[i];
-        tuple[2] = comp3[i];
-        tuple[3] = comp4[i];
-        tuple[4] = comp5[i];
-        tuple[5] = comp6[i];
-        this->InsertVariableComponent(tensors, i, -1, tuple, realId, 0, TENSOR_SYMM_PER_NODE);
+        this->ReadFloatArray(tensorsRead + i * numPts, numPts);
         }
+      this->InsertVariableComponents(tensors, numPts, 0, 6, tensorsRead, realId, 0, TENSOR_SYMM_PER_NODE);
       tensors->SetName(description);
       output->GetPointData()->AddArray(tensors);
       tensors->Delete();
-      delete [] comp1;
-      delete [] comp2;
-      delete [] comp3;
-      delete [] comp4;
-      delete [] comp5;
-      delete [] comp6;
+      delete [] tensorsRead;
       }
 
     this->IFile->peek();
@@ -1927,9 +2105,7 @@ int vtkPEnSightGoldBinaryReader::ReadTensorsPerNode(
 
   if (this->IFile)
     {
-    this->IFile->close();
-    delete this->IFile;
-    this->IFile = NULL;
+    this->CloseFile();
     }
 
   return 1;
@@ -2037,9 +2213,7 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerElement(
                 vtkErrorMacro("Unknown element type \"" << line << "\"");
                 if (this->IFile)
                   {
-                  this->IFile->close();
-                  delete this->IFile;
-                  this->IFile = NULL;
+                  this->CloseFile();
                   }
                 return 0;
                 }
@@ -2099,10 +2273,7 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerElement(
         {
         scalarsRead = new float[numCells];
         this->ReadFloatArray(scalarsRead, numCells);
-        for (i = 0; i < numCells; i++)
-          {
-          this->InsertVariableComponent(scalars, i, component, &(scalarsRead[i]), realId, 0, SCALAR_PER_ELEMENT);
-          }
+        this->InsertVariableComponents(scalars, numCells, component, 1, scalarsRead, realId, 0, SCALAR_PER_ELEMENT);
         if (this->IFile->eof())
           {
           lineRead = 0;
@@ -2124,9 +2295,7 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerElement(
             vtkErrorMacro("Unknown element type \"" << line << "\"");
             if (this->IFile)
               {
-              this->IFile->close();
-              delete this->IFile;
-              this->IFile = NULL;
+              this->CloseFile();
               }
             if (component == 0)
               {
@@ -2138,10 +2307,7 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerElement(
           numCellsPerElement = this->GetCellIds(idx, elementType)->GetNumberOfIds();
           scalarsRead = new float[numCellsPerElement];
           this->ReadFloatArray(scalarsRead, numCellsPerElement);
-          for (i = 0; i < numCellsPerElement; i++)
-            {
-            this->InsertVariableComponent(scalars, i, component, &(scalarsRead[i]), idx, elementType, SCALAR_PER_ELEMENT);
-            }
+          this->InsertVariableComponents(scalars, numCellsPerElement, component, 1, scalarsRead, idx, elementType, SCALAR_PER_ELEMENT);
           this->IFile->peek();
           if (this->IFile->eof())
             {
@@ -2185,9 +2351,7 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerElement(
 
   if (this->IFile)
     {
-    this->IFile->close();
-    delete this->IFile;
-    this->IFile = NULL;
+    this->CloseFile();
     }
   return 1;
 }
@@ -2200,9 +2364,8 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerElement(
   char line[80];
   int partId, realId, numCells, numCellsPerElement, i, idx;
   vtkFloatArray *vectors;
-  float *comp1, *comp2, *comp3;
+  float *vectorsRead;
   int lineRead, elementType;
-  float tuple[3];
   vtkDataSet *output;
 
   // Initialize
@@ -2343,19 +2506,13 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerElement(
       // type (and what their ids are) -- IF THIS IS NOT A BLOCK SECTION
       if (strncmp(line, "block", 5) == 0)
         {
-        comp1 = new float[numCells];
-        comp2 = new float[numCells];
-        comp3 = new float[numCells];
-        this->ReadFloatArray(comp1, numCells);
-        this->ReadFloatArray(comp2, numCells);
-        this->ReadFloatArray(comp3, numCells);
-        for (i = 0; i < numCells; i++)
+        // One plane per component, each a record of its own.
+        vectorsRead = new float[3 * numCells];
+        for (i = 0; i < 3; i++)
           {
-          tuple[0] = comp1[i];
-          tuple[1] = comp2[i];
-          tuple[2] = comp3[i];
-          this->InsertVariableComponent(vectors, i, -1, tuple, realId, 0, VECTOR_PER_ELEMENT);
+          this->ReadFloatArray(vectorsRead + i * numCells, numCells);
           }
+        this->InsertVariableComponents(vectors, numCells, 0, 3, vectorsRead, realId, 0, VECTOR_PER_ELEMENT);
         this->IFile->peek();
         if (this->IFile->eof())
           {
@@ -2365,9 +2522,7 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerElement(
           {
           lineRead = this->ReadLine(line);
           }
-        delete [] comp1;
-        delete [] comp2;
-        delete [] comp3;
+        delete [] vectorsRead;
         }
       else
         {
@@ -2386,19 +2541,13 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerElement(
           idx = this->UnstructuredPartIds->IsId(realId);
           numCellsPerElement =
             this->GetCellIds(idx, elementType)->GetNumberOfIds();
-          comp1 = new float[numCellsPerElement];
-          comp2 = new float[numCellsPerElement];
-          comp3 = new float[numCellsPerElement];
-          this->ReadFloatArray(comp1, numCellsPerElement);
-          this->ReadFloatArray(comp2, numCellsPerElement);
-          this->ReadFloatArray(comp3, numCellsPerElement);
-          for (i = 0; i < numCellsPerElement; i++)
+          // One plane per component, each a record of its own.
+          vectorsRead = new float[3 * numCellsPerElement];
+          for (i = 0; i < 3; i++)
             {
-            tuple[0] = comp1[i];
-            tuple[1] = comp2[i];
-            tuple[2] = comp3[i];
-            this->InsertVariableComponent(vectors, i, 0, tuple, idx, elementType, VECTOR_PER_ELEMENT);
+            this->ReadFloatArray(vectorsRead + i * numCellsPerElement, numCellsPerElement);
             }
+          this->InsertVariableComponents(vectors, numCellsPerElement, 0, 3, vectorsRead, idx, elementType, VECTOR_PER_ELEMENT);
           this->IFile->peek();
           if (this->IFile->eof())
             {
@@ -2408,9 +2557,7 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerElement(
             {
             lineRead = this->ReadLine(line);
             }
-          delete [] comp1;
-          delete [] comp2;
-          delete [] comp3;
+          delete [] vectorsRead;
           } // end while
         } // end else
       vectors->SetName(description);
@@ -2437,9 +2584,7 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerElement(
 
   if (this->IFile)
     {
-    this->IFile->close();
-    delete this->IFile;
-    this->IFile = NULL;
+    this->CloseFile();
     }
   return 1;
 }
@@ -2453,8 +2598,7 @@ int vtkPEnSightGoldBinaryReader::ReadTensorsPerElement(
   int partId, realId, numCells, numCellsPerElement, i, idx;
   vtkFloatArray *tensors;
   int lineRead, elementType;
-  float *comp1, *comp2, *comp3, *comp4, *comp5, *comp6;
-  float tuple[6];
+  float *tensorsRead;
   vtkDataSet *output;
 
   // Initialize
@@ -2597,28 +2741,13 @@ int vtkPEnSightGoldBinaryReader::ReadTensorsPerElement(
       // type (and what their ids are) -- IF THIS IS NOT A BLOCK SECTION
       if (strncmp(line, "block", 5) == 0)
         {
-        comp1 = new float[numCells];
-        comp2 = new float[numCells];
-        comp3 = new float[numCells];
-        comp4 = new float[numCells];
-        comp5 = new float[numCells];
-        comp6 = new float[numCells];
-        this->ReadFloatArray(comp1, numCells);
-        this->ReadFloatArray(comp2, numCells);
-        this->ReadFloatArray(comp3, numCells);
-        this->ReadFloatArray(comp4, numCells);
-        this->ReadFloatArray(comp5, numCells);
-        this->ReadFloatArray(comp6, numCells);
-        for (i = 0; i < numCells; i++)
+        // One plane per component, each a record of its own.
+        tensorsRead = new float[6 * numCells];
+        for (i = 0; i < 6; i++)
           {
-          tuple[0] = comp1[i];
-          tuple[1] = comp2[i];
-          tuple[2] = comp3[i];
-          tuple[3] = comp4[i];
-          tuple[4] = comp5[i];
-          tuple[5] = comp6[i];
-          this->InsertVariableComponent(tensors,i,-1,tuple,realId,0,TENSOR_SYMM_PER_ELEMENT);
+          this->ReadFloatArray(tensorsRead + i * numCells, numCells);
           }
+        this->InsertVariableComponents(tensors, numCells, 0, 6, tensorsRead, realId, 0, TENSOR_SYMM_PER_ELEMENT);
         this->IFile->peek();
         if (this->IFile->eof())
           {
@@ -2628,12 +2757,7 @@ int vtkPEnSightGoldBinaryReader::ReadTensorsPerElement(
           {
           lineRead = this->ReadLine(line);
           }
-        delete [] comp1;
-        delete [] comp2;
-        delete [] comp3;
-        delete [] comp4;
-        delete [] comp5;
-        delete [] comp6;
+        delete [] tensorsRead;
         }
       else
         {
@@ -2652,28 +2776,13 @@ int vtkPEnSightGoldBinaryReader::ReadTensorsPerElement(
           idx = this->UnstructuredPartIds->IsId(realId);
           numCellsPerElement =
             this->GetCellIds(idx, elementType)->GetNumberOfIds();
-          comp1 = new float[numCellsPerElement];
-          comp2 = new float[numCellsPerElement];
-          comp3 = new float[numCellsPerElement];
-          comp4 = new float[numCellsPerElement];
-          comp5 = new float[numCellsPerElement];
-          comp6 = new float[numCellsPerElement];
-          this->ReadFloatArray(comp1, numCellsPerElement);
-          this->ReadFloatArray(comp2, numCellsPerElement);
-          this->ReadFloatArray(comp3, numCellsPerElement);
-          this->ReadFloatArray(comp4, numCellsPerElement);
-          this->ReadFloatArray(comp5, numCellsPerElement);
-          this->ReadFloatArray(comp6, numCellsPerElement);
-          for (i = 0; i < numCellsPerElement; i++)
+          // One plane per component, each a record of its own.
+          tensorsRead = new float[6 * numCellsPerElement];
+          for (i = 0; i < 6; i++)
             {
-            tuple[0] = comp1[i];
-            tuple[1] = comp2[i];
-            tuple[2] = comp3[i];
-            tuple[3] = comp4[i];
-            tuple[4] = comp5[i];
-            tuple[5] = comp6[i];
-            this->InsertVariableComponent(tensors, i, 0, tuple, idx, elementType, TENSOR_SYMM_PER_ELEMENT);
+            this->ReadFloatArray(tensorsRead + i * numCellsPerElement, numCellsPerElement);
             }
+          this->InsertVariableComponents(tensors, numCellsPerElement, 0, 6, tensorsRead, idx, elementType, TENSOR_SYMM_PER_ELEMENT);
           this->IFile->peek();
           if (this->IFile->eof())
             {
@@ -2683,12 +2792,7 @@ int vtkPEnSightGoldBinaryReader::ReadTensorsPerElement(
             {
             lineRead = this->ReadLine(line);
             }
-          delete [] comp1;
-          delete [] comp2;
-          delete [] comp3;
-          delete [] comp4;
-          delete [] comp5;
-          delete [] comp6;
+          delete [] tensorsRead;
           } // end while
         } // end else
       tensors->SetName(description);
@@ -2711,9 +2815,7 @@ int vtkPEnSightGoldBinaryReader::ReadTensorsPerElement(
 
   if (this->IFile)
     {
-    this->IFile->close();
-    delete this->IFile;
-    this->IFile = NULL;
+    this->CloseFile();
     }
   return 1;
 }
@@ -2795,8 +2897,6 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
         return -1;
         }
 
-      nodeIds = new vtkIdType[1];
-
       if (this->ElementIdsListed)
         {
         this->IFile->seekg(sizeof(int)*numElements, ios::cur);
@@ -2804,14 +2904,8 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
 
       nodeIdList = new int[numElements];
       this->ReadIntArray(nodeIdList, numElements);
+      this->InsertNextCellsAndIds(output, VTK_VERTEX, 1, nodeIdList, idx, vtkPEnSightReader::POINT, numElements);
 
-      for (i = 0; i < numElements; i++)
-        {
-        nodeIds[0] = nodeIdList[i] - 1;
-        this->InsertNextCellAndId(output,VTK_VERTEX,1,nodeIds,idx,vtkPEnSightReader::POINT,i,numElements);
-        }
-
-      delete [] nodeIds;
       delete [] nodeIdList;
       }
     else if (strncmp(line, "g_point", 7) == 0)
@@ -2845,7 +2939,6 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
         vtkErrorMacro("Invalid number of bar2 cells; check that ByteOrder is set correctly.");
         return -1;
         }
-      nodeIds = new vtkIdType[2];
       if (this->ElementIdsListed)
         {
         this->IFile->seekg(sizeof(int)*numElements, ios::cur);
@@ -2853,17 +2946,8 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
 
       nodeIdList = new int[numElements * 2];
       this->ReadIntArray(nodeIdList, numElements * 2);
+      this->InsertNextCellsAndIds(output, VTK_LINE, 2, nodeIdList, idx, vtkPEnSightReader::BAR2, numElements);
 
-      for (i = 0; i < numElements; i++)
-        {
-        for (j = 0; j < 2; j++)
-          {
-          nodeIds[j] = nodeIdList[2*i+j] - 1;
-          }
-        this->InsertNextCellAndId(output,VTK_LINE,2,nodeIds,idx,vtkPEnSightReader::BAR2,i,numElements);
-        }
-
-      delete [] nodeIds;
       delete [] nodeIdList;
       }
     else if (strncmp(line, "g_bar2", 6) == 0)
@@ -2897,8 +2981,6 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
         vtkErrorMacro("Invalid number of bar3 cells; check that ByteOrder is set correctly.");
         return -1;
         }
-      nodeIds = new vtkIdType[3];
-
       if (this->ElementIdsListed)
         {
         this->IFile->seekg(sizeof(int)*numElements, ios::cur);
@@ -2906,16 +2988,10 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
 
       nodeIdList = new int[numElements*3];
       this->ReadIntArray(nodeIdList, numElements*3);
+      // EnSight lists the mid-edge node between the two end nodes.
+      static const int bar3Order[3] = { 0, 2, 1 };
+      this->InsertNextCellsAndIds(output, VTK_QUADRATIC_EDGE, 3, nodeIdList, idx, vtkPEnSightReader::BAR3, numElements, bar3Order);
 
-      for (i = 0; i < numElements; i++)
-        {
-        nodeIds[0] = nodeIdList[3*i]-1;
-        nodeIds[1] = nodeIdList[3*i+2]-1;
-        nodeIds[2] = nodeIdList[3*i+1]-1;
-        this->InsertNextCellAndId(output,VTK_QUADRATIC_EDGE,3,nodeIds,idx,vtkPEnSightReader::BAR3,i,numElements);
-        }
-
-      delete [] nodeIds;
       delete [] nodeIdList;
       }
     else if (strncmp(line, "g_bar3", 6) == 0)
@@ -3045,38 +3121,17 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
 
       if (cellType == vtkPEnSightReader::TRIA6)
         {
-        nodeIds = new vtkIdType[6];
         nodeIdList = new int[numElements*6];
         this->ReadIntArray(nodeIdList, numElements*6);
+        this->InsertNextCellsAndIds(output, VTK_QUADRATIC_TRIANGLE, 6, nodeIdList, idx, cellType, numElements);
         }
       else
         {
-        nodeIds = new vtkIdType[3];
         nodeIdList = new int[numElements*3];
         this->ReadIntArray(nodeIdList, numElements*3);
+        this->InsertNextCellsAndIds(output, VTK_TRIANGLE, 3, nodeIdList, idx, cellType, numElements);
         }
 
-      for (i = 0; i < numElements; i++)
-        {
-        if (cellType == vtkPEnSightReader::TRIA6)
-          {
-          for (j = 0; j < 6; j++)
-            {
-            nodeIds[j] = nodeIdList[6*i+j] - 1;
-            }
-          this->InsertNextCellAndId(output,VTK_QUADRATIC_TRIANGLE, 6,nodeIds,idx,cellType,i,numElements);
-          }
-        else
-          {
-          for (j = 0; j < 3; j++)
-            {
-            nodeIds[j] = nodeIdList[3*i+j] - 1;
-            }
-          this->InsertNextCellAndId(output,VTK_TRIANGLE, 3,nodeIds,idx,cellType,i,numElements);
-          }
-        }
-
-      delete [] nodeIds;
       delete [] nodeIdList;
       }
     else if (strncmp(line, "g_tria3", 7) == 0 ||
@@ -3146,38 +3201,17 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
 
       if (cellType == vtkPEnSightReader::QUAD8)
         {
-        nodeIds = new vtkIdType[8];
         nodeIdList = new int[numElements*8];
         this->ReadIntArray(nodeIdList, numElements*8);
+        this->InsertNextCellsAndIds(output, VTK_QUADRATIC_QUAD, 8, nodeIdList, idx, cellType, numElements);
         }
       else
         {
-        nodeIds = new vtkIdType[4];
         nodeIdList = new int[numElements*4];
         this->ReadIntArray(nodeIdList, numElements*4);
+        this->InsertNextCellsAndIds(output, VTK_QUAD, 4, nodeIdList, idx, cellType, numElements);
         }
 
-      for (i = 0; i < numElements; i++)
-        {
-        if (cellType == vtkPEnSightReader::QUAD8)
-          {
-          for (j = 0; j < 8; j++)
-            {
-            nodeIds[j] = nodeIdList[8*i+j] - 1;
-            }
-          this->InsertNextCellAndId(output,VTK_QUADRATIC_QUAD, 8,nodeIds,idx,cellType,i,numElements);
-          }
-        else
-          {
-          for (j = 0; j < 4; j++)
-            {
-            nodeIds[j] = nodeIdList[4*i+j] - 1;
-            }
-          this->InsertNextCellAndId(output,VTK_QUAD, 4,nodeIds,idx,cellType,i,numElements);
-          }
-        }
-
-      delete [] nodeIds;
       delete [] nodeIdList;
       }
     else if (strncmp(line, "g_quad4", 7) == 0 ||
@@ -3341,38 +3375,17 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
 
       if (cellType == vtkPEnSightReader::TETRA10)
         {
-        nodeIds = new vtkIdType[10];
         nodeIdList = new int[numElements*10];
         this->ReadIntArray(nodeIdList, numElements*10);
+        this->InsertNextCellsAndIds(output, VTK_QUADRATIC_TETRA, 10, nodeIdList, idx, cellType, numElements);
         }
       else
         {
-        nodeIds = new vtkIdType[4];
         nodeIdList = new int[numElements*4];
         this->ReadIntArray(nodeIdList, numElements*4);
+        this->InsertNextCellsAndIds(output, VTK_TETRA, 4, nodeIdList, idx, cellType, numElements);
         }
 
-      for (i = 0; i < numElements; i++)
-        {
-        if (cellType == vtkPEnSightReader::TETRA10)
-          {
-          for (j = 0; j < 10; j++)
-            {
-            nodeIds[j] = nodeIdList[10*i+j] - 1;
-            }
-          this->InsertNextCellAndId(output,VTK_QUADRATIC_TETRA, 10,nodeIds,idx,cellType,i,numElements);
-          }
-        else
-          {
-          for (j = 0; j < 4; j++)
-            {
-            nodeIds[j] = nodeIdList[4*i+j] - 1;
-            }
-          this->InsertNextCellAndId(output,VTK_TETRA, 4,nodeIds,idx,cellType,i,numElements);
-          }
-        }
-
-      delete [] nodeIds;
       delete [] nodeIdList;
       }
     else if (strncmp(line, "g_tetra4", 8) == 0 ||
@@ -3442,38 +3455,17 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
 
       if (cellType == vtkPEnSightReader::PYRAMID13)
         {
-        nodeIds = new vtkIdType[13];
         nodeIdList = new int[numElements*13];
         this->ReadIntArray(nodeIdList, numElements*13);
+        this->InsertNextCellsAndIds(output, VTK_QUADRATIC_PYRAMID, 13, nodeIdList, idx, cellType, numElements);
         }
       else
         {
-        nodeIds = new vtkIdType[5];
         nodeIdList = new int[numElements*5];
         this->ReadIntArray(nodeIdList, numElements*5);
+        this->InsertNextCellsAndIds(output, VTK_PYRAMID, 5, nodeIdList, idx, cellType, numElements);
         }
 
-      for (i = 0; i < numElements; i++)
-        {
-        if (cellType == vtkPEnSightReader::PYRAMID13)
-          {
-          for (j = 0; j < 13; j++)
-            {
-            nodeIds[j] = nodeIdList[13*i+j] - 1;
-            }
-          this->InsertNextCellAndId(output,VTK_QUADRATIC_PYRAMID, 13,nodeIds,idx,cellType,i,numElements);
-          }
-        else
-          {
-          for (j = 0; j < 5; j++)
-            {
-            nodeIds[j] = nodeIdList[5*i+j] - 1;
-            }
-          this->InsertNextCellAndId(output,VTK_PYRAMID, 5,nodeIds,idx,cellType,i,numElements);
-          }
-        }
-
-      delete [] nodeIds;
       delete [] nodeIdList;
       }
     else if (strncmp(line, "g_pyramid5", 10) == 0 ||
@@ -3543,37 +3535,17 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
 
       if (cellType == vtkPEnSightReader::HEXA20)
         {
-        nodeIds = new vtkIdType[20];
         nodeIdList = new int[numElements*20];
         this->ReadIntArray(nodeIdList, numElements*20);
+        this->InsertNextCellsAndIds(output, VTK_QUADRATIC_HEXAHEDRON, 20, nodeIdList, idx, cellType, numElements);
         }
       else
         {
-        nodeIds = new vtkIdType[8];
         nodeIdList = new int[numElements*8];
         this->ReadIntArray(nodeIdList, numElements*8);
+        this->InsertNextCellsAndIds(output, VTK_HEXAHEDRON, 8, nodeIdList, idx, cellType, numElements);
         }
 
-      for (i = 0; i < numElements; i++)
-        {
-        if (cellType == vtkPEnSightReader::HEXA20)
-          {
-          for (j = 0; j < 20; j++)
-            {
-            nodeIds[j] = nodeIdList[20*i+j] - 1;
-            }
-          this->InsertNextCellAndId(output,VTK_QUADRATIC_HEXAHEDRON, 20,nodeIds,idx,cellType,i,numElements);
-          }
-        else
-          {
-          for (j = 0; j < 8; j++)
-            {
-            nodeIds[j] = nodeIdList[8*i+j] - 1;
-            }
-          this->InsertNextCellAndId(output,VTK_HEXAHEDRON,8,nodeIds,idx,cellType,i,numElements);
-          }
-        }
-      delete [] nodeIds;
       delete [] nodeIdList;
 
       }
@@ -3644,38 +3616,17 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
 
       if (cellType == vtkPEnSightReader::PENTA15)
         {
-        nodeIds = new vtkIdType[15];
         nodeIdList = new int[numElements*15];
         this->ReadIntArray(nodeIdList, numElements*15);
+        this->InsertNextCellsAndIds(output, VTK_QUADRATIC_WEDGE, 15, nodeIdList, idx, cellType, numElements);
         }
       else
         {
-        nodeIds = new vtkIdType[6];
         nodeIdList = new int[numElements*6];
         this->ReadIntArray(nodeIdList, numElements*6);
+        this->InsertNextCellsAndIds(output, VTK_WEDGE, 6, nodeIdList, idx, cellType, numElements);
         }
 
-      for (i = 0; i < numElements; i++)
-        {
-        if (cellType == vtkPEnSightReader::PENTA15)
-          {
-          for (j = 0; j < 15; j++)
-            {
-            nodeIds[j] = nodeIdList[15*i+j] - 1;
-            }
-          this->InsertNextCellAndId(output,VTK_QUADRATIC_WEDGE, 15,nodeIds,idx,cellType,i,numElements);
-          }
-        else
-          {
-          for (j = 0; j < 6; j++)
-            {
-            nodeIds[j] = nodeIdList[6*i+j] - 1;
-            }
-          this->InsertNextCellAndId(output,VTK_WEDGE, 6,nodeIds,idx,cellType,i,numElements);
-          }
-        }
-
-      delete [] nodeIds;
       delete [] nodeIdList;
       }
     else if (strncmp(line, "g_penta6", 8) == 0 ||
@@ -3848,17 +3799,31 @@ int vtkPEnSightGoldBinaryReader::CreateStructuredGridOutput(
 
   long currentPositionInFile = this->IFile->tellg();
 
-  // Buffer Read.
+  // Buffer Read. The buffer is filled on first use.
   this->FloatBufferFilePosition = currentPositionInFile;
-  this->FloatBufferIndexBegin = 0;
+  this->FloatBufferIndexBegin = -1;
   this->FloatBufferNumberOfVectors = numPts;
   long endFilePosition = currentPositionInFile + 3 * numPts * sizeof(float);
   if (this->Fortran)
     endFilePosition += 24; // 4 * (begin + end) * number of components (3)
-  this->UpdateFloatBuffer();
   this->IFile->seekg(endFilePosition);
 
-  for (i = 0; i < numPts; i++)
+  int numMappedPts = -1;
+  if (this->MappedBuffer && points->GetDataType() == VTK_FLOAT)
+    {
+    points->SetNumberOfPoints(this->GetPointIds(partId)->GetLocalNumberOfIds());
+    numMappedPts = this->CopyMappedCoordinates(partId,
+      static_cast<float*>(points->GetVoidPointer(0)), true);
+    if (numMappedPts >= 0)
+      {
+      points->SetNumberOfPoints(numMappedPts);
+      }
+    else
+      {
+      points->Reset();
+      }
+    }
+  for (i = 0; i < numPts && numMappedPts < 0; i++)
     {
     int realPointId = this->GetPointIds(partId)->GetId(i);
     if( realPointId != -1 )
@@ -4410,10 +4375,10 @@ int vtkPEnSightGoldBinaryReader::ReadOrSkipCoordinates(vtkPoints* points, long o
 
   long currentPositionInFile = this->IFile->tellg();
 
+  // The buffer is filled on first use, so that skipped parts are not read.
   this->FloatBufferFilePosition = currentPositionInFile;
-  this->FloatBufferIndexBegin = 0;
+  this->FloatBufferIndexBegin = -1;
   this->FloatBufferNumberOfVectors = numPts;
-  this->UpdateFloatBuffer();
 
   // Position to reach at the end of this method
   long endFilePosition = currentPositionInFile + 3 * numPts * sizeof(float);
@@ -4451,9 +4416,13 @@ int vtkPEnSightGoldBinaryReader::ReadOrSkipCoordinates(vtkPoints* points, long o
       int localNumberOfIds = this->GetPointIds(partId)->GetLocalNumberOfIds();
       points->Allocate(localNumberOfIds);
       points->SetNumberOfPoints(localNumberOfIds);
+      bool mapped = this->MappedBuffer &&
+        points->GetDataType() == VTK_FLOAT &&
+        this->CopyMappedCoordinates(partId,
+          static_cast<float*>(points->GetVoidPointer(0)), false) >= 0;
       int maxId = -1;
       int minId = -1;
-      for (i = 0; i < numPts; i++)
+      for (i = 0; i < numPts && !mapped; i++)
         {
         float vec[3];
         int id = this->GetPointIds(partId)->GetId(i);
@@ -4483,6 +4452,66 @@ int vtkPEnSightGoldBinaryReader::ReadOrSkipCoordinates(vtkPoints* points, long o
     }
 }
 
+//----------------------------------------------------------------------------
+int vtkPEnSightGoldBinaryReader::CopyMappedCoordinates(int partId,
+                                                       float* coords,
+                                                       bool compact)
+{
+  // We assume FloatBufferFilePosition and FloatBufferNumberOfVectors were
+  // previously set.
+  if (!this->MappedBuffer)
+    {
+    return -1;
+    }
+  int numPts = this->FloatBufferNumberOfVectors;
+  size_t planeSize = static_cast<size_t>(numPts) * sizeof(float);
+  const char* planes[3];
+  for (int c = 0; c < 3; c++)
+    {
+    // Each component is a record of its own in Fortran files.
+    size_t offset = static_cast<size_t>(this->FloatBufferFilePosition) +
+      c * planeSize + (this->Fortran ? 4 + c * 8 : 0);
+    planes[c] = this->MappedBuffer->GetData(offset, planeSize);
+    if (!planes[c])
+      {
+      vtkErrorMacro("Coordinates go past the end of the file.");
+      return -1;
+      }
+    this->MappedBuffer->WillNeed(planes[c], planeSize);
+    }
+
+  // Interleave the raw values, then swap them all at once.
+  vtkPEnSightReaderCellIds* pointIds = this->GetPointIds(partId);
+  int numCopied = 0;
+  int maxIndex = -1;
+  for (int i = 0; i < numPts; i++)
+    {
+    int id = pointIds->GetId(i);
+    if (id == -1)
+      {
+      continue;
+      }
+    int index = compact ? numCopied : id;
+    float* point = coords + 3 * static_cast<vtkIdType>(index);
+    memcpy(point, planes[0] + i * sizeof(float), sizeof(float));
+    memcpy(point + 1, planes[1] + i * sizeof(float), sizeof(float));
+    memcpy(point + 2, planes[2] + i * sizeof(float), sizeof(float));
+    maxIndex = index > maxIndex ? index : maxIndex;
+    numCopied++;
+    }
+
+  vtkIdType numValues = 3 * (static_cast<vtkIdType>(maxIndex) + 1);
+  if (this->ByteOrder == FILE_LITTLE_ENDIAN)
+    {
+    vtkByteSwap::Swap4LERange(coords, numValues);
+    }
+  else
+    {
+    vtkByteSwap::Swap4BERange(coords, numValues);
+    }
+  return numCopied;
+}
+
 //----------------------------------------------------------------------------
 int vtkPEnSightGoldBinaryReader::InjectCoordinatesAtEnd(vtkUnstructuredGrid* output, long coordinatesOffset, int partId )
 {
@@ -4586,8 +4615,22 @@ void vtkPEnSightGoldBinaryReader::UpdateFloatBuffer()
   this->IFile->seekg(currentPosition);
 }
 
+//----------------------------------------------------------------------------
+void vtkPEnSightGoldBinaryReader::SetUseMemoryMapping(bool use)
+{
+  vtkPEnSightGoldBinaryReader::UseMemoryMapping = use;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPEnSightGoldBinaryReader::GetUseMemoryMapping()
+{
+  return vtkPEnSightGoldBinaryReader::UseMemoryMapping;
+}
+
 //----------------------------------------------------------------------------
 void vtkPEnSightGoldBinaryReader::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+  os << indent << "UseMemoryMapping: "
+     << vtkPEnSightGoldBinaryReader::UseMemoryMapping << endl;
 }
@@ -15,6 +15,13 @@
 // .NAME vtkPEnSightGoldBinaryReader
 // .SECTION Description
 // Parallel vtkEnSightGoldBinaryReader.
+//
+// When UseMemoryMapping is on, files are mapped in memory (mmap, or a file
+// mapping on Windows) instead of being read through an ifstream. Skipping
+// parts and time steps then no longer hits the file system, arrays are
+// copied out of the mapping in one go and coordinates are interleaved
+// straight into the output points. Files that cannot be mapped (e.g. too
+// large for the address space) are read through an ifstream as before.
 // .SECTION Thanks
 // <verbatim>
 //
@@ -38,6 +45,9 @@
 class vtkMultiBlockDataSet;
 class vtkUnstructuredGrid;
 class vtkPoints;
+//BTX
+class vtkPEnSightGoldBinaryReaderMappedBuffer;
+//ETX
 
 class VTKPVVTKEXTENSIONSDEFAULT_EXPORT vtkPEnSightGoldBinaryReader : public vtkPEnSightReader
 {
@@ -46,6 +56,13 @@ class VTKPVVTKEXTENSIONSDEFAULT_EXPORT vtkPEnSightGoldBinaryReader : public vtkP
   vtkTypeMacro(vtkPEnSightGoldBinaryReader, vtkPEnSightReader);
   virtual void PrintSelf(ostream& os, vtkIndent indent);
 
+  // Description:
+  // Get/Set whether files are memory mapped rather than read through a
+  // stream. This is a global setting shared by all instances. Off by
+  // default.
+  static void SetUseMemoryMapping(bool use);
+  static bool GetUseMemoryMapping();
+
  protected:
   vtkPEnSightGoldBinaryReader();
   ~vtkPEnSightGoldBinaryReader();
@@ -53,6 +70,10 @@ class VTKPVVTKEXTENSIONSDEFAULT_EXPORT vtkPEnSightGoldBinaryReader : public vtkP
   // Returns 1 if successful.  Sets file size as a side action.
   int OpenFile(const char* filename);
 
+  // Description:
+  // Close the current file, if any, and release its mapping.
+  void CloseFile();
+
 
   // Returns 1 if successful.  Handles constructing the filename, opening the file and checking
   // if it's binary
@@ -166,6 +187,14 @@ class VTKPVVTKEXTENSIONSDEFAULT_EXPORT vtkPEnSightGoldBinaryReader : public vtkP
   // Read Coordinates, or just skip the part in the file.
   int ReadOrSkipCoordinates(vtkPoints* points, long offset, int partId, bool skip);
 
+  // Description:
+  // Copy the coordinates located by FloatBufferFilePosition and
+  // FloatBufferNumberOfVectors from the memory mapped file into \c coords
+  // (3 floats per point). Points are stored at their local id, or one after
+  // the other when \c compact is true. Returns the number of points copied,
+  // or -1 if the file is not mapped or too short.
+  int CopyMappedCoordinates(int partId, float* coords, bool compact);
+
   // Description:
   // Internal method to inject Coordinates and Global Ids at the end
   // of a part read for Unstructured data.
@@ -190,7 +219,9 @@ class VTKPVVTKEXTENSIONSDEFAULT_EXPORT vtkPEnSightGoldBinaryReader : public vtkP
   int ElementIdsListed;
   int Fortran;
 
-  ifstream *IFile;
+  istream *IFile;
+  // Set when IFile reads from a memory mapped file.
+  vtkPEnSightGoldBinaryReaderMappedBuffer *MappedBuffer;
   // The size of the file could be used to choose byte order.
   long FileSize;
 
@@ -209,6 +240,8 @@ class VTKPVVTKEXTENSIONSDEFAULT_EXPORT vtkPEnSightGoldBinaryReader : public vtkP
   // Total number of vectors;
   int FloatBufferNumberOfVectors;
 
+  static bool UseMemoryMapping;
+
  private:
   vtkPEnSightGoldBinaryReader(const vtkPEnSightGoldBinaryReader&);  // Not implemented.
   void operator=(const vtkPEnSightGoldBinaryReader&);  // Not implemented.
@@ -2445,6 +2445,92 @@ void vtkPEnSightReader::InsertNextCellAndId(vtkUnstructuredGrid* output, int vtk
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkPEnSightReader::InsertNextCellsAndIds(vtkUnstructuredGrid* output, int vtkCellType, vtkIdType numPoints, const int *nodeIdList, int partId, int ensightCellType, vtkIdType numElements, const int *order)
+{
+  // Same distribution as InsertNextCellAndId()
+  int mpiLocalProcessId = this->GetMultiProcessLocalProcessId();
+  int mpiNumberOfProcesses = this->GetMultiProcessNumberOfProcesses();
+  vtkIdType numElnts = (numElements / mpiNumberOfProcesses) + 1;
+  vtkIdType begin = mpiLocalProcessId * numElnts;
+  vtkIdType end = begin + numElnts;
+  if (begin > numElements)
+    {
+    begin = numElements;
+    }
+  if (end > numElements)
+    {
+    end = numElements;
+    }
+
+  vtkPEnSightReaderCellIds* pointIds = this->GetPointIds(partId);
+  vtkPEnSightReaderCellIds* cellIds = this->GetCellIds(partId, ensightCellType);
+  vtkIdType i;
+  for (i = 0; i < begin; i++)
+    {
+    cellIds->InsertNextId(-1);
+    }
+
+  std::vector<vtkIdType> newPoints(numPoints);
+  for (i = begin; i < end; i++)
+    {
+    const int* cellNodeIds = nodeIdList + i * numPoints;
+    for (vtkIdType j = 0; j < numPoints; j++)
+      {
+      int nodeId = cellNodeIds[order ? order[j] : j] - 1;
+      int realId = pointIds->GetId(nodeId);
+      if (realId == -1)
+        {
+        pointIds->SetId(nodeId, this->LastPointId);
+        realId = this->LastPointId;
+        this->LastPointId++;
+        }
+      newPoints[j] = realId;
+      }
+    vtkIdType cellId = output->InsertNextCell(vtkCellType, numPoints, &newPoints[0]);
+    cellIds->InsertNextId(cellId);
+    }
+
+  for (i = end; i < numElements; i++)
+    {
+    cellIds->InsertNextId(-1);
+    }
+
+  if (end > begin)
+    {
+    this->CoordinatesAtEnd = true;
+    this->InjectGlobalElementIds = true;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPEnSightReader::InsertVariableComponents(vtkFloatArray* array, int numValues, int component, int numComponents, const float* content, int partId, int ensightCellType, int insertionType)
+{
+  vtkPEnSightReaderCellIds* ids;
+  if( (insertionType == SCALAR_PER_ELEMENT) || (insertionType == VECTOR_PER_ELEMENT) || (insertionType == TENSOR_SYMM_PER_ELEMENT) )
+    ids = this->GetCellIds(partId, ensightCellType);
+  else
+    ids = this->GetPointIds(partId);
+
+  int arrayComponents = array->GetNumberOfComponents();
+  vtkIdType numTuples = array->GetNumberOfTuples();
+  float* data = array->GetPointer(0);
+  for (int i = 0; i < numValues; i++)
+    {
+    vtkIdType realId = ids->GetId(i);
+    if (realId < 0 || realId >= numTuples)
+      {
+      continue;
+      }
+    float* tuple = data + realId * arrayComponents + component;
+    for (int c = 0; c < numComponents; c++)
+      {
+      tuple[c] = content[static_cast<vtkIdType>(c) * numValues + i];
+      }
+    }
+  array->Modified();
+}
+
 //----------------------------------------------------------------------------
 void vtkPEnSightReader::PrepareStructuredDimensionsForDistribution(int partId, int *oldDimensions, int *newDimensions, int *splitDimension, int *splitDimensionBeginIndex,
                                                                     int ghostLevel, vtkUnsignedCharArray *pointGhostArray, vtkUnsignedCharArray *cellGhostArray)
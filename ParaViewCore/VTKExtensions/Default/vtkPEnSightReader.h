@@ -773,6 +773,21 @@ class VTKPVVTKEXTENSIONSDEFAULT_EXPORT vtkPEnSightReader : public vtkPGenericEnS
   void InsertNextCellAndId(vtkUnstructuredGrid*, int vtkCellType, vtkIdType numPoints, vtkIdType *points , int partId, int ensightCellType, vtkIdType globalId, vtkIdType numElements);
   void InsertVariableComponent(vtkFloatArray* array, int i, int component, float* content, int partId, int ensightCellType, int insertionType);
 
+  // Description:
+  // Same as InsertNextCellAndId() for \c numElements cells of \c numPoints
+  // points each, whose 1-based EnSight node ids are listed one cell after the
+  // other in \c nodeIdList. The node ids of each cell are taken in the order
+  // given by \c order, if not NULL. The range of elements owned by this
+  // process is computed once and no buffer is allocated per cell.
+  void InsertNextCellsAndIds(vtkUnstructuredGrid*, int vtkCellType, vtkIdType numPoints, const int *nodeIdList, int partId, int ensightCellType, vtkIdType numElements, const int *order = NULL);
+
+  // Description:
+  // Same as InsertVariableComponent() for \c numValues values laid out as
+  // in EnSight files: \c numComponents planes of \c numValues floats. Plane
+  // c is stored in component \c component + c of \c array. Ids are mapped
+  // once per value and the values are written straight into the array.
+  void InsertVariableComponents(vtkFloatArray* array, int numValues, int component, int numComponents, const float* content, int partId, int ensightCellType, int insertionType);
+
   // Description:
   // 1. Find future split dimension for distribution (biggest)
   // 2. Compute New dimensions
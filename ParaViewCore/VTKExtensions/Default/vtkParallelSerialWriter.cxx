@@ -27,6 +27,7 @@
 #include "vtkReductionFilter.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTable.h"
 #include "vtkTrivialProducer.h"
 
 #include <vtksys/ios/sstream>
@@ -56,6 +57,7 @@ vtkParallelSerialWriter::vtkParallelSerialWriter()
   this->PostGatherHelper = 0;
 
   this->WriteAllTimeSteps = 0;
+  this->WriteCollectively = 0;
   this->NumberOfTimeSteps = 0;
   this->CurrentTimeIndex = 0;
 
@@ -226,6 +228,12 @@ void vtkParallelSerialWriter::WriteAFile(const char* filename, vtkDataObject* in
 {
   vtkMultiProcessController* controller =
     vtkMultiProcessController::GetGlobalController();
+  if (this->WriteCollectively && controller &&
+    controller->GetNumberOfProcesses() > 1)
+    {
+    this->WriteAFileCollectively(filename, input);
+    return;
+    }
 
   vtkSmartPointer<vtkReductionFilter> md = vtkSmartPointer<vtkReductionFilter>::New();
   md->SetController(controller);
@@ -261,32 +269,99 @@ void vtkParallelSerialWriter::WriteAFile(const char* filename, vtkDataObject* in
       outputCopy.TakeReference(output->NewInstance());
       outputCopy->ShallowCopy(output);
 
-      vtksys_ios::ostringstream fname;
-      if (this->WriteAllTimeSteps)
-        {
-        std::string path =
-          vtksys::SystemTools::GetFilenamePath(filename);
-        std::string fnamenoext =
-          vtksys::SystemTools::GetFilenameWithoutLastExtension(filename);
-        std::string ext =
-          vtksys::SystemTools::GetFilenameLastExtension(filename);
-        fname << path << "/" << fnamenoext << "." << this->CurrentTimeIndex << ext;
-        }
-      else
-        {
-        fname << filename;
-        }
       vtkTrivialProducer* tp = vtkTrivialProducer::New();
       tp->SetOutput(outputCopy);
       this->Writer->SetInputConnection(tp->GetOutputPort());
       tp->Delete();
-      this->SetWriterFileName(fname.str().c_str());
+      this->SetWriterFileName(this->GetTimeStepFileName(filename).c_str());
       this->WriteInternal();
       this->Writer->SetInputConnection(0);
       }
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkParallelSerialWriter::WriteAFileCollectively(
+  const char* filename, vtkDataObject* input)
+{
+  vtkMultiProcessController* controller =
+    vtkMultiProcessController::GetGlobalController();
+
+  // Every process must take part in the write, even without local data.
+  vtkSmartPointer<vtkDataObject> localData;
+  if (input && this->PreGatherHelper)
+    {
+    this->PreGatherHelper->RemoveAllInputs();
+    vtkSmartPointer<vtkDataObject> incopy;
+    incopy.TakeReference(input->NewInstance());
+    incopy->ShallowCopy(input);
+    vtkTrivialProducer* tp = vtkTrivialProducer::New();
+    tp->SetOutput(incopy);
+    this->PreGatherHelper->AddInputConnection(0, tp->GetOutputPort());
+    tp->Delete();
+    this->PreGatherHelper->Update();
+    vtkDataObject* result = this->PreGatherHelper->GetOutputDataObject(0);
+    localData.TakeReference(result->NewInstance());
+    localData->ShallowCopy(result);
+    this->PreGatherHelper->RemoveAllInputs();
+    }
+  else if (input)
+    {
+    localData.TakeReference(input->NewInstance());
+    localData->ShallowCopy(input);
+    }
+  else
+    {
+    // e.g. a block that's empty on this process.
+    localData = vtkSmartPointer<vtkTable>::New();
+    }
+
+  vtkTrivialProducer* tp = vtkTrivialProducer::New();
+  tp->SetOutput(localData);
+  this->Writer->SetInputConnection(tp->GetOutputPort());
+  tp->Delete();
+  this->SetWriterFileName(this->GetTimeStepFileName(filename).c_str());
+  if (this->Writer && this->Interpreter)
+    {
+    vtkClientServerStream stream;
+    stream << vtkClientServerStream::Invoke
+           << this->Writer << "SetController" << controller
+           << vtkClientServerStream::End;
+    this->Interpreter->ProcessStream(stream);
+    }
+  this->WriteInternal();
+  if (this->Writer && this->Interpreter)
+    {
+    vtkClientServerStream stream;
+    stream << vtkClientServerStream::Invoke
+           << this->Writer << "SetController" << static_cast<vtkObjectBase*>(0)
+           << vtkClientServerStream::End;
+    this->Interpreter->ProcessStream(stream);
+    }
+  this->Writer->SetInputConnection(0);
+}
+
+//----------------------------------------------------------------------------
+std::string vtkParallelSerialWriter::GetTimeStepFileName(const char* filename)
+{
+  vtksys_ios::ostringstream fname;
+  if (this->WriteAllTimeSteps)
+    {
+    std::string path =
+      vtksys::SystemTools::GetFilenamePath(filename);
+    std::string fnamenoext =
+      vtksys::SystemTools::GetFilenameWithoutLastExtension(filename);
+    std::string ext =
+      vtksys::SystemTools::GetFilenameLastExtension(filename);
+    fname << path << "/" << fnamenoext << "." << this->CurrentTimeIndex << ext;
+    }
+  else
+    {
+    fname << filename;
+    }
+  return fname.str();
+}
+
 //----------------------------------------------------------------------------
 // Overload standard modified time function. If the internal reader is
 // modified, then this object is modified as well.
@@ -336,4 +411,5 @@ void vtkParallelSerialWriter::SetWriterFileName(const char* fname)
 void vtkParallelSerialWriter::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "WriteCollectively: " << this->WriteCollectively << endl;
 }
@@ -27,6 +27,8 @@
 #include "vtkPVVTKExtensionsDefaultModule.h" //needed for exports
 #include "vtkDataObjectAlgorithm.h"
 
+#include <string> // for std::string
+
 class vtkClientServerInterpreter;
 
 class VTKPVVTKEXTENSIONSDEFAULT_EXPORT vtkParallelSerialWriter : public vtkDataObjectAlgorithm
@@ -97,6 +99,17 @@ public:
   vtkSetMacro(WriteAllTimeSteps, int);
   vtkBooleanMacro(WriteAllTimeSteps, int);
 
+  // Description:
+  // When set and running with more than one process, the data is not gathered
+  // on the root node. Instead, the PreGatherHelper (if any) is applied to the
+  // local data and the internal writer is invoked on every process, after
+  // being given the controller with SetController(), so that it writes its
+  // share of the file concurrently. This requires a writer that supports
+  // it, such as vtkCSVWriter. Off by default.
+  vtkGetMacro(WriteCollectively, int);
+  vtkSetMacro(WriteCollectively, int);
+  vtkBooleanMacro(WriteCollectively, int);
+
 //BTX
   // Description:
   // Get/Set the interpreter to use to call methods on the writer.
@@ -123,6 +136,8 @@ private:
   
   void WriteATimestep(vtkDataObject* input);
   void WriteAFile(const char* fname, vtkDataObject* input);
+  void WriteAFileCollectively(const char* fname, vtkDataObject* input);
+  std::string GetTimeStepFileName(const char* fname);
 
   void SetWriterFileName(const char* fname);
   void WriteInternal();
@@ -137,6 +152,7 @@ private:
   int GhostLevel;
 
   int WriteAllTimeSteps;
+  int WriteCollectively;
   int NumberOfTimeSteps;
   int CurrentTimeIndex;
 
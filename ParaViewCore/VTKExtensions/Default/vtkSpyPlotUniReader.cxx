@@ -8,10 +8,20 @@
 #include "vtkIntArray.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkByteSwap.h"
+#include "vtkSMPTools.h"
 #include <vector>
 #include <vtksys/ios/sstream>
 #include <vtksys/RegularExpression.hxx>
 
+#if defined(_WIN32)
+# include "vtkWindows.h"
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
 //=============================================================================
 //-----------------------------------------------------------------------------
 
@@ -34,6 +44,248 @@ inline ostream& operator<< (ostream& os, const vtkSpyPlotWriteString& c)
   return os;
 }
 
+template<class t>
+int vtkSpyPlotUniReaderRunLengthDataDecode(vtkSpyPlotUniReader* self,
+                                           const unsigned char* in,
+                                           int inSize, t* out,
+                                           int outSize, t scale=1);
+
+namespace
+{
+//-----------------------------------------------------------------------------
+// Read-only mapping of a whole file. Open() fails if the file cannot be
+// mapped (e.g. too large for the address space), in which case the data is
+// read through the stream instead.
+class vtkSpyPlotMappedFile
+{
+public:
+  vtkSpyPlotMappedFile() : Data(0), Size(0)
+#if defined(_WIN32)
+    , File(INVALID_HANDLE_VALUE), Mapping(0)
+#endif
+    {
+    }
+  ~vtkSpyPlotMappedFile()
+    {
+    this->Close();
+    }
+
+  bool Open(const char* filename)
+    {
+    this->Close();
+#if defined(_WIN32)
+    this->File = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    LARGE_INTEGER size;
+    if (this->File == INVALID_HANDLE_VALUE ||
+        !GetFileSizeEx(this->File, &size) || size.QuadPart <= 0 ||
+        static_cast<unsigned long long>(size.QuadPart) >
+        static_cast<unsigned long long>(static_cast<size_t>(-1)))
+      {
+      this->Close();
+      return false;
+      }
+    this->Mapping = CreateFileMappingA(this->File, NULL, PAGE_READONLY,
+                                       0, 0, NULL);
+    const void* data = this->Mapping ?
+      MapViewOfFile(this->Mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (!data)
+      {
+      this->Close();
+      return false;
+      }
+    this->Data = static_cast<const unsigned char*>(data);
+    this->Size = static_cast<vtkTypeInt64>(size.QuadPart);
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+      {
+      return false;
+      }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0 ||
+        static_cast<unsigned long long>(info.st_size) >
+        static_cast<unsigned long long>(static_cast<size_t>(-1)))
+      {
+      close(fd);
+      return false;
+      }
+    void* data = mmap(0, static_cast<size_t>(info.st_size), PROT_READ,
+                      MAP_PRIVATE, fd, 0);
+    // The mapping stays valid once the descriptor is closed.
+    close(fd);
+    if (data == MAP_FAILED)
+      {
+      return false;
+      }
+    this->Data = static_cast<const unsigned char*>(data);
+    this->Size = static_cast<vtkTypeInt64>(info.st_size);
+#endif
+    return true;
+    }
+
+  void Close()
+    {
+#if defined(_WIN32)
+    if (this->Data)
+      {
+      UnmapViewOfFile(this->Data);
+      }
+    if (this->Mapping)
+      {
+      CloseHandle(this->Mapping);
+      this->Mapping = 0;
+      }
+    if (this->File != INVALID_HANDLE_VALUE)
+      {
+      CloseHandle(this->File);
+      this->File = INVALID_HANDLE_VALUE;
+      }
+#else
+    if (this->Data)
+      {
+      munmap(const_cast<unsigned char*>(this->Data),
+             static_cast<size_t>(this->Size));
+      }
+#endif
+    this->Data = 0;
+    this->Size = 0;
+    }
+
+  const unsigned char* GetData() const { return this->Data; }
+  vtkTypeInt64 GetSize() const { return this->Size; }
+
+private:
+  vtkSpyPlotMappedFile(const vtkSpyPlotMappedFile&); // Not implemented
+  void operator=(const vtkSpyPlotMappedFile&); // Not implemented
+
+  const unsigned char* Data;
+  vtkTypeInt64 Size;
+#if defined(_WIN32)
+  HANDLE File;
+  HANDLE Mapping;
+#endif
+};
+
+//-----------------------------------------------------------------------------
+// When the file cannot be mapped, compressed planes are buffered up to this
+// size before being decoded.
+const size_t vtkSpyPlotMaxBufferedBytes = 64 * 1024 * 1024;
+
+//-----------------------------------------------------------------------------
+// One run-length encoded plane of a block and where it has to be decoded.
+struct vtkSpyPlotDecodeTask
+{
+  vtkTypeInt64 Offset; // in the mapped file or the read buffer
+  int NumBytes;
+  float* FloatOut;
+  unsigned char* UnsignedCharOut;
+  int NumValues;
+  vtkSpyPlotUniReader::Variable* Var;
+  int BlockId;
+  bool Failed;
+};
+
+//-----------------------------------------------------------------------------
+// Releases everything allocated for the variables being loaded when reading
+// fails, as well as the array being located, which has not been stored yet.
+// The variables are then read again on the next request.
+void vtkSpyPlotReleaseVariables(
+  std::vector<vtkSpyPlotUniReader::Variable*>& vars, int numberOfBlocks,
+  vtkDataArray* current)
+{
+  std::vector<vtkSpyPlotUniReader::Variable*>::iterator iter;
+  for (iter = vars.begin(); iter != vars.end(); ++iter)
+    {
+    vtkSpyPlotUniReader::Variable* var = *iter;
+    for (int block = 0; block < numberOfBlocks; ++block)
+      {
+      if (var->DataBlocks[block])
+        {
+        var->DataBlocks[block]->Delete();
+        }
+      }
+    delete [] var->DataBlocks;
+    var->DataBlocks = 0;
+    delete [] var->GhostCellsFixed;
+    var->GhostCellsFixed = 0;
+    }
+  vars.clear();
+  if (current)
+    {
+    current->Delete();
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Decodes planes concurrently. Each plane is decoded into its own part of
+// the destination array, so no synchronization is needed. Failures are only
+// flagged here and reported by the calling thread.
+class vtkSpyPlotDecodeFunctor
+{
+public:
+  const unsigned char* Data;
+  std::vector<vtkSpyPlotDecodeTask>* Tasks;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType cc = begin; cc < end; ++cc)
+      {
+      vtkSpyPlotDecodeTask& task = (*this->Tasks)[cc];
+      const unsigned char* in = this->Data + task.Offset;
+      if (task.FloatOut)
+        {
+        task.Failed = !::vtkSpyPlotUniReaderRunLengthDataDecode(
+          static_cast<vtkSpyPlotUniReader*>(0), in, task.NumBytes,
+          task.FloatOut, task.NumValues);
+        }
+      else
+        {
+        task.Failed = !::vtkSpyPlotUniReaderRunLengthDataDecode(
+          static_cast<vtkSpyPlotUniReader*>(0), in, task.NumBytes,
+          task.UnsignedCharOut, task.NumValues,
+          static_cast<unsigned char>(255));
+        }
+      }
+    }
+};
+
+//-----------------------------------------------------------------------------
+// Decodes the pending planes and reports, on the calling thread, the ones
+// that could not be decoded. Returns false if any plane failed.
+bool vtkSpyPlotDecodePlanes(vtkSpyPlotUniReader* self,
+                            const unsigned char* data,
+                            std::vector<vtkSpyPlotDecodeTask>& tasks)
+{
+  if (tasks.empty())
+    {
+    return true;
+    }
+  vtkSpyPlotDecodeFunctor functor;
+  functor.Data = data;
+  functor.Tasks = &tasks;
+  vtkSMPTools::For(0, static_cast<vtkIdType>(tasks.size()), functor);
+
+  bool status = true;
+  std::vector<vtkSpyPlotDecodeTask>::iterator iter;
+  for (iter = tasks.begin(); iter != tasks.end(); ++iter)
+    {
+    if (iter->Failed)
+      {
+      vtkErrorWithObjectMacro(self, "Problem RLD decoding "
+                              << (iter->FloatOut ? "float" : "unsigned char")
+                              << " data array " << iter->Var->Name
+                              << " of block " << iter->BlockId
+                              << ". Too much data generated. Excpected: "
+                              << iter->NumValues);
+      status = false;
+      }
+    }
+  tasks.clear();
+  return status;
+}
+}
+
 
 
 //-----------------------------------------------------------------------------
@@ -76,6 +328,7 @@ vtkSpyPlotUniReader::vtkSpyPlotUniReader()
   this->NumberOfCellFields = 0;
   this->HaveInformation = 0;
   this->DownConvertVolumeFraction = 1;
+  this->MapFile = 1;
   this->DataTypeChanged = 0;
   this->GeomTimeStep = -1; // Indicate that geometry will have to be loaded
   this->NeedToCheck = 1; // Indicates non-geometric data needs to be checked
@@ -323,7 +576,18 @@ int vtkSpyPlotUniReader::MakeCurrent()
 
   dump = this->CurrentTimeStep;
   dp = this->DataDumps+dump;
-    
+
+  // The compressed planes of all the fields to load are located first and
+  // then decoded concurrently, right into their arrays. When the file can be
+  // mapped, planes are decoded in place. Otherwise they are read into
+  // arrayBuffer first, and decoded whenever the buffer grows too large.
+  vtkSpyPlotMappedFile mappedFile;
+  bool mapped = this->MapFile && mappedFile.Open(this->FileName);
+  std::vector<vtkSpyPlotDecodeTask> decodeTasks;
+  std::vector<vtkSpyPlotUniReader::Variable*> loadedVariables;
+  vtkTypeInt64 position = -1;
+  arrayBuffer.clear();
+
   for (int fieldCnt = 0; fieldCnt < dp->NumVars; ++ fieldCnt )
     {
     vtkSpyPlotUniReader::Variable* var = dp->Variables + fieldCnt;
@@ -350,8 +614,11 @@ int vtkSpyPlotUniReader::MakeCurrent()
         for ( dataBlock = 0; 
               dataBlock < dp->ActualNumberOfBlocks; ++ dataBlock )
           {
-          var->DataBlocks[dataBlock]->Delete();
-          var->DataBlocks[dataBlock] = 0;
+          if ( var->DataBlocks[dataBlock] )
+            {
+            var->DataBlocks[dataBlock]->Delete();
+            var->DataBlocks[dataBlock] = 0;
+            }
           }
         delete [] var->DataBlocks;
         var->DataBlocks = 0;
@@ -377,6 +644,7 @@ int vtkSpyPlotUniReader::MakeCurrent()
       var->GhostCellsFixed = new int[dp->ActualNumberOfBlocks];
       memset(var->GhostCellsFixed, 0, dp->ActualNumberOfBlocks * sizeof(int));
       vtkDebugMacro( " Allocate DataBlocks: " << var->DataBlocks );
+      loadedVariables.push_back(var);
       blocksExists = 0;
       }
 
@@ -390,7 +658,14 @@ int vtkSpyPlotUniReader::MakeCurrent()
     //vtkDebugMacro( "  Field: " << fieldCnt << " / " << dp->NumVars 
     // << " [" << var->Name << "]" );
     //vtkDebugMacro( "    Jump to: " << dp->SavedVariableOffsets[fieldCnt] );
-    spis.Seek(dp->SavedVariableOffsets[fieldCnt]);
+    if ( mapped )
+      {
+      position = dp->SavedVariableOffsets[fieldCnt];
+      }
+    else
+      {
+      spis.Seek(dp->SavedVariableOffsets[fieldCnt]);
+      }
     int numBytes;
     int block;
     int actualBlockId = 0;
@@ -429,40 +704,77 @@ int vtkSpyPlotUniReader::MakeCurrent()
         for ( zax = 0; zax < bdims[2]; ++ zax )
           { 
           int planeSize = bdims[0] * bdims[1];
-          if ( !spis.ReadInt32s(&numBytes, 1) )
+          vtkTypeInt64 offset;
+          if ( mapped )
             {
-            vtkErrorMacro( "Problem reading the number of bytes" );
-            return 0;
-            }
-          if ( static_cast<int>(arrayBuffer.size()) < numBytes )
-            {
-            arrayBuffer.resize(numBytes);
-            }
-          if ( !spis.ReadString(&*arrayBuffer.begin(), numBytes) )
-            {
-            vtkErrorMacro( "Problem reading the bytes" );
-            return 0;
-            }
-          if ( floatArray )
-            {
-            float* ptr = floatArray->GetPointer(zax * planeSize);
-            if ( !this->RunLengthDataDecode(&*arrayBuffer.begin(), 
-                                            numBytes, ptr, planeSize) )
+            if ( position + 4 > mappedFile.GetSize() )
+              {
+              vtkErrorMacro( "Problem reading the number of bytes" );
+              vtkSpyPlotReleaseVariables(loadedVariables,
+                                         dp->ActualNumberOfBlocks, dataArray);
+              return 0;
+              }
+            memcpy(&numBytes, mappedFile.GetData() + position, 4);
+            vtkByteSwap::SwapBE(&numBytes);
+            position += 4;
+            if ( numBytes < 0 || position + numBytes > mappedFile.GetSize() )
               {
-              vtkErrorMacro( "Problem RLD decoding float data array" );
+              vtkErrorMacro( "Problem reading the bytes" );
+              vtkSpyPlotReleaseVariables(loadedVariables,
+                                         dp->ActualNumberOfBlocks, dataArray);
               return 0;
               }
+            offset = position;
+            position += numBytes;
             }
-          if ( unsignedCharArray )
+          else
             {
-            unsigned char* ptr = unsignedCharArray->GetPointer(zax * planeSize);
-            if ( !this->RunLengthDataDecode(&*arrayBuffer.begin(), numBytes,
-                                            ptr, planeSize) )
+            if ( !spis.ReadInt32s(&numBytes, 1) || numBytes < 0 )
+              {
+              vtkErrorMacro( "Problem reading the number of bytes" );
+              vtkSpyPlotReleaseVariables(loadedVariables,
+                                         dp->ActualNumberOfBlocks, dataArray);
+              return 0;
+              }
+            if ( !arrayBuffer.empty() &&
+                 arrayBuffer.size() + numBytes > vtkSpyPlotMaxBufferedBytes )
+              {
+              if ( !vtkSpyPlotDecodePlanes(this, &arrayBuffer[0],
+                                           decodeTasks) )
+                {
+                vtkSpyPlotReleaseVariables(loadedVariables,
+                                           dp->ActualNumberOfBlocks,
+                                           dataArray);
+                return 0;
+                }
+              arrayBuffer.clear();
+              }
+            offset = static_cast<vtkTypeInt64>(arrayBuffer.size());
+            arrayBuffer.resize(arrayBuffer.size() + numBytes);
+            if ( numBytes > 0 &&
+                 !spis.ReadString(&arrayBuffer[offset], numBytes) )
               {
-              vtkErrorMacro( "Problem RLD decoding unsigned char data array" );
+              vtkErrorMacro( "Problem reading the bytes" );
+              vtkSpyPlotReleaseVariables(loadedVariables,
+                                         dp->ActualNumberOfBlocks, dataArray);
               return 0;
               }
             }
+          if ( dataArray )
+            {
+            vtkSpyPlotDecodeTask task;
+            task.Offset = offset;
+            task.NumBytes = numBytes;
+            task.FloatOut = floatArray ?
+              floatArray->GetPointer(zax * planeSize) : 0;
+            task.UnsignedCharOut = unsignedCharArray ?
+              unsignedCharArray->GetPointer(zax * planeSize) : 0;
+            task.NumValues = planeSize;
+            task.Var = var;
+            task.BlockId = actualBlockId;
+            task.Failed = false;
+            decodeTasks.push_back(task);
+            }
           }
         if ( dataArray )
           {
@@ -476,6 +788,22 @@ int vtkSpyPlotUniReader::MakeCurrent()
       }
     }
 
+  // Do not keep arrays that could not be decoded.
+  const unsigned char* data = mapped ? mappedFile.GetData() :
+    (arrayBuffer.empty() ? 0 : &arrayBuffer[0]);
+  if ( !vtkSpyPlotDecodePlanes(this, data, decodeTasks) )
+    {
+    vtkSpyPlotReleaseVariables(loadedVariables, dp->ActualNumberOfBlocks, 0);
+    return 0;
+    }
+  arrayBuffer.clear();
+
+  // Markers are read from where the last field ends.
+  if ( mapped && position >= 0 )
+    {
+    spis.Seek(position);
+    }
+
   if (blocksUpdated && needMarkers)
     {
     if (this->ReadMarkerDumps(&spis) == 0) 
@@ -692,7 +1020,7 @@ template<class t>
 int vtkSpyPlotUniReaderRunLengthDataDecode(vtkSpyPlotUniReader* self, 
                                            const unsigned char* in, 
                                            int inSize, t* out, 
-                                           int outSize, t scale=1)
+                                           int outSize, t scale)
 {
   int outIndex = 0, inIndex = 0;
 
@@ -716,9 +1044,12 @@ int vtkSpyPlotUniReaderRunLengthDataDecode(vtkSpyPlotUniReader* self,
         {
         if ( outIndex >= outSize )
           {
-          vtkErrorWithObjectMacro(self, "Problem doing RLD decode. "
-                                  << "Too much data generated. Excpected: " 
-                                  << outSize );
+          if ( self )
+            {
+            vtkErrorWithObjectMacro(self, "Problem doing RLD decode. "
+                                    << "Too much data generated. Excpected: " 
+                                    << outSize );
+            }
           return 0;
           }
         out[outIndex] = static_cast<t>(val*scale);
@@ -733,9 +1064,12 @@ int vtkSpyPlotUniReaderRunLengthDataDecode(vtkSpyPlotUniReader* self,
         {
         if ( outIndex >= outSize )
           {
-          vtkErrorWithObjectMacro(self, "Problem doing RLD decode. "
-                                  << "Too much data generated. Excpected: " 
-                                  << outSize );
+          if ( self )
+            {
+            vtkErrorWithObjectMacro(self, "Problem doing RLD decode. "
+                                    << "Too much data generated. Excpected: " 
+                                    << outSize );
+            }
           return 0;
           }
         float val;
@@ -1394,6 +1728,7 @@ void vtkSpyPlotUniReader::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "DataTypeChanged: " << this->DataTypeChanged << endl;
   os << indent << "NumberOfCellFields: " << this->NumberOfCellFields << endl;
   os << indent << "NeedToCheck: " << this->NeedToCheck << endl;
+  os << indent << "MapFile: " << this->MapFile << endl;
 }
 
 
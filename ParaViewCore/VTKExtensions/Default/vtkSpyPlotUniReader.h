@@ -25,6 +25,10 @@ PURPOSE.  See the above copyright notice for more information.
 // class.  Note the grids in the reader may have bad ghost cells that will
 // need to be taken into consideration in terms of both geometry and 
 // cell data
+//
+// Cell data is memory mapped when possible and the run-length encoded planes
+// of all the blocks are decoded concurrently (using vtkSMPTools) right into
+// the cell arrays.
 //-----------------------------------------------------------------------------
 //=============================================================================
 #ifndef __vtkSpyPlotUniReader_h
@@ -210,6 +214,12 @@ public:
   vtkSetMacro(DataTypeChanged, int);
   void SetDownConvertVolumeFraction(int vf);
 
+  // Description:
+  // Set and get whether cell data is decoded from a memory mapping of the
+  // file when possible (the default), or read through the file stream.
+  vtkSetMacro(MapFile, int);
+  vtkGetMacro(MapFile, int);
+
 protected:
   vtkSpyPlotUniReader();
   ~vtkSpyPlotUniReader();
@@ -289,6 +299,7 @@ private:
 
   int DataTypeChanged;
   int DownConvertVolumeFraction;
+  int MapFile;
 
   int NumberOfCellFields;
   
@@ -0,0 +1,212 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVGeometryFilterTopologyCache.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Extracts the surface of a time series over a static mesh with and without
+// reusing the surface topology. Each output is edited in place afterwards,
+// as a downstream filter could, which must not affect the next time steps.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPVGeometryFilter.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+// A 2x2x1 block of hexahedra. Only the points and attributes change with
+// the time step, the cell arrays are shared by all steps.
+vtkSmartPointer<vtkUnstructuredGrid> NewTimeStep(int step,
+  vtkUnsignedCharArray* types, vtkIdTypeArray* locations, vtkCellArray* cells)
+{
+  vtkSmartPointer<vtkUnstructuredGrid> grid =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkDoubleArray> temperature;
+  temperature->SetName("temperature");
+  for (int k = 0; k < 2; k++)
+    {
+    for (int j = 0; j < 3; j++)
+      {
+      for (int i = 0; i < 3; i++)
+        {
+        vtkIdType id = points->InsertNextPoint(i + 0.1 * step, j, k);
+        temperature->InsertNextValue(100 * step + id);
+        }
+      }
+    }
+  grid->SetPoints(points.GetPointer());
+  grid->GetPointData()->AddArray(temperature.GetPointer());
+  grid->SetCells(types, locations, cells);
+
+  vtkNew<vtkDoubleArray> pressure;
+  pressure->SetName("pressure");
+  for (vtkIdType cc = 0; cc < cells->GetNumberOfCells(); cc++)
+    {
+    pressure->InsertNextValue(1000 * step + cc);
+    }
+  grid->GetCellData()->AddArray(pressure.GetPointer());
+  return grid;
+}
+
+bool CompareArrays(vtkDataArray* expected, vtkDataArray* actual,
+                   const char* what)
+{
+  if (!expected || !actual ||
+      expected->GetNumberOfTuples() != actual->GetNumberOfTuples() ||
+      expected->GetNumberOfComponents() != actual->GetNumberOfComponents())
+    {
+    std::cerr << "Mismatch in size of " << what << "." << std::endl;
+    return false;
+    }
+  for (vtkIdType i = 0; i < expected->GetNumberOfTuples(); i++)
+    {
+    for (int c = 0; c < expected->GetNumberOfComponents(); c++)
+      {
+      if (expected->GetComponent(i, c) != actual->GetComponent(i, c))
+        {
+        std::cerr << "Mismatch in " << what << " at tuple " << i << "."
+                  << std::endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+bool Compare(vtkPolyData* expected, vtkPolyData* actual)
+{
+  if (expected->GetNumberOfPolys() == 0 ||
+      expected->GetNumberOfPolys() != actual->GetNumberOfPolys() ||
+      !CompareArrays(expected->GetPolys()->GetData(),
+                     actual->GetPolys()->GetData(), "polygons") ||
+      !CompareArrays(expected->GetPoints()->GetData(),
+                     actual->GetPoints()->GetData(), "coordinates"))
+    {
+    return false;
+    }
+  const char* pointArrays[2] = { "temperature", "vtkOriginalPointIds" };
+  for (int a = 0; a < 2; a++)
+    {
+    if (!CompareArrays(expected->GetPointData()->GetArray(pointArrays[a]),
+                       actual->GetPointData()->GetArray(pointArrays[a]),
+                       pointArrays[a]))
+      {
+      return false;
+      }
+    }
+  const char* cellArrays[2] = { "pressure", "vtkOriginalCellIds" };
+  for (int a = 0; a < 2; a++)
+    {
+    if (!CompareArrays(expected->GetCellData()->GetArray(cellArrays[a]),
+                       actual->GetCellData()->GetArray(cellArrays[a]),
+                       cellArrays[a]))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+// Scribbles over the cells and original ids of \c output, without marking
+// them modified.
+void EditInPlace(vtkPolyData* output)
+{
+  vtkIdType* polys = output->GetPolys()->GetPointer();
+  vtkIdType size = output->GetPolys()->GetNumberOfConnectivityEntries();
+  for (vtkIdType cc = 0; cc < size; cc += polys[cc] + 1)
+    {
+    for (vtkIdType pt = 1; pt <= polys[cc]; pt++)
+      {
+      polys[cc + pt] = 0;
+      }
+    }
+  vtkIdTypeArray* ids = vtkIdTypeArray::SafeDownCast(
+    output->GetCellData()->GetArray("vtkOriginalCellIds"));
+  for (vtkIdType cc = 0; ids && cc < ids->GetNumberOfTuples(); cc++)
+    {
+    ids->GetPointer(0)[cc] = -1;
+    }
+  ids = vtkIdTypeArray::SafeDownCast(
+    output->GetPointData()->GetArray("vtkOriginalPointIds"));
+  for (vtkIdType cc = 0; ids && cc < ids->GetNumberOfTuples(); cc++)
+    {
+    ids->GetPointer(0)[cc] = -1;
+    }
+}
+}
+
+int TestPVGeometryFilterTopologyCache(int, char*[])
+{
+  vtkNew<vtkCellArray> cells;
+  vtkNew<vtkUnsignedCharArray> types;
+  vtkNew<vtkIdTypeArray> locations;
+  for (int j = 0; j < 2; j++)
+    {
+    for (int i = 0; i < 2; i++)
+      {
+      vtkIdType p = i + 3 * j;
+      vtkIdType hexa[8] = { p, p + 1, p + 4, p + 3,
+                            p + 9, p + 10, p + 13, p + 12 };
+      cells->InsertNextCell(8, hexa);
+      locations->InsertNextValue(cells->GetInsertLocation(8));
+      types->InsertNextValue(VTK_HEXAHEDRON);
+      }
+    }
+
+  vtkNew<vtkPVGeometryFilter> cached;
+  vtkNew<vtkPVGeometryFilter> reference;
+  vtkPVGeometryFilter* filters[2] = { cached.GetPointer(),
+                                      reference.GetPointer() };
+  for (int f = 0; f < 2; f++)
+    {
+    filters[f]->SetUseOutline(0);
+    filters[f]->SetPassThroughCellIds(1);
+    filters[f]->SetPassThroughPointIds(1);
+    }
+  cached->SetReuseSurfaceTopology(true);
+  reference->SetReuseSurfaceTopology(false);
+
+  for (int step = 0; step < 4; step++)
+    {
+    vtkSmartPointer<vtkUnstructuredGrid> grid = NewTimeStep(step,
+      types.GetPointer(), locations.GetPointer(), cells.GetPointer());
+    for (int f = 0; f < 2; f++)
+      {
+      filters[f]->SetInputData(grid);
+      filters[f]->Update();
+      }
+    vtkPolyData* actual = vtkPolyData::SafeDownCast(cached->GetOutput());
+    vtkPolyData* expected = vtkPolyData::SafeDownCast(reference->GetOutput());
+    if (!actual || !expected || !Compare(expected, actual))
+      {
+      std::cerr << "ERROR: Surfaces differ at time step " << step << "."
+                << std::endl;
+      return EXIT_FAILURE;
+      }
+    EditInPlace(actual);
+    }
+  return EXIT_SUCCESS;
+}
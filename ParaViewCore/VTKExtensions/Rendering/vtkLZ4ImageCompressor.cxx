@@ -0,0 +1,255 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkLZ4ImageCompressor.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLZ4ImageCompressor.h"
+
+#include "vtkObjectFactory.h"
+
+#include <string.h>
+
+vtkStandardNewMacro(vtkLZ4ImageCompressor);
+
+namespace
+{
+  // LZ4 block format constants.
+  const int MIN_MATCH = 4;
+  const int LAST_LITERALS = 5;     // the last 5 bytes are always literals
+  const int MATCH_FIND_LIMIT = 12; // no match may start in the last 12 bytes
+  const int MAX_DISTANCE = 65535;
+  const int HASH_LOG = 12;
+
+  inline vtkTypeUInt32 vtkLZ4Read32(const unsigned char* ptr)
+    {
+    vtkTypeUInt32 value;
+    memcpy(&value, ptr, 4);
+    return value;
+    }
+
+  inline int vtkLZ4Hash(vtkTypeUInt32 sequence)
+    {
+    return static_cast<int>((sequence * 2654435761U) >> (32 - HASH_LOG));
+    }
+
+  // Writes a length using the LZ4 255-continuation encoding for the part that
+  // exceeds the 4 bit field of the token.
+  inline unsigned char* vtkLZ4WriteLength(unsigned char* op, vtkIdType length)
+    {
+    for (; length >= 255; length -= 255)
+      {
+      *op++ = 255;
+      }
+    *op++ = static_cast<unsigned char>(length);
+    return op;
+    }
+
+  inline unsigned char* vtkLZ4WriteLiterals(unsigned char* op,
+    const unsigned char* literals, vtkIdType numLiterals,
+    unsigned char*& token)
+    {
+    token = op++;
+    if (numLiterals >= 15)
+      {
+      *token = 15 << 4;
+      op = vtkLZ4WriteLength(op, numLiterals - 15);
+      }
+    else
+      {
+      *token = static_cast<unsigned char>(numLiterals << 4);
+      }
+    memcpy(op, literals, numLiterals);
+    return op + numLiterals;
+    }
+}
+
+//-----------------------------------------------------------------------------
+vtkLZ4ImageCompressor::vtkLZ4ImageCompressor()
+{
+}
+
+//-----------------------------------------------------------------------------
+vtkLZ4ImageCompressor::~vtkLZ4ImageCompressor()
+{
+}
+
+//-----------------------------------------------------------------------------
+vtkIdType vtkLZ4ImageCompressor::GetMaximumCompressedTileSize(
+  vtkIdType inSize) const
+{
+  return inSize + inSize / 255 + 16;
+}
+
+//-----------------------------------------------------------------------------
+vtkIdType vtkLZ4ImageCompressor::CompressTile(
+  const unsigned char* in, vtkIdType inSize, unsigned char* out) const
+{
+  const unsigned char* ip = in;
+  const unsigned char* anchor = in;
+  const unsigned char* const iend = in + inSize;
+  unsigned char* op = out;
+  unsigned char* token = NULL;
+
+  if (inSize > MATCH_FIND_LIMIT + 1)
+    {
+    const unsigned char* const mflimit = iend - MATCH_FIND_LIMIT;
+    const unsigned char* const matchlimit = iend - LAST_LITERALS;
+
+    // positions of the last occurrence of each hashed 4 byte sequence.
+    vtkTypeUInt32 table[1 << HASH_LOG];
+    memset(table, 0, sizeof(table));
+
+    ip++;
+    int searchCount = 0;
+    while (ip < mflimit)
+      {
+      const vtkTypeUInt32 sequence = vtkLZ4Read32(ip);
+      const int hash = vtkLZ4Hash(sequence);
+      const unsigned char* ref = in + table[hash];
+      table[hash] = static_cast<vtkTypeUInt32>(ip - in);
+      if (ip - ref > MAX_DISTANCE || ref == ip ||
+        vtkLZ4Read32(ref) != sequence)
+        {
+        // skip faster over incompressible data.
+        ip += 1 + (searchCount++ >> 6);
+        continue;
+        }
+      searchCount = 0;
+
+      // extend the match backwards.
+      while (ip > anchor && ref > in && ip[-1] == ref[-1])
+        {
+        ip--;
+        ref--;
+        }
+
+      // extend the match forward.
+      const unsigned char* mp = ip + MIN_MATCH;
+      const unsigned char* rp = ref + MIN_MATCH;
+      while (mp < matchlimit && *mp == *rp)
+        {
+        mp++;
+        rp++;
+        }
+      const vtkIdType matchLength = (mp - ip) - MIN_MATCH;
+
+      op = vtkLZ4WriteLiterals(op, anchor, ip - anchor, token);
+      const int offset = static_cast<int>(ip - ref);
+      *op++ = static_cast<unsigned char>(offset & 0xff);
+      *op++ = static_cast<unsigned char>(offset >> 8);
+      if (matchLength >= 15)
+        {
+        *token |= 15;
+        op = vtkLZ4WriteLength(op, matchLength - 15);
+        }
+      else
+        {
+        *token |= static_cast<unsigned char>(matchLength);
+        }
+
+      ip = mp;
+      anchor = ip;
+      }
+    }
+
+  // last literals.
+  op = vtkLZ4WriteLiterals(op, anchor, iend - anchor, token);
+  return op - out;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkLZ4ImageCompressor::DecompressTile(const unsigned char* in,
+  vtkIdType inSize, unsigned char* out, vtkIdType outSize) const
+{
+  const unsigned char* ip = in;
+  const unsigned char* const iend = in + inSize;
+  unsigned char* op = out;
+  unsigned char* const oend = out + outSize;
+
+  while (ip < iend)
+    {
+    const unsigned char token = *ip++;
+
+    // literals.
+    vtkIdType length = token >> 4;
+    if (length == 15)
+      {
+      unsigned char s;
+      do
+        {
+        if (ip >= iend)
+          {
+          return false;
+          }
+        s = *ip++;
+        length += s;
+        } while (s == 255);
+      }
+    if (ip + length > iend || op + length > oend)
+      {
+      return false;
+      }
+    memcpy(op, ip, length);
+    ip += length;
+    op += length;
+    if (ip >= iend)
+      {
+      // the last sequence has no match.
+      break;
+      }
+
+    // match.
+    if (ip + 2 > iend)
+      {
+      return false;
+      }
+    const vtkIdType offset = ip[0] | (ip[1] << 8);
+    ip += 2;
+    if (offset == 0 || offset > op - out)
+      {
+      return false;
+      }
+    length = token & 15;
+    if (length == 15)
+      {
+      unsigned char s;
+      do
+        {
+        if (ip >= iend)
+          {
+          return false;
+          }
+        s = *ip++;
+        length += s;
+        } while (s == 255);
+      }
+    length += MIN_MATCH;
+    if (op + length > oend)
+      {
+      return false;
+      }
+    // matches may overlap the output, copy byte by byte.
+    const unsigned char* ref = op - offset;
+    for (vtkIdType cc=0; cc < length; cc++)
+      {
+      op[cc] = ref[cc];
+      }
+    op += length;
+    }
+  return op == oend;
+}
+
+//-----------------------------------------------------------------------------
+void vtkLZ4ImageCompressor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+}
@@ -0,0 +1,54 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkLZ4ImageCompressor.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkLZ4ImageCompressor - Fast loss-less image compressor using the
+// LZ4 block format.
+// .SECTION Description
+// vtkLZ4ImageCompressor compresses each tile with a single pass LZ77 coder
+// producing LZ4 compatible blocks. It trades compression ratio for speed: it
+// is several times faster than zlib at its fastest level, which makes it a
+// good fit for interactive remote rendering over fast networks. Combine it
+// with DeltaMode to get good ratios when consecutive frames are similar.
+// .SECTION See Also
+// vtkTiledImageCompressor
+
+#ifndef __vtkLZ4ImageCompressor_h
+#define __vtkLZ4ImageCompressor_h
+
+#include "vtkTiledImageCompressor.h"
+#include "vtkPVVTKExtensionsRenderingModule.h" // needed for export macro
+
+class VTKPVVTKEXTENSIONSRENDERING_EXPORT vtkLZ4ImageCompressor : public vtkTiledImageCompressor
+{
+public:
+  static vtkLZ4ImageCompressor* New();
+  vtkTypeMacro(vtkLZ4ImageCompressor, vtkTiledImageCompressor);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+protected:
+  vtkLZ4ImageCompressor();
+  virtual ~vtkLZ4ImageCompressor();
+
+  virtual vtkIdType CompressTile(const unsigned char* in, vtkIdType inSize,
+    unsigned char* out) const;
+  virtual bool DecompressTile(const unsigned char* in, vtkIdType inSize,
+    unsigned char* out, vtkIdType outSize) const;
+  virtual vtkIdType GetMaximumCompressedTileSize(vtkIdType inSize) const;
+
+private:
+  vtkLZ4ImageCompressor(const vtkLZ4ImageCompressor&); // Not implemented.
+  void operator=(const vtkLZ4ImageCompressor&); // Not implemented.
+};
+
+#endif
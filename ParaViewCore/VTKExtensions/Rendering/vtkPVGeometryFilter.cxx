@@ -39,6 +39,7 @@
 #include "vtkHyperOctreeSurfaceFilter.h"
 #include "vtkHyperTreeGrid.h"
 #include "vtkHyperTreeGridGeometry.h"
+#include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationIntegerVectorKey.h"
@@ -47,10 +48,12 @@
 #include "vtkMultiBlockDataSet.h"
 #include "vtkMultiPieceDataSet.h"
 #include "vtkMultiProcessController.h"
+#include "vtkMutexLock.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkOutlineSource.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
 #include "vtkPVRecoverGeometryWireframe.h"
@@ -59,6 +62,8 @@
 #include "vtkRectilinearGridOutlineFilter.h"
 #include "vtkSelectionNode.h"
 #include "vtkSmartPointer.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStripper.h"
 #include "vtkStructuredGrid.h"
@@ -70,6 +75,7 @@
 #include "vtkUnsignedIntArray.h"
 #include "vtkUnstructuredGridGeometryFilter.h"
 #include "vtkUnstructuredGrid.h"
+#include "vtkWeakPointer.h"
 
 #include <map>
 #include <vector>
@@ -141,6 +147,157 @@ public:
     }
 };
 
+//----------------------------------------------------------------------------
+// Surfaces extracted from unstructured grids, keyed on the cell array they
+// were extracted from. An entry is valid as long as the cell array, the cell
+// types and the ghost cells it was computed from are alive and unmodified.
+// The weak pointers are only touched with the mutex held, since leaves are
+// processed concurrently.
+class vtkPVGeometryFilter::vtkTopologyCache
+{
+public:
+  struct Key
+    {
+    vtkCellArray* Cells;
+    unsigned long CellsMTime;
+    vtkUnsignedCharArray* Types;
+    unsigned long TypesMTime;
+    vtkDataArray* Ghosts;
+    unsigned long GhostsMTime;
+    vtkIdType NumberOfPoints;
+    int NonlinearSubdivisionLevel;
+
+    Key(vtkUnstructuredGrid* input, int nonlinearSubdivisionLevel)
+      {
+      this->Cells = input->GetCells();
+      this->CellsMTime = this->Cells->GetMTime();
+      this->Types = input->GetCellTypesArray();
+      this->TypesMTime = this->Types->GetMTime();
+      this->Ghosts = input->GetCellData()->GetArray(
+        vtkDataSetAttributes::GhostArrayName());
+      this->GhostsMTime = this->Ghosts? this->Ghosts->GetMTime() : 0;
+      this->NumberOfPoints = input->GetNumberOfPoints();
+      this->NonlinearSubdivisionLevel = nonlinearSubdivisionLevel;
+      }
+
+    bool operator==(const Key& other) const
+      {
+      return this->Cells == other.Cells &&
+        this->CellsMTime == other.CellsMTime &&
+        this->Types == other.Types && this->TypesMTime == other.TypesMTime &&
+        this->Ghosts == other.Ghosts &&
+        this->GhostsMTime == other.GhostsMTime &&
+        this->NumberOfPoints == other.NumberOfPoints &&
+        this->NonlinearSubdivisionLevel == other.NonlinearSubdivisionLevel;
+      }
+    };
+
+  // Cells of the extracted surface (no points, no attributes) and the ids of
+  // the input points and cells its points and cells come from. The cache
+  // owns these arrays: outputs only ever get copies of them, since they may
+  // be edited in place downstream.
+  struct Topology
+    {
+    vtkSmartPointer<vtkPolyData> Surface;
+    vtkSmartPointer<vtkIdTypeArray> PointIds;
+    vtkSmartPointer<vtkIdTypeArray> CellIds;
+    };
+
+  vtkTopologyCache() : Mutex(vtkMutexLock::New()), PruneSize(64)
+    {
+    }
+
+  // Sets the cells of \c dest to new copies of the cells of \c source.
+  static void CopyCells(vtkPolyData* source, vtkPolyData* dest)
+    {
+    vtkNew<vtkCellArray> verts;
+    verts->DeepCopy(source->GetVerts());
+    dest->SetVerts(verts.GetPointer());
+    vtkNew<vtkCellArray> lines;
+    lines->DeepCopy(source->GetLines());
+    dest->SetLines(lines.GetPointer());
+    vtkNew<vtkCellArray> polys;
+    polys->DeepCopy(source->GetPolys());
+    dest->SetPolys(polys.GetPointer());
+    vtkNew<vtkCellArray> strips;
+    strips->DeepCopy(source->GetStrips());
+    dest->SetStrips(strips.GetPointer());
+    }
+
+  static vtkSmartPointer<vtkIdTypeArray> CopyIds(vtkIdTypeArray* ids)
+    {
+    vtkSmartPointer<vtkIdTypeArray> copy =
+      vtkSmartPointer<vtkIdTypeArray>::New();
+    copy->DeepCopy(ids);
+    copy->SetName(ids->GetName());
+    return copy;
+    }
+
+  ~vtkTopologyCache()
+    {
+    this->Mutex->Delete();
+    }
+
+  bool Find(const Key& key, Topology& topology)
+    {
+    this->Mutex->Lock();
+    MapType::iterator iter = this->Entries.find(key.Cells);
+    bool found = (iter != this->Entries.end() &&
+      iter->second.Cells != NULL && iter->second.CacheKey == key);
+    if (found)
+      {
+      topology = iter->second.Value;
+      }
+    this->Mutex->Unlock();
+    return found;
+    }
+
+  void Add(const Key& key, const Topology& topology)
+    {
+    this->Mutex->Lock();
+    Entry& entry = this->Entries.insert(
+      MapType::value_type(key.Cells, Entry(key))).first->second;
+    entry.CacheKey = key;
+    entry.Cells = key.Cells;
+    entry.Value = topology;
+    if (this->Entries.size() >= this->PruneSize)
+      {
+      // Drop the entries whose cell array was released.
+      for (MapType::iterator iter = this->Entries.begin();
+        iter != this->Entries.end();)
+        {
+        if (iter->second.Cells == NULL)
+          {
+          this->Entries.erase(iter++);
+          }
+        else
+          {
+          ++iter;
+          }
+        }
+      this->PruneSize = std::max(static_cast<size_t>(64),
+        2 * this->Entries.size());
+      }
+    this->Mutex->Unlock();
+    }
+
+private:
+  struct Entry
+    {
+    Key CacheKey;
+    vtkWeakPointer<vtkCellArray> Cells;
+    Topology Value;
+
+    Entry(const Key& key) : CacheKey(key)
+      {
+      }
+    };
+  typedef std::map<vtkCellArray*, Entry> MapType;
+  MapType Entries;
+  vtkMutexLock* Mutex;
+  size_t PruneSize;
+};
+
 //----------------------------------------------------------------------------
 vtkPVGeometryFilter::vtkPVGeometryFilter ()
 {
@@ -185,6 +342,9 @@ vtkPVGeometryFilter::vtkPVGeometryFilter ()
 
   this->HideInternalAMRFaces = true;
   this->UseNonOverlappingAMRMetaDataForOutlines = true;
+  this->ExecuteBlocksInParallel = true;
+  this->ReuseSurfaceTopology = true;
+  this->TopologyCache = new vtkTopologyCache();
 }
 
 //----------------------------------------------------------------------------
@@ -219,6 +379,7 @@ vtkPVGeometryFilter::~vtkPVGeometryFilter ()
   this->OutlineSource->Delete();
   this->InternalProgressObserver->Delete();
   this->SetController(0);
+  delete this->TopologyCache;
 }
 
 //----------------------------------------------------------------------------
@@ -877,6 +1038,146 @@ int vtkPVGeometryFilter::RequestAMRData(
   return 1;
 }
 
+//----------------------------------------------------------------------------
+// Extracts the surfaces of a set of leaves concurrently. Leaves that cannot
+// be processed concurrently are left NULL in Outputs.
+class vtkPVGeometryFilter::BlocksFunctor
+{
+  vtkPVGeometryFilter* Self;
+  vtkSMPThreadLocalObject<vtkDataSetSurfaceFilter> SurfaceFilters;
+
+public:
+  const std::vector<vtkDataObject*>* Inputs;
+  std::vector<vtkSmartPointer<vtkPolyData> >* Outputs;
+  const int* WholeExtent;
+
+  BlocksFunctor(vtkPVGeometryFilter* self) : Self(self)
+    {
+    }
+
+  void Initialize()
+    {
+    vtkDataSetSurfaceFilter* surfaceFilter = this->SurfaceFilters.Local();
+    vtkDataSetSurfaceFilter* reference = this->Self->DataSetSurfaceFilter;
+    surfaceFilter->SetPassThroughCellIds(reference->GetPassThroughCellIds());
+    surfaceFilter->SetPassThroughPointIds(reference->GetPassThroughPointIds());
+    surfaceFilter->SetUseStrips(reference->GetUseStrips());
+    surfaceFilter->SetNonlinearSubdivisionLevel(
+      reference->GetNonlinearSubdivisionLevel());
+    }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    vtkDataSetSurfaceFilter* surfaceFilter = this->SurfaceFilters.Local();
+    for (vtkIdType cc = begin; cc < end; ++cc)
+      {
+      vtkDataObject* input = (*this->Inputs)[cc];
+      if (!input)
+        {
+        continue;
+        }
+      vtkSmartPointer<vtkPolyData> output = vtkSmartPointer<vtkPolyData>::New();
+      if (this->Self->ExecuteBlockConcurrently(
+          input, output, surfaceFilter, this->WholeExtent))
+        {
+        this->Self->CleanupOutputData(output, 0);
+        (*this->Outputs)[cc] = output;
+        }
+      }
+    }
+
+  void Reduce()
+    {
+    }
+};
+
+//----------------------------------------------------------------------------
+bool vtkPVGeometryFilter::ExecuteBlockConcurrently(vtkDataObject* input,
+  vtkPolyData* output, vtkDataSetSurfaceFilter* surfaceFilter,
+  const int* wholeExtent)
+{
+  // Outlines, polydata strips, triangulation and nonlinear subdivision use
+  // internal pipelines, which can only be executed from the main thread.
+  if (this->UseOutline || this->Triangulate)
+    {
+    return false;
+    }
+
+  if (vtkImageData* id = vtkImageData::SafeDownCast(input))
+    {
+    if (id->GetNumberOfCells() > 0)
+      {
+      surfaceFilter->StructuredExecute(id, output, id->GetExtent(),
+        id->GetExtent());
+      }
+    return true;
+    }
+
+  if (vtkStructuredGrid* sg = vtkStructuredGrid::SafeDownCast(input))
+    {
+    if (sg->GetNumberOfCells() > 0)
+      {
+      if (sg->HasAnyBlankCells())
+        {
+        surfaceFilter->DataSetExecute(sg, output);
+        }
+      else
+        {
+        surfaceFilter->StructuredExecute(sg, output, sg->GetExtent(),
+          const_cast<int*>(wholeExtent));
+        }
+      }
+    return true;
+    }
+
+  if (vtkRectilinearGrid* rg = vtkRectilinearGrid::SafeDownCast(input))
+    {
+    if (rg->GetNumberOfCells() > 0)
+      {
+      surfaceFilter->StructuredExecute(rg, output, rg->GetExtent(),
+        const_cast<int*>(wholeExtent));
+      }
+    return true;
+    }
+
+  if (vtkUnstructuredGridBase* ug = vtkUnstructuredGridBase::SafeDownCast(input))
+    {
+    if (this->NonlinearSubdivisionLevel > 0)
+      {
+      vtkSmartPointer<vtkCellIterator> cellIter =
+          vtkSmartPointer<vtkCellIterator>::Take(ug->NewCellIterator());
+      for (cellIter->InitTraversal(); !cellIter->IsDoneWithTraversal();
+           cellIter->GoToNextCell())
+        {
+        if (!vtkCellTypes::IsLinear(cellIter->GetCellType()))
+          {
+          return false;
+          }
+        }
+      }
+    if (ug->GetNumberOfCells() > 0)
+      {
+      vtkSmartPointer<vtkUnstructuredGridBase> inputClone =
+          vtkSmartPointer<vtkUnstructuredGridBase>::Take(ug->NewInstance());
+      inputClone->ShallowCopy(ug);
+      this->ExtractUnstructuredGridSurface(surfaceFilter, inputClone, output);
+      }
+    return true;
+    }
+
+  if (vtkPolyData* pd = vtkPolyData::SafeDownCast(input))
+    {
+    if (this->UseStrips)
+      {
+      return false;
+      }
+    this->PolyDataPassThrough(pd, output);
+    return true;
+    }
+
+  return false;
+}
+
 //----------------------------------------------------------------------------
 int vtkPVGeometryFilter::RequestCompositeData(vtkInformation*,
                                               vtkInformationVector** inputVector,
@@ -919,14 +1220,58 @@ int vtkPVGeometryFilter::RequestCompositeData(vtkInformation*,
   non_null_leaves.reserve(totNumBlocks); //just an estimate.
   int* wholeExtent = vtkStreamingDemandDrivenPipeline::GetWholeExtent(
     inputVector[0]->GetInformationObject(0));
+  // Extract the surfaces of the leaves that allow it concurrently first. A
+  // dataset appearing more than once in the tree is processed concurrently
+  // only once since VTK datasets are not safe to traverse from several
+  // threads.
+  std::vector<vtkSmartPointer<vtkPolyData> > concurrentOutputs;
+  if (this->ExecuteBlocksInParallel && totNumBlocks > 1)
+    {
+    std::vector<vtkDataObject*> blocks;
+    blocks.reserve(totNumBlocks);
+    std::set<vtkDataObject*> seen;
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+      {
+      vtkDataObject* block = iter->GetCurrentDataObject();
+      blocks.push_back(seen.insert(block).second? block : NULL);
+      }
+    concurrentOutputs.resize(blocks.size());
+
+    BlocksFunctor functor(this);
+    functor.Inputs = &blocks;
+    functor.Outputs = &concurrentOutputs;
+    functor.WholeExtent = wholeExtent;
+    if (!this->UseOutline)
+      {
+      this->OutlineFlag = 0;
+      }
+
+    // Deferred garbage collection keeps a global, unsynchronized, list of
+    // objects; suspend it while worker threads create and release objects.
+    vtkGarbageCollector::DeferredCollectionPop();
+    vtkSMPTools::For(0, static_cast<vtkIdType>(blocks.size()), functor);
+    vtkGarbageCollector::DeferredCollectionPush();
+    }
+
   int numInputs = 0;
   for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
     {
     vtkDataObject* block = iter->GetCurrentDataObject();
 
-    vtkPolyData* tmpOut = vtkPolyData::New();
-    this->ExecuteBlock(block, tmpOut, 0, 0, 1, 0, wholeExtent);
-    this->CleanupOutputData(tmpOut, 0);
+    vtkPolyData* tmpOut;
+    if (static_cast<size_t>(numInputs) < concurrentOutputs.size() &&
+      concurrentOutputs[numInputs])
+      {
+      tmpOut = concurrentOutputs[numInputs];
+      tmpOut->Register(NULL);
+      concurrentOutputs[numInputs] = NULL;
+      }
+    else
+      {
+      tmpOut = vtkPolyData::New();
+      this->ExecuteBlock(block, tmpOut, 0, 0, 1, 0, wholeExtent);
+      this->CleanupOutputData(tmpOut, 0);
+      }
     //skip empty nodes.
     if (tmpOut->GetNumberOfPoints() > 0)
       {
@@ -1372,6 +1717,119 @@ void vtkPVGeometryFilter::RectilinearGridExecute(vtkRectilinearGrid* input,
   output->CopyStructure(outline->GetOutput());
 }
 
+//----------------------------------------------------------------------------
+void vtkPVGeometryFilter::ExtractUnstructuredGridSurface(
+  vtkDataSetSurfaceFilter* surfaceFilter, vtkUnstructuredGridBase* input,
+  vtkPolyData* output)
+{
+  vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(input);
+  const char* cellIdsName = surfaceFilter->GetOriginalCellIdsName();
+  const char* pointIdsName = surfaceFilter->GetOriginalPointIdsName();
+  if (!this->ReuseSurfaceTopology || !ug || !ug->GetCells() ||
+    !ug->GetCellTypesArray() || !ug->GetPoints() ||
+    ug->GetCellData()->GetAbstractArray(cellIdsName) ||
+    ug->GetPointData()->GetAbstractArray(pointIdsName))
+    {
+    surfaceFilter->UnstructuredGridExecute(input, output);
+    return;
+    }
+
+  vtkTopologyCache::Key key(ug, surfaceFilter->GetNonlinearSubdivisionLevel());
+  vtkTopologyCache::Topology entry;
+  if (!this->TopologyCache->Find(key, entry))
+    {
+    // Extract the surface, forcing the original ids that map it back to the
+    // input so that it can be cached.
+    int passThroughCellIds = surfaceFilter->GetPassThroughCellIds();
+    int passThroughPointIds = surfaceFilter->GetPassThroughPointIds();
+    surfaceFilter->PassThroughCellIdsOn();
+    surfaceFilter->PassThroughPointIdsOn();
+    surfaceFilter->UnstructuredGridExecute(input, output);
+    surfaceFilter->SetPassThroughCellIds(passThroughCellIds);
+    surfaceFilter->SetPassThroughPointIds(passThroughPointIds);
+
+    vtkIdTypeArray* cellIds = vtkIdTypeArray::SafeDownCast(
+      output->GetCellData()->GetArray(cellIdsName));
+    vtkIdTypeArray* pointIds = vtkIdTypeArray::SafeDownCast(
+      output->GetPointData()->GetArray(pointIdsName));
+
+    // The surface can only be rebuilt from the input if every output point
+    // is an input point.
+    bool cacheable = (cellIds != NULL && pointIds != NULL);
+    for (vtkIdType cc = 0, max = cacheable? pointIds->GetNumberOfTuples() : 0;
+      cc < max; ++cc)
+      {
+      if (pointIds->GetValue(cc) < 0)
+        {
+        cacheable = false;
+        break;
+        }
+      }
+    if (cacheable)
+      {
+      entry.Surface = vtkSmartPointer<vtkPolyData>::New();
+      vtkTopologyCache::CopyCells(output, entry.Surface);
+      entry.CellIds = vtkTopologyCache::CopyIds(cellIds);
+      entry.PointIds = vtkTopologyCache::CopyIds(pointIds);
+      this->TopologyCache->Add(key, entry);
+      }
+
+    if (!passThroughCellIds)
+      {
+      output->GetCellData()->RemoveArray(cellIdsName);
+      }
+    if (!passThroughPointIds)
+      {
+      output->GetPointData()->RemoveArray(pointIdsName);
+      }
+    return;
+    }
+
+  // Same connectivity as a previous extraction: gather the new points and
+  // attributes through the cached ids.
+  const vtkIdType* pointIds = entry.PointIds->GetPointer(0);
+  vtkIdType numPts = entry.PointIds->GetNumberOfTuples();
+  vtkPoints* inPoints = ug->GetPoints();
+  vtkNew<vtkPoints> outPoints;
+  outPoints->SetDataType(inPoints->GetDataType());
+  outPoints->SetNumberOfPoints(numPts);
+  vtkDataArray* inCoords = inPoints->GetData();
+  vtkDataArray* outCoords = outPoints->GetData();
+  vtkPointData* inPD = ug->GetPointData();
+  vtkPointData* outPD = output->GetPointData();
+  outPD->Initialize();
+  outPD->CopyGlobalIdsOn();
+  outPD->CopyAllocate(inPD, numPts);
+  for (vtkIdType cc = 0; cc < numPts; ++cc)
+    {
+    outCoords->SetTuple(cc, pointIds[cc], inCoords);
+    outPD->CopyData(inPD, pointIds[cc], cc);
+    }
+  output->SetPoints(outPoints.GetPointer());
+
+  const vtkIdType* cellIds = entry.CellIds->GetPointer(0);
+  vtkIdType numCells = entry.CellIds->GetNumberOfTuples();
+  vtkCellData* inCD = ug->GetCellData();
+  vtkCellData* outCD = output->GetCellData();
+  outCD->Initialize();
+  outCD->CopyGlobalIdsOn();
+  outCD->CopyAllocate(inCD, numCells);
+  for (vtkIdType cc = 0; cc < numCells; ++cc)
+    {
+    outCD->CopyData(inCD, cellIds[cc], cc);
+    }
+
+  vtkTopologyCache::CopyCells(entry.Surface, output);
+  if (surfaceFilter->GetPassThroughCellIds())
+    {
+    outCD->AddArray(vtkTopologyCache::CopyIds(entry.CellIds));
+    }
+  if (surfaceFilter->GetPassThroughPointIds())
+    {
+    outPD->AddArray(vtkTopologyCache::CopyIds(entry.PointIds));
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkPVGeometryFilter::UnstructuredGridExecute(
   vtkUnstructuredGridBase* input, vtkPolyData* output, int doCommunicate)
@@ -1472,7 +1930,15 @@ void vtkPVGeometryFilter::UnstructuredGridExecute(
 
     if (input->GetNumberOfCells() > 0)
       {
-      this->DataSetSurfaceFilter->UnstructuredGridExecute(input, output);
+      if (handleSubdivision)
+        {
+        this->DataSetSurfaceFilter->UnstructuredGridExecute(input, output);
+        }
+      else
+        {
+        this->ExtractUnstructuredGridSurface(
+          this->DataSetSurfaceFilter, input, output);
+        }
       }
 
     if (this->Triangulate && (output->GetNumberOfPolys() > 0))
@@ -1581,46 +2047,7 @@ void vtkPVGeometryFilter::PolyDataExecute(
       }
     else
       {
-      output->ShallowCopy(input);
-      if (this->PassThroughCellIds)
-        {
-        vtkNew<vtkIdTypeArray> originalCellIds;
-        originalCellIds->SetName("vtkOriginalCellIds");
-        originalCellIds->SetNumberOfComponents(1);
-        vtkNew<vtkIdTypeArray> originalFaceIds;
-        originalFaceIds->SetName(vtkPVRecoverGeometryWireframe::ORIGINAL_FACE_IDS());
-        originalFaceIds->SetNumberOfComponents(1);
-        vtkCellData *outputCD = output->GetCellData();
-        outputCD->AddArray(originalCellIds.Get());
-        if (this->Triangulate)
-          {
-          outputCD->AddArray(originalFaceIds.Get());
-          }
-        vtkIdType numTup = output->GetNumberOfCells();
-        originalCellIds->SetNumberOfValues(numTup);
-        originalFaceIds->SetNumberOfValues(numTup);
-        for (vtkIdType cId = 0; cId < numTup; cId++)
-          {
-          originalCellIds->SetValue(cId, cId);
-          originalFaceIds->SetValue(cId, cId);
-          }
-        }
-      if (this->PassThroughPointIds)
-        {
-        vtkNew<vtkIdTypeArray> originalPointIds;
-        originalPointIds->SetName("vtkOriginalPointIds");
-        originalPointIds->SetNumberOfComponents(1);
-        vtkPointData *outputPD = output->GetPointData();
-        outputPD->AddArray(originalPointIds.Get());
-        vtkIdType numTup = output->GetNumberOfPoints();
-        originalPointIds->SetNumberOfValues(numTup);
-        for (vtkIdType pId = 0; pId < numTup; pId++)
-          {
-          originalPointIds->SetValue(pId, pId);
-          }
-        }
-
-      output->RemoveGhostCells();
+      this->PolyDataPassThrough(input, output);
 
       if (this->Triangulate)
         {
@@ -1659,6 +2086,52 @@ void vtkPVGeometryFilter::PolyDataExecute(
   this->DataSetExecute(input, output, doCommunicate);
 }
 
+//----------------------------------------------------------------------------
+void vtkPVGeometryFilter::PolyDataPassThrough(
+  vtkPolyData* input, vtkPolyData* output)
+{
+  output->ShallowCopy(input);
+  if (this->PassThroughCellIds)
+    {
+    vtkNew<vtkIdTypeArray> originalCellIds;
+    originalCellIds->SetName("vtkOriginalCellIds");
+    originalCellIds->SetNumberOfComponents(1);
+    vtkNew<vtkIdTypeArray> originalFaceIds;
+    originalFaceIds->SetName(vtkPVRecoverGeometryWireframe::ORIGINAL_FACE_IDS());
+    originalFaceIds->SetNumberOfComponents(1);
+    vtkCellData *outputCD = output->GetCellData();
+    outputCD->AddArray(originalCellIds.Get());
+    if (this->Triangulate)
+      {
+      outputCD->AddArray(originalFaceIds.Get());
+      }
+    vtkIdType numTup = output->GetNumberOfCells();
+    originalCellIds->SetNumberOfValues(numTup);
+    originalFaceIds->SetNumberOfValues(numTup);
+    for (vtkIdType cId = 0; cId < numTup; cId++)
+      {
+      originalCellIds->SetValue(cId, cId);
+      originalFaceIds->SetValue(cId, cId);
+      }
+    }
+  if (this->PassThroughPointIds)
+    {
+    vtkNew<vtkIdTypeArray> originalPointIds;
+    originalPointIds->SetName("vtkOriginalPointIds");
+    originalPointIds->SetNumberOfComponents(1);
+    vtkPointData *outputPD = output->GetPointData();
+    outputPD->AddArray(originalPointIds.Get());
+    vtkIdType numTup = output->GetNumberOfPoints();
+    originalPointIds->SetNumberOfValues(numTup);
+    for (vtkIdType pId = 0; pId < numTup; pId++)
+      {
+      originalPointIds->SetValue(pId, pId);
+      }
+    }
+
+  output->RemoveGhostCells();
+}
+
 //----------------------------------------------------------------------------
 void vtkPVGeometryFilter::OctreeExecute(
   vtkHyperOctree* input, vtkPolyData* out, int doCommunicate)
@@ -1765,6 +2238,10 @@ void vtkPVGeometryFilter::PrintSelf(ostream& os, vtkIndent indent)
      << (this->PassThroughCellIds ? "On\n" : "Off\n");
   os << indent << "PassThroughPointIds: "
      << (this->PassThroughPointIds ? "On\n" : "Off\n");
+  os << indent << "ExecuteBlocksInParallel: "
+     << this->ExecuteBlocksInParallel << endl;
+  os << indent << "ReuseSurfaceTopology: "
+     << this->ReuseSurfaceTopology << endl;
 }
 
 //----------------------------------------------------------------------------
@@ -153,6 +153,27 @@ public:
   vtkGetMacro(UseNonOverlappingAMRMetaDataForOutlines, bool);
   vtkBooleanMacro(UseNonOverlappingAMRMetaDataForOutlines, bool);
 
+  // Description:
+  // When set to true (default), the surfaces of the leaves of composite
+  // datasets are extracted concurrently (using vtkSMPTools), each thread
+  // using its own vtkDataSetSurfaceFilter. Leaves that need internal
+  // pipelines (outlines, strips for polydata, triangulation or nonlinear
+  // subdivision) are still processed serially.
+  vtkSetMacro(ExecuteBlocksInParallel, bool);
+  vtkGetMacro(ExecuteBlocksInParallel, bool);
+  vtkBooleanMacro(ExecuteBlocksInParallel, bool);
+
+  // Description:
+  // When set to true (default), the surface extracted from a
+  // vtkUnstructuredGrid is cached together with the ids of the points and
+  // cells it came from. As long as the connectivity of that grid does not
+  // change (same cell arrays, not modified), e.g. for time series over a
+  // static mesh, the external faces are not recomputed: the new points,
+  // point data and cell data are simply gathered through the cached ids.
+  vtkSetMacro(ReuseSurfaceTopology, bool);
+  vtkGetMacro(ReuseSurfaceTopology, bool);
+  vtkBooleanMacro(ReuseSurfaceTopology, bool);
+
   // These keys are put in the output composite-data metadata for multipieces
   // since this filter merges multipieces together.
   static vtkInformationIntegerVectorKey* POINT_OFFSETS();
@@ -240,6 +261,26 @@ protected:
   void PolyDataExecute(
     vtkPolyData* input, vtkPolyData* output, int doCommunicate);
 
+  // Description:
+  // Used by PolyDataExecute() when not generating strips: shallow copies the
+  // input, adds the original ids arrays and removes ghost cells.
+  void PolyDataPassThrough(vtkPolyData* input, vtkPolyData* output);
+
+  // Description:
+  // Thread-safe counterpart of ExecuteBlock() for a leaf of a composite
+  // dataset, using \c surfaceFilter instead of this->DataSetSurfaceFilter.
+  // Returns false, without producing anything, if the leaf can only be
+  // processed with ExecuteBlock() on the main thread.
+  bool ExecuteBlockConcurrently(vtkDataObject* input, vtkPolyData* output,
+    vtkDataSetSurfaceFilter* surfaceFilter, const int* wholeExtent);
+
+  // Description:
+  // Extracts the surface of a linear unstructured grid with \c surfaceFilter,
+  // reusing the topology cached for the same connectivity when
+  // ReuseSurfaceTopology is on. Thread-safe.
+  void ExtractUnstructuredGridSurface(vtkDataSetSurfaceFilter* surfaceFilter,
+    vtkUnstructuredGridBase* input, vtkPolyData* output);
+
   void OctreeExecute(
     vtkHyperOctree* input, vtkPolyData* output, int doCommunicate);
 
@@ -306,6 +347,8 @@ protected:
 
   bool HideInternalAMRFaces;
   bool UseNonOverlappingAMRMetaDataForOutlines;
+  bool ExecuteBlocksInParallel;
+  bool ReuseSurfaceTopology;
 
 private:
   vtkPVGeometryFilter(const vtkPVGeometryFilter&); // Not implemented
@@ -320,6 +363,10 @@ private:
   void AddBlockColors(vtkPolyData* pd, unsigned int index);
   void AddHierarchicalIndex(vtkPolyData* pd, unsigned int level, unsigned int index);
   class BoundsReductionOperation;
+  class BlocksFunctor;
+  friend class BlocksFunctor;
+  class vtkTopologyCache;
+  vtkTopologyCache* TopologyCache;
 //ETX
 };
 
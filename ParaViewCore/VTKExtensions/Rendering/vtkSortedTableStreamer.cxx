@@ -75,7 +75,8 @@ public:
   virtual int  Compute( vtkTable* input, vtkTable* output,
                         vtkIdType block, vtkIdType blockSize,
                         bool revertOrder) = 0;
-  virtual bool IsInvalid(vtkTable* input, vtkDataArray* dataToProcess) = 0;
+  virtual bool IsInvalid(vtkTable* input, vtkDataArray* dataToProcess,
+                         int selectedComponent) = 0;
   virtual bool IsSortable() = 0;
   virtual bool TestInternalClasses() = 0;
 
@@ -571,6 +572,15 @@ public:
         }
       }
   };
+  // Location of a global index in the distributed sort. See
+  // SearchGlobalIndexLocations() for the meaning of each field.
+  struct GlobalIndexLocation
+  {
+    vtkIdType NbGlobalToSkip;
+    vtkIdType LocalOffset;
+    vtkIdType NbInLocalBar;
+  };
+  typedef vtksys_stl::map<vtkIdType, GlobalIndexLocation> SplitterTableType;
 
 public:
 
@@ -580,6 +590,7 @@ public:
     this->LocalSorter = 0;
     this->GlobalHistogram = 0;
     this->Debug = false;
+    this->Sortable = -1;
     }
 
   Internals( vtkTable* input, vtkDataArray* dataToSort,
@@ -588,14 +599,11 @@ public:
     // Default values
     this->SelectedComponent = 0;
     this->NeedToBuildCache = true;
+    this->Sortable = -1;
     this->DataToSort = dataToSort;
 
     this->InputMTime = input->GetMTime();
-
-    if( dataToSort ) // Might be NULL
-      {
-      this->DataMTime = dataToSort->GetMTime();
-      }
+    this->DataMTime = dataToSort ? dataToSort->GetMTime() : 0; // Might be NULL
 
     // Get MPI objects
     this->MPI = controller->GetCommunicator();
@@ -616,6 +624,15 @@ public:
   // --------------------------------------------------------------------------
   bool IsSortable()
     {
+    // The answer only depends on the data to sort and the selected component,
+    // so only communicate the first time.
+    if(this->Sortable != -1)
+      {
+      this->CommonRange[0] = this->SortableRange[0];
+      this->CommonRange[1] = this->SortableRange[1];
+      return this->Sortable == 1;
+      }
+
     // See if one process is able to sort the table,
     // if not then just say NOT sortable
     int localCanSort = (this->DataToSort == NULL) ? 0 : 1;
@@ -623,6 +640,9 @@ public:
     this->MPI->AllReduce(&localCanSort, &globalCanSort, 1, vtkCommunicator::MAX_OP);
     if(globalCanSort == 0)
       {
+      this->SortableRange[0] = this->CommonRange[0] = 0;
+      this->SortableRange[1] = this->CommonRange[1] = 0;
+      this->Sortable = 0;
       return false;
       }
 
@@ -674,6 +694,9 @@ public:
     this->CommonRange[0] -= FLT_EPSILON;
     this->CommonRange[1] += FLT_EPSILON;
 
+    this->SortableRange[0] = this->CommonRange[0];
+    this->SortableRange[1] = this->CommonRange[1];
+    this->Sortable = sortable ? 1 : 0;
     return sortable;
     }
 
@@ -683,6 +706,9 @@ public:
     // We are building the cache so no need to build it next time
     this->NeedToBuildCache = false;
 
+    // The previous splitters do not match the new local sort
+    this->SplitterTable.clear();
+
     // Communication buffer
     vtkIdType* bufferHistogramValues = new vtkIdType[this->NumProcs *  HISTOGRAM_SIZE];
 
@@ -903,37 +929,40 @@ public:
       }
 
     // ------------------------------------------------------------------------
-    // Search for lower bound
+    // Locate the block boundaries in the global sort
+    //    The boundaries of the neighbouring blocks are located at the same
+    //    time and kept in the splitter table, so scrolling over them does not
+    //    need any new histogram refinement.
     // ------------------------------------------------------------------------
-    vtkIdType nbElementsToRemoveFromHead = 0;
-    vtkIdType localOffset = 0;
-    vtkIdType nbElementsInBar = 0;
-    this->SearchGlobalIndexLocation( (block * blockSize),
-                                     this->LocalSorter->Histo,
-                                     this->GlobalHistogram,
-                                     nbElementsToRemoveFromHead,
-                                     localOffset,
-                                     nbElementsInBar);
-
-
+    vtkIdType totalValues = this->GlobalHistogram->TotalValues;
+    std::vector<vtkIdType> boundaries;
+    for(vtkIdType idx = MAX(0, block - SPLITTER_PREFETCH);
+        idx <= block + SPLITTER_PREFETCH; ++idx)
+      {
+      if(idx > block && idx * blockSize >= totalValues)
+        {
+        break;
+        }
+      vtkIdType upperIdx = MIN(totalValues, (idx + 1) * blockSize);
+      boundaries.push_back(idx * blockSize);
+      boundaries.push_back(upperIdx - 1); // It is not a size it is an index
+      }
+    this->LocateGlobalIndices(boundaries);
 
     // ------------------------------------------------------------------------
-    // Search for upper bound
+    // Lower bound
     // ------------------------------------------------------------------------
-    vtkIdType upperOffset = 0;
-    vtkIdType globalUpperOffset = 0;
-    vtkIdType searchIdx =
-        (this->GlobalHistogram->TotalValues < (block + 1) * blockSize) ?
-        this->GlobalHistogram->TotalValues : ((block + 1) * blockSize);
-    searchIdx--; // It is not a size it is an index (so -1)
-
-    this->SearchGlobalIndexLocation( searchIdx,
-                                     this->LocalSorter->Histo,
-                                     this->GlobalHistogram,
-                                     globalUpperOffset,
-                                     upperOffset,
-                                     nbElementsInBar );
+    const GlobalIndexLocation& lower = this->SplitterTable[block * blockSize];
+    vtkIdType nbElementsToRemoveFromHead = lower.NbGlobalToSkip;
+    vtkIdType localOffset = lower.LocalOffset;
 
+    // ------------------------------------------------------------------------
+    // Upper bound
+    // ------------------------------------------------------------------------
+    const GlobalIndexLocation& upper =
+        this->SplitterTable[MIN(totalValues, (block + 1) * blockSize) - 1];
+    vtkIdType upperOffset = upper.LocalOffset;
+    vtkIdType nbElementsInBar = upper.NbInLocalBar;
 
     // We have to include our searched index (so +1)
     vtkIdType localSize = (upperOffset + nbElementsInBar) - localOffset + 1;
@@ -1038,77 +1067,181 @@ public:
     }
 
   // --------------------------------------------------------------------------
-  // nbGlobalToSkip is the number of elements that should be skiped at the end
+  // Make sure that the splitter table knows the location of each of the given
+  // global indices. Only the missing ones are searched, all at once.
+  // As this is a collective operation, the same indices MUST be requested on
+  // every process. The splitter table is then the same everywhere too.
+  void LocateGlobalIndices(const std::vector<vtkIdType>& indices)
+    {
+    std::vector<vtkIdType> missingIndices;
+    for(int pass=0; pass < 2; ++pass)
+      {
+      missingIndices.clear();
+      for(size_t idx=0; idx < indices.size(); ++idx)
+        {
+        if(this->SplitterTable.find(indices[idx]) == this->SplitterTable.end()
+           && std::find(missingIndices.begin(), missingIndices.end(),
+                        indices[idx]) == missingIndices.end())
+          {
+          missingIndices.push_back(indices[idx]);
+          }
+        }
+
+      // Keep the table bounded when scrolling over a huge table
+      if(this->SplitterTable.size() + missingIndices.size() <= MAX_SPLITTERS)
+        {
+        break;
+        }
+      this->SplitterTable.clear();
+      }
+
+    if(missingIndices.empty())
+      {
+      return;
+      }
+
+    std::vector<GlobalIndexLocation> locations;
+    this->SearchGlobalIndexLocations(missingIndices, locations);
+    for(size_t idx=0; idx < missingIndices.size(); ++idx)
+      {
+      this->SplitterTable[missingIndices[idx]] = locations[idx];
+      }
+    }
+
+  // --------------------------------------------------------------------------
+  // For each searched global index:
+  // NbGlobalToSkip is the number of elements that should be skiped at the end
   // if you exactly want to reach the searchedGlobalIndex.
-  // localOffset is the corresponding local index in the sorted table to the
-  // global index of (searchedGlobalIndex - nbGlobalToSkip)
-  // nbInLocalBar is the local number of elements that are available
+  // LocalOffset is the corresponding local index in the sorted table to the
+  // global index of (searchedGlobalIndex - NbGlobalToSkip)
+  // NbInLocalBar is the local number of elements that are available
   // in the hitogram bar where the searchedGlobalIndex has been found.
-  // nbInLocalBar is used when you want to get an upper bound that
+  // NbInLocalBar is used when you want to get an upper bound that
   // will include the searchedGlobalIndex.
-  void SearchGlobalIndexLocation(vtkIdType searchedGlobalIndex,
-                                 Histogram* localHistogram,
-                                 Histogram* globalHistogram,
-                                 vtkIdType& nbGlobalToSkip,
-                                 vtkIdType& localOffset,
-                                 vtkIdType& nbInLocalBar)
+  // All the searches are refined together, so each refinement level only
+  // costs a single AllGather whatever the number of searched indices.
+  void SearchGlobalIndexLocations(
+    const std::vector<vtkIdType>& searchedGlobalIndices,
+    std::vector<GlobalIndexLocation>& locations)
     {
-    // Communication buffer
-    vtkIdType* bufferHistogramValues = new vtkIdType[this->NumProcs *  HISTOGRAM_SIZE];
+    size_t nbSearches = searchedGlobalIndices.size();
+    locations.resize(nbSearches);
+
+    // Setup inital hitogram range and values
+    std::vector<Histogram*> localHistograms(nbSearches);
+    std::vector<Histogram*> globalHistograms(nbSearches);
+    std::vector<bool> pending(nbSearches, true);
+    size_t nbPending = nbSearches;
+    size_t searchIdx;
+    for(searchIdx = 0; searchIdx < nbSearches; ++searchIdx)
+      {
+      localHistograms[searchIdx] = new Histogram();
+      globalHistograms[searchIdx] = new Histogram();
+      this->LocalSorter->Histo->CopyTo(*localHistograms[searchIdx]);
+      this->GlobalHistogram->CopyTo(*globalHistograms[searchIdx]);
+
+      // Reset local offsets
+      locations[searchIdx].NbGlobalToSkip = searchedGlobalIndices[searchIdx];
+      locations[searchIdx].LocalOffset = 0;
+      locations[searchIdx].NbInLocalBar = 0;
+      }
+
+    // Communication buffers
+    vtkIdType* localHistogramValues = new vtkIdType[nbSearches * HISTOGRAM_SIZE];
+    vtkIdType* bufferHistogramValues =
+        new vtkIdType[this->NumProcs * nbSearches * HISTOGRAM_SIZE];
 
     // Local internal working var
     vtkIdType histogramBarIdx = -1;
     double currentRange[2];
     vtkIdType idx, idxEnd;
+    vtkIdType nbSent;
 
-    // Setup inital hitogram range and values
-    Histogram _globalHistogram;
-    Histogram _localHistogram;
-    localHistogram->CopyTo(_localHistogram);
-    globalHistogram->CopyTo(_globalHistogram);
-
-    // Reset local offsets
-    localOffset = 0;
-    nbGlobalToSkip = searchedGlobalIndex;
-
-    do
+    while(nbPending > 0)
       {
-      nbGlobalToSkip -= _globalHistogram.GetNewRange(nbGlobalToSkip,
-                                                     histogramBarIdx,
-                                                     currentRange);
-
-      localOffset += _localHistogram.GetNumberOfElements(0, histogramBarIdx);
-      nbInLocalBar = _localHistogram.GetNumberOfElements(histogramBarIdx,
-                                                         histogramBarIdx+1);
-
-      // Based on a narrowed range, build local histogram to get closer to the
-      // real index of the object
-      _localHistogram.SetScalarRange(currentRange);
-      _localHistogram.ClearHistogramValues();
-
-      idxEnd = localOffset + nbInLocalBar;
-      for(idx = localOffset; idx < idxEnd; ++idx)
+      nbSent = 0;
+      for(searchIdx = 0; searchIdx < nbSearches; ++searchIdx)
         {
-        _localHistogram.AddValue(this->LocalSorter->Array[idx].Value);
-        }
+        if(!pending[searchIdx])
+          {
+          continue;
+          }
+        GlobalIndexLocation& location = locations[searchIdx];
+        Histogram& _localHistogram = *localHistograms[searchIdx];
+        Histogram& _globalHistogram = *globalHistograms[searchIdx];
+
+        location.NbGlobalToSkip -=
+            _globalHistogram.GetNewRange(location.NbGlobalToSkip,
+                                         histogramBarIdx,
+                                         currentRange);
+
+        location.LocalOffset +=
+            _localHistogram.GetNumberOfElements(0, histogramBarIdx);
+        location.NbInLocalBar =
+            _localHistogram.GetNumberOfElements(histogramBarIdx,
+                                                histogramBarIdx+1);
+
+        // Based on a narrowed range, build local histogram to get closer to
+        // the real index of the object
+        _localHistogram.SetScalarRange(currentRange);
+        _localHistogram.ClearHistogramValues();
+
+        idxEnd = location.LocalOffset + location.NbInLocalBar;
+        for(idx = location.LocalOffset; idx < idxEnd; ++idx)
+          {
+          _localHistogram.AddValue(this->LocalSorter->Array[idx].Value);
+          }
+        _globalHistogram.SetScalarRange(currentRange);
 
-      // Exchange local histo with everyone
-      this->MPI->AllGather( _localHistogram.Values,
-                            bufferHistogramValues, HISTOGRAM_SIZE);
+        std::copy(_localHistogram.Values,
+                  _localHistogram.Values + HISTOGRAM_SIZE,
+                  localHistogramValues + nbSent * HISTOGRAM_SIZE);
+        ++nbSent;
+        }
 
-      // Build global histogram
-      _globalHistogram.SetScalarRange(currentRange);
-      _globalHistogram.ClearHistogramValues();
+      // Exchange local histograms of all the pending searches with everyone
+      this->MPI->AllGather( localHistogramValues,
+                            bufferHistogramValues, nbSent * HISTOGRAM_SIZE);
 
-      idxEnd = this->NumProcs * HISTOGRAM_SIZE;
-      for(idx = 0; idx < idxEnd; ++idx)
+      // Build global histograms. As they only depend on gathered data, every
+      // process agrees on the searches that are done.
+      nbSent = 0;
+      for(searchIdx = 0; searchIdx < nbSearches; ++searchIdx)
         {
-        _globalHistogram.TotalValues += bufferHistogramValues[idx];
-        _globalHistogram.Values[idx % HISTOGRAM_SIZE] += bufferHistogramValues[idx];
+        if(!pending[searchIdx])
+          {
+          continue;
+          }
+        Histogram& _globalHistogram = *globalHistograms[searchIdx];
+        _globalHistogram.ClearHistogramValues();
+        for(int proc = 0; proc < this->NumProcs; ++proc)
+          {
+          vtkIdType* values =
+              bufferHistogramValues + (proc * nbPending + nbSent) * HISTOGRAM_SIZE;
+          for(idx = 0; idx < HISTOGRAM_SIZE; ++idx)
+            {
+            _globalHistogram.TotalValues += values[idx];
+            _globalHistogram.Values[idx] += values[idx];
+            }
+          }
+        ++nbSent;
+
+        if(locations[searchIdx].NbGlobalToSkip <= 0
+           || !_globalHistogram.CanBeReduced())
+          {
+          pending[searchIdx] = false;
+          }
         }
+      nbPending = static_cast<size_t>(
+          std::count(pending.begin(), pending.end(), true));
       }
-    while(nbGlobalToSkip > 0 && _globalHistogram.CanBeReduced());
 
+    for(searchIdx = 0; searchIdx < nbSearches; ++searchIdx)
+      {
+      delete localHistograms[searchIdx];
+      delete globalHistograms[searchIdx];
+      }
+    delete[] localHistogramValues;
     delete[] bufferHistogramValues;
     }
 
@@ -1176,13 +1309,21 @@ public:
   void InvalidateCache()
     {
     this->NeedToBuildCache = true;
+    this->Sortable = -1;
+    this->SplitterTable.clear();
     }
 
   // --------------------------------------------------------------------------
-  bool IsInvalid(vtkTable* input, vtkDataArray* dataToProcess)
+  // Returns true if the cache of this process can not be used for the given
+  // input. A process without an array to sort keeps its cache as long as its
+  // input is unchanged.
+  bool IsInvalid(vtkTable* input, vtkDataArray* dataToProcess,
+                 int selectedComponent)
     {
-    return !dataToProcess || input->GetMTime() != this->InputMTime
-           || dataToProcess->GetMTime() != this->DataMTime;
+    return dataToProcess != this->DataToSort
+           || input->GetMTime() != this->InputMTime
+           || (dataToProcess && dataToProcess->GetMTime() != this->DataMTime)
+           || selectedComponent != this->SelectedComponent;
     }
 
   // --------------------------------------------------------------------------
@@ -1405,6 +1546,9 @@ private:
   vtkCommunicator* MPI;       // MPI communicator to send/receive/gather
   int SelectedComponent;      // Component used to sort array
   bool NeedToBuildCache;
+  int Sortable;               // Cached IsSortable() result, -1 if unknown
+  double SortableRange[2];    // CommonRange computed by IsSortable()
+  SplitterTableType SplitterTable; // Located global indices, by global index
   bool Debug;
 
   const static int VTK_TABLE_EXCHANGE_TAG = 50;
@@ -1415,6 +1559,13 @@ private:
   // Maybe make some test on huge cluster to see which histogram size is
   // the best.
   const static int HISTOGRAM_SIZE = 256;
+
+  // Number of blocks before and after the requested one whose boundaries
+  // are located along with it.
+  const static int SPLITTER_PREFETCH = 8;
+
+  // Maximum number of entries kept in the splitter table.
+  const static size_t MAX_SPLITTERS = 65536;
 };
 //****************************************************************************
 vtkStandardNewMacro(vtkSortedTableStreamer);
@@ -1570,8 +1721,19 @@ int vtkSortedTableStreamer::RequestData( vtkInformation* vtkNotUsed(request),
   // single point/cell.
   // --------------------------------------------------------------------------
 
-  // Delete internal object if the input has change (table or array to sort)
-  if(this->Internal && this->Internal->IsInvalid(input, arrayToProcess))
+  int realComponent = (!arrayToProcess) ?  0 :
+                      this->GetSelectedComponent() % arrayToProcess->GetNumberOfComponents();
+
+  // Delete internal object if the input has change (table, array to sort or
+  // component). Sorting is collective and the cached state decides which
+  // communications happen, so all processes must agree on keeping or
+  // rebuilding it, including those with an empty input.
+  int localInvalid = (!this->Internal ||
+    this->Internal->IsInvalid(input, arrayToProcess, realComponent)) ? 1 : 0;
+  int globalInvalid = localInvalid;
+  this->Controller->AllReduce(&localInvalid, &globalInvalid, 1,
+                              vtkCommunicator::MAX_OP);
+  if(this->Internal && globalInvalid)
     {
     delete this->Internal;
     this->Internal = 0;
@@ -1579,8 +1741,6 @@ int vtkSortedTableStreamer::RequestData( vtkInformation* vtkNotUsed(request),
 
   // Make sure that an internal object is available
   this->CreateInternalIfNeeded(input, arrayToProcess);
-  int realComponent = (!arrayToProcess) ?  0 :
-                      this->GetSelectedComponent() % arrayToProcess->GetNumberOfComponents();
   this->Internal->SetSelectedComponent(realComponent);
 
 
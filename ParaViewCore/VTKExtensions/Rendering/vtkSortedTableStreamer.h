@@ -18,6 +18,12 @@
 // This filter is used quickly get a sorted subset of a given vtkTable.
 // By sorted we mean a subset build from a global sort even if some optimisation
 // allow us to skip a global table sorting.
+//
+// Each process sorts its own rows once and keeps that sorted run until the
+// input, the sorted column, the component or the order change. The location
+// of the requested block boundaries in the global order are kept as well
+// (along with the ones of the neighbouring blocks), so scrolling through the
+// table only has to gather the rows of the requested block.
 
 #ifndef __vtkSortedTableStreamer_h
 #define __vtkSortedTableStreamer_h
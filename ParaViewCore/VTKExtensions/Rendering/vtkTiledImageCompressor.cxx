@@ -0,0 +1,523 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkTiledImageCompressor.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkTiledImageCompressor.h"
+
+#include "vtkMultiProcessStream.h"
+#include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <algorithm>
+#include <map>
+#include <string.h>
+#include <vector>
+#include <vtksys/ios/sstream>
+
+namespace
+{
+  // Compressed stream layout (all integers are 32 bit little-endian):
+  //   [version][flags][components][reserved]
+  //   [number of tuples][tile size in pixels][number of tiles]
+  //   [frame id][base frame id]
+  //   [tile mode] x number of tiles (one byte each)
+  //   [tile payload size] x number of tiles
+  //   tile payloads
+  // The base frame id of a delta frame is the id of the frame it was computed
+  // against; it is 0 for key frames.
+  const unsigned char TILED_VERSION = 2;
+  const vtkIdType HEADER_SIZE = 24;
+  const unsigned char FLAG_KEEPS_HISTORY = 0x1; // sender is in delta mode
+  const unsigned char FLAG_DELTA_FRAME = 0x2;   // tiles are XOR-ed with previous
+
+  enum TileModes
+    {
+    TILE_STORED = 0,
+    TILE_COMPRESSED = 1,
+    TILE_EMPTY = 2
+    };
+
+  inline void vtkWriteUInt32(unsigned char* dest, vtkTypeUInt32 value)
+    {
+    for (int cc=0; cc < 4; cc++)
+      {
+      dest[cc] = static_cast<unsigned char>(value & 0xff);
+      value = value >> 8;
+      }
+    }
+
+  inline vtkTypeUInt32 vtkReadUInt32(const unsigned char* src)
+    {
+    return static_cast<vtkTypeUInt32>(src[0]) |
+      (static_cast<vtkTypeUInt32>(src[1]) << 8) |
+      (static_cast<vtkTypeUInt32>(src[2]) << 16) |
+      (static_cast<vtkTypeUInt32>(src[3]) << 24);
+    }
+}
+
+//-----------------------------------------------------------------------------
+class vtkTiledImageCompressor::vtkInternals
+{
+public:
+  vtkTiledImageCompressor* Self;
+
+  // Last frame sent to/received from a destination, used in delta mode.
+  struct History
+    {
+    std::vector<unsigned char> Frame;
+    int Components;
+    vtkTypeUInt32 FrameId;
+    int FramesSinceKeyFrame;
+    History() : Components(0), FrameId(0), FramesSinceKeyFrame(0) {}
+    };
+  std::map<int, History> Histories;
+
+  // State shared with the SMP functors during a Compress/Decompress call.
+  const unsigned char* Previous;
+  unsigned char* Image;
+  vtkIdType ImageSize;
+  vtkIdType TileBytes;
+  bool DeltaFrame;
+  std::vector<std::vector<unsigned char> > Tiles;
+  std::vector<unsigned char> Modes;
+  const unsigned char* Payload;
+  std::vector<vtkIdType> Offsets;
+  std::vector<vtkIdType> Sizes;
+  std::vector<char> Status;
+
+  vtkInternals(vtkTiledImageCompressor* self) : Self(self),
+    Previous(NULL), Image(NULL), ImageSize(0), TileBytes(0),
+    DeltaFrame(false), Payload(NULL)
+    {
+    }
+
+  vtkIdType GetTileLength(vtkIdType tile) const
+    {
+    vtkIdType begin = tile * this->TileBytes;
+    return std::min(this->TileBytes, this->ImageSize - begin);
+    }
+
+  void CompressTiles(vtkIdType begin, vtkIdType end)
+    {
+    std::vector<unsigned char> delta;
+    for (vtkIdType tile=begin; tile < end; tile++)
+      {
+      const vtkIdType offset = tile * this->TileBytes;
+      const vtkIdType length = this->GetTileLength(tile);
+      const unsigned char* src = this->Image + offset;
+
+      if (this->DeltaFrame)
+        {
+        delta.resize(length);
+        const unsigned char* prev = this->Previous + offset;
+        unsigned char changed = 0;
+        for (vtkIdType cc=0; cc < length; cc++)
+          {
+          delta[cc] = src[cc] ^ prev[cc];
+          changed |= delta[cc];
+          }
+        if (changed == 0)
+          {
+          this->Modes[tile] = TILE_EMPTY;
+          this->Tiles[tile].clear();
+          continue;
+          }
+        src = &delta[0];
+        }
+
+      std::vector<unsigned char>& out = this->Tiles[tile];
+      out.resize(this->Self->GetMaximumCompressedTileSize(length));
+      vtkIdType outSize = this->Self->CompressTile(src, length, &out[0]);
+      if (outSize > 0 && outSize < length)
+        {
+        this->Modes[tile] = TILE_COMPRESSED;
+        out.resize(outSize);
+        }
+      else
+        {
+        // incompressible tile, store it as is.
+        this->Modes[tile] = TILE_STORED;
+        out.assign(src, src + length);
+        }
+      }
+    }
+
+  void DecompressTiles(vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType tile=begin; tile < end; tile++)
+      {
+      const vtkIdType offset = tile * this->TileBytes;
+      const vtkIdType length = this->GetTileLength(tile);
+      unsigned char* dest = this->Image + offset;
+      const unsigned char* src = this->Payload + this->Offsets[tile];
+
+      bool status = true;
+      switch (this->Modes[tile])
+        {
+      case TILE_STORED:
+        status = (this->Sizes[tile] == length);
+        if (status)
+          {
+          memcpy(dest, src, length);
+          }
+        break;
+      case TILE_COMPRESSED:
+        status = this->Self->DecompressTile(src, this->Sizes[tile], dest, length);
+        break;
+      case TILE_EMPTY:
+        memset(dest, 0, length);
+        break;
+      default:
+        status = false;
+        }
+
+      if (status && this->DeltaFrame)
+        {
+        const unsigned char* prev = this->Previous + offset;
+        for (vtkIdType cc=0; cc < length; cc++)
+          {
+          dest[cc] ^= prev[cc];
+          }
+        }
+      this->Status[tile] = status? 1 : 0;
+      }
+    }
+
+  // vtkSMPTools functors dispatching tile ranges to the methods above.
+  class CompressFunctor
+    {
+    vtkInternals* Internals;
+  public:
+    CompressFunctor(vtkInternals* internals) : Internals(internals) {}
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      this->Internals->CompressTiles(begin, end);
+      }
+    };
+
+  class DecompressFunctor
+    {
+    vtkInternals* Internals;
+  public:
+    DecompressFunctor(vtkInternals* internals) : Internals(internals) {}
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      this->Internals->DecompressTiles(begin, end);
+      }
+    };
+};
+
+//-----------------------------------------------------------------------------
+vtkTiledImageCompressor::vtkTiledImageCompressor()
+    :
+  TileSize(65536),
+  DeltaMode(0),
+  KeyFrameInterval(64),
+  Destination(0)
+{
+  this->Internals = new vtkInternals(this);
+}
+
+//-----------------------------------------------------------------------------
+vtkTiledImageCompressor::~vtkTiledImageCompressor()
+{
+  delete this->Internals;
+}
+
+//-----------------------------------------------------------------------------
+void vtkTiledImageCompressor::ResetDelta()
+{
+  this->Internals->Histories.erase(this->Destination);
+}
+
+//-----------------------------------------------------------------------------
+void vtkTiledImageCompressor::ResetAllDeltas()
+{
+  this->Internals->Histories.clear();
+}
+
+//-----------------------------------------------------------------------------
+int vtkTiledImageCompressor::Compress()
+{
+  if (!(this->Input && this->Output))
+    {
+    vtkWarningMacro("Cannot compress empty input or output detected.");
+    return VTK_ERROR;
+    }
+
+  vtkInternals& internals = *this->Internals;
+  const int numComps = this->Input->GetNumberOfComponents();
+  const vtkIdType numTuples = this->Input->GetNumberOfTuples();
+  const vtkIdType imageSize = numTuples * numComps;
+  const vtkIdType numTiles =
+    (numTuples + this->TileSize - 1) / this->TileSize;
+
+  vtkInternals::History& history = internals.Histories[this->Destination];
+  internals.Image = this->Input->GetPointer(0);
+  internals.ImageSize = imageSize;
+  internals.TileBytes = static_cast<vtkIdType>(this->TileSize) * numComps;
+  internals.DeltaFrame = (this->DeltaMode &&
+    static_cast<vtkIdType>(history.Frame.size()) == imageSize &&
+    history.Components == numComps &&
+    (this->KeyFrameInterval <= 0 ||
+     history.FramesSinceKeyFrame < this->KeyFrameInterval));
+  internals.Previous = internals.DeltaFrame? &history.Frame[0] : NULL;
+  const vtkTypeUInt32 baseFrameId = internals.DeltaFrame? history.FrameId : 0;
+
+  // ids are never 0, which marks key frames.
+  history.FrameId = (history.FrameId == VTK_TYPE_UINT32_MAX)?
+    1 : history.FrameId + 1;
+  history.FramesSinceKeyFrame =
+    internals.DeltaFrame? history.FramesSinceKeyFrame + 1 : 0;
+  internals.Tiles.resize(numTiles);
+  internals.Modes.resize(numTiles);
+
+  vtkInternals::CompressFunctor functor(this->Internals);
+  vtkSMPTools::For(0, numTiles, 1, functor);
+
+  // Assemble the header and tile payloads.
+  const vtkIdType headerSize = HEADER_SIZE + 5 * numTiles;
+  vtkIdType totalSize = headerSize;
+  for (vtkIdType tile=0; tile < numTiles; tile++)
+    {
+    totalSize += static_cast<vtkIdType>(internals.Tiles[tile].size());
+    }
+
+  this->Output->SetNumberOfComponents(1);
+  this->Output->SetNumberOfTuples(totalSize);
+  unsigned char* out = this->Output->GetPointer(0);
+  out[0] = TILED_VERSION;
+  out[1] = static_cast<unsigned char>(
+    (this->DeltaMode? FLAG_KEEPS_HISTORY : 0) |
+    (internals.DeltaFrame? FLAG_DELTA_FRAME : 0));
+  out[2] = static_cast<unsigned char>(numComps);
+  out[3] = 0;
+  vtkWriteUInt32(out + 4, static_cast<vtkTypeUInt32>(numTuples));
+  vtkWriteUInt32(out + 8, static_cast<vtkTypeUInt32>(this->TileSize));
+  vtkWriteUInt32(out + 12, static_cast<vtkTypeUInt32>(numTiles));
+  vtkWriteUInt32(out + 16, history.FrameId);
+  vtkWriteUInt32(out + 20, baseFrameId);
+  unsigned char* modes = out + HEADER_SIZE;
+  unsigned char* sizes = modes + numTiles;
+  unsigned char* payload = out + headerSize;
+  for (vtkIdType tile=0; tile < numTiles; tile++)
+    {
+    const std::vector<unsigned char>& data = internals.Tiles[tile];
+    modes[tile] = internals.Modes[tile];
+    vtkWriteUInt32(sizes + 4*tile, static_cast<vtkTypeUInt32>(data.size()));
+    if (!data.empty())
+      {
+      memcpy(payload, &data[0], data.size());
+      payload += data.size();
+      }
+    }
+
+  // Keep the frame around for the next delta.
+  if (this->DeltaMode)
+    {
+    history.Frame.assign(internals.Image, internals.Image + imageSize);
+    history.Components = numComps;
+    }
+  else
+    {
+    this->ResetDelta();
+    }
+  internals.Image = NULL;
+  internals.Previous = NULL;
+  return VTK_OK;
+}
+
+//-----------------------------------------------------------------------------
+int vtkTiledImageCompressor::Decompress()
+{
+  if (!(this->Input && this->Output))
+    {
+    vtkWarningMacro("Cannot decompress empty input or output detected.");
+    return VTK_ERROR;
+    }
+
+  vtkInternals& internals = *this->Internals;
+  const unsigned char* in = this->Input->GetPointer(0);
+  const vtkIdType inSize = this->Input->GetNumberOfTuples() *
+    this->Input->GetNumberOfComponents();
+  if (inSize < HEADER_SIZE || in[0] != TILED_VERSION)
+    {
+    vtkErrorMacro("Invalid compressed image stream.");
+    return VTK_ERROR;
+    }
+
+  const unsigned char flags = in[1];
+  const int numComps = in[2];
+  const vtkIdType numTuples = vtkReadUInt32(in + 4);
+  const vtkIdType tileSize = vtkReadUInt32(in + 8);
+  const vtkIdType numTiles = vtkReadUInt32(in + 12);
+  const vtkTypeUInt32 frameId = vtkReadUInt32(in + 16);
+  const vtkTypeUInt32 baseFrameId = vtkReadUInt32(in + 20);
+  const vtkIdType headerSize = HEADER_SIZE + 5 * numTiles;
+  const vtkIdType imageSize = numTuples * numComps;
+  if (inSize < headerSize || tileSize <= 0 ||
+    numTiles != (numTuples + tileSize - 1) / tileSize)
+    {
+    vtkErrorMacro("Invalid compressed image header.");
+    return VTK_ERROR;
+    }
+
+  vtkInternals::History& history = internals.Histories[this->Destination];
+  internals.DeltaFrame = (flags & FLAG_DELTA_FRAME) != 0;
+  if (internals.DeltaFrame &&
+    (static_cast<vtkIdType>(history.Frame.size()) != imageSize ||
+     history.Components != numComps || history.FrameId != baseFrameId))
+    {
+    // a frame was lost or failed to decode: this delta does not apply to
+    // what we have. Nothing can be decoded until the next key frame.
+    vtkErrorMacro("Received delta frame " << frameId << " against frame "
+      << baseFrameId << ", which is not the previous frame received.");
+    this->ResetDelta();
+    return VTK_ERROR;
+    }
+  internals.Previous = internals.DeltaFrame? &history.Frame[0] : NULL;
+
+  if (this->Output->GetNumberOfComponents() != numComps ||
+    this->Output->GetNumberOfTuples() != numTuples)
+    {
+    this->Output->SetNumberOfComponents(numComps);
+    this->Output->SetNumberOfTuples(numTuples);
+    }
+
+  internals.Image = this->Output->GetPointer(0);
+  internals.ImageSize = imageSize;
+  internals.TileBytes = tileSize * numComps;
+  internals.Payload = in + headerSize;
+  internals.Modes.assign(in + HEADER_SIZE, in + HEADER_SIZE + numTiles);
+  internals.Offsets.resize(numTiles);
+  internals.Sizes.resize(numTiles);
+  internals.Status.assign(numTiles, 0);
+  vtkIdType offset = 0;
+  for (vtkIdType tile=0; tile < numTiles; tile++)
+    {
+    internals.Offsets[tile] = offset;
+    internals.Sizes[tile] = vtkReadUInt32(in + HEADER_SIZE + numTiles + 4*tile);
+    offset += internals.Sizes[tile];
+    }
+  if (headerSize + offset > inSize)
+    {
+    vtkErrorMacro("Truncated compressed image stream.");
+    internals.Image = NULL;
+    internals.Previous = NULL;
+    this->ResetDelta();
+    return VTK_ERROR;
+    }
+
+  vtkInternals::DecompressFunctor functor(this->Internals);
+  vtkSMPTools::For(0, numTiles, 1, functor);
+
+  bool status = true;
+  for (vtkIdType tile=0; tile < numTiles; tile++)
+    {
+    status = status && (internals.Status[tile] != 0);
+    }
+
+  internals.Image = NULL;
+  internals.Previous = NULL;
+  if (status && (flags & FLAG_KEEPS_HISTORY))
+    {
+    history.Frame.assign(this->Output->GetPointer(0),
+      this->Output->GetPointer(0) + imageSize);
+    history.Components = numComps;
+    history.FrameId = frameId;
+    }
+  else
+    {
+    this->ResetDelta();
+    }
+
+  if (!status)
+    {
+    vtkErrorMacro("Failed to decompress image tiles.");
+    return VTK_ERROR;
+    }
+  return VTK_OK;
+}
+
+//-----------------------------------------------------------------------------
+void vtkTiledImageCompressor::SaveConfiguration(vtkMultiProcessStream *stream)
+{
+  vtkImageCompressor::SaveConfiguration(stream);
+  *stream
+    << this->TileSize
+    << this->DeltaMode;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkTiledImageCompressor::RestoreConfiguration(vtkMultiProcessStream *stream)
+{
+  if (vtkImageCompressor::RestoreConfiguration(stream))
+    {
+    int tileSize;
+    int deltaMode;
+    *stream
+      >> tileSize
+      >> deltaMode;
+    this->SetTileSize(tileSize);
+    this->SetDeltaMode(deltaMode);
+    return true;
+    }
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+const char *vtkTiledImageCompressor::SaveConfiguration()
+{
+  std::ostringstream oss;
+  oss
+    << vtkImageCompressor::SaveConfiguration()
+    << " "
+    << this->TileSize
+    << " "
+    << this->DeltaMode;
+
+  this->SetConfiguration(oss.str().c_str());
+
+  return this->Configuration;
+}
+
+//-----------------------------------------------------------------------------
+const char *vtkTiledImageCompressor::RestoreConfiguration(const char *stream)
+{
+  stream=vtkImageCompressor::RestoreConfiguration(stream);
+  if (stream)
+    {
+    std::istringstream iss(stream);
+    int tileSize;
+    int deltaMode;
+    iss
+      >> tileSize
+      >> deltaMode;
+    this->SetTileSize(tileSize);
+    this->SetDeltaMode(deltaMode);
+    // tellg() fails once the whole stream has been consumed.
+    return iss.eof()? stream+strlen(stream) : stream+iss.tellg();
+    }
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+void vtkTiledImageCompressor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "TileSize: " << this->TileSize << endl
+     << indent << "DeltaMode: " << this->DeltaMode << endl
+     << indent << "KeyFrameInterval: " << this->KeyFrameInterval << endl
+     << indent << "Destination: " << this->Destination << endl;
+}
@@ -0,0 +1,146 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkTiledImageCompressor.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkTiledImageCompressor - Superclass for image compressors that
+// compress independent tiles in parallel.
+// .SECTION Description
+// vtkTiledImageCompressor splits the input image into tiles of TileSize pixels
+// and compresses/decompresses each tile independently using vtkSMPTools, so
+// that the work is spread across the available cores (when VTK is built with
+// a threaded SMP backend). Subclasses provide the per-tile codec by
+// implementing CompressTile and DecompressTile.
+//
+// When DeltaMode is on, every frame except the first one (or the first one
+// after the image size changes) is XOR-ed against the previous frame before
+// compression. Tiles that did not change reduce to zeros and are sent as an
+// empty tile; the rest typically compress much better than the raw pixels.
+// Delta mode requires that every compressed frame is decompressed, in order,
+// by the same decompressor instance on the receiving end. Each frame carries
+// its sequence id and, for delta frames, the id of the frame it was computed
+// against; the receiver rejects a delta frame that does not apply to the last
+// frame it decoded, e.g. after a lost or corrupt frame, until the next key
+// frame. The sender emits a key frame every KeyFrameInterval frames so that
+// the receiver eventually resynchronizes on its own; senders that can be told
+// about a failure should also call ResetDelta() to force one right away.
+//
+// A sender serving several receivers, or a receiver fed by several senders,
+// keeps a separate history for each of them: set Destination to identify the
+// peer before each Compress/Decompress call.
+//
+// The configuration stream is:
+// [ClassName, LossLessMode, TileSize, DeltaMode, [Derived Class Stream]].
+// .SECTION See Also
+// vtkLZ4ImageCompressor vtkTiledZlibImageCompressor
+
+#ifndef __vtkTiledImageCompressor_h
+#define __vtkTiledImageCompressor_h
+
+#include "vtkImageCompressor.h"
+#include "vtkPVVTKExtensionsRenderingModule.h" // needed for export macro
+
+class vtkMultiProcessStream;
+
+class VTKPVVTKEXTENSIONSRENDERING_EXPORT vtkTiledImageCompressor : public vtkImageCompressor
+{
+public:
+  vtkTypeMacro(vtkTiledImageCompressor, vtkImageCompressor);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Number of pixels per tile. Tiles are compressed independently, possibly
+  // concurrently. Default is 65536.
+  vtkSetClampMacro(TileSize, int, 1024, VTK_INT_MAX);
+  vtkGetMacro(TileSize, int);
+
+  // Description:
+  // When set, frames are encoded as the difference with the previous frame.
+  // Off by default.
+  vtkSetMacro(DeltaMode, int);
+  vtkGetMacro(DeltaMode, int);
+  vtkBooleanMacro(DeltaMode, int);
+
+  // Description:
+  // In DeltaMode, a key frame is sent at least every KeyFrameInterval frames.
+  // 0 or less disables periodic key frames. Default is 64.
+  vtkSetMacro(KeyFrameInterval, int);
+  vtkGetMacro(KeyFrameInterval, int);
+
+  // Description:
+  // Identifies the peer frames are compressed for or decompressed from. The
+  // previous frame used in DeltaMode is kept per destination. Default is 0.
+  vtkSetMacro(Destination, int);
+  vtkGetMacro(Destination, int);
+
+  // Description:
+  // Forget the previous frame of the current Destination, forcing the next
+  // frame compressed for it to be a key frame.
+  void ResetDelta();
+
+  // Description:
+  // Forget the previous frames of all destinations.
+  void ResetAllDeltas();
+
+  // Description:
+  // Compress/Decompress data array on the objects input with results
+  // in the objects output. See also Set/GetInput/Output.
+  virtual int Compress();
+  virtual int Decompress();
+
+  //BTX
+  // Description:
+  // Serialize/Restore compressor configuration (but not the data) into the stream.
+  virtual void SaveConfiguration(vtkMultiProcessStream *stream);
+  virtual bool RestoreConfiguration(vtkMultiProcessStream* stream);
+  //ETX
+  virtual const char *SaveConfiguration();
+  virtual const char *RestoreConfiguration(const char *stream);
+
+protected:
+  vtkTiledImageCompressor();
+  virtual ~vtkTiledImageCompressor();
+
+  // Description:
+  // Compress \c inSize bytes from \c in into \c out, which holds at least
+  // GetMaximumCompressedTileSize(inSize) bytes. Returns the number of bytes
+  // written or 0 on failure. Called concurrently from several threads;
+  // implementations must not modify the object.
+  virtual vtkIdType CompressTile(const unsigned char* in, vtkIdType inSize,
+    unsigned char* out) const = 0;
+
+  // Description:
+  // Decompress \c inSize bytes from \c in into exactly \c outSize bytes of
+  // \c out. Returns false on failure. Called concurrently from several
+  // threads; implementations must not modify the object.
+  virtual bool DecompressTile(const unsigned char* in, vtkIdType inSize,
+    unsigned char* out, vtkIdType outSize) const = 0;
+
+  // Description:
+  // Worst case size of a compressed tile of \c inSize bytes.
+  virtual vtkIdType GetMaximumCompressedTileSize(vtkIdType inSize) const = 0;
+
+  int TileSize;
+  int DeltaMode;
+  int KeyFrameInterval;
+  int Destination;
+
+private:
+  vtkTiledImageCompressor(const vtkTiledImageCompressor&); // Not implemented.
+  void operator=(const vtkTiledImageCompressor&); // Not implemented.
+
+  class vtkInternals;
+  vtkInternals* Internals;
+  friend class vtkInternals;
+};
+
+#endif
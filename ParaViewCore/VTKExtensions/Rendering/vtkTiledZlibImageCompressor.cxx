@@ -0,0 +1,123 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkTiledZlibImageCompressor.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkTiledZlibImageCompressor.h"
+
+#include "vtkMultiProcessStream.h"
+#include "vtkObjectFactory.h"
+#include "vtk_zlib.h"
+
+#include <string.h>
+#include <vtksys/ios/sstream>
+
+vtkStandardNewMacro(vtkTiledZlibImageCompressor);
+
+//-----------------------------------------------------------------------------
+vtkTiledZlibImageCompressor::vtkTiledZlibImageCompressor()
+    :
+  CompressionLevel(1)
+{
+}
+
+//-----------------------------------------------------------------------------
+vtkTiledZlibImageCompressor::~vtkTiledZlibImageCompressor()
+{
+}
+
+//-----------------------------------------------------------------------------
+vtkIdType vtkTiledZlibImageCompressor::GetMaximumCompressedTileSize(
+  vtkIdType inSize) const
+{
+  return static_cast<vtkIdType>(compressBound(static_cast<uLong>(inSize)));
+}
+
+//-----------------------------------------------------------------------------
+vtkIdType vtkTiledZlibImageCompressor::CompressTile(
+  const unsigned char* in, vtkIdType inSize, unsigned char* out) const
+{
+  uLongf outSize = compressBound(static_cast<uLong>(inSize));
+  if (compress2(reinterpret_cast<Bytef*>(out), &outSize,
+      reinterpret_cast<const Bytef*>(in), static_cast<uLong>(inSize),
+      this->CompressionLevel) != Z_OK)
+    {
+    return 0;
+    }
+  return static_cast<vtkIdType>(outSize);
+}
+
+//-----------------------------------------------------------------------------
+bool vtkTiledZlibImageCompressor::DecompressTile(const unsigned char* in,
+  vtkIdType inSize, unsigned char* out, vtkIdType outSize) const
+{
+  uLongf destSize = static_cast<uLongf>(outSize);
+  return uncompress(reinterpret_cast<Bytef*>(out), &destSize,
+    reinterpret_cast<const Bytef*>(in), static_cast<uLong>(inSize)) == Z_OK &&
+    destSize == static_cast<uLongf>(outSize);
+}
+
+//-----------------------------------------------------------------------------
+void vtkTiledZlibImageCompressor::SaveConfiguration(vtkMultiProcessStream *stream)
+{
+  vtkTiledImageCompressor::SaveConfiguration(stream);
+  *stream << this->CompressionLevel;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkTiledZlibImageCompressor::RestoreConfiguration(vtkMultiProcessStream *stream)
+{
+  if (vtkTiledImageCompressor::RestoreConfiguration(stream))
+    {
+    int level;
+    *stream >> level;
+    this->SetCompressionLevel(level);
+    return true;
+    }
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+const char *vtkTiledZlibImageCompressor::SaveConfiguration()
+{
+  std::ostringstream oss;
+  oss
+    << vtkTiledImageCompressor::SaveConfiguration()
+    << " "
+    << this->CompressionLevel;
+
+  this->SetConfiguration(oss.str().c_str());
+
+  return this->Configuration;
+}
+
+//-----------------------------------------------------------------------------
+const char *vtkTiledZlibImageCompressor::RestoreConfiguration(const char *stream)
+{
+  stream=vtkTiledImageCompressor::RestoreConfiguration(stream);
+  if (stream)
+    {
+    std::istringstream iss(stream);
+    int level;
+    iss >> level;
+    this->SetCompressionLevel(level);
+    return iss.eof()? stream+strlen(stream) : stream+iss.tellg();
+    }
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+void vtkTiledZlibImageCompressor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "CompressionLevel: " << this->CompressionLevel << endl;
+}
@@ -0,0 +1,76 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkTiledZlibImageCompressor.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkTiledZlibImageCompressor - Loss-less image compressor using zlib
+// on independent tiles.
+// .SECTION Description
+// vtkTiledZlibImageCompressor compresses each tile with zlib. Unlike
+// vtkZlibImageCompressor, tiles are compressed concurrently, which scales
+// zlib's throughput with the number of cores at a small cost in compression
+// ratio. The compression level varies between 1 and 9, 1 being the fastest.
+//
+// The configuration stream is:
+// [ClassName, LossLessMode, TileSize, DeltaMode, CompressionLevel].
+// .SECTION See Also
+// vtkTiledImageCompressor vtkZlibImageCompressor
+
+#ifndef __vtkTiledZlibImageCompressor_h
+#define __vtkTiledZlibImageCompressor_h
+
+#include "vtkTiledImageCompressor.h"
+#include "vtkPVVTKExtensionsRenderingModule.h" // needed for export macro
+
+class vtkMultiProcessStream;
+
+class VTKPVVTKEXTENSIONSRENDERING_EXPORT vtkTiledZlibImageCompressor : public vtkTiledImageCompressor
+{
+public:
+  static vtkTiledZlibImageCompressor* New();
+  vtkTypeMacro(vtkTiledZlibImageCompressor, vtkTiledImageCompressor);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Set compression level. A setting of 1 is the fastest producing the
+  // smallest compression ratio while a setting of 9 is the slowest producing
+  // the highest compression ratio. Default is 1.
+  vtkSetClampMacro(CompressionLevel, int, 1, 9);
+  vtkGetMacro(CompressionLevel, int);
+
+  //BTX
+  // Description:
+  // Serialize/Restore compressor configuration (but not the data) into the stream.
+  virtual void SaveConfiguration(vtkMultiProcessStream *stream);
+  virtual bool RestoreConfiguration(vtkMultiProcessStream* stream);
+  //ETX
+  virtual const char *SaveConfiguration();
+  virtual const char *RestoreConfiguration(const char *stream);
+
+protected:
+  vtkTiledZlibImageCompressor();
+  virtual ~vtkTiledZlibImageCompressor();
+
+  virtual vtkIdType CompressTile(const unsigned char* in, vtkIdType inSize,
+    unsigned char* out) const;
+  virtual bool DecompressTile(const unsigned char* in, vtkIdType inSize,
+    unsigned char* out, vtkIdType outSize) const;
+  virtual vtkIdType GetMaximumCompressedTileSize(vtkIdType inSize) const;
+
+  int CompressionLevel;
+
+private:
+  vtkTiledZlibImageCompressor(const vtkTiledZlibImageCompressor&); // Not implemented.
+  void operator=(const vtkTiledZlibImageCompressor&); // Not implemented.
+};
+
+#endif
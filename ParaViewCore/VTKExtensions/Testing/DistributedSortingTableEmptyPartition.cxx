@@ -0,0 +1,188 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    DistributedSortingTableEmptyPartition.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Stream a distributed sort block by block while the last process has an
+// empty partition without the column to sort. All processes must take the
+// same collective path, a mismatch would hang the test.
+// This test requires at least 2 MPI processes.
+
+#include "vtkDoubleArray.h"
+#include "vtkMPIController.h"
+#include "vtkObjectFactory.h"
+#include "vtkProcess.h"
+#include "vtkSortedTableStreamer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTable.h"
+
+namespace
+{
+const vtkIdType NumberOfRowsPerProcess = 100;
+const vtkIdType BlockSize = 64;
+}
+
+class EmptyPartitionProcess : public vtkProcess
+{
+public:
+  static EmptyPartitionProcess *New();
+  vtkTypeMacro(EmptyPartitionProcess, vtkProcess);
+
+  virtual void Execute();
+
+protected:
+  EmptyPartitionProcess() {}
+
+  // Stream all the blocks sorted on the given component and check them on
+  // the root process. Returns false on failure.
+  bool CheckBlocks(vtkSortedTableStreamer* sortFilter, int component);
+};
+
+vtkStandardNewMacro(EmptyPartitionProcess);
+
+bool EmptyPartitionProcess::CheckBlocks(vtkSortedTableStreamer* sortFilter,
+                                        int component)
+{
+  int me = this->Controller->GetLocalProcessId();
+  int nbProc = this->Controller->GetNumberOfProcesses();
+  vtkIdType total = (nbProc - 1) * NumberOfRowsPerProcess;
+  vtkIdType nbBlocks = (total + BlockSize - 1) / BlockSize;
+
+  sortFilter->SetSelectedComponent(component);
+
+  bool status = true;
+  vtkIdType received = 0;
+  double last = -VTK_DOUBLE_MAX;
+  // Request each block twice, the second request reuses the sort cache.
+  for (vtkIdType i = 0; i < 2 * nbBlocks; ++i)
+    {
+    vtkIdType block = i / 2;
+    sortFilter->SetBlock(block);
+    sortFilter->Update();
+
+    if (me != 0 || (i % 2) == 1)
+      {
+      continue;
+      }
+
+    vtkDoubleArray* data = vtkDoubleArray::SafeDownCast(
+      sortFilter->GetOutput()->GetColumnByName("Data"));
+    if (!data)
+      {
+      cout << "Block " << block << " has no Data column." << endl;
+      return false;
+      }
+    for (vtkIdType j = 0; j < data->GetNumberOfTuples(); ++j)
+      {
+      double value = data->GetComponent(j, component);
+      if (value < last)
+        {
+        cout << "Block " << block << " is not sorted on component "
+             << component << " at row " << j << "." << endl;
+        status = false;
+        }
+      last = value;
+      }
+    received += data->GetNumberOfTuples();
+    }
+
+  if (me == 0 && received != total)
+    {
+    cout << "Received " << received << " rows, expected " << total << "."
+         << endl;
+    status = false;
+    }
+  return status;
+}
+
+void EmptyPartitionProcess::Execute()
+{
+  int me = this->Controller->GetLocalProcessId();
+  int nbProc = this->Controller->GetNumberOfProcesses();
+
+  // The last process keeps an empty table.
+  vtkTable* table = vtkTable::New();
+  if (me != nbProc - 1)
+    {
+    vtkDoubleArray* data = vtkDoubleArray::New();
+    data->SetName("Data");
+    data->SetNumberOfComponents(2);
+    data->SetNumberOfTuples(NumberOfRowsPerProcess);
+    for (vtkIdType i = 0; i < NumberOfRowsPerProcess; ++i)
+      {
+      double value = static_cast<double>((i * 37 + me * 11) % 101);
+      data->SetComponent(i, 0, value);
+      data->SetComponent(i, 1, -value);
+      }
+    table->AddColumn(data);
+    data->Delete();
+    }
+
+  vtkSortedTableStreamer* sortFilter = vtkSortedTableStreamer::New();
+  sortFilter->SetInputData(table);
+  sortFilter->SetColumnNameToSort("Data");
+  sortFilter->SetBlockSize(BlockSize);
+
+  vtkStreamingDemandDrivenPipeline* exec =
+    vtkStreamingDemandDrivenPipeline::SafeDownCast(sortFilter->GetExecutive());
+  exec->SetUpdateExtent(0, me, nbProc, 0);
+
+  // Changing the component invalidates the cache on every process but the
+  // empty one.
+  bool status = this->CheckBlocks(sortFilter, 0);
+  status = this->CheckBlocks(sortFilter, 1) && status;
+
+  int localStatus = status ? 1 : 0;
+  this->ReturnValue = 0;
+  this->Controller->AllReduce(&localStatus, &this->ReturnValue, 1,
+                              vtkCommunicator::MIN_OP);
+
+  sortFilter->Delete();
+  table->Delete();
+}
+
+int main(int argc, char **argv)
+{
+  int retVal = 1;
+
+  vtkMPIController *contr = vtkMPIController::New();
+  contr->Initialize(&argc, &argv);
+
+  vtkMultiProcessController::SetGlobalController(contr);
+
+  int numProcs = contr->GetNumberOfProcesses();
+  int me = contr->GetLocalProcessId();
+
+  if (numProcs < 2)
+    {
+    if (me == 0)
+      {
+      cout << "DistributedSortingTableEmptyPartition test requires more than 1 process" << endl;
+      }
+    contr->Finalize();
+    contr->Delete();
+    return retVal;
+    }
+
+  EmptyPartitionProcess *p = EmptyPartitionProcess::New();
+  contr->SetSingleProcessObject(p);
+  contr->SingleMethodExecute();
+
+  retVal = p->GetReturnValue();
+  p->Delete();
+
+  contr->Finalize();
+  contr->Delete();
+
+  return !retVal;
+}
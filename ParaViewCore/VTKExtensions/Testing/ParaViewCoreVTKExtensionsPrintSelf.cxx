@@ -54,6 +54,7 @@
 #include "vtkIsoVolume.h"
 #include "vtkKdTreeGenerator.h"
 #include "vtkKdTreeManager.h"
+#include "vtkLZ4ImageCompressor.h"
 #include "vtkMarkSelectedRows.h"
 #include "vtkMaterialInterfaceCommBuffer.h"
 #include "vtkMaterialInterfaceFilter.h"
@@ -131,6 +132,7 @@
 #include "vtkPVTrackballRoll.h"
 #include "vtkPVTrackballRotate.h"
 #include "vtkPVTrackballZoom.h"
+#include "vtkPVTraceRecorder.h"
 #include "vtkPVTransform.h"
 #include "vtkPVTrivialProducer.h"
 #include "vtkPVUpdateSuppressor.h"
@@ -153,6 +155,7 @@
 #include "vtkSquirtCompressor.h"
 #include "vtkSurfaceVectors.h"
 #include "vtkTexturePainter.h"
+#include "vtkTiledZlibImageCompressor.h"
 #include "vtkTilesHelper.h"
 #include "vtkTileDisplayHelper.h"
 #include "vtkTimeToTextConvertor.h"
@@ -237,6 +240,7 @@ int ParaViewCoreVTKExtensionsPrintSelf(int , char *[])
   PRINT_SELF(vtkIsoVolume);
   PRINT_SELF(vtkKdTreeGenerator);
   PRINT_SELF(vtkKdTreeManager);
+  PRINT_SELF(vtkLZ4ImageCompressor);
   PRINT_SELF(vtkMarkSelectedRows);
   //PRINT_SELF(vtkMaterialInterfaceCommBuffer);
   PRINT_SELF(vtkMaterialInterfaceFilter);
@@ -314,6 +318,7 @@ int ParaViewCoreVTKExtensionsPrintSelf(int , char *[])
   PRINT_SELF(vtkPVTrackballRoll);
   PRINT_SELF(vtkPVTrackballRotate);
   PRINT_SELF(vtkPVTrackballZoom);
+  PRINT_SELF(vtkPVTraceRecorder);
   PRINT_SELF(vtkPVTransform);
   PRINT_SELF(vtkPVTrivialProducer);
   PRINT_SELF(vtkPVUpdateSuppressor);
@@ -336,6 +341,7 @@ int ParaViewCoreVTKExtensionsPrintSelf(int , char *[])
   PRINT_SELF(vtkSquirtCompressor);
   PRINT_SELF(vtkSurfaceVectors);
   PRINT_SELF(vtkTexturePainter);
+  PRINT_SELF(vtkTiledZlibImageCompressor);
   //PRINT_SELF(vtkTilesHelper);
   //PRINT_SELF(vtkTileDisplayHelper);
   PRINT_SELF(vtkTimeToTextConvertor);
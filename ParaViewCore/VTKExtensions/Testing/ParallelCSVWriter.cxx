@@ -0,0 +1,370 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    ParallelCSVWriter.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Write a table collectively with vtkCSVWriter, each process writing its own
+// rows into the same file, and compare the file with the whole table written
+// serially. The serial file is also compared with the text the writer
+// produced when it formatted values through a stream. The first process has
+// more rows than fit in a batch, the last one has an empty partition without
+// columns.
+// This test requires at least 2 MPI processes.
+
+#include "vtkCharArray.h"
+#include "vtkCSVWriter.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkIntArray.h"
+#include "vtkMPIController.h"
+#include "vtkObjectFactory.h"
+#include "vtkProcess.h"
+#include "vtkSmartPointer.h"
+#include "vtkStringArray.h"
+#include "vtkTable.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+namespace
+{
+// more than the 16384 * 64 rows the writer formats per batch.
+const vtkIdType LargePartitionRows = 1100000;
+
+vtkIdType NumberOfRows(int proc, int nbProc)
+{
+  if (proc == nbProc - 1)
+    {
+    return 0;
+    }
+  return proc == 0? LargePartitionRows : 1000 + 37 * proc;
+}
+
+vtkIdType FirstRow(int proc, int nbProc)
+{
+  vtkIdType first = 0;
+  for (int cc = 0; cc < proc; ++cc)
+    {
+    first += NumberOfRows(cc, nbProc);
+    }
+  return first;
+}
+
+// Rows [first, first + count) of the table, whatever the partition.
+vtkSmartPointer<vtkTable> NewTable(vtkIdType first, vtkIdType count)
+{
+  vtkSmartPointer<vtkDoubleArray> doubles =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  doubles->SetName("Doubles");
+  doubles->SetNumberOfComponents(2);
+  doubles->SetNumberOfTuples(count);
+  vtkSmartPointer<vtkFloatArray> floats = vtkSmartPointer<vtkFloatArray>::New();
+  floats->SetName("Floats");
+  floats->SetNumberOfTuples(count);
+  vtkSmartPointer<vtkIntArray> ints = vtkSmartPointer<vtkIntArray>::New();
+  ints->SetName("Ints");
+  ints->SetNumberOfTuples(count);
+  vtkSmartPointer<vtkIdTypeArray> ids = vtkSmartPointer<vtkIdTypeArray>::New();
+  ids->SetName("Ids");
+  ids->SetNumberOfTuples(count);
+  vtkSmartPointer<vtkCharArray> chars = vtkSmartPointer<vtkCharArray>::New();
+  chars->SetName("Chars");
+  chars->SetNumberOfTuples(count);
+  vtkSmartPointer<vtkUnsignedCharArray> bytes =
+    vtkSmartPointer<vtkUnsignedCharArray>::New();
+  bytes->SetName("Bytes");
+  bytes->SetNumberOfTuples(count);
+  vtkSmartPointer<vtkStringArray> strings =
+    vtkSmartPointer<vtkStringArray>::New();
+  strings->SetName("Strings");
+  strings->SetNumberOfTuples(count);
+
+  for (vtkIdType i = 0; i < count; ++i)
+    {
+    vtkIdType row = first + i;
+    doubles->SetComponent(i, 0, (row - 500000) * 1.37e-3);
+    doubles->SetComponent(i, 1, 1.0e-12 / (row + 1) + row * 1.0e6);
+    floats->SetValue(i, static_cast<float>(row) / 7.0f);
+    ints->SetValue(i, static_cast<int>((row * 7919) % 100003) - 50000);
+    ids->SetValue(i, row * 1000003);
+    chars->SetValue(i, static_cast<char>(row % 128 - 64));
+    bytes->SetValue(i, static_cast<unsigned char>(row % 256));
+    std::ostringstream value;
+    value << "row " << row;
+    strings->SetValue(i, value.str());
+    }
+
+  vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
+  table->AddColumn(doubles);
+  table->AddColumn(floats);
+  table->AddColumn(ints);
+  table->AddColumn(ids);
+  table->AddColumn(chars);
+  table->AddColumn(bytes);
+  table->AddColumn(strings);
+  return table;
+}
+
+template <class T>
+void AppendValue(std::ostream& stream, T value)
+{
+  stream << value;
+}
+
+void AppendValue(std::ostream& stream, char value)
+{
+  stream << static_cast<int>(value);
+}
+
+void AppendValue(std::ostream& stream, unsigned char value)
+{
+  stream << static_cast<int>(value);
+}
+
+template <class T>
+void AppendValues(std::ostream& stream, T* values, vtkIdType row,
+  int numComps, bool* first)
+{
+  for (int comp = 0; comp < numComps; ++comp)
+    {
+    if (!*first)
+      {
+      stream << ",";
+      }
+    *first = false;
+    AppendValue(stream, values[row * numComps + comp]);
+    }
+}
+
+// The text vtkCSVWriter wrote for the table with its default delimiters when
+// it formatted values through a stream.
+std::string ReferenceText(vtkTable* table, int precision, bool scientific)
+{
+  std::ostringstream stream;
+  bool first = true;
+  for (vtkIdType col = 0; col < table->GetNumberOfColumns(); ++col)
+    {
+    vtkAbstractArray* array = table->GetColumn(col);
+    for (int comp = 0; comp < array->GetNumberOfComponents(); ++comp)
+      {
+      stream << (first? "" : ",") << "\"" << array->GetName();
+      if (array->GetNumberOfComponents() > 1)
+        {
+        stream << ":" << comp;
+        }
+      stream << "\"";
+      first = false;
+      }
+    }
+  stream << "\n";
+
+  if (scientific)
+    {
+    stream << std::scientific;
+    }
+  stream << std::setprecision(precision);
+  for (vtkIdType row = 0; row < table->GetNumberOfRows(); ++row)
+    {
+    first = true;
+    for (vtkIdType col = 0; col < table->GetNumberOfColumns(); ++col)
+      {
+      vtkAbstractArray* array = table->GetColumn(col);
+      vtkStringArray* strings = vtkStringArray::SafeDownCast(array);
+      if (strings)
+        {
+        stream << (first? "" : ",") << "\"" << strings->GetValue(row) << "\"";
+        first = false;
+        continue;
+        }
+      switch (array->GetDataType())
+        {
+        vtkTemplateMacro(AppendValues(stream,
+            static_cast<VTK_TT*>(array->GetVoidPointer(0)), row,
+            array->GetNumberOfComponents(), &first));
+        }
+      }
+    stream << "\n";
+    }
+  return stream.str();
+}
+
+std::string ReadFile(const std::string& fileName)
+{
+  std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+  return std::string((std::istreambuf_iterator<char>(file)),
+    std::istreambuf_iterator<char>());
+}
+
+// Returns a description of the first difference between a and b, or an empty
+// string if they are equal.
+std::string Difference(const std::string& a, const std::string& b)
+{
+  if (a == b)
+    {
+    return std::string();
+    }
+  size_t pos = 0;
+  while (pos < a.size() && pos < b.size() && a[pos] == b[pos])
+    {
+    ++pos;
+    }
+  std::ostringstream diff;
+  diff << "sizes " << a.size() << " and " << b.size()
+       << ", first difference at byte " << pos << ": \""
+       << a.substr(pos, 40) << "\" vs \"" << b.substr(pos, 40) << "\"";
+  return diff.str();
+}
+}
+
+class ParallelCSVWriterProcess : public vtkProcess
+{
+public:
+  static ParallelCSVWriterProcess *New();
+  vtkTypeMacro(ParallelCSVWriterProcess, vtkProcess);
+
+  virtual void Execute();
+
+  std::string TempDir;
+
+protected:
+  ParallelCSVWriterProcess() {}
+
+  // Writes the table collectively and, on the root process, serially, then
+  // compares the files on the root process. Returns false on failure.
+  bool Check(int precision, bool scientific);
+};
+
+vtkStandardNewMacro(ParallelCSVWriterProcess);
+
+bool ParallelCSVWriterProcess::Check(int precision, bool scientific)
+{
+  int me = this->Controller->GetLocalProcessId();
+  int nbProc = this->Controller->GetNumberOfProcesses();
+  std::string collectiveName = this->TempDir + "/ParallelCSVWriter.csv";
+  std::string serialName = this->TempDir + "/ParallelCSVWriterSerial.csv";
+
+  // The last process keeps an empty table without columns.
+  vtkSmartPointer<vtkTable> partition = vtkSmartPointer<vtkTable>::New();
+  if (me != nbProc - 1)
+    {
+    partition = NewTable(FirstRow(me, nbProc), NumberOfRows(me, nbProc));
+    }
+  vtkSmartPointer<vtkCSVWriter> writer = vtkSmartPointer<vtkCSVWriter>::New();
+  writer->SetInputData(partition);
+  writer->SetFileName(collectiveName.c_str());
+  writer->SetPrecision(precision);
+  writer->SetUseScientificNotation(scientific);
+  writer->SetController(this->Controller);
+  writer->Write();
+  if (writer->GetErrorCode() != 0)
+    {
+    cout << "Process " << me << " failed writing " << collectiveName << "."
+         << endl;
+    return false;
+    }
+  if (me != 0)
+    {
+    return true;
+    }
+
+  vtkSmartPointer<vtkTable> table = NewTable(0, FirstRow(nbProc, nbProc));
+  vtkSmartPointer<vtkCSVWriter> serialWriter =
+    vtkSmartPointer<vtkCSVWriter>::New();
+  serialWriter->SetInputData(table);
+  serialWriter->SetFileName(serialName.c_str());
+  serialWriter->SetPrecision(precision);
+  serialWriter->SetUseScientificNotation(scientific);
+  serialWriter->Write();
+  if (serialWriter->GetErrorCode() != 0)
+    {
+    cout << "Failed writing " << serialName << "." << endl;
+    return false;
+    }
+
+  std::string serial = ReadFile(serialName);
+  std::string diff = Difference(ReadFile(collectiveName), serial);
+  if (!diff.empty())
+    {
+    cout << "Collective and serial writes differ with precision " << precision
+         << (scientific? " in scientific notation" : "") << ": " << diff
+         << endl;
+    return false;
+    }
+  diff = Difference(serial, ReferenceText(table, precision, scientific));
+  if (!diff.empty())
+    {
+    cout << "Serial write differs from the stream formatting with precision "
+         << precision << (scientific? " in scientific notation" : "") << ": "
+         << diff << endl;
+    return false;
+    }
+  return true;
+}
+
+void ParallelCSVWriterProcess::Execute()
+{
+  bool status = this->Check(5, true);
+  status = this->Check(9, false) && status;
+
+  int localStatus = status ? 1 : 0;
+  this->ReturnValue = 0;
+  this->Controller->AllReduce(&localStatus, &this->ReturnValue, 1,
+                              vtkCommunicator::MIN_OP);
+}
+
+int main(int argc, char **argv)
+{
+  int retVal = 1;
+
+  vtkMPIController *contr = vtkMPIController::New();
+  contr->Initialize(&argc, &argv);
+
+  vtkMultiProcessController::SetGlobalController(contr);
+
+  int numProcs = contr->GetNumberOfProcesses();
+  int me = contr->GetLocalProcessId();
+
+  if (numProcs < 2)
+    {
+    if (me == 0)
+      {
+      cout << "ParallelCSVWriter test requires more than 1 process" << endl;
+      }
+    contr->Finalize();
+    contr->Delete();
+    return retVal;
+    }
+
+  char* tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+
+  ParallelCSVWriterProcess *p = ParallelCSVWriterProcess::New();
+  p->TempDir = tempDir;
+  delete [] tempDir;
+  contr->SetSingleProcessObject(p);
+  contr->SingleMethodExecute();
+
+  retVal = p->GetReturnValue();
+  p->Delete();
+
+  contr->Finalize();
+  contr->Delete();
+
+  return !retVal;
+}
@@ -0,0 +1,160 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestSpyPlotUniReaderDecode.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Reads the cell data of a SpyPlot file from a memory mapping of the file
+// and through the file stream. Both must decode the same values for every
+// block and time step, including after an array is unselected and selected
+// again and when volume fractions are no longer down converted.
+
+#include "vtkDataArray.h"
+#include "vtkDataArraySelection.h"
+#include "vtkNew.h"
+#include "vtkSmartPointer.h"
+#include "vtkSpyPlotUniReader.h"
+#include "vtkTestUtilities.h"
+
+#include <iostream>
+#include <string.h>
+#include <string>
+
+namespace
+{
+vtkSmartPointer<vtkSpyPlotUniReader> NewReader(const char* fname,
+  vtkDataArraySelection* selection, int mapFile)
+{
+  vtkSmartPointer<vtkSpyPlotUniReader> reader =
+    vtkSmartPointer<vtkSpyPlotUniReader>::New();
+  reader->SetFileName(fname);
+  reader->SetCellArraySelection(selection);
+  reader->SetMapFile(mapFile);
+  if (!reader->ReadInformation())
+    {
+    return NULL;
+    }
+  return reader;
+}
+
+bool SameValues(vtkDataArray* a, vtkDataArray* b)
+{
+  return a->GetDataType() == b->GetDataType() &&
+    a->GetNumberOfComponents() == b->GetNumberOfComponents() &&
+    a->GetNumberOfTuples() == b->GetNumberOfTuples() &&
+    memcmp(a->GetVoidPointer(0), b->GetVoidPointer(0),
+      a->GetNumberOfTuples() * a->GetNumberOfComponents() *
+      a->GetDataTypeSize()) == 0;
+}
+
+// Reads every time step with both readers and compares the selected arrays
+// of every block.
+bool Compare(vtkSpyPlotUniReader* mapped, vtkSpyPlotUniReader* streamed,
+  vtkDataArraySelection* selection, const char* step)
+{
+  int numberOfArrays = 0;
+  int* range = mapped->GetTimeStepRange();
+  for (int timeStep = range[0]; timeStep <= range[1]; ++timeStep)
+    {
+    mapped->SetCurrentTimeStep(timeStep);
+    streamed->SetCurrentTimeStep(timeStep);
+    mapped->SetNeedToCheck(1);
+    streamed->SetNeedToCheck(1);
+    if (!mapped->MakeCurrent() || !streamed->MakeCurrent())
+      {
+      std::cerr << "ERROR: " << step << ": cannot read time step "
+                << timeStep << "." << std::endl;
+      return false;
+      }
+    int numberOfBlocks = mapped->GetNumberOfDataBlocks();
+    if (streamed->GetNumberOfDataBlocks() != numberOfBlocks)
+      {
+      std::cerr << "ERROR: " << step << ": different numbers of blocks."
+                << std::endl;
+      return false;
+      }
+    for (int field = 0; mapped->GetCellFieldName(field); ++field)
+      {
+      const char* name = mapped->GetCellFieldName(field);
+      if (!selection->ArrayIsEnabled(name))
+        {
+        continue;
+        }
+      for (int block = 0; block < numberOfBlocks; ++block)
+        {
+        int fixed;
+        vtkDataArray* a = mapped->GetCellFieldData(block, field, &fixed);
+        vtkDataArray* b = streamed->GetCellFieldData(block, field, &fixed);
+        if (!a || !b || !SameValues(a, b))
+          {
+          std::cerr << "ERROR: " << step << ": array " << name << " of block "
+                    << block << " differs at time step " << timeStep << "."
+                    << std::endl;
+          return false;
+          }
+        ++numberOfArrays;
+        }
+      }
+    }
+  if (numberOfArrays == 0)
+    {
+    std::cerr << "ERROR: " << step << ": no array compared." << std::endl;
+    return false;
+    }
+  return true;
+}
+}
+
+int TestSpyPlotUniReaderDecode(int argc, char* argv[])
+{
+  char* fname = vtkTestUtilities::ExpandDataFileName(
+    argc, argv, "Data/SPCTH/ball_and_box.spcth");
+  std::string fileName = fname;
+  delete [] fname;
+
+  vtkNew<vtkDataArraySelection> selection;
+  vtkSmartPointer<vtkSpyPlotUniReader> mapped =
+    NewReader(fileName.c_str(), selection.GetPointer(), 1);
+  vtkSmartPointer<vtkSpyPlotUniReader> streamed =
+    NewReader(fileName.c_str(), selection.GetPointer(), 0);
+  if (!mapped || !streamed)
+    {
+    std::cerr << "ERROR: Cannot read " << fileName << "." << std::endl;
+    return EXIT_FAILURE;
+    }
+  selection->EnableAllArrays();
+  if (!Compare(mapped, streamed, selection.GetPointer(), "all arrays"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // an array unselected is released, and read again once selected.
+  std::string name = selection->GetArrayName(0);
+  selection->DisableArray(name.c_str());
+  if (!Compare(mapped, streamed, selection.GetPointer(), "array unselected"))
+    {
+    return EXIT_FAILURE;
+    }
+  selection->EnableArray(name.c_str());
+  if (!Compare(mapped, streamed, selection.GetPointer(), "array reselected"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // volume fractions are decoded as floats rather than unsigned chars.
+  mapped->SetDownConvertVolumeFraction(0);
+  streamed->SetDownConvertVolumeFraction(0);
+  if (!Compare(mapped, streamed, selection.GetPointer(), "float fractions"))
+    {
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,268 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestTiledImageCompressor.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLZ4ImageCompressor.h"
+#include "vtkNew.h"
+#include "vtkTiledZlibImageCompressor.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <string.h>
+
+namespace
+{
+  const int WIDTH = 640;
+  const int HEIGHT = 480;
+
+  void FillImage(vtkUnsignedCharArray* image, int frame)
+    {
+    image->SetNumberOfComponents(4);
+    image->SetNumberOfTuples(WIDTH * HEIGHT);
+    unsigned char* ptr = image->GetPointer(0);
+    for (int y=0; y < HEIGHT; y++)
+      {
+      for (int x=0; x < WIDTH; x++, ptr += 4)
+        {
+        // a smooth background with a small square moving with the frame.
+        bool inSquare = (x >= 100 + frame && x < 140 + frame &&
+          y >= 100 && y < 140);
+        ptr[0] = inSquare? 255 : static_cast<unsigned char>(x / 3);
+        ptr[1] = inSquare? 0 : static_cast<unsigned char>(y / 2);
+        ptr[2] = static_cast<unsigned char>((x ^ y) & 0x0f);
+        ptr[3] = 255;
+        }
+      }
+    }
+
+  bool Compress(vtkTiledImageCompressor* sender, vtkUnsignedCharArray* image,
+    vtkUnsignedCharArray* compressed)
+    {
+    sender->SetInput(image);
+    if (sender->Compress() != VTK_OK)
+      {
+      cerr << "ERROR: Compress failed." << endl;
+      return false;
+      }
+    compressed->DeepCopy(sender->GetOutput());
+    return true;
+    }
+
+  bool Decompress(vtkTiledImageCompressor* receiver,
+    vtkUnsignedCharArray* compressed, vtkUnsignedCharArray* result)
+    {
+    result->SetNumberOfComponents(4);
+    result->SetNumberOfTuples(WIDTH * HEIGHT);
+    receiver->SetInput(compressed);
+    receiver->SetOutput(result);
+    return receiver->Decompress() == VTK_OK;
+    }
+
+  bool RoundTrip(vtkTiledImageCompressor* sender,
+    vtkTiledImageCompressor* receiver, vtkUnsignedCharArray* image,
+    vtkIdType& compressedSize)
+    {
+    vtkNew<vtkUnsignedCharArray> compressed;
+    if (!Compress(sender, image, compressed.GetPointer()))
+      {
+      return false;
+      }
+    compressedSize = compressed->GetNumberOfTuples();
+
+    vtkNew<vtkUnsignedCharArray> result;
+    if (!Decompress(receiver, compressed.GetPointer(), result.GetPointer()))
+      {
+      cerr << "ERROR: Decompress failed." << endl;
+      return false;
+      }
+    if (memcmp(result->GetPointer(0), image->GetPointer(0),
+        image->GetNumberOfTuples() * 4) != 0)
+      {
+      cerr << "ERROR: Decompressed image does not match the input." << endl;
+      return false;
+      }
+    return true;
+    }
+
+  bool TestCompressor(vtkTiledImageCompressor* sender,
+    vtkTiledImageCompressor* receiver)
+    {
+    const char* config = sender->SaveConfiguration();
+    if (receiver->RestoreConfiguration(config) == NULL ||
+      receiver->GetTileSize() != sender->GetTileSize() ||
+      receiver->GetDeltaMode() != sender->GetDeltaMode())
+      {
+      cerr << "ERROR: Failed to restore configuration " << config << endl;
+      return false;
+      }
+
+    vtkNew<vtkUnsignedCharArray> image;
+    vtkIdType keyFrameSize, deltaFrameSize, unchangedFrameSize;
+    FillImage(image.GetPointer(), 0);
+    if (!RoundTrip(sender, receiver, image.GetPointer(), keyFrameSize))
+      {
+      return false;
+      }
+    FillImage(image.GetPointer(), 5);
+    if (!RoundTrip(sender, receiver, image.GetPointer(), deltaFrameSize))
+      {
+      return false;
+      }
+    if (!RoundTrip(sender, receiver, image.GetPointer(), unchangedFrameSize))
+      {
+      return false;
+      }
+    cout << sender->GetClassName() << ": raw " << WIDTH * HEIGHT * 4
+      << ", key frame " << keyFrameSize << ", delta frame " << deltaFrameSize
+      << ", unchanged frame " << unchangedFrameSize << endl;
+    if (keyFrameSize >= WIDTH * HEIGHT * 4 ||
+      deltaFrameSize >= keyFrameSize || unchangedFrameSize >= deltaFrameSize)
+      {
+      cerr << "ERROR: Unexpected compressed sizes." << endl;
+      return false;
+      }
+    return true;
+    }
+
+  // A lost frame must not be silently decoded against the wrong base: the
+  // receiver rejects the deltas until the sender sends a key frame, either
+  // on request or periodically.
+  bool TestResync(vtkTiledImageCompressor* sender,
+    vtkTiledImageCompressor* receiver)
+    {
+    sender->ResetAllDeltas();
+    receiver->ResetAllDeltas();
+    sender->SetKeyFrameInterval(3);
+
+    vtkNew<vtkUnsignedCharArray> image;
+    vtkNew<vtkUnsignedCharArray> compressed;
+    vtkNew<vtkUnsignedCharArray> result;
+    vtkIdType size;
+    FillImage(image.GetPointer(), 0);
+    if (!RoundTrip(sender, receiver, image.GetPointer(), size))
+      {
+      return false;
+      }
+
+    // frame 1 is lost.
+    FillImage(image.GetPointer(), 1);
+    if (!Compress(sender, image.GetPointer(), compressed.GetPointer()))
+      {
+      return false;
+      }
+    FillImage(image.GetPointer(), 2);
+    if (!Compress(sender, image.GetPointer(), compressed.GetPointer()))
+      {
+      return false;
+      }
+    cerr << "Expecting an error about an out of step delta frame." << endl;
+    if (Decompress(receiver, compressed.GetPointer(), result.GetPointer()))
+      {
+      cerr << "ERROR: A delta against a lost frame was decoded." << endl;
+      return false;
+      }
+
+    // the key frame requested after the failure resynchronizes.
+    sender->ResetDelta();
+    FillImage(image.GetPointer(), 3);
+    if (!RoundTrip(sender, receiver, image.GetPointer(), size))
+      {
+      return false;
+      }
+
+    // a periodic key frame resynchronizes too, without a request.
+    FillImage(image.GetPointer(), 4);
+    if (!Compress(sender, image.GetPointer(), compressed.GetPointer()))
+      {
+      return false;
+      }
+    int frame = 5;
+    for (; frame < 5 + sender->GetKeyFrameInterval(); frame++)
+      {
+      FillImage(image.GetPointer(), frame);
+      if (!Compress(sender, image.GetPointer(), compressed.GetPointer()))
+        {
+        return false;
+        }
+      if (Decompress(receiver, compressed.GetPointer(), result.GetPointer()))
+        {
+        break;
+        }
+      }
+    if (frame == 5 + sender->GetKeyFrameInterval() ||
+      memcmp(result->GetPointer(0), image->GetPointer(0),
+        image->GetNumberOfTuples() * 4) != 0)
+      {
+      cerr << "ERROR: No periodic key frame resynchronized the receiver."
+           << endl;
+      return false;
+      }
+    return true;
+    }
+
+  // Frames sent to two destinations, interleaved, are deltas against the
+  // previous frame sent to the same destination.
+  bool TestDestinations(vtkTiledImageCompressor* sender,
+    vtkTiledImageCompressor* receiver1, vtkTiledImageCompressor* receiver2)
+    {
+    sender->ResetAllDeltas();
+    sender->SetKeyFrameInterval(0);
+    vtkTiledImageCompressor* receivers[2] = { receiver1, receiver2 };
+    vtkNew<vtkUnsignedCharArray> image;
+    for (int frame=0; frame < 6; frame++)
+      {
+      int destination = frame % 2;
+      sender->SetDestination(destination + 1);
+      // each destination sees its own sequence of images.
+      FillImage(image.GetPointer(), 10 * destination + frame / 2);
+      vtkIdType size;
+      if (!RoundTrip(sender, receivers[destination], image.GetPointer(),
+          size))
+        {
+        cerr << "ERROR: Frame " << frame << " for destination "
+             << destination + 1 << " failed." << endl;
+        return false;
+        }
+      }
+    sender->SetDestination(0);
+    return true;
+    }
+}
+
+int TestTiledImageCompressor(int, char*[])
+{
+  vtkNew<vtkLZ4ImageCompressor> lz4Sender;
+  vtkNew<vtkLZ4ImageCompressor> lz4Receiver;
+  lz4Sender->SetTileSize(16384);
+  lz4Sender->DeltaModeOn();
+  if (!TestCompressor(lz4Sender.GetPointer(), lz4Receiver.GetPointer()) ||
+    !TestResync(lz4Sender.GetPointer(), lz4Receiver.GetPointer()))
+    {
+    return 1;
+    }
+  vtkNew<vtkLZ4ImageCompressor> lz4Receiver2;
+  if (!TestDestinations(lz4Sender.GetPointer(), lz4Receiver.GetPointer(),
+      lz4Receiver2.GetPointer()))
+    {
+    return 1;
+    }
+
+  vtkNew<vtkTiledZlibImageCompressor> zlibSender;
+  vtkNew<vtkTiledZlibImageCompressor> zlibReceiver;
+  zlibSender->SetCompressionLevel(3);
+  zlibSender->DeltaModeOn();
+  if (!TestCompressor(zlibSender.GetPointer(), zlibReceiver.GetPointer()))
+    {
+    return 1;
+    }
+  return 0;
+}
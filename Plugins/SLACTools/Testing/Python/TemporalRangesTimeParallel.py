@@ -0,0 +1,96 @@
+# Checks that TemporalRanges computes the same table whether the data
+# (TimeParallel off) or the time steps (TimeParallel on) are split across the
+# processes, with more and with fewer time steps than processes.
+
+from paraview.simple import *
+from paraview import servermanager
+from paraview import smtesting
+
+smtesting.ProcessCommandLineArguments()
+
+LoadDistributedPlugin('SLACTools', True, globals())
+
+NUMBER_OF_POINTS = 1000
+
+# Time steps 0, 1, ..., steps - 1 of a data set that can be read in pieces.
+informationScript = """
+import vtk
+sddp = vtk.vtkStreamingDemandDrivenPipeline
+outInfo = self.GetExecutive().GetOutputInformation(0)
+outInfo.Remove(sddp.TIME_STEPS())
+for t in range(%(steps)d):
+  outInfo.Append(sddp.TIME_STEPS(), t)
+outInfo.Remove(sddp.TIME_RANGE())
+outInfo.Append(sddp.TIME_RANGE(), 0)
+outInfo.Append(sddp.TIME_RANGE(), %(steps)d - 1)
+outInfo.Set(sddp.MAXIMUM_NUMBER_OF_PIECES(), -1)
+"""
+
+script = """
+import math
+import vtk
+sddp = vtk.vtkStreamingDemandDrivenPipeline
+outInfo = self.GetExecutive().GetOutputInformation(0)
+piece = outInfo.Get(sddp.UPDATE_PIECE_NUMBER())
+numPieces = outInfo.Get(sddp.UPDATE_NUMBER_OF_PIECES())
+t = outInfo.Get(sddp.UPDATE_TIME_STEP())
+
+points = vtk.vtkPoints()
+scalars = vtk.vtkDoubleArray()
+scalars.SetName('Scalar')
+vectors = vtk.vtkDoubleArray()
+vectors.SetName('Vector')
+vectors.SetNumberOfComponents(3)
+for i in range(%(points)d*piece/numPieces, %(points)d*(piece + 1)/numPieces):
+  points.InsertNextPoint(i, 0, 0)
+  scalars.InsertNextValue(math.sin(0.1*i + t))
+  vectors.InsertNextTuple3(i*t, -t, math.cos(i))
+
+output = self.GetOutput()
+output.SetPoints(points)
+output.GetPointData().AddArray(scalars)
+output.GetPointData().AddArray(vectors)
+"""
+
+def ComputeRanges(steps, timeParallel):
+  source = ProgrammableSource(OutputDataSetType='vtkPolyData')
+  source.ScriptRequestInformation = informationScript % { 'steps' : steps }
+  source.Script = script % { 'points' : NUMBER_OF_POINTS }
+  ranges = TemporalRanges(Input=source)
+  ranges.TimeParallel = timeParallel
+  ranges.UpdatePipeline()
+  # the reduced table is on the root.
+  table = servermanager.Fetch(ranges, 0)
+  Delete(ranges)
+  Delete(source)
+  return table
+
+def Columns(table):
+  columns = {}
+  for c in range(table.GetNumberOfColumns()):
+    column = table.GetColumn(c)
+    if column.IsA('vtkDoubleArray'):
+      columns[column.GetName()] = \
+        [column.GetValue(r) for r in range(column.GetNumberOfTuples())]
+  return columns
+
+COUNT_ROW = 3
+for steps in [2, 7]:
+  expected = Columns(ComputeRanges(steps, 0))
+  actual = Columns(ComputeRanges(steps, 1))
+  if sorted(actual.keys()) != sorted(expected.keys()) or not expected:
+    raise smtesting.TestError, \
+      'Columns differ with %d time steps: %s, expected %s.' % \
+      (steps, sorted(actual.keys()), sorted(expected.keys()))
+  for name in expected:
+    if expected[name][COUNT_ROW] != steps*NUMBER_OF_POINTS:
+      raise smtesting.TestError, \
+        '%s has %g values over %d time steps, expected %d.' % \
+        (name, expected[name][COUNT_ROW], steps, steps*NUMBER_OF_POINTS)
+    for e, a in zip(expected[name], actual[name]):
+      if abs(a - e) > 1e-9*max(1.0, abs(e)):
+        raise smtesting.TestError, \
+          '%s differs with %d time steps: %s, expected %s.' % \
+          (name, steps, actual[name], expected[name])
+
+print 'Test passes'
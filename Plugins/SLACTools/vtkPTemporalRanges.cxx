@@ -28,6 +28,8 @@
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTable.h"
 
+#include <algorithm>
+
 #include "vtkSmartPointer.h"
 #define VTK_CREATE(type, name) \
   vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
@@ -100,6 +102,7 @@ vtkPTemporalRanges::vtkPTemporalRanges()
 {
   this->Controller = NULL;
   this->SetController(vtkMultiProcessController::GetGlobalController());
+  this->TimeParallel = 0;
 }
 
 vtkPTemporalRanges::~vtkPTemporalRanges()
@@ -112,6 +115,99 @@ void vtkPTemporalRanges::PrintSelf(ostream &os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
 
   os << indent << "Controller: " << this->Controller << endl;
+  os << indent << "TimeParallel: " << this->TimeParallel << endl;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkPTemporalRanges::IsTimeParallel()
+{
+  return (   this->TimeParallel && this->Controller
+          && (this->Controller->GetNumberOfProcesses() > 1) );
+}
+
+//-----------------------------------------------------------------------------
+void vtkPTemporalRanges::GetTimeStepRange(int numTimeSteps, int range[2])
+{
+  if (!this->IsTimeParallel())
+    {
+    this->Superclass::GetTimeStepRange(numTimeSteps, range);
+    return;
+    }
+
+  // Contiguous ranges keep consecutive time steps on the same process, which
+  // is friendlier to readers caching data between time steps. With fewer
+  // time steps than processes, each process gets one time step, shared with
+  // the other processes of its group (see GetPiece()), so that none of them
+  // sits idle.
+  int numProcs = this->Controller->GetNumberOfProcesses();
+  int procId = this->Controller->GetLocalProcessId();
+  range[0] = static_cast<int>(
+    (static_cast<vtkTypeInt64>(numTimeSteps)*procId)/numProcs);
+  range[1] = static_cast<int>(
+    (static_cast<vtkTypeInt64>(numTimeSteps)*(procId+1))/numProcs);
+  if (numTimeSteps < numProcs)
+    {
+    range[1] = std::min(range[0] + 1, numTimeSteps);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkPTemporalRanges::GetPiece(int numTimeSteps,
+                                  int &piece, int &numPieces)
+{
+  int numProcs = this->Controller->GetNumberOfProcesses();
+  int procId = this->Controller->GetLocalProcessId();
+  if (numTimeSteps >= numProcs)
+    {
+    piece = 0;
+    numPieces = 1;
+    return;
+    }
+
+  // The processes sharing time step t are those for which
+  // numTimeSteps*procId/numProcs == t, that is [ceil(t*numProcs/numTimeSteps),
+  // ceil((t+1)*numProcs/numTimeSteps)).
+  vtkTypeInt64 timeStep = (static_cast<vtkTypeInt64>(numTimeSteps)*procId)
+    / numProcs;
+  int first = static_cast<int>(
+    (timeStep*numProcs + numTimeSteps - 1)/numTimeSteps);
+  int last = static_cast<int>(
+    ((timeStep+1)*numProcs + numTimeSteps - 1)/numTimeSteps);
+  piece = procId - first;
+  numPieces = last - first;
+}
+
+//-----------------------------------------------------------------------------
+int vtkPTemporalRanges::RequestUpdateExtent(vtkInformation *request,
+                                            vtkInformationVector **inputVector,
+                                            vtkInformationVector *outputVector)
+{
+  if (!this->Superclass::RequestUpdateExtent(request, inputVector,
+                                             outputVector))
+    {
+    return 0;
+    }
+
+  vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
+  int numTimeSteps
+    = inInfo->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+  int range[2];
+  this->GetTimeStepRange(numTimeSteps, range);
+  if (this->IsTimeParallel() && (range[0] < range[1]))
+    {
+    // Each process covers the whole data set for its own time steps, or its
+    // share of it when several processes work on the same time step.
+    int piece, numPieces;
+    this->GetPiece(numTimeSteps, piece, numPieces);
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER(),
+                piece);
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES(),
+                numPieces);
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_GHOST_LEVELS(),
+                0);
+    }
+
+  return 1;
 }
 
 //-----------------------------------------------------------------------------
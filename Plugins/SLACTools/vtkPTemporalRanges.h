@@ -25,6 +25,15 @@
 // vtkPTemporalRanges works basically like its superclass, vtkTemporalRanges,
 // except that it works in a data parallel manner.
 //
+// When TimeParallel is on, it works in a time parallel manner instead: the
+// time steps are split in contiguous ranges across the processes, each
+// process iterates over its own range requesting the whole data set, and the
+// partial tables are reduced at the end as usual. When there are fewer time
+// steps than processes, the processes sharing a time step split its data
+// instead. This requires a reader that can provide the whole data set on any
+// process. With many time steps this scales much better than iterating over
+// all of them on every process.
+//
 
 #ifndef __vtkPTemporalRanges_h
 #define __vtkPTemporalRanges_h
@@ -43,11 +52,23 @@ public:
   vtkGetObjectMacro(Controller, vtkMultiProcessController);
   virtual void SetController(vtkMultiProcessController *);
 
+  // Description:
+  // When on, the time steps, rather than the data, are split across the
+  // processes. Off by default.
+  vtkSetMacro(TimeParallel, int);
+  vtkGetMacro(TimeParallel, int);
+  vtkBooleanMacro(TimeParallel, int);
+
 protected:
   vtkPTemporalRanges();
   ~vtkPTemporalRanges();
 
   vtkMultiProcessController *Controller;
+  int TimeParallel;
+
+  virtual int RequestUpdateExtent(vtkInformation *,
+                                  vtkInformationVector **,
+                                  vtkInformationVector *);
 
   virtual int RequestData(vtkInformation *,
                           vtkInformationVector **,
@@ -55,6 +76,19 @@ protected:
 
   virtual void Reduce(vtkTable *table);
 
+  virtual void GetTimeStepRange(int numTimeSteps, int range[2]);
+
+  // Description:
+  // Returns true when the time steps are split across several processes.
+  bool IsTimeParallel();
+
+  // Description:
+  // In time parallel mode, returns the piece of the data set requested by
+  // this process for its time steps: the whole data set, unless there are
+  // fewer time steps than processes, in which case each time step is split
+  // among the processes working on it.
+  void GetPiece(int numTimeSteps, int &piece, int &numPieces);
+
 private:
   vtkPTemporalRanges(const vtkPTemporalRanges &);       // Not implemented
   void operator=(const vtkPTemporalRanges &);           // Not implemented
@@ -30,6 +30,8 @@
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStringArray.h"
 #include "vtkTable.h"
@@ -78,19 +80,6 @@ namespace vtkTemporalRangesNamespace{
     column->SetValue(COUNT_ROW,   0.0);
   }
 
-  inline void AccumulateValue(double value, vtkDoubleArray *column)
-  {
-    if (!isnan(value))
-      {
-      column->SetValue(AVERAGE_ROW, value + column->GetValue(AVERAGE_ROW));
-      column->SetValue(MINIMUM_ROW, std::min(column->GetValue(MINIMUM_ROW),
-                                                value));
-      column->SetValue(MAXIMUM_ROW, std::max(column->GetValue(MAXIMUM_ROW),
-                                                value));
-      column->SetValue(COUNT_ROW, column->GetValue(COUNT_ROW) + 1);
-      }
-  }
-
   inline void AccumulateColumn(vtkDoubleArray *source,
                                vtkDoubleArray *target)
   {
@@ -106,6 +95,106 @@ namespace vtkTemporalRangesNamespace{
                                               target->GetValue(MAXIMUM_ROW)));
     target->SetValue(COUNT_ROW, totalCount);
   }
+
+  // Accumulates the sum, minimum, maximum and count of each component (and
+  // of the magnitude, last, for arrays with several components) of a range
+  // of tuples, in thread local buffers that are merged by Reduce().
+  class AccumulateArrayFunctor
+  {
+  public:
+    vtkDataArray *Field;
+    int NumberOfComponents;
+    int NumberOfColumns;
+    std::vector<double> Values;
+    vtkSMPThreadLocal<std::vector<double> > LocalValues;
+
+    AccumulateArrayFunctor(vtkDataArray *field) : Field(field)
+    {
+      this->NumberOfComponents = field->GetNumberOfComponents();
+      this->NumberOfColumns = this->NumberOfComponents
+        + (this->NumberOfComponents > 1 ? 1 : 0);
+      this->InitializeValues(this->Values);
+    }
+
+    void InitializeValues(std::vector<double> &values)
+    {
+      values.resize(NUMBER_OF_ROWS*this->NumberOfColumns);
+      for (int c = 0; c < this->NumberOfColumns; c++)
+        {
+        double *column = &values[NUMBER_OF_ROWS*c];
+        column[AVERAGE_ROW] = 0.0;
+        column[MINIMUM_ROW] = vtkTypeTraits<double>::Max();
+        column[MAXIMUM_ROW] = vtkTypeTraits<double>::Min();
+        column[COUNT_ROW]   = 0.0;
+        }
+    }
+
+    void Initialize()
+    {
+      this->InitializeValues(this->LocalValues.Local());
+    }
+
+    static void AccumulateValue(double value, double *column)
+    {
+      if (!isnan(value))
+        {
+        column[AVERAGE_ROW] += value;
+        column[MINIMUM_ROW] = std::min(column[MINIMUM_ROW], value);
+        column[MAXIMUM_ROW] = std::max(column[MAXIMUM_ROW], value);
+        column[COUNT_ROW] += 1;
+        }
+    }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      double *values = &this->LocalValues.Local()[0];
+      for (vtkIdType i = begin; i < end; i++)
+        {
+        double mag = 0.0;
+        for (int j = 0; j < this->NumberOfComponents; j++)
+          {
+          double value = this->Field->GetComponent(i, j);
+          mag += value*value;
+          AccumulateValue(value, values + NUMBER_OF_ROWS*j);
+          }
+        if (this->NumberOfComponents > 1)
+          {
+          AccumulateValue(sqrt(mag),
+                          values + NUMBER_OF_ROWS*this->NumberOfComponents);
+          }
+        }
+    }
+
+    void Reduce()
+    {
+      vtkSMPThreadLocal<std::vector<double> >::iterator iter;
+      for (iter = this->LocalValues.begin();
+           iter != this->LocalValues.end(); ++iter)
+        {
+        for (int c = 0; c < this->NumberOfColumns; c++)
+          {
+          double *column = &this->Values[NUMBER_OF_ROWS*c];
+          const double *local = &(*iter)[NUMBER_OF_ROWS*c];
+          column[AVERAGE_ROW] += local[AVERAGE_ROW];
+          column[MINIMUM_ROW] = std::min(column[MINIMUM_ROW],
+                                         local[MINIMUM_ROW]);
+          column[MAXIMUM_ROW] = std::max(column[MAXIMUM_ROW],
+                                         local[MAXIMUM_ROW]);
+          column[COUNT_ROW] += local[COUNT_ROW];
+          }
+        }
+    }
+
+    // Stores the merged sum (not yet divided by the count), minimum,
+    // maximum and count of a column in an accumulation array.
+    void GetColumn(int c, vtkDoubleArray *target)
+    {
+      for (int r = 0; r < NUMBER_OF_ROWS; r++)
+        {
+        target->SetValue(r, this->Values[NUMBER_OF_ROWS*c + r]);
+        }
+    }
+  };
 };
 using namespace vtkTemporalRangesNamespace;
 
@@ -172,8 +261,13 @@ int vtkTemporalRanges::RequestUpdateExtent(
   double *inTimes = inInfo->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
   if (inTimes)
     {
+    int numTimeSteps
+      = inInfo->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+    int range[2];
+    this->GetTimeStepRange(numTimeSteps, range);
+    int index = std::min(range[0] + this->CurrentTimeIndex, numTimeSteps - 1);
     inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP(),
-                inTimes[this->CurrentTimeIndex]);
+                inTimes[index]);
     }
 
   return 1;
@@ -187,6 +281,11 @@ int vtkTemporalRanges::RequestData(vtkInformation *request,
   vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
   vtkTable *output = vtkTable::GetData(outputVector);
 
+  int numTimeSteps
+    = inInfo->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+  int range[2];
+  this->GetTimeStepRange(numTimeSteps, range);
+
   if (this->CurrentTimeIndex == 0)
     {
     // First execution.  Initialize table.
@@ -196,7 +295,11 @@ int vtkTemporalRanges::RequestData(vtkInformation *request,
   vtkCompositeDataSet *compositeInput = vtkCompositeDataSet::GetData(inInfo);
   vtkDataSet *dsInput = vtkDataSet::GetData(inInfo);
 
-  if (compositeInput)
+  if ((numTimeSteps > 0) && (range[0] >= range[1]))
+    {
+    // No time step to process here (they all went to other processes).
+    }
+  else if (compositeInput)
     {
     this->AccumulateCompositeData(compositeInput, output);
     }
@@ -213,8 +316,7 @@ int vtkTemporalRanges::RequestData(vtkInformation *request,
 
   this->CurrentTimeIndex++;
 
-  if (  this->CurrentTimeIndex
-      < inInfo->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS()) )
+  if (range[0] + this->CurrentTimeIndex < range[1])
     {
     // There is still more to do.
     request->Set(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING(), 1);
@@ -229,6 +331,13 @@ int vtkTemporalRanges::RequestData(vtkInformation *request,
   return 1;
 }
 
+//-----------------------------------------------------------------------------
+void vtkTemporalRanges::GetTimeStepRange(int numTimeSteps, int range[2])
+{
+  range[0] = 0;
+  range[1] = numTimeSteps;
+}
+
 //-----------------------------------------------------------------------------
 void vtkTemporalRanges::InitializeTable(vtkTable *output)
 {
@@ -317,20 +426,15 @@ void vtkTemporalRanges::AccumulateArray(vtkDataArray *field, vtkTable *output)
     InitializeColumn(componentAccumulate[0]);
     }
 
-  for (vtkIdType i = 0; i < numTuples; i++)
+  AccumulateArrayFunctor functor(field);
+  vtkSMPTools::For(0, numTuples, functor);
+  for (int j = 0; j < numComponents; j++)
     {
-    double mag = 0.0;
-    for (int j = 0; j < numComponents; j++)
-      {
-      double value = field->GetComponent(i, j);
-      mag += value*value;
-      AccumulateValue(value, componentAccumulate[j]);
-      }
-    if (magnitudeColumn)
-      {
-      mag = sqrt(mag);
-      AccumulateValue(mag, magnitudeAccumulate);
-      }
+    functor.GetColumn(j, componentAccumulate[j]);
+    }
+  if (magnitudeColumn)
+    {
+    functor.GetColumn(numComponents, magnitudeAccumulate);
     }
 
   for (int j = 0; j < numComponents; j++)
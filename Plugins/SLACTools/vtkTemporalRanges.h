@@ -31,6 +31,8 @@
 // and time, it will also give a single statistics over all blocks in a data
 // set.
 //
+// The values of each array are accumulated concurrently (using vtkSMPTools).
+//
 
 #ifndef __vtkTemporalRanges_h
 #define __vtkTemporalRanges_h
@@ -79,6 +81,12 @@ protected:
                           vtkInformationVector **,
                           vtkInformationVector *);
 
+  // Description:
+  // Returns the time steps, [range[0], range[1]), iterated over by this
+  // filter. Processes all of them by default. Subclasses can override this
+  // to share the time steps with other processes.
+  virtual void GetTimeStepRange(int numTimeSteps, int range[2]);
+
   virtual void InitializeTable(vtkTable *output);
 
   virtual void AccumulateCompositeData(vtkCompositeDataSet *input,
@@ -26,6 +26,14 @@ public:
   TerminationCondition();
   virtual ~TerminationCondition();
 
+  /**
+  Initialize from another termination condition. Private copies of
+  its periodic boundary faces and termination surfaces are built so
+  that both objects may be used concurrently. The working domain is
+  reset and the color mapper is not copied.
+  */
+  void Copy(const TerminationCondition &other);
+
   /**
   Determine if the segment p0->p1 intersects a periodic boundary.
   If so the bc is applied and the face id (1-6) is returned.
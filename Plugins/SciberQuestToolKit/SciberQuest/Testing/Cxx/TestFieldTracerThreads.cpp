@@ -0,0 +1,143 @@
+/*
+   ____    _ __           ____               __    ____
+  / __/___(_) /  ___ ____/ __ \__ _____ ___ / /_  /  _/__  ____
+ _\ \/ __/ / _ \/ -_) __/ /_/ / // / -_|_-</ __/ _/ // _ \/ __/
+/___/\__/_/_.__/\__/_/  \___\_\_,_/\__/___/\__/ /___/_//_/\__(_)
+
+Copyright 2012 SciberQuest Inc.
+*/
+#include "vtkMultiProcessController.h"
+#include "vtkSQBOVMetaReader.h"
+#include "vtkSQFieldTracer.h"
+#include "vtkSQLineSource.h"
+#include "vtkPolyData.h"
+#include "vtkPoints.h"
+#include "TestUtils.h"
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+// Trace the same field lines on one and on several threads per rank,
+// the results should be identical.
+
+namespace {
+vtkPolyData *Trace(
+      vtkMultiProcessController *controller,
+      const std::string &inputFileName,
+      int nThreads)
+{
+  vtkSQBOVMetaReader *mr=vtkSQBOVMetaReader::New();
+  mr->SetFileName(inputFileName.c_str());
+  mr->SetPointArrayStatus("b",1);
+  mr->SetNumberOfGhostCells(2);
+  mr->SetXHasPeriodicBC(1);
+  mr->SetYHasPeriodicBC(1);
+  mr->SetZHasPeriodicBC(1);
+  mr->SetBlockSize(8,8,8);
+  mr->SetBlockCacheSize(4);
+
+  // enough seeds for every thread to have work and to steal some.
+  vtkSQLineSource *p1=vtkSQLineSource::New();
+  p1->SetPoint1(-0.125,-0.125,0.0);
+  p1->SetPoint2(-0.5,-0.5,0.0);
+  p1->SetResolution(63);
+
+  vtkSQFieldTracer *ft=vtkSQFieldTracer::New();
+  ft->SetMode(vtkSQFieldTracer::MODE_STREAM);
+  ft->SetIntegratorType(vtkSQFieldTracer::INTEGRATOR_RK4);
+  ft->SetMaxStep(0.01);
+  ft->SetMaxLineLength(300);
+  ft->SetNullThreshold(0.001);
+  ft->SetForwardOnly(0);
+  ft->SetUseDynamicScheduler(0);
+  ft->SetNumberOfThreads(nThreads);
+  ft->AddInputConnection(0,mr->GetOutputPort(0));
+  ft->AddInputConnection(1,p1->GetOutputPort(0));
+  ft->SetInputArrayToProcess(0,0,0,vtkDataObject::FIELD_ASSOCIATION_POINTS,"b");
+  mr->Delete();
+  p1->Delete();
+
+  GetParallelExec(
+        controller->GetLocalProcessId(),
+        controller->GetNumberOfProcesses(),
+        ft,
+        0.0);
+  ft->Update();
+
+  vtkPolyData *output=vtkPolyData::New();
+  output->ShallowCopy(ft->GetOutput());
+  ft->Delete();
+
+  return output;
+}
+
+int Compare(vtkPolyData *serial, vtkPolyData *threaded)
+{
+  vtkIdType nPts=serial->GetNumberOfPoints();
+  if ((nPts!=threaded->GetNumberOfPoints())
+    || (serial->GetNumberOfCells()!=threaded->GetNumberOfCells()))
+    {
+    std::cerr
+      << "Threaded trace has "
+      << threaded->GetNumberOfPoints() << " points and "
+      << threaded->GetNumberOfCells() << " cells, expected "
+      << nPts << " points and "
+      << serial->GetNumberOfCells() << " cells." << std::endl;
+    return 1;
+    }
+  if (nPts==0)
+    {
+    return 0;
+    }
+  vtkPoints *spts=serial->GetPoints();
+  vtkPoints *tpts=threaded->GetPoints();
+  for (vtkIdType i=0; i<nPts; ++i)
+    {
+    double sx[3];
+    double tx[3];
+    spts->GetPoint(i,sx);
+    tpts->GetPoint(i,tx);
+    for (int q=0; q<3; ++q)
+      {
+      if (std::fabs(sx[q]-tx[q])>1.0e-6)
+        {
+        std::cerr
+          << "Threaded trace differs at point " << i << "." << std::endl;
+        return 1;
+        }
+      }
+    }
+  return 0;
+}
+};
+
+int TestFieldTracerThreads(int argc, char *argv[])
+{
+  vtkMultiProcessController *controller=Initialize(&argc,&argv);
+
+  // configure
+  std::string dataRoot;
+  std::string tempDir;
+  std::string baseline;
+  BroadcastConfiguration(controller,argc,argv,dataRoot,tempDir,baseline);
+
+  std::string inputFileName;
+  inputFileName=dataRoot+"/SciberQuestToolKit/MagneticIslands/MagneticIslands.bov";
+
+  vtkPolyData *serial=Trace(controller,inputFileName,1);
+  vtkPolyData *threaded=Trace(controller,inputFileName,4);
+
+  int localStatus=Compare(serial,threaded);
+  serial->Delete();
+  threaded->Delete();
+
+  int testStatus=0;
+  controller->AllReduce(
+        &localStatus,
+        &testStatus,
+        1,
+        vtkCommunicator::MAX_OP);
+
+  return Finalize(controller,testStatus);
+}
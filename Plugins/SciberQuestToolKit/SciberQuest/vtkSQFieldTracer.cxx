@@ -45,6 +45,9 @@ Copyright 2012 SciberQuest Inc.
 #include "vtkRungeKutta4.h"
 #include "vtkRungeKutta45.h"
 #include "vtkMultiProcessController.h"
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
+#include "vtkConditionVariable.h"
 #include "vtkMath.h"
 
 #include "vtkPVInformationKeys.h"
@@ -75,6 +78,7 @@ Copyright 2012 SciberQuest Inc.
 #endif
 
 #include <algorithm>
+#include <deque>
 
 #ifdef SQTK_DEBUG
 #define vtkSQFieldTracerDEBUG 2
@@ -98,6 +102,420 @@ Copyright 2012 SciberQuest Inc.
 
 const double vtkSQFieldTracer::EPSILON = 1.0E-12;
 
+class FieldTraceReadService;
+
+//*****************************************************************************
+// Per-thread integration state. Each worker has its own integrator,
+// interpolator and termination condition (the working domain of which
+// tracks the neighborhood the worker has loaded) and a range of line
+// ids. Workers that run out of lines steal from the others.
+class FieldTraceWorker
+{
+public:
+  FieldTraceWorker()
+        :
+    Tracer(0),
+    Peers(0),
+    Reader(0),
+    FieldName(0),
+    TraceData(0),
+    NumberOfLines(0),
+    Integrator(0),
+    Interp(0),
+    Cache(0),
+    TermCon(0),
+    OwnTermCon(0),
+    Service(0),
+    First(0),
+    Last(0)
+    {}
+
+  ~FieldTraceWorker()
+    {
+    this->SetCache(0);
+    if (this->Integrator)
+      {
+      this->Integrator->Delete();
+      }
+    if (this->OwnTermCon)
+      {
+      delete this->TermCon;
+      }
+    }
+
+  // Description:
+  // Hold a reference to the neighborhood being integrated so that it
+  // survives being evicted from the reader's cache by another worker.
+  void SetCache(vtkDataSet *data)
+    {
+    if (this->Cache==data) return;
+    if (this->Cache) this->Cache->UnRegister(0);
+    this->Cache=data;
+    if (this->Cache) this->Cache->Register(0);
+    }
+
+  // Description:
+  // Read the neighborhood of pt and point the worker's interpolator at it.
+  // When integrating on several threads the request is served on the
+  // calling thread (see FieldTraceReadService), which is the only one
+  // that touches the reader. Returns 0 if the read failed.
+  vtkDataSet *ReadNeighborhood(const double *pt);
+
+  // Description:
+  // Does the work of ReadNeighborhood for the point stored in ReadPoint,
+  // on the thread that may use the reader. Along with the read, every
+  // reference count change and lazily computed member of the shared
+  // neighborhood happens here, so that the integrating threads only ever
+  // read it.
+  void LoadNeighborhood();
+
+  // Description:
+  // Set the range of line ids [first, last) to integrate.
+  void SetRange(vtkIdType first, vtkIdType last)
+    {
+    this->RangeLock.Lock();
+    this->First=first;
+    this->Last=last;
+    this->RangeLock.Unlock();
+    }
+
+  // Description:
+  // Return the number of lines left in the range.
+  vtkIdType GetNumberRemaining()
+    {
+    this->RangeLock.Lock();
+    vtkIdType n=this->Last-this->First;
+    this->RangeLock.Unlock();
+    return n;
+    }
+
+  // Description:
+  // Take the next line id from the front of the range. Returns false when
+  // the range is empty.
+  bool Pop(vtkIdType &id)
+    {
+    this->RangeLock.Lock();
+    bool ok=this->First<this->Last;
+    if (ok)
+      {
+      id=this->First;
+      ++this->First;
+      }
+    this->RangeLock.Unlock();
+    return ok;
+    }
+
+  // Description:
+  // Give away the back half of the range. Returns false when fewer than
+  // two lines are left, those are left to the owner.
+  bool Split(vtkIdType &first, vtkIdType &last)
+    {
+    this->RangeLock.Lock();
+    vtkIdType n=this->Last-this->First;
+    bool ok=n>1;
+    if (ok)
+      {
+      first=this->Last-n/2;
+      last=this->Last;
+      this->Last=first;
+      }
+    this->RangeLock.Unlock();
+    return ok;
+    }
+
+  // Description:
+  // Take half of the largest range left among the other workers. Returns
+  // false when there is nothing left to steal.
+  bool Steal()
+    {
+    FieldTraceWorker *victim=0;
+    vtkIdType most=1;
+    size_t nPeers=this->Peers->size();
+    for (size_t i=0; i<nPeers; ++i)
+      {
+      FieldTraceWorker *peer=(*this->Peers)[i];
+      if (peer==this) continue;
+      vtkIdType n=peer->GetNumberRemaining();
+      if (n>most)
+        {
+        most=n;
+        victim=peer;
+        }
+      }
+    if (victim==0)
+      {
+      return false;
+      }
+    // the victim may have drained its range since, in that case
+    // look again.
+    vtkIdType first,last;
+    if (victim->Split(first,last))
+      {
+      this->SetRange(first,last);
+      }
+    return true;
+    }
+
+  // Description:
+  // Integrate the lines of the range and then those stolen from the
+  // other workers. When there is a single worker it runs on the calling
+  // thread and reports progress, otherwise progress is reported by the
+  // read service.
+  void Run()
+    {
+    bool reportProgress
+      = (this->Service==0) && !this->Tracer->UseDynamicScheduler;
+    vtkIdType nLines=this->NumberOfLines;
+    vtkIdType nDone=0;
+    while (1)
+      {
+      vtkIdType i;
+      if (!this->Pop(i))
+        {
+        if (this->Steal()) continue;
+        break;
+        }
+
+      // progress report for static load balance. the report
+      // for dynamic load balance is done once for each block.
+      if (reportProgress && !(nDone%10))
+        {
+        vtkIdType nLeft=0;
+        size_t nPeers=this->Peers->size();
+        for (size_t j=0; j<nPeers; ++j)
+          {
+          nLeft+=(*this->Peers)[j]->GetNumberRemaining();
+          }
+        this->Tracer->UpdateProgress((double)(nLines-nLeft)/(double)nLines);
+        }
+      ++nDone;
+
+      // trace a stream line
+      FieldLine *line=this->TraceData->GetFieldLine(i);
+      this->Tracer->IntegrateOne(line,this);
+      this->LineDone();
+      }
+    }
+
+  // Description:
+  // Let the read service know a line has been traced.
+  void LineDone();
+
+public:
+  // shared by all workers
+  vtkSQFieldTracer *Tracer;
+  std::vector<FieldTraceWorker*> *Peers;
+  vtkSQOOCReader *Reader;
+  const char *FieldName;
+  FieldTraceData *TraceData;
+  vtkIdType NumberOfLines;
+
+  // private to this worker
+  vtkInitialValueProblemSolver *Integrator;
+  vtkInterpolatedVelocityField *Interp;   // held by the integrator
+  vtkDataSet *Cache;                      // neighborhood being integrated
+  TerminationCondition *TermCon;
+  int OwnTermCon;
+
+  // neighborhood read requests, see FieldTraceReadService
+  FieldTraceReadService *Service;
+  double ReadPoint[3];
+  vtkDataSet *ReadResult;
+  int ReadPending;
+
+private:
+  vtkSimpleMutexLock RangeLock;
+  vtkIdType First;
+  vtkIdType Last;
+};
+
+//*****************************************************************************
+// Serves the neighborhood reads of the workers on the calling thread.
+// Readers may make MPI calls and ParaView initializes MPI without
+// thread support (MPI_THREAD_SINGLE), so when the lines are integrated
+// on several threads those only integrate, and post their reads here.
+// The calling thread serves them in order and reports progress while
+// the workers run.
+class FieldTraceReadService
+{
+public:
+  FieldTraceReadService()
+        :
+    Tracer(0),
+    Workers(0),
+    NumberOfLines(0),
+    NumberActive(0),
+    NumberDone(0)
+    {}
+
+  // Description:
+  // Called from a worker thread. Blocks until the calling thread has
+  // read the neighborhood of worker->ReadPoint.
+  void Read(FieldTraceWorker *worker)
+    {
+    this->Lock.Lock();
+    worker->ReadPending=1;
+    this->Requests.push_back(worker);
+    this->Wake.Signal();
+    while (worker->ReadPending)
+      {
+      this->Served.Wait(this->Lock);
+      }
+    this->Lock.Unlock();
+    }
+
+  // Description:
+  // Called from a worker thread after each line.
+  void LineDone()
+    {
+    this->Lock.Lock();
+    ++this->NumberDone;
+    if (!(this->NumberDone%10))
+      {
+      this->Wake.Signal();
+      }
+    this->Lock.Unlock();
+    }
+
+  // Description:
+  // Called from a worker thread when it has no more lines to trace.
+  void WorkerDone()
+    {
+    this->Lock.Lock();
+    --this->NumberActive;
+    this->Wake.Signal();
+    this->Lock.Unlock();
+    }
+
+  // Description:
+  // Run on the calling thread until all the workers are done.
+  void Serve()
+    {
+    bool reportProgress=!this->Tracer->UseDynamicScheduler;
+    vtkIdType nReported=0;
+    this->Lock.Lock();
+    while ((this->NumberActive>0) || !this->Requests.empty())
+      {
+      if (!this->Requests.empty())
+        {
+        FieldTraceWorker *worker=this->Requests.front();
+        this->Requests.pop_front();
+        this->Lock.Unlock();
+        worker->LoadNeighborhood();
+        this->Lock.Lock();
+        worker->ReadPending=0;
+        this->Served.Broadcast();
+        }
+      else
+      if (reportProgress && (this->NumberDone-nReported>=10))
+        {
+        nReported=this->NumberDone;
+        this->Lock.Unlock();
+        this->Tracer->UpdateProgress(
+            (double)nReported/(double)this->NumberOfLines);
+        this->Lock.Lock();
+        }
+      else
+        {
+        this->Wake.Wait(this->Lock);
+        }
+      }
+    this->Lock.Unlock();
+    }
+
+  // Description:
+  // vtkMultiThreader entry point, user data is the service. Thread 0 is
+  // the calling thread and serves the others.
+  static VTK_THREAD_RETURN_TYPE ThreadMain(void *arg)
+    {
+    vtkMultiThreader::ThreadInfo *info
+      = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    FieldTraceReadService *service
+      = static_cast<FieldTraceReadService*>(info->UserData);
+    if (info->ThreadID==0)
+      {
+      service->Serve();
+      }
+    else
+      {
+      (*service->Workers)[info->ThreadID-1]->Run();
+      service->WorkerDone();
+      }
+    return VTK_THREAD_RETURN_VALUE;
+    }
+
+public:
+  vtkSQFieldTracer *Tracer;
+  std::vector<FieldTraceWorker*> *Workers;
+  vtkIdType NumberOfLines;
+  int NumberActive;
+
+private:
+  vtkSimpleMutexLock Lock;
+  vtkConditionVariable Wake;    // signals the calling thread
+  vtkConditionVariable Served;  // signals the workers
+  std::deque<FieldTraceWorker*> Requests;
+  vtkIdType NumberDone;
+};
+
+//-----------------------------------------------------------------------------
+vtkDataSet *FieldTraceWorker::ReadNeighborhood(const double *pt)
+{
+  this->ReadPoint[0]=pt[0];
+  this->ReadPoint[1]=pt[1];
+  this->ReadPoint[2]=pt[2];
+  this->ReadResult=0;
+  if (this->Service)
+    {
+    this->Service->Read(this);
+    }
+  else
+    {
+    this->LoadNeighborhood();
+    }
+  return this->ReadResult;
+}
+
+//-----------------------------------------------------------------------------
+void FieldTraceWorker::LoadNeighborhood()
+{
+  vtkDataSet *nhood
+    = this->Reader->ReadNeighborhood(
+        this->ReadPoint,this->TermCon->GetWorkingDomain());
+  this->SetCache(nhood);
+  if (!nhood)
+    {
+    // force a read on the next line.
+    this->TermCon->ResetWorkingDomain();
+    vtkErrorWithObjectMacro(this->Tracer,"Read neighborhood failed.");
+    return;
+    }
+
+  // The readers produce image data and rectilinear grids. Once their
+  // bounds are computed, locating and interpolating in those only reads
+  // the dataset, so the workers can share them.
+  nhood->GetBounds();
+
+  // Initialize the vector field interpolator.
+  this->Interp=vtkInterpolatedVelocityField::New();
+  this->Interp->AddDataSet(nhood);
+  this->Interp->SelectVectors(
+        vtkDataObject::FIELD_ASSOCIATION_POINTS,this->FieldName);
+  this->Integrator->SetFunctionSet(this->Interp);
+  this->Interp->Delete();
+
+  this->ReadResult=nhood;
+}
+
+//-----------------------------------------------------------------------------
+void FieldTraceWorker::LineDone()
+{
+  if (this->Service)
+    {
+    this->Service->LineDone();
+    }
+}
+
 //-----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSQFieldTracer);
 
@@ -109,6 +527,7 @@ vtkSQFieldTracer::vtkSQFieldTracer()
   UseDynamicScheduler(0),
   WorkerBlockSize(16),
   MasterBlockSize(256),
+  NumberOfThreads(1),
   ForwardOnly(0),
   StepUnit(ARC_LENGTH),
   MinStep(1.0E-8),
@@ -160,6 +579,7 @@ vtkSQFieldTracer::~vtkSQFieldTracer()
   #if vtkSQFieldTracerDEBUG>1
   pCerr() << "=====vtkSQFieldTracer::~vtkSQFieldTracer" << std::endl;
   #endif
+  this->ClearWorkers();
   if (this->Integrator)
     {
     this->Integrator->Delete();
@@ -269,6 +689,13 @@ int vtkSQFieldTracer::Initialize(vtkPVXMLElement *root)
     this->SetWorkerBlockSize(workerBlockSize);
     }
 
+  int numberOfThreads=-1;
+  GetOptionalAttribute<int,1>(elem,"number_of_threads",&numberOfThreads);
+  if (numberOfThreads>0)
+    {
+    this->SetNumberOfThreads(numberOfThreads);
+    }
+
   int squeezeColorMap=-1;
   GetOptionalAttribute<int,1>(elem,"squeeze_color_map",&squeezeColorMap);
   if (squeezeColorMap>=0)
@@ -296,6 +723,7 @@ int vtkSQFieldTracer::Initialize(vtkPVXMLElement *root)
       << "#   dynamicScheduler=" << this->GetUseDynamicScheduler() << "\n"
       << "#   masterBlockSize=" << this->GetMasterBlockSize() << "\n"
       << "#   workerBlockSize=" << this->GetWorkerBlockSize() << "\n"
+      << "#   numberOfThreads=" << this->GetNumberOfThreads() << "\n"
       << "#   squeezeColorMap=" << this->GetSqueezeColorMap() << "\n";
     }
 
@@ -906,7 +1334,9 @@ int vtkSQFieldTracer::RequestData(
   // are used. The reduction makes use of global communication.
   traceData->PrintLegend(this->SqueezeColorMap);
 
-  // close the open file and release reader.
+  // release the neighborhoods held by the workers, close the open
+  // file and release reader.
+  this->ClearWorkers();
   oocr->Close();
   oocr->Delete();
 
@@ -1145,27 +1575,71 @@ int vtkSQFieldTracer::IntegrateBlock(
   log->EndEvent("vtkSQFieldTracer::InsertCells");
   #endif
 
-  TerminationCondition *tcon=traceData->GetTerminationCondition();
+  // workers are created on the first block, and kept for the
+  // following blocks.
+  if (this->Workers.empty())
+    {
+    this->InitializeWorkers(traceData->GetTerminationCondition());
+    }
 
-  for (vtkIdType i=0; i<nLines; ++i) //, prog+=progInc)
+  // deal the lines out in contiguous ranges, threads that finish
+  // early steal from the others. Small blocks use fewer threads.
+  int nWorkers=(int)this->Workers.size();
+  int nThreads=(int)std::min((vtkIdType)nWorkers,nLines);
+  for (int j=0; j<nWorkers; ++j)
     {
-    // progress report for static load balance. the report
-    // for dunamic load balance is done once for each block.
-    if (!this->UseDynamicScheduler && !(i%10))
+    FieldTraceWorker *worker=this->Workers[j];
+    worker->Reader=oocr;
+    worker->FieldName=fieldName;
+    worker->TraceData=traceData;
+    worker->NumberOfLines=nLines;
+    if (j<nThreads)
       {
-      double prog=(double)i/(double)nLines;
-      this->UpdateProgress(prog);
+      worker->SetRange(j*nLines/nThreads,(j+1)*nLines/nThreads);
       }
+    else
+      {
+      worker->SetRange(0,0);
+      }
+    }
 
-    // trace a stream line
-    FieldLine *line=traceData->GetFieldLine(i);
-    this->IntegrateOne(oocr,oocrCache,fieldName,line,tcon);
-
-    #if vtkSQFieldTracerDEBUG>=0
-    cstd::err << ".";
+  if (nThreads<2)
+    {
+    this->Workers[0]->Run();
+    }
+  else
+    {
+    #if defined vtkSQFieldTracerTIME
+    log->StartEvent("vtkSQFieldTracer::IntegrateThreaded");
+    #endif
+    // the calling thread serves the reads of the workers, see
+    // FieldTraceReadService.
+    FieldTraceReadService service;
+    service.Tracer=this;
+    service.Workers=&this->Workers;
+    service.NumberOfLines=nLines;
+    service.NumberActive=nWorkers;
+    for (int j=0; j<nWorkers; ++j)
+      {
+      this->Workers[j]->Service=&service;
+      }
+    vtkMultiThreader *threads=vtkMultiThreader::New();
+    threads->SetNumberOfThreads(nWorkers+1);
+    threads->SetSingleMethod(FieldTraceReadService::ThreadMain,&service);
+    threads->SingleMethodExecute();
+    threads->Delete();
+    for (int j=0; j<nWorkers; ++j)
+      {
+      this->Workers[j]->Service=0;
+      }
+    #if defined vtkSQFieldTracerTIME
+    log->EndEvent("vtkSQFieldTracer::IntegrateThreaded");
     #endif
     }
 
+  // the neighborhood last read by the first worker.
+  oocrCache=this->Workers[0]->Cache;
+
   // sync results to output. free resources in preparation
   // for the next pass.
   #if defined vtkSQFieldTracerTIME
@@ -1183,12 +1657,12 @@ int vtkSQFieldTracer::IntegrateBlock(
 
 //-----------------------------------------------------------------------------
 void vtkSQFieldTracer::IntegrateOne(
-      vtkSQOOCReader *oocR,
-      vtkDataSet *&oocRCache,
-      const char *fieldName,
       FieldLine *line,
-      TerminationCondition *tcon)
+      FieldTraceWorker *worker)
 {
+  TerminationCondition *tcon=worker->TermCon;
+  vtkInitialValueProblemSolver *integrator=worker->Integrator;
+
   #if defined vtkSQFieldTracerTIME
   vtkSQLog *log=vtkSQLog::GetGlobalInstance();
   log->StartEvent("vtkSQFieldTracer::Integrate");
@@ -1237,8 +1711,7 @@ void vtkSQFieldTracer::IntegrateOne(
     double p2[3]={0.0};                     // integrated point, non-periodic coordinate space.
     double s0[3]={0.0};                     // segment start point
     int bcSurf=0;                           // set when a periodic boundary condition has been applied.
-    static                                  // interpolator
-    vtkInterpolatedVelocityField *interp=0;
+    vtkInterpolatedVelocityField *&interp=worker->Interp; // interpolator
     #if vtkSQFieldTracerDEBUG>1
     double minStepTaken=VTK_DOUBLE_MAX;
     double maxStepTaken=VTK_DOUBLE_MIN;
@@ -1265,18 +1738,11 @@ void vtkSQFieldTracer::IntegrateOne(
         log->EndEvent("vtkSQFieldTracer::Integrate");
         log->StartEvent("vtkSQFieldTracer::LoadBlock");
         #endif
-        oocRCache=oocR->ReadNeighborhood(p0,tcon->GetWorkingDomain());
-        if (!oocRCache)
+        // this also initializes the worker's interpolator.
+        if (!worker->ReadNeighborhood(p0))
           {
-          vtkErrorMacro("Read neighborhood failed.");
           return;
           }
-        // Initialize the vector field interpolator.
-        interp=vtkInterpolatedVelocityField::New();
-        interp->AddDataSet(oocRCache);
-        interp->SelectVectors(vtkDataObject::FIELD_ASSOCIATION_POINTS,fieldName);
-        this->Integrator->SetFunctionSet(interp);
-        interp->Delete();
         #if defined vtkSQFieldTracerTIME
         log->EndEvent("vtkSQFieldTracer::LoadBlock");
         log->StartEvent("vtkSQFieldTracer::Integrate");
@@ -1339,7 +1805,7 @@ void vtkSQFieldTracer::IntegrateOne(
       interp->SetNormalizeVector(true);
       double error=0.0;
       double stepTaken=0.0;
-      int iErr=this->Integrator->ComputeNextStep(
+      int iErr=integrator->ComputeNextStep(
           p0,p1,0,
           stepSize,
           stepTaken,
@@ -1613,6 +2079,50 @@ void vtkSQFieldTracer::IntegrateOne(
   return;
 }
 
+//-----------------------------------------------------------------------------
+void vtkSQFieldTracer::InitializeWorkers(TerminationCondition *tcon)
+{
+  this->ClearWorkers();
+
+  // when threaded, the calling thread serves the reads and so needs a
+  // thread of its own.
+  int nThreads=std::min(this->NumberOfThreads,VTK_MAX_THREADS-1);
+
+  for (int i=0; i<nThreads; ++i)
+    {
+    FieldTraceWorker *worker=new FieldTraceWorker;
+    worker->Tracer=this;
+    worker->Peers=&this->Workers;
+    if (i==0)
+      {
+      // the calling thread uses the filter's integrator and the map's
+      // termination condition.
+      worker->Integrator=this->Integrator;
+      worker->Integrator->Register(0);
+      worker->TermCon=tcon;
+      }
+    else
+      {
+      worker->Integrator=this->Integrator->NewInstance();
+      worker->TermCon=new TerminationCondition;
+      worker->TermCon->Copy(*tcon);
+      worker->OwnTermCon=1;
+      }
+    this->Workers.push_back(worker);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkSQFieldTracer::ClearWorkers()
+{
+  size_t nWorkers=this->Workers.size();
+  for (size_t i=0; i<nWorkers; ++i)
+    {
+    delete this->Workers[i];
+    }
+  this->Workers.clear();
+}
+
 //-----------------------------------------------------------------------------
 unsigned long vtkSQFieldTracer::GetGlobalCellId(vtkDataSet *data)
 {
@@ -1699,4 +2209,5 @@ void vtkSQFieldTracer::ClipStep(
 void vtkSQFieldTracer::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << endl;
 }
@@ -12,6 +12,14 @@ Copyright 2012 SciberQuest Inc.
 // Scalable field line tracer using RK45 Adds capability to
 // terminate trace upon intersection with one of a set of
 // surfaces.
+//
+// Seeds are distributed across processes either statically or by a
+// master/worker scheduler (see UseDynamicScheduler). Within a process
+// the field lines of each block of seeds may be integrated on several
+// threads (see NumberOfThreads). Each thread starts on a contiguous
+// range of the block, and threads that run out of work steal the back
+// half of the largest range left. Neighborhoods are read on the calling
+// thread on behalf of the integrating threads.
 // TODO verify that VTK rk45 implementation increases step size!!
 
 #ifndef __vtkSQFieldTracer_h
@@ -20,6 +28,8 @@ Copyright 2012 SciberQuest Inc.
 #include "vtkSciberQuestModule.h" // for export macro
 #include "vtkDataSetAlgorithm.h"
 
+#include <vector> // for vector
+
 class vtkUnstructuredGrid;
 class vtkSQOOCReader;
 class vtkMultiProcessController;
@@ -30,6 +40,8 @@ class vtkPVXMLElement;
 class IdBlock;
 class FieldLine;
 class FieldTraceData;
+class FieldTraceWorker;
+class FieldTraceReadService;
 class TerminationCondition;
 //ETX
 
@@ -186,6 +198,15 @@ public:
   vtkSetMacro(UseDynamicScheduler,int);
   vtkGetMacro(UseDynamicScheduler,int);
 
+  // Description:
+  // Set the number of threads used to integrate the field lines of each
+  // block of seeds on this process. When this is greater than 1 the
+  // calling thread does not integrate but makes all the reads for the
+  // others, so that MPI is only ever used from the calling thread. The
+  // default is 1.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_INT_MAX);
+  vtkGetMacro(NumberOfThreads,int);
+
   // Description:
   // Set the log level.
   // 0 -- no logging
@@ -243,16 +264,22 @@ private:
 
 
   // Description:
-  // Trace one field line from the given seed point, using the given out-of-core
-  // reader. As segments are generated they are tested using the stermination
-  // condition and terminated imediately. The last neighborhood read is stored
-  // in the nhood parameter. It is up to the caller to delete this.
+  // Trace one field line from the given seed point, using the out-of-core
+  // reader of the given worker. As segments are generated they are tested
+  // using the stermination condition and terminated imediately. The
+  // integrator, termination condition and the last neighborhood read are
+  // those of the given worker.
   void IntegrateOne(
-        vtkSQOOCReader *oocR,
-        vtkDataSet *&oocRCache,
-        const char *fieldName,
         FieldLine *line,
-        TerminationCondition *tcon);
+        FieldTraceWorker *worker);
+
+  // Description:
+  // Create/release the per-thread integration state. Workers are kept
+  // across blocks so that the neighborhood each has loaded is reused.
+  void InitializeWorkers(TerminationCondition *tcon);
+  void ClearWorkers();
+  friend class FieldTraceWorker;
+  friend class FieldTraceReadService;
   //ETX
 
   // Description:
@@ -286,6 +313,10 @@ private:
   int UseDynamicScheduler;
   int WorkerBlockSize;
   int MasterBlockSize;
+  int NumberOfThreads;
+  //BTX
+  std::vector<FieldTraceWorker*> Workers;
+  //ETX
 
   // Parameters controlling integration
   int ForwardOnly;
@@ -150,6 +150,42 @@ def get_memuse() :
         retval.append("DS[" + rank + "] " + procUse + " / " + hostUse)
     return retval
 
+def enable_trace(enable=True) :
+    """
+    Turns the trace recorder on (or off) on all processes. While on, pipeline
+    executions, data delivery and renders are recorded as timed spans. Use
+    save_trace() to collect them.
+    """
+    pxm = paraview.servermanager.ProxyManager()
+    tr = pxm.NewProxy("misc", "TraceRecorder")
+    prop = tr.GetProperty("Enable")
+    prop.SetElements1(1 if enable else 0)
+    tr.UpdateVTKObjects()
+
+def save_trace(filename, clear=True) :
+    """
+    Gathers the events recorded since enable_trace() from the client and all
+    server ranks and saves them as a Chrome trace (JSON) timeline that can be
+    opened in chrome://tracing or Perfetto. When clear is True, the recorded
+    events are discarded once gathered.
+    """
+    session = paraview.servermanager.ActiveConnection.Session
+
+    components = [session.CLIENT]
+    if paraview.servermanager.ActiveConnection.IsRemote():
+        if session.GetRenderClientMode() == session.RENDERING_UNIFIED:
+            components.append(session.SERVERS)
+        else:
+            components += [session.RENDER_SERVER, session.DATA_SERVER]
+
+    traceInfo = paraview.servermanager.vtkPVTraceInformation()
+    for component in components:
+        info = paraview.servermanager.vtkPVTraceInformation()
+        info.SetClearRecorder(clear)
+        session.GatherInformation(component, info, 0)
+        traceInfo.AddInformation(info)
+    return traceInfo.WriteChromeTrace(filename)
+
 def dump_logs( filename ) :
     """
     This saves off the logs we've gathered.